@@ -0,0 +1,227 @@
+// Copyright (c) 2024-2025 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file main.cpp
+/// @brief Channel large-payload benchmark: 256 B - 16 MB messages through the payload pool
+///
+/// A producer thread streams messages of one size through a Channel while a
+/// consumer thread drains it. Payloads over Message::INLINE_SIZE travel in
+/// SharedMemoryPool blocks, so every size except the first exercises the
+/// pool path. The pool is deliberately small relative to the message volume:
+/// the producer regularly sees "Pool exhausted" and has to wait for the
+/// consumer (backpressure), which the 'stalls' column counts.
+///
+/// Modes:
+///   raw   - postRaw / tryReceiveRaw (memcpy in, memcpy out)
+///   value - post / tryReceive (serialize into the block, decode in place)
+///
+/// With --byte-ring the channel uses ChannelMode::ByteRing, where payloads up to
+/// a quarter of the ring (64 KB here) travel inline as variable-length records
+/// and only larger ones use the pool.
+///
+/// Usage:
+///   channel_payload_benchmark                # Both modes, 256 B .. 16 MB
+///   channel_payload_benchmark --max-mb 1     # Stop at 1 MB
+///   channel_payload_benchmark --mode raw     # Only one mode
+///   channel_payload_benchmark --byte-ring    # ByteRing channel instead of fixed slots
+
+#include <lager_ext/ipc.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lager_ext;
+using namespace lager_ext::ipc;
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+constexpr std::size_t KB = 1024;
+constexpr std::size_t MB = 1024 * KB;
+constexpr std::size_t TARGET_BYTES_PER_RUN = 512 * MB; // Message count = volume / size
+constexpr std::size_t MIN_MESSAGES = 32;
+constexpr std::size_t MAX_MESSAGES = 200000;
+constexpr std::size_t QUEUE_CAPACITY = 1024;
+constexpr uint32_t MSG_PAYLOAD = 1;
+
+struct BenchConfig {
+    std::size_t max_bytes = 16 * MB;
+    bool raw_mode = true;
+    bool value_mode = true;
+    ChannelMode channel_mode = ChannelMode::FixedSlots;
+};
+
+struct RunResult {
+    double mb_per_sec = 0;
+    double msgs_per_sec = 0;
+    std::size_t stalls = 0; // Posts rejected with a full pool or queue
+    bool intact = true;
+};
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+void printHeader(const std::string& title) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << title << "\n";
+    std::cout << std::string(60, '=') << "\n\n";
+}
+
+std::string format_size(std::size_t bytes) {
+    if (bytes >= MB) {
+        return std::to_string(bytes / MB) + " MB";
+    }
+    if (bytes >= KB) {
+        return std::to_string(bytes / KB) + " KB";
+    }
+    return std::to_string(bytes) + " B";
+}
+
+// Room for a few messages in flight, far less than the volume sent
+std::size_t pool_size_for(std::size_t message_size) {
+    return std::max<std::size_t>(2 * MB, 4 * (message_size + 4 * KB));
+}
+
+//=============================================================================
+// Benchmark
+//=============================================================================
+
+RunResult run(const BenchConfig& cfg, std::size_t size, bool value_mode) {
+    const std::string name = "lager_ext_payload_bench_" + std::to_string(size) + (value_mode ? "_v" : "_r");
+    auto producer = Channel::create(name, QUEUE_CAPACITY, pool_size_for(size), cfg.channel_mode);
+    auto consumer = producer ? Channel::open(name) : nullptr;
+    if (!producer || !consumer) {
+        std::cerr << "Failed to create channel " << name << "\n";
+        return {0, 0, 0, false};
+    }
+
+    const std::size_t count = std::clamp(TARGET_BYTES_PER_RUN / size, MIN_MESSAGES, MAX_MESSAGES);
+
+    // Payload: raw bytes, or a string value of the same length (a few bytes of framing on top)
+    std::vector<uint8_t> bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    const ImmerValue value{std::string(bytes.begin(), bytes.end())};
+
+    RunResult result;
+    std::atomic<bool> intact{true};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread consumer_thread([&] {
+        std::vector<uint8_t> buffer(size);
+        std::size_t received = 0;
+        while (received < count) {
+            if (value_mode) {
+                if (auto msg = consumer->tryReceive()) {
+                    if (received == 0 && !(msg->data == value)) {
+                        intact = false;
+                    }
+                    ++received;
+                    continue;
+                }
+            } else {
+                uint32_t msgId = 0;
+                int n = consumer->tryReceiveRaw(msgId, buffer.data(), buffer.size());
+                if (n > 0) {
+                    if (received == 0 && (static_cast<std::size_t>(n) != size || buffer != bytes)) {
+                        intact = false;
+                    }
+                    ++received;
+                    continue;
+                }
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    for (std::size_t sent = 0; sent < count;) {
+        bool ok = value_mode ? producer->post(MSG_PAYLOAD, value) : producer->postRaw(MSG_PAYLOAD, bytes.data(), size);
+        if (ok) {
+            ++sent;
+        } else {
+            ++result.stalls; // Backpressure: wait for the consumer to hand blocks back
+            std::this_thread::yield();
+        }
+    }
+    consumer_thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.mb_per_sec = static_cast<double>(size) * count / MB / seconds;
+    result.msgs_per_sec = count / seconds;
+    result.intact = intact.load();
+    return result;
+}
+
+void run_mode(const BenchConfig& cfg, bool value_mode) {
+    std::cout << "Mode: " << (value_mode ? "value (post / tryReceive)" : "raw (postRaw / tryReceiveRaw)") << "\n";
+    std::cout << std::left << std::setw(10) << "Size" << std::setw(12) << "MB/s" << std::setw(14) << "msgs/s"
+              << std::setw(12) << "stalls"
+              << "result\n";
+    std::cout << std::string(60, '-') << "\n";
+
+    for (std::size_t size : {256 * std::size_t{1}, 1 * KB, 4 * KB, 64 * KB, 1 * MB, 4 * MB, 16 * MB}) {
+        if (size > cfg.max_bytes) {
+            break;
+        }
+        RunResult r = run(cfg, size, value_mode);
+        std::cout << std::left << std::setw(10) << format_size(size) << std::setw(12) << std::fixed
+                  << std::setprecision(1) << r.mb_per_sec << std::setw(14) << std::setprecision(0) << r.msgs_per_sec
+                  << std::setw(12) << r.stalls << (r.intact ? "ok" : "CORRUPT") << "\n";
+    }
+    std::cout << "\n";
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-mb") == 0 && i + 1 < argc) {
+            cfg.max_bytes = static_cast<std::size_t>(std::atoi(argv[++i])) * MB;
+        } else if (std::strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            cfg.raw_mode = std::strcmp(mode, "raw") == 0;
+            cfg.value_mode = std::strcmp(mode, "value") == 0;
+        } else if (std::strcmp(argv[i], "--byte-ring") == 0) {
+            cfg.channel_mode = ChannelMode::ByteRing;
+        }
+    }
+
+    printHeader("Channel Large Payload Benchmark (256 B - 16 MB)");
+
+    std::cout << "Channel mode: " << (cfg.channel_mode == ChannelMode::ByteRing ? "ByteRing" : "FixedSlots")
+              << "\n\n";
+
+    if (cfg.raw_mode) {
+        run_mode(cfg, false);
+    }
+    if (cfg.value_mode) {
+        run_mode(cfg, true);
+    }
+
+    std::cout << "Notes:\n";
+    if (cfg.channel_mode == ChannelMode::ByteRing) {
+        std::cout << "  - Payloads over " << QUEUE_CAPACITY * sizeof(Message) / 4 / KB
+                  << " KB travel in SharedMemoryPool blocks\n";
+    } else {
+        std::cout << "  - Payloads over " << Message::INLINE_SIZE << " bytes travel in SharedMemoryPool blocks\n";
+    }
+    std::cout << "  - 'stalls' counts posts rejected while the pool or queue was full (backpressure)\n";
+    std::cout << "  - 'result' checks the first received payload against the one sent\n";
+    return 0;
+}
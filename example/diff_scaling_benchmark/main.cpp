@@ -0,0 +1,345 @@
+// Copyright (c) 2024-2025 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file main.cpp
+/// @brief collect_diff scaling benchmark: diff time vs scene size for a single edit
+///
+/// Builds scenes of 1k - 100k objects, edits one object's position (and one
+/// entry of the draw-order vector), then diffs the two states:
+///
+///   legacy  - the previous collect_diff: find() per key over both maps,
+///             element-by-element vector walk, deep == on every entry
+///   current - collect_diff: immer::diff over shared HAMT nodes, box identity,
+///             shared RRB subtrees skipped
+///
+/// Both must report the same two modifications. The legacy walk grows with the
+/// scene; the current one should stay roughly flat.
+///
+/// A second table moves every object of the largest scene and diffs it with
+/// collect_diff on 1 - 8 threads; all thread counts must report the same
+/// modifications in the same order.
+///
+/// A third table diffs the largest scene against a deserialized copy of its
+/// edited state, which shares no storage with it: a full walk vs
+/// DiffOptions::prune_by_hash over cached content hashes.
+///
+/// Usage:
+///   diff_scaling_benchmark                  # 1k, 10k, 100k objects
+///   diff_scaling_benchmark --max 1000000    # Up to 1M objects
+///   diff_scaling_benchmark --iterations 50  # Diffs per measurement
+
+#include <lager_ext/path_utils.h>
+#include <lager_ext/serialization.h>
+#include <lager_ext/shared_state.h>
+#include <lager_ext/value.h>
+#include <lager_ext/value_diff.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lager_ext;
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+struct BenchConfig {
+    std::size_t max_objects = 100000;
+    int iterations = 20;
+};
+
+constexpr std::size_t THREAD_COUNTS[] = {1, 2, 4, 8};
+
+struct RunResult {
+    double legacy_us = 0;
+    double current_us = 0;
+    std::size_t legacy_changes = 0;
+    std::size_t current_changes = 0;
+};
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+void printHeader(const std::string& title) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << title << "\n";
+    std::cout << std::string(60, '=') << "\n\n";
+}
+
+std::string object_id(std::size_t i) {
+    return "obj_" + std::to_string(i);
+}
+
+/// {"objects": {id: {name, visible, transform: {position, rotation, scale}}}, "draw_order": [id...]}
+ImmerValue make_scene(std::size_t objects) {
+    auto map = ValueMap{}.transient();
+    auto order = ValueVector{}.transient();
+    for (std::size_t i = 0; i < objects; ++i) {
+        const std::string id = object_id(i);
+        ImmerValue transform = ImmerValue::map({{"position", ImmerValue::vec3(float(i), 0.0f, 0.0f)},
+                                                {"rotation", ImmerValue::vec4(0.0f, 0.0f, 0.0f, 1.0f)},
+                                                {"scale", ImmerValue::vec3(1.0f, 1.0f, 1.0f)}});
+        map.set(id, ImmerValue::map({{"name", ImmerValue{"Object " + std::to_string(i)}},
+                                     {"visible", ImmerValue{true}},
+                                     {"transform", transform}}));
+        order.push_back(ImmerValue{id});
+    }
+    return ImmerValue::map({{"objects", ImmerValue{BoxedValueMap{map.persistent()}}},
+                            {"draw_order", ImmerValue{BoxedValueVector{order.persistent()}}}});
+}
+
+/// Move one object and swap one draw-order entry, sharing everything else
+ImmerValue edit_scene(const ImmerValue& scene, std::size_t objects) {
+    const std::size_t target = objects / 2;
+    Path position;
+    position.push_back("objects").push_back(object_id(target)).push_back("transform").push_back("position");
+    Path order;
+    order.push_back("draw_order").push_back(target);
+
+    ImmerValue moved = set_at_path(scene, position, ImmerValue::vec3(-1.0f, 2.0f, 3.0f));
+    return set_at_path(moved, order, ImmerValue{"moved"});
+}
+
+/// Move every object, sharing only the draw order
+ImmerValue move_all(const ImmerValue& scene, std::size_t objects) {
+    ImmerValue moved = scene;
+    for (std::size_t i = 0; i < objects; ++i) {
+        Path position;
+        position.push_back("objects").push_back(object_id(i)).push_back("transform").push_back("position");
+        moved = set_at_path(moved, position, ImmerValue::vec3(float(i), 1.0f, 0.0f));
+    }
+    return moved;
+}
+
+bool same_modifications(const DiffResult& a, const DiffResult& b) {
+    return a.added.empty() && b.added.empty() && a.removed.empty() && b.removed.empty() &&
+           std::equal(a.modified.begin(), a.modified.end(), b.modified.begin(), b.modified.end(),
+                      [](const ModifiedEntry& x, const ModifiedEntry& y) {
+                          return x.path == y.path && x.new_value == y.new_value;
+                      });
+}
+
+/// Counts leaf changes reported by diff_values
+class ChangeCounter : public DiffSink {
+public:
+    void on_add(PathView, const ImmerValue&) override { ++count; }
+    void on_remove(PathView, const ImmerValue&) override { ++count; }
+    void on_change(PathView, const ImmerValue&, const ImmerValue&) override { ++count; }
+    std::size_t count = 0;
+};
+
+template <typename Fn>
+double time_once_us(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+//=============================================================================
+// Legacy collect_diff (before structural sharing was used)
+//=============================================================================
+
+void legacy_diff(const ImmerValue& old_val, const ImmerValue& new_val, Path& path, DiffResult& result) {
+    if (old_val.data == new_val.data) {
+        return;
+    }
+    if (old_val.type_index() != new_val.type_index()) {
+        result.modified.push_back({path, old_val, new_val});
+        return;
+    }
+    if (auto* old_map = old_val.get_if<BoxedValueMap>()) {
+        const auto& new_map = new_val.get_if<BoxedValueMap>()->get();
+        for (const auto& [key, new_child] : new_map) {
+            path.push_back(key);
+            if (auto* old_child = old_map->get().find(key)) {
+                if (&old_child->data != &new_child.data) {
+                    legacy_diff(*old_child, new_child, path, result);
+                }
+            } else {
+                result.added.emplace_back(path, new_child);
+            }
+            path.pop_back();
+        }
+        for (const auto& [key, old_child] : old_map->get()) {
+            if (!new_map.find(key)) {
+                path.push_back(key);
+                result.removed.emplace_back(path, old_child);
+                path.pop_back();
+            }
+        }
+        return;
+    }
+    if (auto* old_vec = old_val.get_if<BoxedValueVector>()) {
+        const auto& new_vec = new_val.get_if<BoxedValueVector>()->get();
+        const std::size_t common = std::min(old_vec->get().size(), new_vec.size());
+        for (std::size_t i = 0; i < common; ++i) {
+            if (&old_vec->get()[i].data != &new_vec[i].data) {
+                path.push_back(i);
+                legacy_diff(old_vec->get()[i], new_vec[i], path, result);
+                path.pop_back();
+            }
+        }
+        for (std::size_t i = common; i < new_vec.size(); ++i) {
+            path.push_back(i);
+            result.added.emplace_back(path, new_vec[i]);
+            path.pop_back();
+        }
+        for (std::size_t i = common; i < old_vec->get().size(); ++i) {
+            path.push_back(i);
+            result.removed.emplace_back(path, old_vec->get()[i]);
+            path.pop_back();
+        }
+        return;
+    }
+    result.modified.push_back({path, old_val, new_val});
+}
+
+DiffResult legacy_collect_diff(const ImmerValue& old_val, const ImmerValue& new_val) {
+    DiffResult result;
+    Path path;
+    legacy_diff(old_val, new_val, path, result);
+    return result;
+}
+
+//=============================================================================
+// Benchmark
+//=============================================================================
+
+template <typename DiffFn>
+double time_us(int iterations, std::size_t& changes, DiffFn&& diff) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        DiffResult result = diff();
+        changes = result.added.size() + result.removed.size() + result.modified.size();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+RunResult run(const BenchConfig& cfg, std::size_t objects) {
+    const ImmerValue before = make_scene(objects);
+    const ImmerValue after = edit_scene(before, objects);
+
+    RunResult result;
+    result.legacy_us = time_us(cfg.iterations, result.legacy_changes, [&] { return legacy_collect_diff(before, after); });
+    result.current_us = time_us(cfg.iterations, result.current_changes, [&] { return collect_diff(before, after); });
+    return result;
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            cfg.max_objects = static_cast<std::size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            cfg.iterations = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    printHeader("collect_diff Scaling Benchmark (one edit, growing scene)");
+
+    std::cout << "Edit: one object's transform/position + one draw_order entry, " << cfg.iterations
+              << " diffs per measurement\n\n";
+    std::cout << std::left << std::setw(10) << "Objects" << std::setw(14) << "legacy us" << std::setw(14)
+              << "current us" << std::setw(10) << "Speedup" << std::setw(10) << "changes"
+              << "result\n";
+    std::cout << std::string(64, '-') << "\n";
+
+    for (std::size_t objects = 1000; objects <= cfg.max_objects; objects *= 10) {
+        RunResult r = run(cfg, objects);
+        const bool ok = r.legacy_changes == 2 && r.current_changes == 2;
+        std::cout << std::left << std::setw(10) << objects << std::fixed << std::setprecision(1) << std::setw(14)
+                  << r.legacy_us << std::setw(14) << r.current_us << std::setw(10) << r.legacy_us / r.current_us
+                  << std::setw(10) << r.current_changes << (ok ? "ok" : "MISMATCH") << "\n";
+    }
+    std::cout << "\n";
+
+    std::size_t largest = 1000;
+    while (largest * 10 <= cfg.max_objects) {
+        largest *= 10;
+    }
+    printHeader("Parallel collect_diff (every object moved)");
+
+    const ImmerValue before = make_scene(largest);
+    const ImmerValue after = move_all(before, largest);
+    const DiffResult serial = collect_diff(before, after);
+
+    std::cout << "Objects: " << largest << ", " << std::thread::hardware_concurrency() << " hardware threads\n\n";
+    std::cout << std::left << std::setw(10) << "Threads" << std::setw(14) << "us" << std::setw(10) << "Speedup"
+              << std::setw(10) << "changes"
+              << "result\n";
+    std::cout << std::string(50, '-') << "\n";
+
+    double serial_us = 0;
+    for (std::size_t threads : THREAD_COUNTS) {
+        std::size_t changes = 0;
+        DiffResult last;
+        const double us = time_us(cfg.iterations, changes, [&] {
+            last = collect_diff(before, after, threads);
+            return last;
+        });
+        if (threads == 1) {
+            serial_us = us;
+        }
+        const bool ok = changes == largest && same_modifications(serial, last);
+        std::cout << std::left << std::setw(10) << threads << std::fixed << std::setprecision(1) << std::setw(14) << us
+                  << std::setw(10) << serial_us / us << std::setw(10) << changes << (ok ? "ok" : "MISMATCH") << "\n";
+    }
+    std::cout << "\n";
+
+    printHeader("Deserialized copy (no shared storage, one edit)");
+
+    const ImmerValue edited = edit_scene(before, largest);
+    const ImmerValue received = deserialize(serialize(edited));
+    const ImmerValue received_same = deserialize(serialize(before));
+
+    bool equal = false;
+    const double equal_cold_us = time_once_us([&] { equal = received_same == before; });
+    const double hash_before_us = time_once_us([&] { (void)content_hash(before); });
+    const double hash_received_us = time_once_us([&] {
+        (void)content_hash(received);
+        (void)content_hash(received_same);
+    });
+
+    ChangeCounter full;
+    const double full_us = time_once_us([&] { diff_values(before, received, full); });
+    ChangeCounter pruned;
+    const double pruned_us = time_once_us([&] { diff_values(before, received, pruned, {.prune_by_hash = true}); });
+    bool unequal = true;
+    const double unequal_hashed_us = time_once_us([&] { unequal = before != received; });
+
+    std::cout << std::left << std::setw(44) << "Step" << std::setw(14) << "us"
+              << "result\n";
+    std::cout << std::string(64, '-') << "\n";
+    auto row = [](const char* step, double us, const std::string& result) {
+        std::cout << std::left << std::setw(44) << step << std::fixed << std::setprecision(1) << std::setw(14) << us
+                  << result << "\n";
+    };
+    row("== equal copy (deep compare)", equal_cold_us, equal ? "equal" : "MISMATCH");
+    row("content_hash(before), first time", hash_before_us, "");
+    row("content_hash of both copies, first time", hash_received_us, "");
+    row("!= edited copy (cached hashes)", unequal_hashed_us, unequal ? "unequal" : "MISMATCH");
+    row("diff_values, full walk", full_us, std::to_string(full.count) + " changes");
+    row("diff_values, prune_by_hash", pruned_us,
+        std::to_string(pruned.count) + " changes" + (pruned.count == full.count ? "" : " MISMATCH"));
+    std::cout << "\n";
+
+    std::cout << "Notes:\n";
+    std::cout << "  - us = microseconds per collect_diff call\n";
+    std::cout << "  - legacy visits every key of the objects map and every draw_order element\n";
+    std::cout << "  - current only opens the HAMT nodes and RRB subtrees on the edited paths\n";
+    std::cout << "  - threads > 1 split the objects map by HAMT bucket; the result keeps the serial order\n";
+    std::cout << "  - hashes are cached in the containers: each tree is hashed once, later compares are O(1)\n";
+    return 0;
+}
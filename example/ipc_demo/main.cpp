@@ -681,7 +681,7 @@ void test_message_layout() {
     msg.domain = MessageDomain::Document;
     msg.flags = MessageFlags::None;
     msg.requestId = 0;
-    msg.poolOffset = 0;
+    msg.poolBlock = 0;
     
     std::cout << "msg.msgId (hash of 'TestEvent') = " << msg.msgId << "\n";
     std::cout << "msg.domain = " << static_cast<int>(msg.domain) << " (Document)\n";
@@ -0,0 +1,936 @@
+// Copyright (c) 2024-2025 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file main.cpp
+/// @brief Cross-process IPC benchmark suite: Channel, ChannelPair, RemoteBus,
+///        SharedBufferSPSC and StatePublisher/StateSubscriber
+///
+/// Every measurement runs between two processes: this one and a child that is
+/// fork()ed on POSIX, or re-launched from this executable with --child on
+/// Windows. The parent creates its endpoints before spawning the child; the
+/// child opens them, creates whatever it owns and reports "ready" through a
+/// small SharedBufferSPSC control block.
+///
+/// Per transport:
+///   round trip - parent sends, child echoes, parent waits for the echo
+///                (p50 / p99 / p99.9 / max over --iterations, after a warm-up)
+///   throughput - parent streams --messages one way, child counts them and
+///                reports "done" through the control block
+///   CPU        - parent + child CPU time over wall time for each run
+///                (100% = one core busy)
+///
+/// SharedBufferSPSC and StatePublisher are latest-value transports: a reader
+/// that falls behind skips versions, so their throughput run also reports how
+/// many updates the reader actually saw ('delivered').
+///
+/// Usage:
+///   ipc_suite_benchmark                          # All transports, table on stdout
+///   ipc_suite_benchmark --json results.json      # Also write JSON to a file
+///   ipc_suite_benchmark --json -                 # JSON only, on stdout
+///   ipc_suite_benchmark --transport channel      # One transport (channel, channel_pair,
+///                                                #   remote_bus, spsc, state)
+///   ipc_suite_benchmark --iterations 2000 --messages 50000 --payload 1024
+
+#include <lager_ext/event_bus.h>
+#include <lager_ext/event_bus_ipc.h>
+#include <lager_ext/ipc.h>
+#include <lager_ext/shared_buffer_spsc.h>
+#include <lager_ext/shared_state.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace lager_ext;
+using namespace lager_ext::ipc;
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+constexpr uint32_t MSG_DATA = 1;
+constexpr uint32_t MSG_QUIT = 2;
+constexpr std::size_t WARMUP = 100;
+constexpr std::size_t STATE_SHM_SIZE = 4 * 1024 * 1024;
+constexpr auto READY_TIMEOUT = std::chrono::seconds(10);
+constexpr auto IDLE_TIMEOUT = std::chrono::seconds(10); // A child gives up after this long without traffic
+
+struct BenchConfig {
+    std::size_t iterations = 10000; // Round trips
+    std::size_t messages = 100000;  // One-way throughput messages
+    std::size_t payload = 64;       // Payload bytes (SharedBufferSPSC uses a fixed 64-byte sample)
+};
+
+/// Child -> parent control block, one per run
+struct ControlBlock {
+    uint64_t ready = 0;    // Child endpoints are open
+    uint64_t done = 0;     // Child finished its side of the run
+    uint64_t received = 0; // Messages (or distinct updates) the child saw
+};
+
+/// SharedBufferSPSC sample: a sequence number plus filler up to 64 bytes
+struct Sample {
+    uint64_t seq = 0;
+    uint8_t payload[56] = {};
+};
+
+enum class Phase { RoundTrip, Throughput };
+
+constexpr const char* PHASE_NAMES[] = {"rtt", "throughput"};
+
+struct RunResult {
+    bool ok = false;
+    std::vector<double> latencies_us; // Round trip only, sorted
+    std::size_t messages = 0;         // Throughput only
+    uint64_t delivered = 0;
+    double seconds = 0;   // Timed section
+    double cpu_percent = 0; // Parent + child over the whole run
+
+    double percentile(double p) const {
+        if (latencies_us.empty())
+            return 0;
+        auto index = static_cast<std::size_t>(p * (latencies_us.size() - 1));
+        return latencies_us[index];
+    }
+};
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+void printHeader(const std::string& title) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << title << "\n";
+    std::cout << std::string(60, '=') << "\n\n";
+}
+
+double elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// CPU time (user + system) of this process in seconds
+double self_cpu_seconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    auto ticks = [](const FILETIME& ft) { return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+    return static_cast<double>(ticks(kernel) + ticks(user)) / 1e7;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+/// Poll `done` until it returns true: spin with yield first, then short sleeps
+template <typename Pred>
+bool wait_until(Pred done, std::chrono::steady_clock::duration timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (int spins = 0; !done(); ++spins) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        if (spins < 1000) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    return true;
+}
+
+std::string make_bytes(std::size_t size) {
+    std::string bytes(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<char>('a' + i % 26);
+    }
+    return bytes;
+}
+
+ImmerValue make_state(int64_t seq, const std::string& data) {
+    return ImmerValue{ValueMap{}.set("seq", ImmerValue{seq}).set("data", ImmerValue{data})};
+}
+
+int64_t seq_of(const ImmerValue& state) {
+    return state.is_map() ? state.at("seq").as<int64_t>() : 0; // Null before the first update
+}
+
+using Control = SharedBufferSPSC<ControlBlock>;
+
+std::unique_ptr<Control> open_control(const std::string& name) {
+    return Control::open(name + "_ctl");
+}
+
+void report(Control& control, uint64_t ready, uint64_t done, uint64_t received) {
+    control.write(ControlBlock{ready, done, received});
+}
+
+bool wait_ready(const Control& control) {
+    return wait_until([&] { return control.read().ready != 0; }, READY_TIMEOUT);
+}
+
+/// Wait for the child's "done" and return what it received
+std::optional<uint64_t> wait_done(const Control& control) {
+    if (!wait_until([&] { return control.read().done != 0; }, IDLE_TIMEOUT)) {
+        return std::nullopt;
+    }
+    return control.read().received;
+}
+
+//=============================================================================
+// Child process
+//=============================================================================
+
+using ChildFn = int (*)(const BenchConfig&, const std::string& name);
+
+/// The other end of a run: fork() on POSIX, the same executable with --child on Windows
+class ChildProcess {
+public:
+    ChildProcess() = default;
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+    ~ChildProcess() { wait(true); }
+
+    bool start(ChildFn fn, const char* transport, Phase phase, const BenchConfig& cfg, const std::string& name) {
+#ifdef _WIN32
+        (void)fn;
+        char exe[MAX_PATH];
+        GetModuleFileNameA(nullptr, exe, MAX_PATH);
+        std::string cmd = "\"" + std::string(exe) + "\" --child " + transport + " " +
+                          PHASE_NAMES[static_cast<int>(phase)] + " --name " + name + " --iterations " +
+                          std::to_string(cfg.iterations) + " --messages " + std::to_string(cfg.messages) +
+                          " --payload " + std::to_string(cfg.payload);
+        STARTUPINFOA si{};
+        si.cb = sizeof(si);
+        PROCESS_INFORMATION pi{};
+        if (!CreateProcessA(nullptr, cmd.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi)) {
+            return false;
+        }
+        CloseHandle(pi.hThread);
+        process_ = pi.hProcess;
+        return true;
+#else
+        (void)transport;
+        (void)phase;
+        std::cout.flush(); // Don't let the child inherit (and print) buffered output
+        pid_ = fork();
+        if (pid_ == 0) {
+            _exit(fn(cfg, name)); // Skip the parent's destructors: they own the shared memory
+        }
+        return pid_ > 0;
+#endif
+    }
+
+    /// Reap the child (killing it first if asked); true if it exited with 0
+    bool wait(bool kill = false) {
+#ifdef _WIN32
+        if (!process_)
+            return exit_ok_;
+        if (kill)
+            TerminateProcess(process_, 1);
+        WaitForSingleObject(process_, INFINITE);
+        DWORD code = 1;
+        GetExitCodeProcess(process_, &code);
+        FILETIME creation, exit, kernel, user;
+        GetProcessTimes(process_, &creation, &exit, &kernel, &user);
+        auto ticks = [](const FILETIME& ft) { return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+        cpu_seconds_ = static_cast<double>(ticks(kernel) + ticks(user)) / 1e7;
+        CloseHandle(process_);
+        process_ = nullptr;
+        exit_ok_ = code == 0;
+#else
+        if (pid_ <= 0)
+            return exit_ok_;
+        if (kill)
+            ::kill(pid_, SIGKILL);
+        int status = 0;
+        rusage usage{};
+        wait4(pid_, &status, 0, &usage);
+        cpu_seconds_ = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+                       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+        pid_ = -1;
+        exit_ok_ = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+        return exit_ok_;
+    }
+
+    double cpu_seconds() const { return cpu_seconds_; }
+
+private:
+#ifdef _WIN32
+    HANDLE process_ = nullptr;
+#else
+    pid_t pid_ = -1;
+#endif
+    double cpu_seconds_ = 0;
+    bool exit_ok_ = false;
+};
+
+/// Everything a parent-side benchmark needs: config, names, the child handle
+struct RunContext {
+    const BenchConfig& cfg;
+    std::string name; // Unique prefix for this run's shared memory objects
+    const char* transport;
+    Phase phase;
+    ChildFn child_fn;
+    ChildProcess child;
+    std::unique_ptr<Control> control;
+
+    /// Create the control block and start the child; call after the parent's endpoints exist
+    bool spawn() {
+        control = Control::create(name + "_ctl");
+        return control && child.start(child_fn, transport, phase, cfg, name) && wait_ready(*control);
+    }
+};
+
+//=============================================================================
+// Benchmark: Channel (two one-way channels)
+//=============================================================================
+
+int channel_child(const BenchConfig& cfg, const std::string& name, Phase phase) {
+    auto control = open_control(name);
+    auto ping = Channel::open(name + "_ping");
+    auto pong = phase == Phase::RoundTrip ? Channel::create(name + "_pong") : nullptr;
+    if (!control || !ping || (phase == Phase::RoundTrip && !pong)) {
+        return 1;
+    }
+    report(*control, 1, 0, 0);
+
+    uint64_t received = 0;
+    while (auto msg = ping->receive(IDLE_TIMEOUT)) {
+        if (msg->msgId == MSG_QUIT) {
+            return 0;
+        }
+        ++received;
+        if (pong) {
+            while (!pong->post(MSG_DATA, msg->data)) {
+                std::this_thread::yield();
+            }
+        } else if (received == cfg.messages) {
+            report(*control, 1, 1, received);
+            return 0;
+        }
+    }
+    return 1; // Timed out
+}
+
+bool channel_parent(RunContext& ctx, RunResult& result) {
+    auto ping = Channel::create(ctx.name + "_ping");
+    if (!ping || !ctx.spawn()) {
+        return false;
+    }
+    const ImmerValue payload{make_bytes(ctx.cfg.payload)};
+
+    if (ctx.phase == Phase::RoundTrip) {
+        auto pong = Channel::open(ctx.name + "_pong");
+        if (!pong) {
+            return false;
+        }
+        for (std::size_t i = 0; i < WARMUP + ctx.cfg.iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            while (!ping->post(MSG_DATA, payload)) {
+                std::this_thread::yield();
+            }
+            if (!pong->receive(IDLE_TIMEOUT)) {
+                return false;
+            }
+            if (i >= WARMUP) {
+                result.latencies_us.push_back(elapsed_us(start));
+            }
+        }
+        ping->post(MSG_QUIT);
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t sent = 0; sent < ctx.cfg.messages;) {
+        if (ping->post(MSG_DATA, payload)) {
+            ++sent;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    auto received = wait_done(*ctx.control);
+    result.seconds = elapsed_us(start) / 1e6;
+    result.delivered = received.value_or(0);
+    return received.has_value();
+}
+
+//=============================================================================
+// Benchmark: ChannelPair
+//=============================================================================
+
+int channel_pair_child(const BenchConfig& cfg, const std::string& name, Phase phase) {
+    auto control = open_control(name);
+    auto pair = ChannelPair::connect(name);
+    if (!control || !pair) {
+        return 1;
+    }
+    report(*control, 1, 0, 0);
+
+    uint64_t received = 0;
+    while (auto msg = pair->receive(IDLE_TIMEOUT)) {
+        if (msg->msgId == MSG_QUIT) {
+            return 0;
+        }
+        ++received;
+        if (phase == Phase::RoundTrip) {
+            while (!pair->post(MSG_DATA, msg->data)) {
+                std::this_thread::yield();
+            }
+        } else if (received == cfg.messages) {
+            report(*control, 1, 1, received);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+bool channel_pair_parent(RunContext& ctx, RunResult& result) {
+    auto pair = ChannelPair::create(ctx.name);
+    if (!pair || !ctx.spawn()) {
+        return false;
+    }
+    const ImmerValue payload{make_bytes(ctx.cfg.payload)};
+
+    if (ctx.phase == Phase::RoundTrip) {
+        for (std::size_t i = 0; i < WARMUP + ctx.cfg.iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            while (!pair->post(MSG_DATA, payload)) {
+                std::this_thread::yield();
+            }
+            if (!pair->receive(IDLE_TIMEOUT)) {
+                return false;
+            }
+            if (i >= WARMUP) {
+                result.latencies_us.push_back(elapsed_us(start));
+            }
+        }
+        pair->post(MSG_QUIT);
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t sent = 0; sent < ctx.cfg.messages;) {
+        if (pair->post(MSG_DATA, payload)) {
+            ++sent;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    auto received = wait_done(*ctx.control);
+    result.seconds = elapsed_us(start) / 1e6;
+    result.delivered = received.value_or(0);
+    return received.has_value();
+}
+
+//=============================================================================
+// Benchmark: RemoteBus (Peer on both sides)
+//=============================================================================
+
+int remote_bus_child(const BenchConfig& cfg, const std::string& name, Phase phase) {
+    auto control = open_control(name);
+    EventBus bus;
+    RemoteBus remote(name, bus, RemoteBus::Role::Peer);
+    if (!control || !remote.connected()) {
+        return 1;
+    }
+
+    bool quit = false;
+    uint64_t received = 0;
+    auto echo = remote.on_request("ping", [](const ImmerValue& payload) { return payload; });
+    auto tick = remote.subscribe_remote("tick", [&received](const ImmerValue&) { ++received; });
+    auto stop = remote.subscribe_remote("quit", [&quit](const ImmerValue&) { quit = true; });
+    report(*control, 1, 0, 0);
+
+    auto last_activity = std::chrono::steady_clock::now();
+    while (!quit && !(phase == Phase::Throughput && received == cfg.messages)) {
+        if (remote.poll(std::chrono::milliseconds(100)) > 0) {
+            last_activity = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - last_activity > IDLE_TIMEOUT) {
+            return 1;
+        }
+    }
+    if (phase == Phase::Throughput) {
+        report(*control, 1, 1, received);
+    }
+    return 0;
+}
+
+bool remote_bus_parent(RunContext& ctx, RunResult& result) {
+    EventBus bus;
+    RemoteBus remote(ctx.name, bus, RemoteBus::Role::Peer); // Nothing to connect to yet: creates
+    if (!remote.connected() || !ctx.spawn()) {
+        return false;
+    }
+    const ImmerValue payload{make_bytes(ctx.cfg.payload)};
+
+    if (ctx.phase == Phase::RoundTrip) {
+        for (std::size_t i = 0; i < WARMUP + ctx.cfg.iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            if (!remote.send("ping", payload, IDLE_TIMEOUT)) {
+                return false;
+            }
+            if (i >= WARMUP) {
+                result.latencies_us.push_back(elapsed_us(start));
+            }
+        }
+        remote.post_remote("quit", ImmerValue{});
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t sent = 0; sent < ctx.cfg.messages;) {
+        if (remote.post_remote("tick", payload)) {
+            ++sent;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    auto received = wait_done(*ctx.control);
+    result.seconds = elapsed_us(start) / 1e6;
+    result.delivered = received.value_or(0);
+    return received.has_value();
+}
+
+//=============================================================================
+// Benchmark: SharedBufferSPSC (latest-value, polled)
+//=============================================================================
+
+constexpr uint64_t SEQ_QUIT = UINT64_MAX;
+
+int spsc_child(const BenchConfig& cfg, const std::string& name, Phase phase) {
+    auto control = open_control(name);
+    auto ping = SharedBufferSPSC<Sample>::open(name + "_ping");
+    auto pong = SharedBufferSPSC<Sample>::open(name + "_pong");
+    if (!control || !ping || !pong) {
+        return 1;
+    }
+    report(*control, 1, 0, 0);
+
+    uint64_t received = 0;
+    Sample sample;
+    auto last_activity = std::chrono::steady_clock::now();
+    while (true) {
+        if (!ping->try_read(sample)) {
+            if (std::chrono::steady_clock::now() - last_activity > IDLE_TIMEOUT) {
+                return 1;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        last_activity = std::chrono::steady_clock::now();
+        if (sample.seq == SEQ_QUIT) {
+            return 0;
+        }
+        ++received;
+        if (phase == Phase::RoundTrip) {
+            pong->write(sample);
+        } else if (sample.seq == cfg.messages) {
+            report(*control, 1, 1, received);
+            return 0;
+        }
+    }
+}
+
+bool spsc_parent(RunContext& ctx, RunResult& result) {
+    auto ping = SharedBufferSPSC<Sample>::create(ctx.name + "_ping");
+    auto pong = SharedBufferSPSC<Sample>::create(ctx.name + "_pong");
+    if (!ping || !pong || !ctx.spawn()) {
+        return false;
+    }
+    Sample sample;
+
+    if (ctx.phase == Phase::RoundTrip) {
+        Sample echo;
+        for (std::size_t i = 0; i < WARMUP + ctx.cfg.iterations; ++i) {
+            sample.seq = i + 1;
+            auto start = std::chrono::steady_clock::now();
+            ping->write(sample);
+            if (!wait_until([&] { return pong->try_read(echo) && echo.seq == sample.seq; }, IDLE_TIMEOUT)) {
+                return false;
+            }
+            if (i >= WARMUP) {
+                result.latencies_us.push_back(elapsed_us(start));
+            }
+        }
+        sample.seq = SEQ_QUIT;
+        ping->write(sample);
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 1; i <= ctx.cfg.messages; ++i) {
+        sample.seq = i;
+        ping->write(sample); // Never blocks: the reader just sees the latest sample
+    }
+    auto received = wait_done(*ctx.control);
+    result.seconds = elapsed_us(start) / 1e6;
+    result.delivered = received.value_or(0);
+    return received.has_value();
+}
+
+//=============================================================================
+// Benchmark: StatePublisher / StateSubscriber (latest-value, semaphore wake-up)
+//=============================================================================
+
+SharedMemoryConfig state_config(const std::string& name) {
+    SharedMemoryConfig config;
+    config.name = name;
+    config.size = STATE_SHM_SIZE;
+    return config;
+}
+
+int state_child(const BenchConfig& cfg, const std::string& name, Phase phase) {
+    auto control = open_control(name);
+    // The echo publisher has to exist before "ready": the parent subscribes to it next
+    std::optional<StatePublisher> pong;
+    if (phase == Phase::RoundTrip) {
+        pong.emplace(state_config(name + "_pong"));
+    }
+    StateSubscriber ping(state_config(name + "_ping"));
+    if (!control || !ping.is_valid() || (pong && !pong->is_valid())) {
+        return 1;
+    }
+    report(*control, 1, 0, 0);
+
+    int64_t last_seq = 0;
+    auto last_activity = std::chrono::steady_clock::now();
+    while (true) {
+        const int64_t seq = seq_of(ping.wait_for_update(std::chrono::milliseconds(100)));
+        if (seq == last_seq) {
+            if (std::chrono::steady_clock::now() - last_activity > IDLE_TIMEOUT) {
+                return 1;
+            }
+            continue;
+        }
+        last_seq = seq;
+        last_activity = std::chrono::steady_clock::now();
+        if (seq < 0) {
+            return 0; // Quit
+        }
+        if (pong) {
+            pong->publish(make_state(seq, {}));
+        } else if (seq == static_cast<int64_t>(cfg.messages)) {
+            report(*control, 1, 1, ping.stats().total_updates);
+            return 0;
+        }
+    }
+}
+
+bool state_parent(RunContext& ctx, RunResult& result) {
+    StatePublisher ping(state_config(ctx.name + "_ping"));
+    if (!ping.is_valid() || !ctx.spawn()) {
+        return false;
+    }
+    const std::string data = make_bytes(ctx.cfg.payload);
+
+    if (ctx.phase == Phase::RoundTrip) {
+        StateSubscriber pong(state_config(ctx.name + "_pong"));
+        if (!pong.is_valid()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < WARMUP + ctx.cfg.iterations; ++i) {
+            const auto seq = static_cast<int64_t>(i + 1);
+            auto start = std::chrono::steady_clock::now();
+            ping.publish(make_state(seq, data));
+            const auto deadline = start + IDLE_TIMEOUT;
+            while (seq_of(pong.wait_for_update(std::chrono::milliseconds(100))) != seq) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+            }
+            if (i >= WARMUP) {
+                result.latencies_us.push_back(elapsed_us(start));
+            }
+        }
+        ping.publish(make_state(-1, {}));
+        return true;
+    }
+
+    // Successive states differ in one key, so publish_diff sends small diffs
+    ImmerValue previous = make_state(0, data);
+    ping.publish(previous);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 1; i <= ctx.cfg.messages; ++i) {
+        ImmerValue next = make_state(static_cast<int64_t>(i), data);
+        ping.publish_diff(previous, next);
+        previous = std::move(next);
+    }
+    auto received = wait_done(*ctx.control);
+    result.seconds = elapsed_us(start) / 1e6;
+    result.delivered = received.value_or(0);
+    return received.has_value();
+}
+
+//=============================================================================
+// Suite
+//=============================================================================
+
+struct Transport {
+    const char* key;  // --transport / --child selector, JSON "key"
+    const char* name; // Display name
+    bool (*parent)(RunContext&, RunResult&);
+    int (*child)(const BenchConfig&, const std::string&, Phase);
+};
+
+const Transport TRANSPORTS[] = {
+    {"channel", "Channel", channel_parent, channel_child},
+    {"channel_pair", "ChannelPair", channel_pair_parent, channel_pair_child},
+    {"remote_bus", "RemoteBus", remote_bus_parent, remote_bus_child},
+    {"spsc", "SharedBufferSPSC", spsc_parent, spsc_child},
+    {"state", "StatePublisher", state_parent, state_child},
+};
+
+// fork() runs the child entry point directly, so it has to fit ChildFn; the
+// transport and phase are bound here
+template <std::size_t T, Phase P>
+int child_entry(const BenchConfig& cfg, const std::string& name) {
+    return TRANSPORTS[T].child(cfg, name, P);
+}
+
+template <std::size_t... T>
+constexpr auto make_child_table(std::index_sequence<T...>) {
+    return std::array<std::array<ChildFn, 2>, sizeof...(T)>{
+        {{child_entry<T, Phase::RoundTrip>, child_entry<T, Phase::Throughput>}...}};
+}
+
+const auto CHILD_ENTRIES = make_child_table(std::make_index_sequence<std::size(TRANSPORTS)>{});
+
+RunResult run(const BenchConfig& cfg, std::size_t transport, Phase phase) {
+    const Transport& t = TRANSPORTS[transport];
+    RunContext ctx{cfg,
+                   "lager_ext_suite_" + std::to_string(static_cast<long long>(
+#ifdef _WIN32
+                                            GetCurrentProcessId()
+#else
+                                            getpid()
+#endif
+                                                )) +
+                       "_" + t.key + "_" + PHASE_NAMES[static_cast<int>(phase)],
+                   t.key,
+                   phase,
+                   CHILD_ENTRIES[transport][static_cast<int>(phase)],
+                   {},
+                   nullptr};
+
+    RunResult result;
+    const double cpu_start = self_cpu_seconds();
+    const auto wall_start = std::chrono::steady_clock::now();
+
+    result.ok = t.parent(ctx, result);
+    result.ok = ctx.child.wait(!result.ok) && result.ok;
+
+    const double wall_s = elapsed_us(wall_start) / 1e6;
+    const double cpu_s = self_cpu_seconds() - cpu_start + ctx.child.cpu_seconds();
+    result.cpu_percent = 100.0 * cpu_s / wall_s;
+    result.messages = phase == Phase::Throughput ? cfg.messages : 0;
+    std::sort(result.latencies_us.begin(), result.latencies_us.end());
+    return result;
+}
+
+std::string platform_name() {
+#if defined(_WIN32)
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#elif defined(__linux__)
+    return "linux";
+#else
+    return "posix";
+#endif
+}
+
+std::string to_json(const BenchConfig& cfg, const std::vector<std::size_t>& selected,
+                    const std::vector<std::pair<RunResult, RunResult>>& results) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"benchmark\": \"ipc_suite\",\n";
+    out << "  \"platform\": \"" << platform_name() << "\",\n";
+    out << "  \"cores\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"config\": {\"iterations\": " << cfg.iterations << ", \"messages\": " << cfg.messages
+        << ", \"payload_bytes\": " << cfg.payload << "},\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Transport& t = TRANSPORTS[selected[i]];
+        const auto& [rtt, tput] = results[i];
+        out << "    {\n";
+        out << "      \"transport\": \"" << t.name << "\",\n";
+        out << "      \"key\": \"" << t.key << "\",\n";
+        out << "      \"round_trip\": {\"ok\": " << (rtt.ok ? "true" : "false")
+            << ", \"samples\": " << rtt.latencies_us.size() << ", \"p50_us\": " << rtt.percentile(0.5)
+            << ", \"p99_us\": " << rtt.percentile(0.99) << ", \"p999_us\": " << rtt.percentile(0.999)
+            << ", \"max_us\": " << rtt.percentile(1.0) << ", \"cpu_percent\": " << rtt.cpu_percent << "},\n";
+        const double msgs_per_sec = tput.ok && tput.seconds > 0 ? tput.messages / tput.seconds : 0;
+        out << "      \"throughput\": {\"ok\": " << (tput.ok ? "true" : "false") << ", \"messages\": " << tput.messages
+            << ", \"delivered\": " << tput.delivered << ", \"msgs_per_sec\": " << msgs_per_sec
+            << ", \"mb_per_sec\": " << msgs_per_sec * cfg.payload / (1024.0 * 1024.0)
+            << ", \"cpu_percent\": " << tput.cpu_percent << "}\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return out.str();
+}
+
+void print_table(const std::vector<std::size_t>& selected, const std::vector<std::pair<RunResult, RunResult>>& results) {
+    std::cout << "Round trip (parent -> child -> parent)\n\n";
+    std::cout << std::left << std::setw(18) << "Transport" << std::setw(11) << "p50 (us)" << std::setw(11)
+              << "p99 (us)" << std::setw(13) << "p99.9 (us)" << std::setw(11) << "max (us)" << std::setw(8)
+              << "CPU %"
+              << "result\n";
+    std::cout << std::string(78, '-') << "\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const RunResult& r = results[i].first;
+        std::cout << std::left << std::setw(18) << TRANSPORTS[selected[i]].name << std::fixed << std::setprecision(1)
+                  << std::setw(11) << r.percentile(0.5) << std::setw(11) << r.percentile(0.99) << std::setw(13)
+                  << r.percentile(0.999) << std::setw(11) << r.percentile(1.0) << std::setw(8) << std::setprecision(0)
+                  << r.cpu_percent << (r.ok ? "ok" : "FAILED") << "\n";
+    }
+
+    std::cout << "\nOne-way throughput (parent -> child)\n\n";
+    std::cout << std::left << std::setw(18) << "Transport" << std::setw(14) << "msgs/s" << std::setw(14)
+              << "delivered" << std::setw(8) << "CPU %"
+              << "result\n";
+    std::cout << std::string(62, '-') << "\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const RunResult& r = results[i].second;
+        const double msgs_per_sec = r.ok && r.seconds > 0 ? r.messages / r.seconds : 0;
+        std::cout << std::left << std::setw(18) << TRANSPORTS[selected[i]].name << std::fixed << std::setprecision(0)
+                  << std::setw(14) << msgs_per_sec << std::setw(14) << r.delivered << std::setw(8) << r.cpu_percent
+                  << (r.ok ? "ok" : "FAILED") << "\n";
+    }
+    std::cout << "\n";
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+std::optional<std::size_t> find_transport(const char* key) {
+    for (std::size_t i = 0; i < std::size(TRANSPORTS); ++i) {
+        if (std::strcmp(TRANSPORTS[i].key, key) == 0) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    std::vector<std::size_t> selected;
+    const char* json_path = nullptr;
+    const char* child_transport = nullptr;
+    const char* child_phase = nullptr;
+    std::string child_name;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            cfg.iterations = static_cast<std::size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--messages") == 0 && i + 1 < argc) {
+            cfg.messages = static_cast<std::size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--payload") == 0 && i + 1 < argc) {
+            cfg.payload = static_cast<std::size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--transport") == 0 && i + 1 < argc) {
+            if (auto t = find_transport(argv[++i])) {
+                selected.push_back(*t);
+            } else {
+                std::cerr << "Unknown transport: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--child") == 0 && i + 2 < argc) {
+            child_transport = argv[++i];
+            child_phase = argv[++i];
+        } else if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            child_name = argv[++i];
+        }
+    }
+
+    // Re-launched child (Windows): run one side of one benchmark and exit
+    if (child_transport) {
+        auto t = find_transport(child_transport);
+        if (!t || child_name.empty()) {
+            return 1;
+        }
+        Phase phase = std::strcmp(child_phase, "rtt") == 0 ? Phase::RoundTrip : Phase::Throughput;
+        return TRANSPORTS[*t].child(cfg, child_name, phase);
+    }
+
+    if (selected.empty()) {
+        for (std::size_t i = 0; i < std::size(TRANSPORTS); ++i) {
+            selected.push_back(i);
+        }
+    }
+    const bool json_only = json_path && std::strcmp(json_path, "-") == 0;
+
+    if (!json_only) {
+        printHeader("IPC Benchmark Suite (cross-process)");
+        std::cout << "Round trips: " << cfg.iterations << " (+" << WARMUP << " warm-up), throughput messages: "
+                  << cfg.messages << ", payload: " << cfg.payload << " bytes\n";
+        std::cout << "Platform: " << platform_name() << ", " << std::thread::hardware_concurrency() << " cores\n\n";
+    }
+
+    std::vector<std::pair<RunResult, RunResult>> results;
+    for (std::size_t t : selected) {
+        if (!json_only) {
+            std::cout << "Running " << TRANSPORTS[t].name << "...\n" << std::flush;
+        }
+        RunResult rtt = run(cfg, t, Phase::RoundTrip);
+        RunResult tput = run(cfg, t, Phase::Throughput);
+        results.emplace_back(std::move(rtt), std::move(tput));
+    }
+
+    const std::string json = to_json(cfg, selected, results);
+    if (json_only) {
+        std::cout << json;
+    } else {
+        std::cout << "\n";
+        print_table(selected, results);
+        if (json_path) {
+            std::ofstream(json_path) << json;
+            std::cout << "JSON written to " << json_path << "\n\n";
+        }
+
+        std::cout << "Notes:\n";
+        std::cout << "  - Every run uses a separate child process (fork on POSIX, re-launch on Windows)\n";
+        std::cout << "  - CPU % = (parent + child CPU time) / wall time; 100% = one core busy\n";
+        std::cout << "  - SharedBufferSPSC and StatePublisher keep only the latest value: 'delivered'\n";
+        std::cout << "    counts the updates the reader saw, msgs/s counts the writer's updates\n";
+        std::cout << "  - SharedBufferSPSC always moves a 64-byte sample; --payload does not apply\n";
+    }
+
+    bool all_ok = std::all_of(results.begin(), results.end(),
+                              [](const auto& r) { return r.first.ok && r.second.ok; });
+    return all_ok ? 0 : 1;
+}
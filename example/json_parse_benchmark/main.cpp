@@ -0,0 +1,206 @@
+// Copyright (c) 2024-2025 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file main.cpp
+/// @brief JSON parse benchmark: from_json vs. parse_json on 1 KB - 100 MB inputs
+///
+/// Generates JSON documents of increasing size in two shapes and reports the
+/// throughput of the original character-at-a-time parser (from_json) and the
+/// SIMD structural-scan parser (parse_json), plus a check that both produced
+/// the same value.
+///
+/// Shapes:
+///   config - nested objects of strings, numbers and booleans
+///   scene  - entity records with transform arrays and tag lists
+///
+/// Usage:
+///   json_parse_benchmark                  # Both shapes, 1 KB .. 100 MB
+///   json_parse_benchmark --max-mb 16      # Stop at 16 MB
+///   json_parse_benchmark --shape config   # Only one shape
+
+#include <lager_ext/serialization.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace lager_ext;
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+constexpr std::size_t KB = 1024;
+constexpr std::size_t MB = 1024 * KB;
+constexpr std::size_t TARGET_BYTES_PER_RUN = 256 * MB; // Repeat small inputs up to this volume
+constexpr int MAX_ITERATIONS = 10000;
+
+struct BenchConfig {
+    std::size_t max_bytes = 100 * MB;
+    bool config_shape = true;
+    bool scene_shape = true;
+};
+
+struct RunResult {
+    double from_json_mbps = 0;
+    double parse_json_mbps = 0;
+    bool same_value = false;
+};
+
+//=============================================================================
+// Document generators
+//=============================================================================
+
+// Deterministic LCG so every run parses identical documents
+struct Lcg {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint32_t next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<uint32_t>(state >> 33);
+    }
+};
+
+void append_config_entry(std::string& out, Lcg& rng, int id) {
+    out += "  \"section_" + std::to_string(id) + "\": {\n";
+    out += "    \"name\": \"Section \\\"" + std::to_string(id) + "\\\" settings\",\n";
+    out += "    \"enabled\": " + std::string(rng.next() % 2 ? "true" : "false") + ",\n";
+    out += "    \"priority\": " + std::to_string(rng.next() % 1000) + ",\n";
+    out += "    \"scale\": " + std::to_string((rng.next() % 100000) / 1000.0) + ",\n";
+    out += "    \"path\": \"C:\\\\assets\\\\textures\\\\tex_" + std::to_string(rng.next() % 500) + ".png\",\n";
+    out += "    \"limits\": {\"min\": -" + std::to_string(rng.next() % 100) + ", \"max\": " +
+           std::to_string(rng.next()) + ", \"step\": 1.5e-3}\n";
+    out += "  }";
+}
+
+void append_scene_entry(std::string& out, Lcg& rng, int id) {
+    auto coord = [&] { return std::to_string(static_cast<int>(rng.next() % 20000) - 10000) + ".25"; };
+    out += "  \"entity_" + std::to_string(id) + "\": {\n";
+    out += "    \"name\": \"Entity " + std::to_string(id) + "\",\n";
+    out += "    \"position\": [" + coord() + ", " + coord() + ", " + coord() + "],\n";
+    out += "    \"rotation\": [0.0, 0.7071, 0.0, 0.7071],\n";
+    out += "    \"scale\": [1.0, 1.0, 1.0],\n";
+    out += "    \"tags\": [\"static\", \"shadow_caster\", \"layer_" + std::to_string(rng.next() % 8) + "\"],\n";
+    out += "    \"visible\": true,\n";
+    out += "    \"parent\": null\n";
+    out += "  }";
+}
+
+std::string make_document(bool scene, std::size_t target_size) {
+    std::string doc = "{\n";
+    Lcg rng;
+    for (int id = 0; doc.size() < target_size; ++id) {
+        if (id > 0) {
+            doc += ",\n";
+        }
+        if (scene) {
+            append_scene_entry(doc, rng, id);
+        } else {
+            append_config_entry(doc, rng, id);
+        }
+    }
+    doc += "\n}\n";
+    return doc;
+}
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+void printHeader(const std::string& title) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << title << "\n";
+    std::cout << std::string(60, '=') << "\n\n";
+}
+
+std::string format_size(std::size_t bytes) {
+    if (bytes >= MB) {
+        return std::to_string(bytes / MB) + " MB";
+    }
+    return std::to_string(bytes / KB) + " KB";
+}
+
+template <typename Fn>
+double measure_mbps(const std::string& doc, int iterations, Fn&& parse) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        parse();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return (static_cast<double>(doc.size()) * iterations / MB) / seconds;
+}
+
+//=============================================================================
+// Benchmark
+//=============================================================================
+
+RunResult run(const std::string& doc) {
+    const int iterations =
+        static_cast<int>(std::clamp<std::size_t>(TARGET_BYTES_PER_RUN / doc.size(), 1, MAX_ITERATIONS));
+
+    RunResult result;
+    ImmerValue slow_value = from_json(doc);
+    JsonParseResult fast_value = parse_json(doc);
+    result.same_value = fast_value.ok() && fast_value.value == slow_value;
+
+    result.from_json_mbps = measure_mbps(doc, iterations, [&] { slow_value = from_json(doc); });
+    result.parse_json_mbps = measure_mbps(doc, iterations, [&] { fast_value = parse_json(doc); });
+    return result;
+}
+
+void run_shape(const BenchConfig& cfg, bool scene) {
+    std::cout << "Shape: " << (scene ? "scene" : "config") << "\n";
+    std::cout << std::left << std::setw(10) << "Size" << std::setw(16) << "from_json MB/s" << std::setw(17)
+              << "parse_json MB/s" << std::setw(10) << "speedup"
+              << "result\n";
+    std::cout << std::string(60, '-') << "\n";
+
+    for (std::size_t size : {1 * KB, 64 * KB, 1 * MB, 16 * MB, 100 * MB}) {
+        if (size > cfg.max_bytes) {
+            break;
+        }
+        std::string doc = make_document(scene, size);
+        RunResult r = run(doc);
+        std::cout << std::left << std::setw(10) << format_size(size) << std::setw(16) << std::fixed
+                  << std::setprecision(1) << r.from_json_mbps << std::setw(17) << r.parse_json_mbps << std::setw(10)
+                  << std::setprecision(2) << r.parse_json_mbps / r.from_json_mbps
+                  << (r.same_value ? "ok" : "MISMATCH") << "\n";
+    }
+    std::cout << "\n";
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-mb") == 0 && i + 1 < argc) {
+            cfg.max_bytes = static_cast<std::size_t>(std::atoi(argv[++i])) * MB;
+        } else if (std::strcmp(argv[i], "--shape") == 0 && i + 1 < argc) {
+            const char* shape = argv[++i];
+            cfg.config_shape = std::strcmp(shape, "config") == 0;
+            cfg.scene_shape = std::strcmp(shape, "scene") == 0;
+        }
+    }
+
+    printHeader("JSON Parse Benchmark (from_json vs parse_json)");
+
+    if (cfg.config_shape) {
+        run_shape(cfg, false);
+    }
+    if (cfg.scene_shape) {
+        run_shape(cfg, true);
+    }
+
+    std::cout << "Notes:\n";
+    std::cout << "  - Throughput is input bytes per second, averaged over repeated parses\n";
+    std::cout << "  - 'result' compares the values produced by both parsers\n";
+    return 0;
+}
@@ -0,0 +1,208 @@
+// Copyright (c) 2024-2025 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file main.cpp
+/// @brief RemoteBus envelope benchmark: binary header vs the old {"n","d","r"} map envelope
+///
+/// RemoteBus used to wrap every event in ImmerValue::map({{"n", name}, {"d", payload}})
+/// and the receiver looked the name up with at("n").as<std::string>() before a
+/// string-keyed handler lookup. It now sends a fixed 24-byte header (name hash,
+/// request id, timestamp, domain, flags) in front of the payload and dispatches
+/// on the hash, deserializing only payloads that have a handler.
+///
+/// Both ends run in this process on one thread: post a batch, then poll it, so
+/// the numbers are the per-event encode + decode + dispatch cost without any
+/// cross-core traffic. The "legacy" rows rebuild the old envelope on a plain
+/// ChannelPair, exactly as RemoteBus used to.
+///
+/// Payloads:
+///   int      - a single integer
+///   map      - a 4-field map (~60 bytes serialized)
+///   unwanted - map events nobody subscribed to (new path skips deserialization)
+///
+/// Usage:
+///   remote_bus_envelope_benchmark                  # 1M events per run
+///   remote_bus_envelope_benchmark --events 200000  # Shorter run
+
+#include <lager_ext/event_bus.h>
+#include <lager_ext/event_bus_ipc.h>
+#include <lager_ext/ipc.h>
+#include <lager_ext/serialization.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace lager_ext;
+using namespace lager_ext::ipc;
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+constexpr std::size_t BATCH = 256; // Posted before each poll; well below the channel capacity
+constexpr std::string_view EVENT_NAME = "DocumentPropertyChanged";
+constexpr std::string_view UNWANTED_NAME = "ViewportScrolled";
+
+struct BenchConfig {
+    std::size_t events = 1000000;
+};
+
+enum class Payload { Int, Map, Unwanted };
+
+constexpr const char* PAYLOAD_NAMES[] = {"int", "map", "unwanted"};
+
+struct RunResult {
+    double events_per_sec = 0;
+    std::size_t handled = 0;
+};
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+void printHeader(const std::string& title) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << title << "\n";
+    std::cout << std::string(60, '=') << "\n\n";
+}
+
+ImmerValue make_payload(Payload payload) {
+    if (payload == Payload::Int) {
+        return ImmerValue{int64_t{42}};
+    }
+    return ImmerValue{ValueMap{}
+                          .set("doc", ImmerValue{std::string("doc-0001")})
+                          .set("path", ImmerValue{std::string("/layers/3/opacity")})
+                          .set("value", ImmerValue{0.75})
+                          .set("user", ImmerValue{int64_t{7}})};
+}
+
+std::string_view name_for(Payload payload) {
+    return payload == Payload::Unwanted ? UNWANTED_NAME : EVENT_NAME;
+}
+
+//=============================================================================
+// Benchmark
+//=============================================================================
+
+/// The old protocol, reproduced on a ChannelPair
+RunResult run_legacy(const BenchConfig& cfg, Payload kind) {
+    auto sender = ChannelPair::create("lager_ext_envelope_bench_legacy");
+    auto receiver = sender ? ChannelPair::connect("lager_ext_envelope_bench_legacy") : nullptr;
+    if (!sender || !receiver) {
+        std::cerr << "Failed to create channel pair\n";
+        return {};
+    }
+
+    RunResult result;
+    std::unordered_map<std::string, std::move_only_function<void(const ImmerValue&) const>> handlers;
+    handlers[std::string(EVENT_NAME)] = [&result](const ImmerValue&) { ++result.handled; };
+
+    const ImmerValue payload = make_payload(kind);
+    const std::string name(name_for(kind));
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t done = 0; done < cfg.events; done += BATCH) {
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            ImmerValue envelope = ImmerValue::map({{"n", name}, {"d", payload}});
+            sender->post(lager_ext::detail::IPC_EVT_EVENT, envelope);
+        }
+        while (auto msg = receiver->tryReceive()) {
+            auto event_name = msg->data.at("n").as<std::string>();
+            auto data = msg->data.at("d");
+            if (auto it = handlers.find(event_name); it != handlers.end()) {
+                it->second(data);
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.events_per_sec = cfg.events / seconds;
+    return result;
+}
+
+RunResult run_binary(const BenchConfig& cfg, Payload kind) {
+    EventBus sender_bus;
+    EventBus receiver_bus;
+    RemoteBus sender("lager_ext_envelope_bench_binary", sender_bus); // Creates the pair
+    RemoteBus receiver("lager_ext_envelope_bench_binary", receiver_bus); // Connects to it
+    if (!sender.connected() || !receiver.connected()) {
+        std::cerr << "Failed to connect RemoteBus\n";
+        return {};
+    }
+
+    RunResult result;
+    auto conn = receiver.subscribe_remote(EVENT_NAME, [&result](const ImmerValue&) { ++result.handled; });
+
+    const ImmerValue payload = make_payload(kind);
+    const std::string_view name = name_for(kind);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t done = 0; done < cfg.events; done += BATCH) {
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            sender.post_remote(name, payload);
+        }
+        receiver.poll();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.events_per_sec = cfg.events / seconds;
+    return result;
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            cfg.events = static_cast<std::size_t>(std::atoll(argv[++i]));
+        }
+    }
+    cfg.events = std::max(BATCH, cfg.events / BATCH * BATCH);
+
+    printHeader("RemoteBus Envelope Benchmark (binary header vs map)");
+
+    std::cout << "Events per run: " << cfg.events << ", batch " << BATCH << ", one thread\n\n";
+
+    std::cout << std::left << std::setw(10) << "Payload" << std::setw(14) << "legacy ev/s" << std::setw(14)
+              << "binary ev/s" << std::setw(10) << "Speedup" << std::setw(12) << "legacy B" << std::setw(10)
+              << "binary B"
+              << "result\n";
+    std::cout << std::string(76, '-') << "\n";
+
+    for (Payload kind : {Payload::Int, Payload::Map, Payload::Unwanted}) {
+        RunResult legacy = run_legacy(cfg, kind);
+        RunResult binary = run_binary(cfg, kind);
+
+        // Bytes on the wire per event (Channel payloads use the compact format)
+        const ImmerValue payload = make_payload(kind);
+        const std::size_t legacy_bytes = serialized_size(
+            ImmerValue::map({{"n", std::string(name_for(kind))}, {"d", payload}}), BinaryFormat::Compact);
+        const std::size_t binary_bytes = 24 + serialized_size(payload, BinaryFormat::Compact);
+
+        const std::size_t expected = kind == Payload::Unwanted ? 0 : cfg.events;
+        const bool ok = legacy.handled == expected && binary.handled == expected;
+
+        std::cout << std::left << std::setw(10) << PAYLOAD_NAMES[static_cast<int>(kind)] << std::fixed
+                  << std::setprecision(0) << std::setw(14) << legacy.events_per_sec << std::setw(14)
+                  << binary.events_per_sec << std::setw(10) << std::setprecision(2)
+                  << binary.events_per_sec / legacy.events_per_sec << std::setw(12) << legacy_bytes << std::setw(10)
+                  << binary_bytes << (ok ? "ok" : "MISMATCH") << "\n";
+    }
+    std::cout << "\n";
+
+    std::cout << "Notes:\n";
+    std::cout << "  - ev/s = post + poll + dispatch per event, both ends on one thread\n";
+    std::cout << "  - B = envelope + payload bytes per event; the binary header is a fixed 24 bytes\n";
+    std::cout << "  - 'unwanted' events have no handler: the binary path reads the header and skips\n";
+    std::cout << "    the payload, the legacy path still deserializes the whole envelope\n";
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Copyright (c) 2024-2025 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file main.cpp
+/// @brief StatePublisher ring benchmark: publish/apply throughput with slow subscribers
+///
+/// One publisher thread streams small diffs while 1, 4 and 16 subscriber
+/// threads poll at a fixed (slow) interval. Reports publish throughput,
+/// per-subscriber apply throughput, and how often subscribers had to fall
+/// back to a full snapshot because they lagged further than the ring depth.
+///
+/// Usage:
+///   state_ring_benchmark                 # Default: 20000 updates, 16 slots
+///   state_ring_benchmark -n 50000        # Custom update count
+///   state_ring_benchmark --slots 64      # Custom ring depth
+///   state_ring_benchmark --delay 500     # Subscriber poll interval in microseconds
+
+#include <lager_ext/shared_state.h>
+#include <lager_ext/value.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lager_ext;
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+constexpr int DEFAULT_UPDATES = 20000;
+constexpr std::size_t DEFAULT_SLOTS = 16;
+constexpr int DEFAULT_POLL_DELAY_US = 200;
+constexpr int STATE_KEYS = 256;
+
+struct BenchConfig {
+    int updates = DEFAULT_UPDATES;
+    std::size_t slots = DEFAULT_SLOTS;
+    int poll_delay_us = DEFAULT_POLL_DELAY_US;
+};
+
+struct RunResult {
+    double publish_per_sec = 0;
+    double apply_per_sec = 0; // Average per subscriber
+    uint64_t diff_updates = 0;
+    uint64_t full_updates = 0;
+    uint64_t missed_updates = 0;
+    uint64_t snapshot_fallbacks = 0;
+    uint64_t torn_reads = 0;
+    bool consistent = true;
+};
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+ImmerValue make_initial_state() {
+    auto state = ImmerValue::map({});
+    for (int i = 0; i < STATE_KEYS; ++i) {
+        state = state.set("key_" + std::to_string(i), ImmerValue{i});
+    }
+    return state;
+}
+
+void printHeader(const std::string& title) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << title << "\n";
+    std::cout << std::string(60, '=') << "\n\n";
+}
+
+//=============================================================================
+// Benchmark
+//=============================================================================
+
+RunResult run(const BenchConfig& cfg, int subscriber_count) {
+    SharedMemoryConfig shm_cfg;
+    shm_cfg.name = "lager_ext_state_ring_bench";
+    shm_cfg.size = 4 * 1024 * 1024;
+    shm_cfg.ring_slots = cfg.slots;
+
+    StatePublisher publisher(shm_cfg);
+    if (!publisher.is_valid()) {
+        std::cerr << "Failed to create publisher\n";
+        return {};
+    }
+
+    ImmerValue state = make_initial_state();
+    publisher.publish(state);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> ready{0};
+    std::vector<StateSubscriber::Stats> sub_stats(subscriber_count);
+    std::vector<double> sub_seconds(subscriber_count, 0.0);
+    std::vector<ImmerValue> sub_final(subscriber_count);
+    std::vector<std::thread> threads;
+
+    for (int s = 0; s < subscriber_count; ++s) {
+        threads.emplace_back([&, s]() {
+            StateSubscriber subscriber(shm_cfg);
+            ready.fetch_add(1);
+            auto start = std::chrono::steady_clock::now();
+            while (!done.load(std::memory_order_acquire)) {
+                subscriber.poll();
+                std::this_thread::sleep_for(std::chrono::microseconds(cfg.poll_delay_us));
+            }
+            subscriber.poll(); // Drain whatever is left
+            sub_seconds[s] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            sub_stats[s] = subscriber.stats();
+            sub_final[s] = subscriber.current();
+        });
+    }
+
+    while (ready.load() < subscriber_count) {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < cfg.updates; ++i) {
+        const std::string key = "key_" + std::to_string(i % STATE_KEYS);
+        ImmerValue next = state.set(key, ImmerValue{i});
+        publisher.publish_diff(state, next);
+        state = next;
+    }
+    double publish_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    done.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    RunResult result;
+    result.publish_per_sec = cfg.updates / publish_seconds;
+    for (int s = 0; s < subscriber_count; ++s) {
+        const auto& st = sub_stats[s];
+        result.apply_per_sec += st.total_updates / sub_seconds[s];
+        result.diff_updates += st.diff_updates;
+        result.full_updates += st.full_updates;
+        result.missed_updates += st.missed_updates;
+        result.snapshot_fallbacks += st.snapshot_fallbacks;
+        result.torn_reads += st.torn_reads;
+        result.consistent = result.consistent && sub_final[s] == state;
+    }
+    result.apply_per_sec /= subscriber_count;
+    return result;
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            cfg.updates = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--slots") == 0 && i + 1 < argc) {
+            cfg.slots = static_cast<std::size_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            cfg.poll_delay_us = std::atoi(argv[++i]);
+        }
+    }
+
+    printHeader("StatePublisher Ring Benchmark");
+    std::cout << "Updates: " << cfg.updates << "  Ring slots: " << cfg.slots
+              << "  Subscriber poll interval: " << cfg.poll_delay_us << " us\n\n";
+
+    std::cout << std::left << std::setw(6) << "Subs" << std::setw(14) << "publish/s" << std::setw(14) << "apply/s/sub"
+              << std::setw(10) << "diffs" << std::setw(10) << "fulls" << std::setw(10) << "missed" << std::setw(10)
+              << "fallback" << std::setw(8) << "torn"
+              << "state\n";
+    std::cout << std::string(92, '-') << "\n";
+
+    for (int subs : {1, 4, 16}) {
+        RunResult r = run(cfg, subs);
+        std::cout << std::left << std::setw(6) << subs << std::setw(14) << std::fixed << std::setprecision(0)
+                  << r.publish_per_sec << std::setw(14) << r.apply_per_sec << std::setw(10) << r.diff_updates
+                  << std::setw(10) << r.full_updates << std::setw(10) << r.missed_updates << std::setw(10)
+                  << r.snapshot_fallbacks << std::setw(8) << r.torn_reads << (r.consistent ? "ok" : "MISMATCH")
+                  << "\n";
+    }
+
+    std::cout << "\nNotes:\n";
+    std::cout << "  - diffs/fulls/missed/fallback/torn are summed over all subscribers\n";
+    std::cout << "  - 'fallback' counts resyncs from the snapshot after lagging past the ring depth\n";
+    return 0;
+}
@@ -52,6 +52,9 @@
 ///   // Synchronous request-response (like SendMessage):
 ///   auto result = remote.send("QueryData", queryPayload);  // Blocking
 ///
+///   // Pipelined requests: many in flight, completed by poll()
+///   remote.send_async("QueryData", queryPayload, [](std::optional<ImmerValue> reply) { ... });
+///
 ///   // Subscribe to all events in a domain
 ///   remote.subscribe_domain(MessageDomain::Document, [](auto envelope, auto& data) {
 ///       // Handle any Document domain event
@@ -63,6 +66,9 @@
 /// - Events must be serializable to work across processes
 /// - The remote bus polls the IPC channel; it does not run a separate thread
 /// - Large payloads (>240 bytes) automatically use the shared memory pool
+/// - Wire format: a fixed 24-byte header (FNV-1a name hash, request id,
+///   timestamp, domain, flags) followed by the serialized payload. Receivers
+///   dispatch on the hash and only deserialize payloads somebody subscribed to
 
 #pragma once
 
@@ -73,6 +79,7 @@
 
 #include <chrono>
 #include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <string>
@@ -172,7 +179,7 @@ public:
     enum class Role {
         Server, ///< Creates the channel
         Client, ///< Connects to existing channel
-        Peer    ///< Bidirectional (creates ChannelPair)
+        Peer    ///< Bidirectional (connects to a ChannelPair, or creates it)
     };
 
     RemoteBus(std::string_view channel_name, EventBus& bus, Role role = Role::Peer,
@@ -191,7 +198,8 @@ public:
     /// @brief Post event to remote only (non-blocking)
     template <IpcEvent Evt>
     bool post_remote(const Evt& evt) {
-        return post_remote(Evt::event_name, IpcEventTrait<Evt>::serialize(evt));
+        static constexpr uint32_t name_hash = ipc::detail::fnv1a_hash32(Evt::event_name);
+        return post_remote_impl(name_hash, IpcEventTrait<Evt>::domain, IpcEventTrait<Evt>::serialize(evt));
     }
 
     /// @brief Post event to both local and remote (non-blocking)
@@ -202,7 +210,8 @@ public:
     }
 
     /// @brief Post dynamic event to remote (non-blocking)
-    bool post_remote(std::string_view event_name, const ImmerValue& payload);
+    bool post_remote(std::string_view event_name, const ImmerValue& payload,
+                     MessageDomain domain = MessageDomain::Global);
 
     /// @brief Post dynamic event to both local and remote (non-blocking)
     bool broadcast(std::string_view event_name, const ImmerValue& payload);
@@ -219,6 +228,27 @@ public:
     std::optional<ImmerValue> send(std::string_view event_name, const ImmerValue& payload,
                               std::chrono::milliseconds timeout = std::chrono::seconds(5));
 
+    /// Completion handler for send_async(): the response, or nullopt on timeout
+    using ResponseHandler = std::move_only_function<void(std::optional<ImmerValue>)>;
+
+    /// @brief Send a request without waiting for the response (pipelined send)
+    /// Any number of requests can be in flight. poll() matches responses by
+    /// request id and calls handler on the polling thread; a request without a
+    /// response after timeout completes with nullopt.
+    /// @return false if the request could not be queued (handler is not called)
+    bool send_async(std::string_view event_name, const ImmerValue& payload, ResponseHandler handler,
+                    std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+    /// @brief send_async() returning a future
+    /// The future becomes ready inside poll(): keep calling wait_and_poll() until
+    /// it is (waiting on it without polling never completes). Holds nullopt on
+    /// timeout or if the request could not be queued.
+    std::future<std::optional<ImmerValue>> send_async(std::string_view event_name, const ImmerValue& payload,
+                                                      std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+    /// @brief Requests sent with send_async() that have neither completed nor timed out
+    [[nodiscard]] std::size_t pending_requests() const;
+
     /// @brief Register a handler for incoming requests
     template <std::invocable<const ImmerValue&> Handler>
         requires std::convertible_to<std::invoke_result_t<Handler, const ImmerValue&>, ImmerValue>
@@ -262,7 +292,7 @@ public:
         uint64_t timestamp;         ///< Message timestamp
         MessageDomain domain;       ///< Message domain
         MessageFlags flags;         ///< Message flags
-        uint16_t requestId;         ///< Request ID (0 for events)
+        uint32_t requestId;         ///< Request ID (0 for events); 32 bits like the wire header since v1
     };
 
     /// @brief Subscribe to all events in a specific domain
@@ -290,11 +320,22 @@ public:
     // ========================================================================
 
     /// @brief Poll for incoming events (non-blocking)
+    /// Also completes send_async() requests: responses that arrived and timeouts that passed
     std::size_t poll();
 
     /// @brief Poll with timeout
+    /// Dispatches everything that arrives within timeout; between messages the
+    /// thread sleeps until the sender publishes (futex wake on Linux), so an idle
+    /// bus costs no CPU and a new event is handled within microseconds.
     std::size_t poll(std::chrono::milliseconds timeout);
 
+    /// @brief Wait for work, then poll once
+    /// Sleeps until a message arrives, a send_async() request times out, or
+    /// timeout passes, then dispatches what is available and returns. Unlike
+    /// poll(timeout) it returns as soon as something was handled, which is what
+    /// a caller waiting on a send_async() future or callback wants.
+    std::size_t wait_and_poll(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
     // ========================================================================
     // Properties
     // ========================================================================
@@ -303,7 +344,15 @@ public:
     [[nodiscard]] const std::string& channel_name() const;
     [[nodiscard]] const std::string& last_error() const;
 
+    struct Stats {
+        uint64_t received = 0;         // Messages taken off the incoming channel
+        uint64_t payloads_decoded = 0; // Payloads deserialized because a handler or pending request wanted them
+        uint64_t dropped = 0;          // Foreign, malformed or other-version messages
+    };
+    [[nodiscard]] Stats stats() const noexcept;
+
 private:
+    bool post_remote_impl(uint32_t name_hash, MessageDomain domain, const ImmerValue& payload);
     Connection subscribe_remote_impl(std::string_view event_name, std::move_only_function<void(const ImmerValue&) const> handler);
     Connection on_request_impl(std::string_view event_name, std::move_only_function<ImmerValue(const ImmerValue&)> handler);
     Connection subscribe_domain_impl(MessageDomain domain, 
@@ -262,7 +262,7 @@ inline ValueBox copy_fast_shared_box_to_local(const FastSharedValueBox& shared_b
 inline ValueMap copy_fast_shared_map_to_local(const FastSharedValueMap& shared_map) {
     auto transient = ValueMap{}.transient();
     for (const auto& [key, value_box] : shared_map) {
-        transient.set(key.to_string(), copy_fast_shared_box_to_local(value_box));
+        transient.set(key.to_string(), fast_deep_copy_to_local(value_box.get()));
     }
     return transient.persistent();
 }
@@ -270,19 +270,19 @@ inline ValueMap copy_fast_shared_map_to_local(const FastSharedValueMap& shared_m
 inline ValueVector copy_fast_shared_vector_to_local(const FastSharedValueVector& shared_vec) {
     auto transient = ValueVector{}.transient();
     for (const auto& value_box : shared_vec) {
-        transient.push_back(copy_fast_shared_box_to_local(value_box));
+        transient.push_back(fast_deep_copy_to_local(value_box.get()));
     }
     return transient.persistent();
 }
 
 inline ValueArray copy_fast_shared_array_to_local(const FastSharedValueArray& shared_arr) {
     // Reserve exact capacity, avoiding reallocations
-    std::vector<ValueBox> temp;
+    std::vector<ImmerValue> temp;
     temp.reserve(shared_arr.size());
     for (const auto& value_box : shared_arr) {
-        temp.push_back(copy_fast_shared_box_to_local(value_box));
+        temp.push_back(fast_deep_copy_to_local(value_box.get()));
     }
-    return ValueArray(temp.begin(), temp.end());
+    return ValueArray(std::make_move_iterator(temp.begin()), std::make_move_iterator(temp.end()));
 }
 
 inline ValueTable copy_fast_shared_table_to_local(const FastSharedValueTable& shared_table) {
@@ -298,11 +298,16 @@ inline FastSharedValueBox copy_local_box_to_fast_shared(const ValueBox& local_bo
     return FastSharedValueBox{fast_deep_copy_to_shared(local_box.get())};
 }
 
+// Maps, vectors and arrays store ImmerValue directly (Container Boxing)
+inline FastSharedValueBox copy_local_value_to_fast_shared(const ImmerValue& local) {
+    return FastSharedValueBox{fast_deep_copy_to_shared(local)};
+}
+
 inline FastSharedValueMap copy_local_map_to_fast_shared(const ValueMap& local_map) {
     // Key optimization: using transient, O(n) complexity!
     auto transient = FastSharedValueMap{}.transient();
-    for (const auto& [key, value_box] : local_map) {
-        transient.set(::shared_memory::SharedString(key), copy_local_box_to_fast_shared(value_box));
+    for (const auto& [key, value] : local_map) {
+        transient.set(::shared_memory::SharedString(key), copy_local_value_to_fast_shared(value));
     }
     return transient.persistent();
 }
@@ -310,8 +315,8 @@ inline FastSharedValueMap copy_local_map_to_fast_shared(const ValueMap& local_ma
 inline FastSharedValueVector copy_local_vector_to_fast_shared(const ValueVector& local_vec) {
     // Key optimization: using transient, O(n) complexity!
     auto transient = FastSharedValueVector{}.transient();
-    for (const auto& value_box : local_vec) {
-        transient.push_back(copy_local_box_to_fast_shared(value_box));
+    for (const auto& value : local_vec) {
+        transient.push_back(copy_local_value_to_fast_shared(value));
     }
     return transient.persistent();
 }
@@ -321,8 +326,8 @@ inline FastSharedValueArray copy_local_array_to_fast_shared(const ValueArray& lo
     // be directly converted to FastSharedValueArray. Using move semantics instead.
     // This is still O(n) due to immer's structural sharing with move.
     FastSharedValueArray result;
-    for (const auto& value_box : local_arr) {
-        result = std::move(result).push_back(copy_local_box_to_fast_shared(value_box));
+    for (const auto& value : local_arr) {
+        result = std::move(result).push_back(copy_local_value_to_fast_shared(value));
     }
     return result;
 }
@@ -407,14 +412,18 @@ inline FastSharedValue fast_deep_copy_to_shared(const ImmerValue& local) {
             if constexpr (std::is_same_v<T, std::monostate>) {
                 return FastSharedValue{};
             }
-            // Signed integers
-            else if constexpr (std::is_same_v<T, int32_t>) {
+            // Signed integers (8/16-bit values widen to int32)
+            else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
+                return FastSharedValue{static_cast<int32_t>(data)};
+            } else if constexpr (std::is_same_v<T, int32_t>) {
                 return FastSharedValue{data};
             } else if constexpr (std::is_same_v<T, int64_t>) {
                 return FastSharedValue{data};
             }
-            // Unsigned integers
-            else if constexpr (std::is_same_v<T, uint32_t>) {
+            // Unsigned integers (8/16-bit values widen to uint32)
+            else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>) {
+                return FastSharedValue{static_cast<uint32_t>(data)};
+            } else if constexpr (std::is_same_v<T, uint32_t>) {
                 return FastSharedValue{data};
             } else if constexpr (std::is_same_v<T, uint64_t>) {
                 return FastSharedValue{data};
@@ -429,17 +438,19 @@ inline FastSharedValue fast_deep_copy_to_shared(const ImmerValue& local) {
             else if constexpr (std::is_same_v<T, bool>) {
                 return FastSharedValue{data};
             }
-            // String
-            else if constexpr (std::is_same_v<T, std::string>) {
-                return FastSharedValue{::shared_memory::SharedString(data)};
-            } else if constexpr (std::is_same_v<T, ValueMap>) {
-                return FastSharedValue{detail::copy_local_map_to_fast_shared(data)};
-            } else if constexpr (std::is_same_v<T, ValueVector>) {
-                return FastSharedValue{detail::copy_local_vector_to_fast_shared(data)};
-            } else if constexpr (std::is_same_v<T, ValueArray>) {
-                return FastSharedValue{detail::copy_local_array_to_fast_shared(data)};
-            } else if constexpr (std::is_same_v<T, ValueTable>) {
-                return FastSharedValue{detail::copy_local_table_to_fast_shared(data)};
+            // String (boxed in ImmerValue)
+            else if constexpr (std::is_same_v<T, BoxedString>) {
+                return FastSharedValue{::shared_memory::SharedString(data.get())};
+            }
+            // Containers (Container Boxing: unwrap the box, copy the container)
+            else if constexpr (std::is_same_v<T, BoxedValueMap>) {
+                return FastSharedValue{detail::copy_local_map_to_fast_shared(data.get())};
+            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
+                return FastSharedValue{detail::copy_local_vector_to_fast_shared(data.get())};
+            } else if constexpr (std::is_same_v<T, BoxedValueArray>) {
+                return FastSharedValue{detail::copy_local_array_to_fast_shared(data.get())};
+            } else if constexpr (std::is_same_v<T, BoxedValueTable>) {
+                return FastSharedValue{detail::copy_local_table_to_fast_shared(data.get())};
             }
             // Math types - trivially copyable, direct copy
             else if constexpr (std::is_same_v<T, Vec2>) {
@@ -448,11 +459,12 @@ inline FastSharedValue fast_deep_copy_to_shared(const ImmerValue& local) {
                 return FastSharedValue{data};
             } else if constexpr (std::is_same_v<T, Vec4>) {
                 return FastSharedValue{data};
-            } else if constexpr (std::is_same_v<T, Mat3>) {
-                return FastSharedValue{data};
-            } else if constexpr (std::is_same_v<T, Mat4x3>) {
-                return FastSharedValue{data};
+            } else if constexpr (std::is_same_v<T, BoxedMat3>) {
+                return FastSharedValue{data.get()};
+            } else if constexpr (std::is_same_v<T, BoxedMat4x3>) {
+                return FastSharedValue{data.get()};
             } else {
+                // Mat4 has no FastSharedValue counterpart
                 return FastSharedValue{};
             }
         },
@@ -468,6 +480,29 @@ inline FastSharedValue deep_copy_to_shared_fast(const ImmerValue& local) {
     return fast_deep_copy_to_shared(local);
 }
 
+//==============================================================================
+// Parallel Construction
+//==============================================================================
+
+/// Containers with fewer children than this are copied serially
+inline constexpr std::size_t PARALLEL_COPY_MIN_ELEMENTS = 1024;
+
+/// @brief Multi-threaded fast_deep_copy_to_shared for large trees
+///
+/// Copies into the calling thread's current region, like fast_deep_copy_to_shared.
+/// The children of every container with at least PARALLEL_COPY_MIN_ELEMENTS
+/// entries are copied by a group of worker threads, each allocating from its
+/// own sub-arena of the region (SharedMemoryRegion::make_sub_arena), so the
+/// bump allocator stays contention-free. Containers are then assembled on the
+/// calling thread. The result is an ordinary FastSharedValue: read it back with
+/// fast_deep_copy_to_local.
+///
+/// Call sync_allocation_cursor() afterwards, as with the serial copy.
+///
+/// @param num_threads Total threads including the caller (0 = hardware concurrency, 1 = serial)
+/// @throws shared_memory_error if no region is set or the region runs out of memory
+LAGER_EXT_API FastSharedValue fast_deep_copy_to_shared_parallel(const ImmerValue& local, std::size_t num_threads = 0);
+
 //==============================================================================
 // FastSharedValueHandle - Handle for FastSharedValue
 //==============================================================================
@@ -494,12 +529,15 @@ public:
     /// @param name Shared memory region name (unique identifier)
     /// @param value The ImmerValue to copy to shared memory
     /// @param max_size Maximum size of shared memory region (default 100MB)
+    /// @param num_threads Threads used for the copy (1 = serial, 0 = hardware concurrency)
     /// @return true on success, false on failure
     ///
-    /// Uses fast_deep_copy_to_shared for O(n) construction complexity.
+    /// Uses fast_deep_copy_to_shared for O(n) construction complexity
+    /// (fast_deep_copy_to_shared_parallel when num_threads != 1).
     /// On failure, the region is cleaned up automatically.
     /// Use last_error() to get the last error message (if any).
-    bool create(const char* name, const ImmerValue& value, size_t max_size = 100 * 1024 * 1024) {
+    bool create(const char* name, const ImmerValue& value, size_t max_size = 100 * 1024 * 1024,
+                size_t num_threads = 1) {
         last_error_.clear();
 
         if (!region_.create(name, max_size)) {
@@ -532,7 +570,11 @@ public:
             header->value_offset = offset;
 
             // Using fast_deep_copy_to_shared - O(n) complexity!
-            new (value_storage) FastSharedValue(fast_deep_copy_to_shared(value));
+            if (num_threads == 1) {
+                new (value_storage) FastSharedValue(fast_deep_copy_to_shared(value));
+            } else {
+                new (value_storage) FastSharedValue(fast_deep_copy_to_shared_parallel(value, num_threads));
+            }
 
             // Sync local cursor to shared header (required for single-threaded allocator)
             region_.sync_allocation_cursor();
@@ -0,0 +1,120 @@
+// indexed_snapshot.h - Random-access binary snapshot format with lazy decode
+
+/// @file indexed_snapshot.h
+/// @brief Indexed binary layout that can be queried without decoding the whole tree.
+///
+/// deserialize() has to walk every byte of a buffer before a single property
+/// can be read. The indexed layout stores an offset table in front of every
+/// container, so a LazyValueView can follow a path straight to the node it
+/// needs and decode only that subtree:
+///
+/// @code
+///   ByteBuffer snapshot = serialize_indexed(scene);
+///
+///   LazyValueView root(snapshot);
+///   ImmerValue pos = root.get_at_path({"entities", "e42", "position"});
+///   std::size_t count = root.at("entities").size();   // No decode at all
+/// @endcode
+///
+/// Layout (little-endian, offsets relative to the start of their node, so any
+/// subtree is self-contained):
+///   INDEXED_FORMAT_MARKER (0xC3), then the root node
+///   Scalars and strings: identical to the standard binary format (tag + payload)
+///   Map / Table:    tag, u32 count, count x {u32 key_offset, u32 key_length, u32 value_offset}
+///                   sorted by key bytes, then the key bytes, then the child nodes
+///   Vector / Array: tag, u32 count, count x u32 value_offset, then the child nodes
+///
+/// Every child lies after its parent's offset table, so decoding always moves
+/// forward and a corrupt buffer cannot make a view loop. deserialize() also
+/// accepts this format (it materializes the whole tree).
+
+#pragma once
+
+#include <lager_ext/api.h>
+#include <lager_ext/path.h>
+#include <lager_ext/value.h>
+
+#include <cstdint>
+#include <string_view>
+
+namespace lager_ext {
+
+/// First byte of every indexed-format buffer
+inline constexpr uint8_t INDEXED_FORMAT_MARKER = 0xC3;
+
+/// Serialize ImmerValue to the indexed snapshot layout
+/// @throws std::runtime_error if a single container exceeds 4 GB
+[[nodiscard]] LAGER_EXT_API ByteBuffer serialize_indexed(const ImmerValue& val);
+
+// ============================================================
+// LazyValueView - Read-only view of one node of an indexed buffer
+//
+// Navigation (at, at_path, size, key_at) only reads offset tables;
+// materialize() decodes the viewed subtree into an ImmerValue.
+// A missing key or index yields an empty view (exists() == false),
+// mirroring ImmerValue::at returning null. Offsets that point outside
+// the buffer throw std::runtime_error.
+//
+// WARNING: The view does NOT own the bytes. The buffer must outlive
+// every view created from it.
+// ============================================================
+
+class LAGER_EXT_API LazyValueView {
+public:
+    /// Empty view (missing value)
+    LazyValueView() noexcept = default;
+
+    /// View the root of an indexed buffer
+    /// @throws std::runtime_error if the buffer does not start with INDEXED_FORMAT_MARKER
+    LazyValueView(const uint8_t* data, std::size_t size);
+    explicit LazyValueView(const ByteBuffer& buffer) : LazyValueView(buffer.data(), buffer.size()) {}
+
+    [[nodiscard]] bool exists() const noexcept { return node_ != nullptr; }
+    explicit operator bool() const noexcept { return exists(); }
+
+    [[nodiscard]] bool is_null() const noexcept;
+    [[nodiscard]] bool is_string() const noexcept;
+    [[nodiscard]] bool is_map() const noexcept;
+    [[nodiscard]] bool is_vector() const noexcept;
+    [[nodiscard]] bool is_array() const noexcept;
+    [[nodiscard]] bool is_table() const noexcept;
+
+    /// Element count of a container, 0 for anything else
+    [[nodiscard]] std::size_t size() const;
+
+    /// Child by key (map) or id (table)
+    [[nodiscard]] LazyValueView at(std::string_view key) const;
+
+    /// Child by index (vector, array)
+    [[nodiscard]] LazyValueView at(std::size_t index) const;
+
+    /// Follow a path; empty view if any element is missing
+    [[nodiscard]] LazyValueView at_path(PathView path) const;
+
+    /// i-th key of a map or table (keys are sorted), empty for other nodes
+    [[nodiscard]] std::string_view key_at(std::size_t i) const;
+
+    /// i-th child of any container (maps and tables in key order)
+    [[nodiscard]] LazyValueView value_at(std::size_t i) const;
+
+    /// Contents of a string node without copying, empty for other nodes
+    [[nodiscard]] std::string_view as_string_view() const;
+
+    /// Decode the viewed subtree (null for an empty view)
+    [[nodiscard]] ImmerValue materialize() const;
+
+    /// at_path(path).materialize()
+    [[nodiscard]] ImmerValue get_at_path(PathView path) const { return at_path(path).materialize(); }
+
+private:
+    LazyValueView(const uint8_t* node, const uint8_t* end) noexcept : node_(node), end_(end) {}
+
+    bool keyed() const noexcept;
+    bool indexed() const noexcept;
+    const uint8_t* child(uint32_t offset) const;
+
+    const uint8_t* node_ = nullptr; // Tag byte of the viewed node
+    const uint8_t* end_ = nullptr;  // End of the whole buffer (bounds for every read)
+};
+
+} // namespace lager_ext
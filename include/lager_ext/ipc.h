@@ -12,9 +12,12 @@
 /// - Lock-free ring buffer using atomic operations
 /// - No system calls in the hot path
 /// - Cache-line aligned to avoid false sharing
-/// - Supports both polling and blocking modes
+/// - Supports both polling and blocking modes (blocking sleeps on a futex on Linux)
 /// - Message domain support for categorization
 /// - Shared memory pool for large payloads (>240 bytes)
+/// - Batched post/receive with one index publish per batch
+///
+/// ChannelMPMC is the variant for many producers and consumers sharing one queue.
 ///
 /// Usage:
 /// @code
@@ -37,11 +40,15 @@
 #include <lager_ext/value.h>
 
 #include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace lager_ext {
 namespace ipc {
@@ -53,6 +60,19 @@ namespace ipc {
 /// Default queue capacity (number of messages)
 constexpr size_t DEFAULT_CAPACITY = 4096;
 
+/// Default size of a channel's large-payload pool (0 disables large payloads)
+constexpr size_t DEFAULT_CHANNEL_POOL_SIZE = 4 * 1024 * 1024;
+
+/// Ring layout of a Channel
+enum class ChannelMode : uint8_t {
+    /// One 256-byte Message slot per message; payloads over Message::INLINE_SIZE go to the pool
+    FixedSlots,
+    /// Variable-length records (32-byte header + payload, padded to 8 bytes) in a byte ring.
+    /// Small messages pack densely; payloads up to a quarter of the ring stay inline,
+    /// larger ones go to the pool.
+    ByteRing
+};
+
 /// Cache line size for padding (avoid false sharing)
 /// C++20: prefer std::hardware_destructive_interference_size when available
 #if __cpp_lib_hardware_interference_size >= 201703L
@@ -77,7 +97,7 @@ constexpr size_t CACHE_LINE_SIZE = 64; // Common value for x86/ARM
 ///     16      1     domain (MessageDomain enum)
 ///     17      1     flags (MessageFlags bitmask)
 ///     18      2     requestId (for request/response correlation, 0 for events)
-///     20      4     poolOffset (offset in SharedMemoryPool if LargePayload flag set)
+///     20      4     poolBlock (SharedMemoryPool offset / MIN_BLOCK_SIZE if LargePayload flag set)
 ///     24      232   inlineData (payload if <= 232 bytes)
 /// @endcode
 struct Message {
@@ -88,7 +108,7 @@ struct Message {
     MessageDomain domain;               ///< Message domain for categorization
     MessageFlags flags;                 ///< Message flags (LargePayload, IsRequest, etc.)
     uint16_t requestId;                 ///< Request/response correlation ID (0 for events)
-    uint32_t poolOffset;                ///< Offset in SharedMemoryPool (if LargePayload)
+    uint32_t poolBlock;                 ///< SharedMemoryPool offset / MIN_BLOCK_SIZE (if LargePayload)
 
     // Header: 4 + 4 + 8 + 1 + 1 + 2 + 4 = 24 bytes
     // Inline data: 232 bytes
@@ -105,7 +125,7 @@ struct Message {
         , domain(MessageDomain::Global)
         , flags(MessageFlags::None)
         , requestId(0)
-        , poolOffset(0) {
+        , poolBlock(0) {
         std::memset(inlineData, 0, INLINE_SIZE);
     }
 
@@ -155,12 +175,21 @@ public:
     /// Create the channel as producer (creates shared memory)
     /// @param name Unique channel name
     /// @param capacity Number of messages the queue can hold
+    /// @param poolSize Size of the SharedMemoryPool for payloads that do not fit inline
+    ///        (created as "<name>_pool"; 0 = inline payloads only)
+    /// @param mode Ring layout. ByteRing uses the same capacity * sizeof(Message) bytes of
+    ///        shared memory as FixedSlots, but holds up to ~6x as many small messages.
     /// @return Channel instance, nullptr on failure
-    static std::unique_ptr<Channel> create(const std::string& name, size_t capacity = DEFAULT_CAPACITY);
+    /// @note The creator owns the shared memory: destroying it removes the channel and its
+    ///       pool (POSIX), after which open() fails. Attached consumers keep their mapping.
+    static std::unique_ptr<Channel> create(const std::string& name, size_t capacity = DEFAULT_CAPACITY,
+                                           size_t poolSize = DEFAULT_CHANNEL_POOL_SIZE,
+                                           ChannelMode mode = ChannelMode::FixedSlots);
 
     /// Open the channel as consumer (attaches to existing shared memory)
-    /// @param name Channel name (must match producer)
+    /// @param name Channel name (must match producer); the mode is taken from the producer
     /// @return Channel instance, nullptr on failure
+    /// @note Does not own the shared memory: destroying it leaves the channel to be reopened
     static std::unique_ptr<Channel> open(const std::string& name);
 
     //-------------------------------------------------------------------------
@@ -171,19 +200,36 @@ public:
     /// @param msgId Message type identifier
     /// @param data Message data (will be serialized)
     /// @param domain Message domain for categorization (default: Global)
-    /// @return true if message was queued, false if queue is full
+    /// @return true if message was queued, false if the queue or the payload pool is full
     /// @note This is non-blocking - returns immediately after queuing (like PostMessage)
-    /// @note Large payloads (>232 bytes) require a shared memory pool
+    /// @note Payloads that do not fit inline (over Message::INLINE_SIZE, or a quarter of
+    ///       the ring in ByteRing mode) are serialized straight into a pool block. The block is recycled once the consumer has received the message;
+    ///       until then a full pool rejects posts ("Pool exhausted") - retry later.
     bool post(uint32_t msgId, const ImmerValue& data = {}, MessageDomain domain = MessageDomain::Global);
 
     /// Post raw bytes to the queue (producer only, no serialization, non-blocking)
     /// @param msgId Message type identifier
     /// @param data Pointer to data
-    /// @param size Data size in bytes
+    /// @param size Data size in bytes (payloads that do not fit inline go through the pool, see post())
     /// @param domain Message domain for categorization (default: Global)
     /// @return true if message was queued
     bool postRaw(uint32_t msgId, const void* data, size_t size, MessageDomain domain = MessageDomain::Global);
 
+    /// One entry of a postBatch() call
+    struct OutgoingMessage {
+        uint32_t msgId = 0;
+        ImmerValue data;
+        MessageDomain domain = MessageDomain::Global;
+    };
+
+    /// Post several messages with a single index publish (producer only, non-blocking)
+    /// Messages are written in order until the queue or the payload pool is full;
+    /// the consumer sees all of them at once. At high rates this saves one
+    /// cross-core writeIndex transfer per message compared to post().
+    /// @return Number of messages queued (a prefix of messages); if fewer than
+    ///         messages.size(), lastError() says why
+    size_t postBatch(std::span<const OutgoingMessage> messages);
+
     /// Check if queue has space for more messages
     bool canPost() const;
 
@@ -213,13 +259,25 @@ public:
 
     /// Receive a message (consumer only, non-blocking)
     /// @return Message if available, std::nullopt if queue is empty
+    /// @note A message whose pool payload cannot be resolved is consumed and dropped,
+    ///       never returned; lastError() reports it. The same holds for the other
+    ///       receive functions.
     std::optional<ReceivedMessage> tryReceive();
 
     /// Receive a message (consumer only, blocking)
-    /// @param timeout Maximum time to wait
+    /// @param timeout Maximum time to wait (milliseconds::max() = forever)
     /// @return Message if received, std::nullopt on timeout
+    /// @note Waits with waitForMessage(), so an idle consumer does not burn a core
     std::optional<ReceivedMessage> receive(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
 
+    /// Block until a message is available (consumer only), without consuming it
+    /// Spins briefly, then sleeps. On Linux the sleep is a futex wait on a word in
+    /// the shared header, and the producer issues a wake only while the consumer
+    /// has announced it is sleeping. Elsewhere it polls with short sleeps.
+    /// @param timeout Maximum time to wait (milliseconds::max() = forever)
+    /// @return true if a message is available, false on timeout
+    bool waitForMessage(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
     /// Receive raw bytes (consumer only, no deserialization)
     /// @param outMsgId Receives the message ID
     /// @param outData Buffer to receive data
@@ -227,6 +285,23 @@ public:
     /// @return Actual data size, 0 if queue empty, -1 if buffer too small
     int tryReceiveRaw(uint32_t& outMsgId, void* outData, size_t maxSize);
 
+    /// Receive all available messages, up to maxCount, with a single index publish
+    /// (consumer only, non-blocking)
+    /// @param out Received messages are appended
+    /// @return Number of messages appended, 0 if the queue is empty
+    size_t receiveBatch(std::vector<ReceivedMessage>& out, size_t maxCount = SIZE_MAX);
+
+    /// Raw payload handler for drainRaw(); the payload points into shared memory
+    /// and is only valid during the call
+    using RawHandler = std::function<void(uint32_t msgId, std::span<const uint8_t> payload)>;
+
+    /// Hand all available messages, up to maxCount, to handler without copying or
+    /// deserializing them, then release them with a single index publish
+    /// (consumer only, non-blocking)
+    /// @return Number of messages handled (dropped broken messages are not handed over)
+    /// @note If handler throws, the messages before it and the one it threw on are consumed
+    size_t drainRaw(const RawHandler& handler, size_t maxCount = SIZE_MAX);
+
     //-------------------------------------------------------------------------
     // Properties
     //-------------------------------------------------------------------------
@@ -237,9 +312,13 @@ public:
     /// Check if this is the producer side
     bool isProducer() const;
 
-    /// Get queue capacity
+    /// Get queue capacity (as passed to create(); in ByteRing mode the ring holds
+    /// capacity * sizeof(Message) bytes)
     size_t capacity() const;
 
+    /// Get the ring layout
+    ChannelMode mode() const;
+
     /// Get last error message
     const std::string& lastError() const;
 
@@ -255,6 +334,14 @@ public:
     Channel& operator=(Channel&&) noexcept;
 
 private:
+    friend class ChannelPair;
+
+    /// ChannelPair's reverse channel: the creator owns the shared memory but
+    /// consumes, the connecting process attaches and produces
+    static std::unique_ptr<Channel> createForConsumer(const std::string& name, size_t capacity, size_t poolSize,
+                                                      ChannelMode mode);
+    static std::unique_ptr<Channel> openForProducer(const std::string& name);
+
     Channel();
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -290,12 +377,19 @@ public:
     /// Create the channel pair (creates both underlying channels)
     /// @param name Unique pair name
     /// @param capacity Number of messages each channel can hold
+    /// @param poolSize Large-payload pool size of each channel (see Channel::create)
+    /// @param mode Ring layout of both channels
     /// @return ChannelPair instance, nullptr on failure
-    static std::unique_ptr<ChannelPair> create(const std::string& name, size_t capacity = DEFAULT_CAPACITY);
+    /// @note The creator owns both channels (see Channel::create) and consumes the reverse one
+    static std::unique_ptr<ChannelPair> create(const std::string& name, size_t capacity = DEFAULT_CAPACITY,
+                                               size_t poolSize = DEFAULT_CHANNEL_POOL_SIZE,
+                                               ChannelMode mode = ChannelMode::FixedSlots);
 
     /// Connect to an existing channel pair
     /// @param name Pair name (must match creator)
     /// @return ChannelPair instance, nullptr on failure
+    /// @note Produces on the reverse channel without owning it: after this side goes away
+    ///       the creator keeps both channels and another process can connect
     static std::unique_ptr<ChannelPair> connect(const std::string& name);
 
     /// Post a message to the other endpoint (non-blocking, like PostMessage)
@@ -309,6 +403,18 @@ public:
     /// @return true if message was queued
     bool postRaw(uint32_t msgId, const void* data, size_t size);
 
+    /// Post several messages to the other endpoint with one index publish (see Channel::postBatch)
+    /// @return Number of messages queued
+    size_t postBatch(std::span<const Channel::OutgoingMessage> messages);
+
+    /// Receive all available messages from the other endpoint (see Channel::receiveBatch)
+    /// @return Number of messages appended to out
+    size_t receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount = SIZE_MAX);
+
+    /// Hand messages from the other endpoint to handler in place (see Channel::drainRaw)
+    /// @return Number of messages handled
+    size_t drainRaw(const Channel::RawHandler& handler, size_t maxCount = SIZE_MAX);
+
     /// Receive a message from the other endpoint (non-blocking)
     std::optional<Channel::ReceivedMessage> tryReceive();
 
@@ -323,6 +429,10 @@ public:
     std::optional<Channel::ReceivedMessage>
     receive(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
 
+    /// Block until a message from the other endpoint is available (see Channel::waitForMessage)
+    /// @return true if a message is available, false on timeout
+    bool waitForMessage(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
     /// Synchronous send with reply (blocking, like SendMessage)
     /// Sends a message and waits for a reply with matching correlation
     /// @return Response value, or nullopt on timeout
@@ -348,5 +458,114 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+//=============================================================================
+// ChannelMPMC - Multi-producer multi-consumer channel
+//=============================================================================
+
+/// @brief Shared queue that any number of processes (and threads) post to and receive from
+///
+/// A bounded Vyukov queue: every slot carries a sequence number next to its
+/// Message, and producers and consumers claim slots with one CAS on a shared
+/// enqueue / dequeue position. There are no producer or consumer roles: every
+/// handle may post and receive.
+///
+/// Usage:
+/// @code
+///     // Editor - creates the queue and drains it
+///     auto queue = ChannelMPMC::create("WorkerEvents");
+///     while (auto msg = queue->receive()) {
+///         process(msg->msgId, msg->data);
+///     }
+///
+///     // Each worker process
+///     auto queue = ChannelMPMC::open("WorkerEvents");
+///     queue->post(MSG_PROGRESS, data);
+/// @endcode
+///
+/// Differences from Channel:
+/// - Payloads must fit inline (Message::INLINE_SIZE bytes serialized); there is no
+///   large-payload pool, as its allocator has a single owner
+/// - Messages are handed out one slot at a time; receiveBatch() and drainRaw() loop
+///   over single receives instead of publishing once per batch
+/// - A process that dies between claiming and publishing a slot stalls consumers
+///   at that slot; the queue has to be recreated
+class LAGER_EXT_API ChannelMPMC {
+public:
+    /// Create the queue (creates shared memory)
+    /// @param name Unique queue name
+    /// @param capacity Number of messages the queue can hold (rounded up to a power of two)
+    /// @return ChannelMPMC instance, nullptr on failure
+    static std::unique_ptr<ChannelMPMC> create(const std::string& name, size_t capacity = DEFAULT_CAPACITY);
+
+    /// Attach to a queue created by another process
+    /// @return ChannelMPMC instance, nullptr on failure
+    static std::unique_ptr<ChannelMPMC> open(const std::string& name);
+
+    /// Post a message (non-blocking, see Channel::post)
+    /// @return false if the queue is full or the serialized payload does not fit inline
+    bool post(uint32_t msgId, const ImmerValue& data = {}, MessageDomain domain = MessageDomain::Global);
+
+    /// Post raw bytes (non-blocking, size <= Message::INLINE_SIZE)
+    bool postRaw(uint32_t msgId, const void* data, size_t size, MessageDomain domain = MessageDomain::Global);
+
+    /// Post several messages in order until the queue is full
+    /// @return Number of messages queued (a prefix of messages)
+    size_t postBatch(std::span<const Channel::OutgoingMessage> messages);
+
+    /// Check if the queue has space for more messages (approximate under contention)
+    bool canPost() const;
+
+    /// Get number of messages waiting to be consumed (approximate under contention)
+    size_t pendingCount() const;
+
+    /// Receive a message (non-blocking)
+    /// @return Message if available, std::nullopt if queue is empty
+    std::optional<Channel::ReceivedMessage> tryReceive();
+
+    /// Receive a message (blocking, see Channel::receive)
+    std::optional<Channel::ReceivedMessage>
+    receive(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Block until a message is available, without consuming it. Another
+    /// consumer may take it first, so a following tryReceive() can still fail.
+    /// @return true if a message is available, false on timeout
+    bool waitForMessage(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Receive raw bytes (non-blocking, no deserialization)
+    /// @return Actual data size, 0 if queue empty, -1 if buffer too small
+    /// @note Unlike Channel, a message that does not fit outData is dropped: once
+    ///       claimed, a slot cannot be handed back to the other consumers
+    int tryReceiveRaw(uint32_t& outMsgId, void* outData, size_t maxSize);
+
+    /// Receive available messages, up to maxCount (non-blocking)
+    /// @return Number of messages appended to out
+    size_t receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount = SIZE_MAX);
+
+    /// Hand available messages, up to maxCount, to handler in place (see Channel::drainRaw)
+    /// @return Number of messages handled
+    size_t drainRaw(const Channel::RawHandler& handler, size_t maxCount = SIZE_MAX);
+
+    const std::string& name() const;
+
+    /// Get queue capacity (a power of two)
+    size_t capacity() const;
+
+    /// Check if this is the creator side (called create())
+    bool isCreator() const;
+
+    const std::string& lastError() const;
+
+    ~ChannelMPMC();
+    ChannelMPMC(const ChannelMPMC&) = delete;
+    ChannelMPMC& operator=(const ChannelMPMC&) = delete;
+    ChannelMPMC(ChannelMPMC&&) noexcept;
+    ChannelMPMC& operator=(ChannelMPMC&&) noexcept;
+
+private:
+    ChannelMPMC();
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 } // namespace ipc
 } // namespace lager_ext
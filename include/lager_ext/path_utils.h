@@ -74,17 +74,38 @@ namespace detail {
     }
 }
 
-/// Erase a key from a map value
+/// Erase a key from a map value, or an entry id from a table value
 /// @note Internal helper
-/// @note Container Boxing: uses BoxedValueMap, unbox -> modify -> rebox
-[[nodiscard]] inline ImmerValue erase_key_from_map(const ImmerValue& val, std::string_view key) {
+/// @note Container Boxing: uses BoxedValueMap/BoxedValueTable, unbox -> modify -> rebox
+[[nodiscard]] inline ImmerValue erase_key(const ImmerValue& val, std::string_view key) {
     if (auto* boxed_map = val.get_if<BoxedValueMap>()) {
         auto new_map = boxed_map->get().erase(std::string{key});
         return ImmerValue{BoxedValueMap{std::move(new_map)}};
     }
+    if (auto* boxed_table = val.get_if<BoxedValueTable>()) {
+        auto new_table = boxed_table->get().erase(std::string{key});
+        return ImmerValue{BoxedValueTable{std::move(new_table)}};
+    }
     return val;
 }
 
+/// Erase an index from a vector or array value
+/// The last element is dropped; any other is set to null, since removing it
+/// would shift the indices after it
+/// @note Internal helper
+[[nodiscard]] inline ImmerValue erase_index(const ImmerValue& val, std::size_t index) {
+    if (auto* boxed_vec = val.get_if<BoxedValueVector>()) {
+        if (index + 1 == boxed_vec->get().size()) {
+            return ImmerValue{BoxedValueVector{boxed_vec->get().take(index)}};
+        }
+    } else if (auto* boxed_arr = val.get_if<BoxedValueArray>()) {
+        if (index + 1 == boxed_arr->get().size()) {
+            return ImmerValue{BoxedValueArray{boxed_arr->get().take(index)}};
+        }
+    }
+    return val.set(index, ImmerValue{});
+}
+
 /// Check if a path element can be accessed in the given value
 /// @note Internal helper - prefer is_valid_path() for public use
 /// @note Uses transparent lookup for zero-allocation string_view access
@@ -140,8 +161,9 @@ namespace detail {
 [[nodiscard]] LAGER_EXT_API ImmerValue set_at_path_vivify(const ImmerValue& root, PathView path, ImmerValue new_val);
 
 /// @brief Erase value at a path
-/// For maps: actually erases the key.
-/// For vectors/arrays: sets to null (cannot shrink without reindexing).
+/// For maps and tables: actually erases the key (entry id).
+/// For vectors/arrays: drops the last element; any other is set to null
+/// (cannot remove it without reindexing).
 /// @param root The root value
 /// @param path The path to the value to erase
 /// @return New root with the element erased
@@ -7,6 +7,7 @@
 // - O(ChangedNodes) instead of O(Watchers * PathDepth)
 // - Automatic pruning of unchanged subtrees via immer identity checks
 // - Fast path for identical state objects
+// - Wildcard levels ("*", "**") visit only the children immer's diff reports
 
 #pragma once
 
@@ -17,6 +18,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace lager_ext {
 
@@ -34,12 +36,25 @@ namespace lager_ext {
 // 1. Fast path: Skip check entirely if old_state == new_state
 // 2. Trie structure: Shared path prefixes are only traversed once
 // 3. Structural sharing: Uses immer's pointer equality for early pruning
+// 4. Wildcards: A "*" or "**" level walks immer's diff of that container,
+//    so only children whose storage changed are visited
+//
+// **Wildcards:**
+// - "*" matches exactly one segment: any map key, table id or index
+// - "**" matches zero or more segments
+// A pattern watch fires once per concrete path whose value changed; use
+// a PathChangeCallback to learn which one. Keys literally named "*" or
+// "**" cannot be watched.
 //
 // Example:
 //   PathWatcher watcher;
 //   watcher.watch("/users/0/name", [](const ImmerValue& old_v, const ImmerValue& new_v) {
 //       std::cout << "Name changed!\n";
 //   });
+//   watcher.watch("/objects/*/transform/position",
+//                 [](PathView path, const ImmerValue& old_v, const ImmerValue& new_v) {
+//       std::cout << path.to_string_path() << " moved\n";
+//   });
 //   watcher.check(old_state, new_state);
 // ============================================================
 
@@ -47,6 +62,11 @@ class LAGER_EXT_API PathWatcher {
 public:
     using ChangeCallback = std::function<void(const ImmerValue& old_val, const ImmerValue& new_val)>;
 
+    /// Callback that also receives the concrete path that changed
+    /// @note The path only lives for the duration of the call
+    using PathChangeCallback =
+        std::function<void(PathView path, const ImmerValue& old_val, const ImmerValue& new_val)>;
+
     PathWatcher();
     ~PathWatcher();
 
@@ -66,7 +86,19 @@ public:
     /// @param callback Function called when value at path changes
     void watch(Path path, ChangeCallback callback);
 
+    /// Add a path or pattern to watch with a path-aware callback
+    /// @param path_str JSON Pointer style path, may contain "*" and "**" segments
+    ///                 (e.g., "/objects/*/transform/position")
+    /// @param callback Function called with each concrete path that changed
+    void watch(const std::string& path_str, PathChangeCallback callback);
+
+    /// Add a path or pattern to watch with a path-aware callback
+    /// @param path Path elements, may contain "*" and "**" segments
+    /// @param callback Function called with each concrete path that changed
+    void watch(Path path, PathChangeCallback callback);
+
     /// Remove all callbacks at a watched path
+    /// @note A pattern is removed by passing the same pattern
     void unwatch(const std::string& path_str);
     void unwatch(const Path& path);
 
@@ -89,7 +121,7 @@ public:
     struct Stats {
         std::size_t total_checks = 0;        ///< Total check() calls
         std::size_t skipped_equal = 0;       ///< Skipped due to equal state
-        std::size_t nodes_visited = 0;       ///< Trie nodes visited
+        std::size_t nodes_visited = 0;       ///< Trie nodes visited (once per concrete path they match)
         std::size_t nodes_pruned = 0;        ///< Nodes pruned via structural sharing
         std::size_t callbacks_triggered = 0; ///< Total callbacks triggered
     };
@@ -104,15 +136,31 @@ private:
     // Trie node for organizing watches by path prefix
     struct WatchNode;
 
+    // Trie nodes matching one concrete path; more than one once wildcards are involved
+    using NodeSet = std::vector<const WatchNode*>;
+
     std::unique_ptr<WatchNode> root_;
     std::size_t watch_count_ = 0;
     Stats stats_;
 
+    // Concrete path of the values being checked, handed to PathChangeCallbacks
+    std::vector<PathElement> path_;
+
     // Recursive check with structural sharing optimization
-    std::size_t check_node(WatchNode* node, const ImmerValue& old_val, const ImmerValue& new_val);
+    std::size_t check_node(const NodeSet& nodes, const ImmerValue& old_val, const ImmerValue& new_val);
+
+    // Look up the child under elem and check it unless it is shared
+    std::size_t check_exact_child(const PathElement& elem, const WatchNode& child, const ImmerValue& old_val,
+                                  const ImmerValue& new_val);
+    std::size_t check_exact_child(const PathElement& elem, const NodeSet& nodes, const ImmerValue& old_val,
+                                  const ImmerValue& new_val);
+
+    // Check the child under elem, pushing elem onto the current path
+    std::size_t check_child(const PathElement& elem, const NodeSet& nodes, const ImmerValue& old_child,
+                            const ImmerValue& new_child);
 
     // Insert a path into the trie
-    void insert_path(const Path& path, ChangeCallback callback);
+    void insert_path(const Path& path, PathChangeCallback callback);
 
     // Remove a path from the trie
     bool remove_path(const Path& path);
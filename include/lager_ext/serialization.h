@@ -40,6 +40,22 @@
 ///   0x13 = Mat3 (36 bytes, 9 floats)
 ///   0x14 = Mat4x3 (48 bytes, 12 floats)
 ///
+/// Compact format (BinaryFormat::Compact):
+///   The buffer starts with COMPACT_FORMAT_MARKER (0xC1, never a valid type tag),
+///   followed by the same tag layout with two changes:
+///   - counts and string lengths are unsigned LEB128 varints
+///   - int16/int32/int64 payloads are zigzag LEB128, uint16/uint32/uint64 plain LEB128
+///   Floats, math types, int8/uint8 and bool are unchanged. deserialize() detects
+///   the marker, so callers never need to know which format was used.
+///
+/// Dictionary format (BinaryFormat::Dictionary):
+///   DICTIONARY_FORMAT_MARKER (0xC2), a varint key count, then every distinct map
+///   key once (varint length + UTF-8 data) in first-seen order. The value tree
+///   follows in the compact encoding, except that each map key is written as the
+///   varint index of its dictionary entry. Table ids are usually unique and stay
+///   inline. Decoding materializes each dictionary key once and copies it into
+///   the maps that use it, so repeated keys are neither re-read nor re-validated.
+///
 /// Note: This header must be included separately from value.h if you need serialization.
 
 #pragma once
@@ -48,7 +64,11 @@
 #include "value.h"
 
 #include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace lager_ext {
@@ -58,12 +78,27 @@ namespace lager_ext {
 // ============================================================
 // Note: ByteBuffer is defined in value.h
 
+/// Wire format selector for serialize / serialize_to / serialized_size
+enum class BinaryFormat : uint8_t {
+    Standard,  ///< Fixed-width counts, lengths and integers
+    Compact,   ///< Marker byte + LEB128 counts/lengths and varint integers
+    Dictionary ///< Compact, with map keys interned in a per-buffer key dictionary
+};
+
+/// First byte of every compact-format buffer
+inline constexpr uint8_t COMPACT_FORMAT_MARKER = 0xC1;
+
+/// First byte of every dictionary-format buffer
+inline constexpr uint8_t DICTIONARY_FORMAT_MARKER = 0xC2;
+
 /// Serialize ImmerValue to binary buffer
 /// @param val The ImmerValue to serialize
+/// @param format Wire format (Compact is ~30-40% smaller for small maps with short keys;
+///               Dictionary additionally pays off when many maps share the same keys)
 /// @return Byte buffer containing serialized data
-LAGER_EXT_API ByteBuffer serialize(const ImmerValue& val);
+LAGER_EXT_API ByteBuffer serialize(const ImmerValue& val, BinaryFormat format = BinaryFormat::Standard);
 
-/// Deserialize ImmerValue from binary buffer
+/// Deserialize ImmerValue from binary buffer (any format, auto-detected)
 /// @param buffer The byte buffer to deserialize
 /// @return Reconstructed ImmerValue, or null ImmerValue on error
 /// @throws std::runtime_error on invalid data format
@@ -76,23 +111,100 @@ LAGER_EXT_API ImmerValue deserialize(const ByteBuffer& buffer);
 /// @note Useful for memory-mapped data or network buffers
 LAGER_EXT_API ImmerValue deserialize(const uint8_t* data, std::size_t size);
 
+// ============================================================
+// Streaming Deserialization
+// ============================================================
+
+/// Push-style incremental decoder for the binary format (any format, auto-detected)
+///
+/// Bytes can be fed in chunks split at any position (mid-tag, mid-number,
+/// mid-string); the decoder keeps its position in the tree between calls.
+/// Only the bytes of the token currently being read are buffered, so peak
+/// memory is the decoded tree itself rather than tree + whole input buffer.
+///
+/// Usage:
+/// @code
+///   StreamingDeserializer decoder;
+///   while (decoder.status() == StreamingDeserializer::Status::NeedMoreData && read_chunk(chunk))
+///       decoder.feed(chunk.data(), chunk.size());
+///   if (decoder.status() == StreamingDeserializer::Status::Complete)
+///       ImmerValue value = decoder.take_result();
+/// @endcode
+///
+/// With a subtree callback, each value completed at the configured depth is
+/// handed over as soon as its last byte arrives (e.g. every top-level entry
+/// of a scene map). Returning false from the callback drops the subtree from
+/// the final tree, so memory is bounded by the largest single subtree.
+class LAGER_EXT_API StreamingDeserializer {
+public:
+    enum class Status : uint8_t {
+        NeedMoreData, ///< Top-level value not finished yet
+        Complete,     ///< Top-level value decoded; see take_result()
+        Error         ///< Malformed input; see error()
+    };
+
+    /// Called for each value completed at the subtree depth.
+    /// @param path Location of the value relative to the root
+    /// @param value The decoded subtree
+    /// @return true to keep the subtree in the result, false to drop it
+    using SubtreeCallback = std::function<bool(PathView path, const ImmerValue& value)>;
+
+    StreamingDeserializer();
+    ~StreamingDeserializer();
+
+    StreamingDeserializer(const StreamingDeserializer&) = delete;
+    StreamingDeserializer& operator=(const StreamingDeserializer&) = delete;
+    StreamingDeserializer(StreamingDeserializer&&) noexcept;
+    StreamingDeserializer& operator=(StreamingDeserializer&&) noexcept;
+
+    /// Register a callback for values completed at `depth` (1 = children of the root)
+    void on_subtree(std::size_t depth, SubtreeCallback callback);
+
+    /// Feed the next chunk of input
+    /// @return Status after consuming the chunk. Bytes after the end of the
+    ///         top-level value are not consumed (see bytes_consumed()).
+    Status feed(const uint8_t* data, std::size_t size);
+    Status feed(const ByteBuffer& chunk) { return feed(chunk.data(), chunk.size()); }
+
+    [[nodiscard]] Status status() const noexcept;
+
+    /// Move the decoded value out (valid once status() == Complete)
+    [[nodiscard]] ImmerValue take_result();
+
+    /// Description of the failure when status() == Error
+    [[nodiscard]] const std::string& error() const noexcept;
+
+    /// Total bytes consumed across all feed() calls
+    [[nodiscard]] std::size_t bytes_consumed() const noexcept;
+
+    /// Discard all state and start decoding a new value (callbacks are kept)
+    void reset();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 // ============================================================
 // Serialization Utilities
 // ============================================================
 
 /// Get serialized size without actually serializing
 /// @param val The ImmerValue to measure
+/// @param format Wire format to measure for
 /// @return Number of bytes required for serialization
 /// @note Useful for pre-allocating buffers
-LAGER_EXT_API std::size_t serialized_size(const ImmerValue& val);
+LAGER_EXT_API std::size_t serialized_size(const ImmerValue& val, BinaryFormat format = BinaryFormat::Standard);
 
 /// Serialize to pre-allocated buffer
 /// @param val The ImmerValue to serialize
 /// @param buffer Pointer to output buffer
 /// @param buffer_size Size of output buffer
+/// @param format Wire format to write
 /// @return Number of bytes written
-/// @note Buffer must have at least serialized_size(val) bytes
-LAGER_EXT_API std::size_t serialize_to(const ImmerValue& val, uint8_t* buffer, std::size_t buffer_size);
+/// @note Buffer must have at least serialized_size(val, format) bytes
+LAGER_EXT_API std::size_t serialize_to(const ImmerValue& val, uint8_t* buffer, std::size_t buffer_size,
+                                       BinaryFormat format = BinaryFormat::Standard);
 
 // ============================================================
 // JSON Serialization
@@ -112,10 +224,79 @@ LAGER_EXT_API std::size_t serialize_to(const ImmerValue& val, uint8_t* buffer, s
 /// - Null, true, false are reserved keywords
 LAGER_EXT_API std::string to_json(const ImmerValue& val, bool compact = false);
 
+/// Append JSON for a ImmerValue to an existing string
+/// @param val The ImmerValue to convert
+/// @param out Destination string; output is appended, existing capacity is reused
+/// @param compact Same formatting as to_json(val, compact)
+///
+/// Reusing one string across calls makes repeated dumps allocation-free
+/// once the buffer has grown to the working size.
+LAGER_EXT_API void to_json(const ImmerValue& val, std::string& out, bool compact = false);
+
+/// Stream JSON for a ImmerValue to a C stdio stream
+/// @param val The ImmerValue to convert
+/// @param file Open, writable stream (not closed or flushed by this call)
+/// @param compact Same formatting as to_json(val, compact)
+/// @return true on success, false if any write failed
+///
+/// Output is staged in a fixed-size stack buffer, so memory use does not
+/// grow with the size of the value.
+LAGER_EXT_API bool to_json_file(const ImmerValue& val, std::FILE* file, bool compact = false);
+
+/// Stream JSON for a ImmerValue to a file descriptor
+/// @param val The ImmerValue to convert
+/// @param fd Open, writable file descriptor (POSIX fd, or CRT fd on Windows)
+/// @param compact Same formatting as to_json(val, compact)
+/// @return true on success, false if any write failed
+LAGER_EXT_API bool to_json_fd(const ImmerValue& val, int fd, bool compact = false);
+
 /// Parse JSON string to ImmerValue
 /// @param json_str The JSON string to parse
 /// @param error_out If provided, receives error message on failure
 /// @return Parsed ImmerValue, or null ImmerValue on parse error
 LAGER_EXT_API ImmerValue from_json(const std::string& json_str, std::string* error_out = nullptr);
 
+/// Error codes reported by parse_json
+enum class JsonError : uint8_t {
+    None = 0,
+    EmptyInput,          ///< Input is empty or whitespace only
+    UnexpectedEnd,       ///< Input ended inside a value
+    UnexpectedCharacter, ///< Character not valid at this point
+    UnterminatedString,  ///< String is missing its closing quote
+    InvalidString,       ///< Unescaped control character inside a string
+    InvalidEscape,       ///< Unknown escape or malformed \uXXXX
+    InvalidNumber,       ///< Malformed or out-of-range number
+    InvalidLiteral,      ///< Misspelled true / false / null
+    TrailingCharacters,  ///< Non-whitespace after the top-level value
+    DepthLimitExceeded,  ///< Containers nested deeper than the parser allows
+    InputTooLarge        ///< Input exceeds 4 GB
+};
+
+/// Result of parse_json: the parsed value, or an error code with its byte offset
+struct JsonParseResult {
+    ImmerValue value;
+    JsonError error = JsonError::None;
+    std::size_t offset = 0; ///< Byte offset of the error in the input
+
+    [[nodiscard]] bool ok() const noexcept { return error == JsonError::None; }
+    explicit operator bool() const noexcept { return ok(); }
+};
+
+/// Parse JSON with the high-throughput parser
+/// @param json The JSON text (does not need to be null-terminated)
+/// @return Parsed value, or an error code and offset on malformed input
+///
+/// Compared to from_json:
+/// - Structural characters are located with SIMD (AVX2 / SSE2, scalar fallback)
+///   before the tree is built, so whitespace and string bodies are skipped in bulk
+/// - Numbers are parsed with std::from_chars; integers map to int / int64_t and
+///   everything else to double, exactly as from_json does
+/// - Malformed input never throws; the error is returned in the result
+/// - Parsing is strict RFC 8259: trailing characters, unescaped control
+///   characters in strings and leading zeros are rejected
+LAGER_EXT_API JsonParseResult parse_json(std::string_view json);
+
+/// Human-readable description of a JsonError
+LAGER_EXT_API const char* json_error_message(JsonError error) noexcept;
+
 } // namespace lager_ext
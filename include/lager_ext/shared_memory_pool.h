@@ -10,27 +10,48 @@
 /// Architecture:
 /// @code
 ///     +-------------------------------------------------------------+
-///     |                   SharedMemoryPool                          |
+///     |             SharedMemoryPool, segment 0 ("name")            |
 ///     +-------------------------------------------------------------+
-///     | Header (512 bytes)                                          |
+///     | Header                                                      |
 ///     |   +-- magic, version                                        |
-///     |   +-- pool_size                                             |
-///     |   +-- free_head (atomic)                                    |
-///     |   +-- stats (allocations, deallocations)                    |
-///     |   +-- SPSC LIFO Cache (shared between Producer/Consumer)    |
+///     |   +-- pool_size, segment sizes                              |
+///     |   +-- deferred free stack head (atomic)                     |
+///     |   +-- stats (allocations, free bytes, free blocks)          |
+///     |   +-- TLSF index: bitmaps + free list heads per size class  |
 ///     +-------------------------------------------------------------+
 ///     | Block 0: [BlockHeader][User Data...][Padding]               |
 ///     | Block 1: [BlockHeader][User Data...][Padding]               |
 ///     | ...                                                         |
 ///     | Block N: [BlockHeader][User Data...][Padding]               |
 ///     +-------------------------------------------------------------+
+///
+///     +-------------------------------------------------------------+
+///     |       Chained segment k ("name_seg<k>"), added on demand    |
+///     +-------------------------------------------------------------+
+///     | SegmentHeader | Block | Block | ...                         |
+///     +-------------------------------------------------------------+
 /// @endcode
 ///
-/// SPSC Optimization:
-/// - Producer calls allocate(), Consumer calls deallocate()
-/// - Shared LIFO cache in shared memory allows O(1) block reuse
-/// - Consumer pushes freed blocks to cache head
-/// - Producer pops from cache tail, achieving near-100% cache hit rate
+/// Allocator (TLSF, two-level segregated fit):
+/// - Free blocks are binned by size class: power of two, then 16 linear steps
+/// - Two bitmaps locate the smallest fitting non-empty bin in O(1)
+/// - Every block header records its physical predecessor (boundary tag), so
+///   freed blocks merge with free neighbours in O(1) and the pool does not
+///   fragment into unusable slivers under mixed-size traffic
+///
+/// Addressing:
+/// - Offsets are 64-bit; internally a block is a 32-bit count of 64-byte
+///   granules whose top bits select the segment (up to 256 GB in total)
+/// - Block state lives in each block header, so there is no per-pool
+///   allocation bitmap and no limit on the number of live blocks
+/// - With max_pool_size above pool_size, allocate() chains a new segment
+///   when no free block fits; the other side maps it on first access
+///
+/// SPSC Pattern:
+/// - One side calls allocate(); any side may call deallocate()
+/// - deallocate() only pushes the block onto a lock-free stack in shared memory
+/// - allocate() takes the whole stack, merges those blocks into the bins and
+///   then allocates, so the bins are only ever touched by one process
 ///
 /// Usage:
 /// @code
@@ -46,7 +67,7 @@
 ///     auto pool = SharedMemoryPool<>::open("MyPool");
 ///     auto span = pool->get(offset, size);
 ///     process_data(span);
-///     pool->deallocate(offset);  // Returns to shared LIFO cache
+///     pool->deallocate(offset);  // Merged back into the bins by the next allocate()
 /// @endcode
 
 #pragma once
@@ -74,11 +95,11 @@ inline constexpr size_t DEFAULT_POOL_SIZE = 1024 * 1024;
 /// Minimum block size (64 bytes, cache line aligned)
 inline constexpr size_t MIN_BLOCK_SIZE = 64;
 
-/// Maximum number of blocks in the pool
-inline constexpr size_t MAX_POOL_BLOCKS = 1024;
+/// Maximum number of segments a pool can chain (including the first)
+inline constexpr size_t MAX_POOL_SEGMENTS = 16;
 
-/// SPSC LIFO cache size (in shared memory, for cross-process reuse)
-inline constexpr size_t SPSC_LIFO_CACHE_SIZE = 8;
+/// Maximum size of one segment (16 GB minus one block)
+inline constexpr uint64_t MAX_SEGMENT_SIZE = (uint64_t{16} << 30) - MIN_BLOCK_SIZE;
 
 //=============================================================================
 // SharedMemoryPool
@@ -92,14 +113,14 @@ inline constexpr size_t SPSC_LIFO_CACHE_SIZE = 8;
 /// - Consumer (opener) reads data and deallocates blocks
 ///
 /// Performance Features:
-/// - Shared LIFO cache: Blocks freed by Consumer are immediately available to Producer
-/// - O(1) allocation: Near 100% cache hit rate for typical IPC patterns
+/// - O(1) allocate and deallocate: TLSF size-class bins, no free list walks
+/// - Coalescing: adjacent free blocks are merged, keeping large blocks available
 /// - Cache-line aligned: All structures aligned to 64 bytes to prevent false sharing
 /// - Lock-free: Uses atomic operations for SPSC safety without mutexes
 ///
 /// Memory Management:
-/// - Uses first-fit free list as fallback when LIFO cache is empty
 /// - Blocks are 64-byte aligned for optimal cache performance
+/// - fragmentation_stats() reports how scattered the free space is
 class SharedMemoryPool {
 public:
     //=========================================================================
@@ -112,11 +133,11 @@ public:
     /// The block remains valid until deallocate() is called.
     class Block {
     public:
-        /// Get the offset of this block (for IPC transfer)
-        [[nodiscard]] uint32_t offset() const noexcept { return offset_; }
+        /// Get the offset of this block (for IPC transfer, always a multiple of MIN_BLOCK_SIZE)
+        [[nodiscard]] uint64_t offset() const noexcept { return offset_; }
 
         /// Get the usable size of this block
-        [[nodiscard]] uint32_t size() const noexcept { return size_; }
+        [[nodiscard]] size_t size() const noexcept { return size_; }
 
         /// Get writable pointer to data
         [[nodiscard]] uint8_t* data() noexcept { return data_; }
@@ -133,26 +154,44 @@ public:
 
     private:
         friend class SharedMemoryPool;
-        Block(uint32_t offset, uint32_t size, uint8_t* data) noexcept
+        Block(uint64_t offset, size_t size, uint8_t* data) noexcept
             : offset_(offset), size_(size), data_(data) {}
         Block() noexcept : offset_(0), size_(0), data_(nullptr) {}
 
-        uint32_t offset_;
-        uint32_t size_;
+        uint64_t offset_;
+        size_t size_;
         uint8_t* data_;
     };
 
+    //=========================================================================
+    // Statistics
+    //=========================================================================
+
+    /// @brief Snapshot of the pool's free space
+    ///
+    /// Exact on the allocating side; elsewhere a racy but bounded snapshot.
+    struct FragmentationStats {
+        size_t free_bytes = 0;          ///< Bytes in free blocks (headers included)
+        size_t free_blocks = 0;         ///< Number of free blocks
+        size_t largest_free_block = 0;  ///< Largest size allocate() can currently satisfy
+        size_t deferred_bytes = 0;      ///< Deallocated, merged on the next allocate()
+        double fragmentation = 0;       ///< 1 - largest / free: 0 = one free block, near 1 = slivers
+    };
+
     //=========================================================================
     // Factory Methods
     //=========================================================================
 
     /// Create a new shared memory pool (Producer side)
     /// @param name Unique pool name
-    /// @param pool_size Total size of the pool in bytes
+    /// @param pool_size Size of the first segment in bytes (at most MAX_SEGMENT_SIZE)
+    /// @param max_pool_size Total size the pool may grow to by chaining segments
+    ///        of pool_size (or larger, for bigger requests); 0 = fixed size
     /// @return Pool instance, nullptr on failure
     static std::unique_ptr<SharedMemoryPool> create(
         std::string_view name,
-        size_t pool_size = DEFAULT_POOL_SIZE);
+        size_t pool_size = DEFAULT_POOL_SIZE,
+        size_t max_pool_size = 0);
 
     /// Open an existing shared memory pool (Consumer side)
     /// @param name Pool name (must match creator)
@@ -169,18 +208,21 @@ public:
     /// Allocate a block from the pool
     /// @param size Required size in bytes
     /// @return Block handle, or empty Block if allocation failed
-    /// @note First checks SPSC LIFO cache for O(1) reuse of freed blocks
-    /// @note Falls back to free list if cache is empty
+    /// @note O(1): merges pending deallocations, then takes the smallest fitting size class
+    /// @note Chains a new segment if nothing fits and max_pool_size allows
+    /// @note Only one side (process/thread) may allocate
     [[nodiscard]] Block allocate(size_t size);
 
     //=========================================================================
-    // Deallocation (Consumer side)  
+    // Deallocation (Any side)
     //=========================================================================
 
     /// Deallocate a block by offset
     /// @param offset Block offset (from Block::offset())
-    /// @note Block is pushed to shared SPSC LIFO cache for fast reuse by Producer
-    void deallocate(uint32_t offset);
+    /// @note Lock-free push onto the shared deferred stack; the allocating side
+    ///       merges the block with its free neighbours on its next allocate()
+    /// @note Stale offsets and double frees are ignored
+    void deallocate(uint64_t offset);
 
     //=========================================================================
     // Data Access
@@ -190,8 +232,9 @@ public:
     /// @param offset Block offset
     /// @param size Expected size (for validation)
     /// @return Span of the block data, empty if invalid
-    [[nodiscard]] std::span<uint8_t> get(uint32_t offset, uint32_t size);
-    [[nodiscard]] std::span<const uint8_t> get(uint32_t offset, uint32_t size) const;
+    /// @note Maps a chained segment on first access from this side
+    [[nodiscard]] std::span<uint8_t> get(uint64_t offset, size_t size);
+    [[nodiscard]] std::span<const uint8_t> get(uint64_t offset, size_t size) const;
 
     //=========================================================================
     // Properties
@@ -203,19 +246,27 @@ public:
     /// Check if this is the creator (Producer) side
     [[nodiscard]] bool is_creator() const;
 
-    /// Get total pool size
+    /// Get total pool size (all segments)
     [[nodiscard]] size_t pool_size() const;
 
-    /// Get approximate free space (may not be accurate due to fragmentation)
+    /// Get number of segments (1 until the pool grows)
+    [[nodiscard]] size_t segment_count() const;
+
+    /// Get total free space, including deallocations not merged yet
+    /// @note A single allocation may be limited by fragmentation; see fragmentation_stats()
     [[nodiscard]] size_t free_space() const;
 
+    /// Get free space statistics (largest free block, fragmentation)
+    [[nodiscard]] FragmentationStats fragmentation_stats() const;
+
     /// Get number of allocated blocks
     [[nodiscard]] size_t allocated_count() const;
 
-    /// Get SPSC LIFO cache hit statistics (for performance tuning)
+    /// Get allocations that reused a whole free block without splitting it
+    /// (per process, for performance tuning)
     [[nodiscard]] size_t cache_hits() const;
 
-    /// Get SPSC LIFO cache miss statistics (for performance tuning)
+    /// Get allocations that had to split a larger free block (per process)
     [[nodiscard]] size_t cache_misses() const;
 
     //=========================================================================
@@ -11,6 +11,10 @@
 /// - Main process owns the lager store and maintains full immer structure sharing
 /// - Child processes receive serialized state updates via shared memory
 /// - Supports both full state and incremental (diff) updates
+/// - Updates are kept in an N-slot versioned ring guarded by per-slot seqlocks,
+///   so a slow subscriber replays every diff it has not seen yet; only a
+///   subscriber that falls more than N versions behind resyncs from the
+///   periodically refreshed full snapshot
 ///
 /// Thread Safety:
 /// - StatePublisher is NOT thread-safe (use from single thread)
@@ -59,6 +63,11 @@ struct SharedMemoryConfig {
     // Performance tuning
     std::chrono::milliseconds poll_interval{10}; // For subscriber polling
     std::size_t max_history = 100;               // Max diff history to keep
+
+    // Update ring (publisher only; subscribers read the layout from shared memory)
+    std::size_t ring_slots = 8;        // Number of versioned update slots (ring depth)
+    std::size_t slot_size = 0;         // Payload bytes per slot (0 = half of size split across slots)
+    std::size_t snapshot_interval = 0; // Refresh full snapshot every N diffs (0 = ring_slots / 2)
 };
 
 // ============================================================
@@ -86,7 +95,9 @@ public:
 
     // Publish incremental diff (recommended for updates)
     // Returns true if diff was published, false if full state was published
-    // (full state is published when diff would be larger)
+    // (full state is published when diff would be larger) or if nothing could
+    // be published because the state outgrew the snapshot area (see
+    // Stats::rejected_publishes)
     bool publish_diff(const ImmerValue& old_state, const ImmerValue& new_state);
 
     // Force publish full state even if diff might be smaller
@@ -102,6 +113,8 @@ public:
         uint64_t diff_publishes = 0;
         std::size_t total_bytes_written = 0;
         std::size_t last_update_size = 0;
+        uint64_t snapshot_writes = 0;    // Full snapshots written (full publishes + periodic refreshes)
+        uint64_t rejected_publishes = 0; // Updates dropped because the state does not fit the snapshot area
     };
     [[nodiscard]] Stats stats() const noexcept;
 
@@ -182,7 +195,9 @@ public:
         uint64_t full_updates = 0;
         uint64_t diff_updates = 0;
         std::size_t total_bytes_read = 0;
-        uint64_t missed_updates = 0; // Updates that were overwritten before reading
+        uint64_t missed_updates = 0;     // Updates skipped by resyncing from a snapshot
+        uint64_t snapshot_fallbacks = 0; // Times the subscriber fell behind the ring depth
+        uint64_t torn_reads = 0;         // Slot reads invalidated by a concurrent overwrite
     };
     [[nodiscard]] Stats stats() const noexcept;
 
@@ -219,14 +234,24 @@ struct DiffResult {
 // ============================================================
 
 // Collect diff between two Values (returns structured diff)
-LAGER_EXT_API DiffResult collect_diff(const ImmerValue& old_val, const ImmerValue& new_val);
+// num_threads > 1 (or 0 = hardware concurrency) splits large containers across threads; same result
+LAGER_EXT_API DiffResult collect_diff(const ImmerValue& old_val, const ImmerValue& new_val,
+                                      std::size_t num_threads = 1);
 
 // Encode diff changes to binary format for transmission
 LAGER_EXT_API ByteBuffer encode_diff(const DiffResult& diff);
 
+// Diff two Values and encode the result directly, without building a DiffResult
+// Same format as encode_diff(collect_diff(old_val, new_val)); returns an empty buffer if nothing changed
+LAGER_EXT_API ByteBuffer encode_diff(const ImmerValue& old_val, const ImmerValue& new_val);
+
 // Decode diff changes from binary format
 LAGER_EXT_API DiffResult decode_diff(const ByteBuffer& data);
 
+// Decode diff changes directly from a raw byte span (no intermediate copy)
+// All lengths are bounds-checked against size; throws std::runtime_error on malformed data
+LAGER_EXT_API DiffResult decode_diff(const uint8_t* data, std::size_t size);
+
 // Apply diff to a ImmerValue, returning the new ImmerValue
 LAGER_EXT_API ImmerValue apply_diff(const ImmerValue& base, const DiffResult& diff);
 
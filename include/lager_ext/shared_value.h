@@ -41,6 +41,7 @@
 // The implementation is in source/shared_value_impl.cpp to prevent
 // boost headers from polluting user's include path.
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -165,6 +166,27 @@ public:
     /// @brief Get current local cursor value (for debugging/diagnostics)
     size_t local_cursor() const;
 
+    /// @brief Create a sub-arena for allocating from another thread (parallel construction)
+    ///
+    /// A sub-arena shares this region's mapping and can be installed as the
+    /// current region of one worker thread. It bump-allocates from chunks of
+    /// `chunk_size` bytes claimed with a fetch_add on `heap_cursor`, a heap
+    /// offset shared by all sub-arenas of one build, so workers never contend
+    /// on individual allocations.
+    ///
+    /// Protocol: sync_allocation_cursor(), initialize `heap_cursor` from
+    /// header()->heap_used, run the workers (this region must not allocate
+    /// meanwhile), then adopt_allocation_cursor(heap_cursor).
+    ///
+    /// @note The sub-arena must not outlive this region
+    SharedMemoryRegion make_sub_arena(std::atomic<size_t>& heap_cursor, size_t chunk_size);
+
+    /// @brief Continue bump allocation from `heap_cursor` (end of a parallel build)
+    void adopt_allocation_cursor(size_t heap_cursor);
+
+    /// @brief Check if this is a sub-arena created by make_sub_arena()
+    bool is_sub_arena() const;
+
 private:
     struct Impl; // Forward declaration - hides boost dependency
     std::unique_ptr<Impl> impl_;
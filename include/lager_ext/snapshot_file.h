@@ -0,0 +1,112 @@
+// snapshot_file.h - Memory-mapped ImmerValue snapshot files
+
+/// @file snapshot_file.h
+/// @brief Save an ImmerValue to disk and map it back without reading or parsing it up front.
+///
+/// A snapshot file is a 32-byte header followed by a serialized payload in any
+/// binary format. MappedSnapshot maps the file read-only; nothing is copied
+/// until a value is materialized. With the indexed format (the default) a
+/// LazyValueView reads single properties straight from the mapping, so opening
+/// a large scene costs a few page faults instead of a full read + parse.
+///
+/// @code
+///   save_snapshot("scene.snap", scene);
+///
+///   MappedSnapshot snap;
+///   if (snap.open("scene.snap", SnapshotOpenMode::View)) {
+///       ImmerValue pos = snap.view().get_at_path({"entities", "e42", "position"});
+///   }
+///
+///   ImmerValue everything = load_snapshot("scene.snap");   // Verified + fully decoded
+/// @endcode
+///
+/// Header (little-endian):
+///   u64 magic "LXSNAP\0\0", u32 version, u8 SnapshotFormat, 3 reserved bytes,
+///   u64 payload size, u64 XXH64 checksum of the payload (seed 0)
+
+#pragma once
+
+#include <lager_ext/api.h>
+#include <lager_ext/indexed_snapshot.h>
+#include <lager_ext/value.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace lager_ext {
+
+/// Payload encoding of a snapshot file
+enum class SnapshotFormat : uint8_t {
+    Standard,   ///< serialize(BinaryFormat::Standard)
+    Compact,    ///< serialize(BinaryFormat::Compact)
+    Dictionary, ///< serialize(BinaryFormat::Dictionary)
+    Indexed     ///< serialize_indexed(): random access through LazyValueView
+};
+
+/// How much MappedSnapshot::open checks before returning
+enum class SnapshotOpenMode : uint8_t {
+    Verified, ///< Validate the header and checksum the whole payload (touches every page)
+    View      ///< Validate the header only; pages fault in as views touch them
+};
+
+/// Write a snapshot file. The file is written under a temporary name and
+/// renamed into place, so readers never see a partially written snapshot.
+/// @param error_out If non-null, receives an error message on failure
+/// @return true on success
+LAGER_EXT_API bool save_snapshot(const std::string& path, const ImmerValue& val,
+                                 SnapshotFormat format = SnapshotFormat::Indexed, std::string* error_out = nullptr);
+
+/// Map, verify and fully decode a snapshot file
+/// @param error_out If non-null, receives an error message on failure
+/// @return The stored value, or null on failure
+[[nodiscard]] LAGER_EXT_API ImmerValue load_snapshot(const std::string& path, std::string* error_out = nullptr);
+
+// ============================================================
+// MappedSnapshot - Read-only memory mapping of a snapshot file
+//
+// The mapping stays valid until close() or destruction; views and
+// pointers obtained from it must not outlive it.
+// ============================================================
+
+class LAGER_EXT_API MappedSnapshot {
+public:
+    MappedSnapshot();
+    ~MappedSnapshot();
+
+    MappedSnapshot(MappedSnapshot&&) noexcept;
+    MappedSnapshot& operator=(MappedSnapshot&&) noexcept;
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    /// Map a snapshot file read-only
+    /// @return false on I/O error, bad header or checksum mismatch (see last_error())
+    bool open(const std::string& path, SnapshotOpenMode mode = SnapshotOpenMode::Verified);
+
+    /// Unmap the file
+    void close();
+
+    [[nodiscard]] bool is_open() const noexcept;
+    [[nodiscard]] const std::string& last_error() const noexcept;
+    [[nodiscard]] SnapshotFormat format() const noexcept;
+
+    /// Serialized payload inside the mapping
+    [[nodiscard]] const uint8_t* data() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    /// Checksum the payload now (e.g. later, for a snapshot opened in View mode)
+    [[nodiscard]] bool verify() const;
+
+    /// Root view of an indexed snapshot; empty view for other formats or when closed
+    [[nodiscard]] LazyValueView view() const;
+
+    /// Decode the whole payload (any format); null when closed
+    /// @throws std::runtime_error if the payload is corrupt (only possible in View mode)
+    [[nodiscard]] ImmerValue materialize() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace lager_ext
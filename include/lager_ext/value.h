@@ -40,6 +40,7 @@
 #include <immer/vector_transient.hpp>
 
 #include <array>           // for Vec2, Vec3, Vec4, Mat3, Mat4x3
+#include <atomic>          // for hashed_refcount_policy
 #include <compare>         // for std::strong_ordering (C++20)
 #include <concepts>        // for C++20 Concepts (C++20)
 #include <cstdint>
@@ -275,19 +276,34 @@ using ValueTable = immer::table<TableEntry, immer::table_key_fn, TransparentStri
 // These wrap the raw containers in immer::box for:
 // - O(1) identity comparison in immer::diff
 // - Efficient sharing across ImmerValue instances
+// - A cached content hash per container (see content_hash())
 // ============================================================
 
+/// Refcount policy of the boxed containers. immer::box keeps the refcount in
+/// the same heap cell as the container, so the cell also carries the
+/// container's content hash, filled in on first use. Containers are
+/// immutable, so a hash never goes stale.
+struct hashed_refcount_policy : immer::default_refcount_policy {
+    using immer::default_refcount_policy::default_refcount_policy;
+
+    /// 0 = not computed yet. Atomic so that parallel readers may fill it in.
+    mutable std::atomic<std::size_t> content_hash{0};
+};
+
+using boxed_container_policy =
+    immer::memory_policy<immer::default_heap_policy, hashed_refcount_policy, immer::default_lock_policy>;
+
 /// Boxed map container
-using BoxedValueMap = immer::box<ValueMap>;
+using BoxedValueMap = immer::box<ValueMap, boxed_container_policy>;
 
 /// Boxed vector container
-using BoxedValueVector = immer::box<ValueVector>;
+using BoxedValueVector = immer::box<ValueVector, boxed_container_policy>;
 
 /// Boxed array container
-using BoxedValueArray = immer::box<ValueArray>;
+using BoxedValueArray = immer::box<ValueArray, boxed_container_policy>;
 
 /// Boxed table container
-using BoxedValueTable = immer::box<ValueTable>;
+using BoxedValueTable = immer::box<ValueTable, boxed_container_policy>;
 
 // Boxed matrix types (reduces variant size from ~72 to ~40 bytes)
 using BoxedMat3 = immer::box<Mat3>;
@@ -755,8 +771,44 @@ static_assert(sizeof(ImmerValue) == size_traits<ImmerValue>::value);
 // Note: std::variant supports <=> in C++20, enabling lexicographic comparison
 // ============================================================
 
+// ============================================================
+// Content hash
+//
+// A structural hash: equal values have equal hashes, whatever their
+// storage (e.g. a tree and its deserialized copy). Each boxed container
+// caches its hash, so hashing a tree a second time - or hashing a new tree
+// that shares subtrees with an old one - only visits the new containers.
+// ============================================================
+
+/// Content hash of a value; computes and caches the hashes of all containers
+/// in it that do not have one yet
+[[nodiscard]] LAGER_EXT_API std::size_t content_hash(const ImmerValue& val);
+
+/// The cached content hash of a container, without computing it.
+/// 0 if not computed yet, and always 0 for scalars.
+[[nodiscard]] inline std::size_t cached_content_hash(const ImmerValue& val) noexcept {
+    auto cached = [](const auto& box) { return box.impl()->content_hash.load(std::memory_order_relaxed); };
+    if (auto* m = std::get_if<BoxedValueMap>(&val.data))
+        return cached(*m);
+    if (auto* v = std::get_if<BoxedValueVector>(&val.data))
+        return cached(*v);
+    if (auto* a = std::get_if<BoxedValueArray>(&val.data))
+        return cached(*a);
+    if (auto* t = std::get_if<BoxedValueTable>(&val.data))
+        return cached(*t);
+    return 0;
+}
+
 /// Equality comparison for ImmerValue
+/// Two containers whose hashes are both cached and differ are unequal without
+/// opening them; otherwise this is a full comparison (hashes never decide equality).
 inline bool operator==(const ImmerValue& a, const ImmerValue& b) {
+    if (const std::size_t hash_a = cached_content_hash(a)) {
+        const std::size_t hash_b = cached_content_hash(b);
+        if (hash_b != 0 && hash_a != hash_b) {
+            return false;
+        }
+    }
     return a.data == b.data;
 }
 
@@ -837,3 +889,9 @@ LAGER_EXT_API void print_value(const ImmerValue& val, const std::string& prefix
 LAGER_EXT_API ImmerValue create_sample_data();
 
 } // namespace lager_ext
+
+/// Hashing by content, for unordered containers of values (e.g. deduplication)
+template <>
+struct std::hash<lager_ext::ImmerValue> {
+    std::size_t operator()(const lager_ext::ImmerValue& val) const { return lager_ext::content_hash(val); }
+};
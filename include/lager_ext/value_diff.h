@@ -5,6 +5,7 @@
 #include <lager_ext/api.h>
 #include <lager_ext/value.h>
 
+#include <cstddef>
 #include <optional>
 #include <vector>
 
@@ -154,6 +155,72 @@ struct DiffNodeView {
     [[nodiscard]] const ImmerValue& value() const { return (type == DiffEntry::Type::Remove) ? get_old() : get_new(); }
 };
 
+// ============================================================
+// DiffSink - Output side of the diff traversal
+//
+// diff_values() is the one tree-diff walk in the library; DiffEntryCollector,
+// DiffValueCollector, collect_diff() and encode_diff() are sinks on top of it.
+// The walk only opens what the two values do not share:
+//   - boxed containers that share storage are skipped without being opened
+//   - maps and tables go through immer::diff, skipping shared HAMT nodes
+//   - vectors skip RRB subtrees both sides share; arrays compare elementwise
+//
+// Paths are views into the walker's stack and are only valid during the
+// call; copy them (Path{path}) to keep them.
+// ============================================================
+
+class LAGER_EXT_API DiffSink {
+public:
+    virtual ~DiffSink() = default;
+
+    /// A value exists only in the new tree
+    virtual void on_add(PathView path, const ImmerValue& value) = 0;
+
+    /// A value exists only in the old tree
+    virtual void on_remove(PathView path, const ImmerValue& value) = 0;
+
+    /// A value differs between the trees (different type, or different leaf)
+    virtual void on_change(PathView path, const ImmerValue& old_value, const ImmerValue& new_value) = 0;
+
+    /// The walk descends into the container at path, and leaves it again.
+    /// Every callback in between has path as its prefix. Containers that
+    /// turn out to be equal still get a matching enter/leave pair.
+    virtual void enter(PathView /*path*/) {}
+    virtual void leave(PathView /*path*/) {}
+};
+
+/// How diff_values() walks and reports
+struct DiffOptions {
+    /// false: a container that differs is reported as one change, without descending into it
+    bool recursive = true;
+
+    /// true: containers added or removed as a whole are reported leaf by leaf
+    /// (null leaves are skipped, empty containers are reported as themselves).
+    /// Only applies in recursive mode.
+    bool expand_subtrees = true;
+
+    /// Threads for large trees (0 = hardware concurrency, 1 = serial).
+    /// Containers with at least PARALLEL_DIFF_MIN_ELEMENTS children are split
+    /// across the threads; the sink is still called on the calling thread
+    /// only, with the same callbacks in the same order as a serial walk.
+    std::size_t num_threads = 1;
+
+    /// true: containers with equal content hashes (see content_hash()) are
+    /// taken as equal and skipped, even when they share no storage - e.g. a
+    /// tree and its deserialized copy. The first diff of a fresh tree hashes
+    /// it once; later diffs reuse the hashes cached in its containers.
+    /// Hashes are 64-bit: a collision (odds ~2^-64 per pair) would hide a change.
+    bool prune_by_hash = false;
+};
+
+/// Containers with fewer children than this are diffed serially, even when
+/// DiffOptions::num_threads asks for more threads
+inline constexpr std::size_t PARALLEL_DIFF_MIN_ELEMENTS = 4096;
+
+/// Diff two values and report every difference to sink, in traversal order
+LAGER_EXT_API void diff_values(const ImmerValue& old_val, const ImmerValue& new_val, DiffSink& sink,
+                               const DiffOptions& options = {});
+
 // ============================================================
 // DiffEntryCollector - Collects diff as a flat list of DiffEntry
 //
@@ -166,24 +233,9 @@ private:
     std::vector<DiffEntry> diffs_;
     bool recursive_ = true;
 
-    // OPTIMIZATION: Path stack for zero-allocation path building
-    mutable std::vector<PathElement> path_stack_;
-
-    // Optimized methods using path stack (no path copying)
-    void diff_value_optimized(const ImmerValue& old_val, const ImmerValue& new_val, std::size_t path_depth);
-    void diff_map_optimized(const ValueMap& old_map, const ValueMap& new_map, std::size_t path_depth);
-    void diff_vector_optimized(const ValueVector& old_vec, const ValueVector& new_vec, std::size_t path_depth);
-    void collect_entries_optimized(const ImmerValue& val, std::size_t path_depth, bool is_add);
-    void collect_removed_optimized(const ImmerValue& val, std::size_t path_depth);
-    void collect_added_optimized(const ImmerValue& val, std::size_t path_depth);
-
-    // Helper: create PathView from current path stack
-    [[nodiscard]] PathView current_path_view(std::size_t depth) const noexcept {
-        return PathView{path_stack_.data(), depth};
-    }
-
 public:
-    void diff(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive = true);
+    /// @param num_threads See DiffOptions::num_threads; the entries come out in the same order either way
+    void diff(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive = true, std::size_t num_threads = 1);
     [[nodiscard]] const std::vector<DiffEntry>& get_diffs() const;
     void clear();
     [[nodiscard]] bool has_changes() const;
@@ -237,7 +289,9 @@ public:
 //       "_old": <old value>,    // present for "remove" and "change"
 //       "_new": <new value>     // present for "add" and "change"
 //     }
-//   - Intermediate nodes mirror the original structure (map/vector)
+//   - Intermediate nodes mirror the original structure (map/vector/table/array),
+//     keyed by map key, table id or index string
+//   - Containers added or removed as a whole are one leaf node
 // ============================================================
 
 class LAGER_EXT_API DiffValueCollector {
@@ -246,25 +300,6 @@ private:
     bool has_changes_ = false;
     bool recursive_ = true;
 
-    // Core diff functions that return the diff subtree for that node
-    ImmerValue diff_value_impl(const ImmerValue& old_val, const ImmerValue& new_val, bool& changed);
-    ImmerValue diff_value_impl_box(const ValueBox& old_box, const ValueBox& new_box, bool& changed);
-    ImmerValue diff_map_impl(const ValueMap& old_map, const ValueMap& new_map, bool& changed);
-    ImmerValue diff_vector_impl(const ValueVector& old_vec, const ValueVector& new_vec, bool& changed);
-
-    // Collect all entries under a container (for add/remove of entire subtree)
-    ImmerValue collect_entries(const ImmerValue& val, DiffEntry::Type type);
-    ImmerValue collect_entries_box(const ValueBox& val_box, DiffEntry::Type type);
-
-    // Create a leaf diff node using ValueBox directly (zero-copy for referenced values)
-    // Preferred when we have access to the original ValueBox from container traversal
-    static ImmerValue make_diff_node(DiffEntry::Type type, const ValueBox& val_box);
-    static ImmerValue make_diff_node(DiffEntry::Type type, const ValueBox& old_box, const ValueBox& new_box);
-
-    // Convenience overloads for ImmerValue& (creates temporary ValueBox)
-    static ImmerValue make_diff_node(DiffEntry::Type type, const ImmerValue& val);
-    static ImmerValue make_diff_node(DiffEntry::Type type, const ImmerValue& old_val, const ImmerValue& new_val);
-
 public:
     DiffValueCollector() = default;
 
@@ -305,14 +340,11 @@ public:
     void print() const;
 };
 
+/// Check whether two values differ, stopping at the first difference
+/// Runs diff_values(), so shared storage, HAMT nodes and RRB subtrees are skipped
+/// the same way. Non-recursive: containers whose storage differs count as different.
 [[nodiscard]] LAGER_EXT_API bool has_any_difference(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive = true);
 
-namespace detail {
-[[nodiscard]] bool values_differ(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive);
-[[nodiscard]] bool maps_differ(const ValueMap& old_map, const ValueMap& new_map, bool recursive);
-[[nodiscard]] bool vectors_differ(const ValueVector& old_vec, const ValueVector& new_vec, bool recursive);
-} // namespace detail
-
 /// Convenience function to compute diff as a ImmerValue tree (uses DiffValueCollector)
 [[nodiscard]] LAGER_EXT_API ImmerValue diff_as_value(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive = true);
 
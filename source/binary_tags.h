@@ -0,0 +1,41 @@
+// binary_tags.h - Type tags of the binary serialization format (internal)
+//
+// value.cpp (standard, compact and dictionary formats) and indexed_snapshot.cpp
+// (indexed format) both read and write these tags, so they live in one place.
+
+#pragma once
+
+#include <cstdint>
+
+namespace lager_ext::detail {
+
+enum class TypeTag : uint8_t {
+    Null = 0x00,
+    Int32 = 0x01, // int32_t (renamed from Int for clarity)
+    Float = 0x02,
+    Double = 0x03,
+    Bool = 0x04,
+    String = 0x05,
+    Map = 0x06,
+    Vector = 0x07,
+    Array = 0x08,
+    Table = 0x09,
+    Int64 = 0x0A, // int64_t
+    // New integer types (0x0B - 0x0F)
+    Int8 = 0x0B,   // int8_t
+    Int16 = 0x0C,  // int16_t
+    UInt8 = 0x0D,  // uint8_t
+    UInt16 = 0x0E, // uint16_t
+    UInt32 = 0x0F, // uint32_t
+    // Math types (0x10 - 0x15)
+    Vec2 = 0x10,
+    Vec3 = 0x11,
+    Vec4 = 0x12,
+    Mat3 = 0x13,
+    Mat4x3 = 0x14,
+    Mat4 = 0x15, // 4x4 matrix
+    // Extended integer types (0x16)
+    UInt64 = 0x16, // uint64_t
+};
+
+} // namespace lager_ext::detail
@@ -0,0 +1,135 @@
+// diff_walk.h - Shared pieces of the structural diff walk (internal)
+//
+// value_diff.cpp (diff_values) and path_watcher.cpp (wildcard levels) both
+// compare two versions of a container by storage before opening it, so the
+// comparator and the RRB vector walk live in one place.
+
+#pragma once
+
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <variant>
+
+namespace lager_ext::detail {
+
+/// Cheap "unchanged" test for immer::diff: two values count as the same only
+/// if they are equal scalars or share their box. Anything else is handed to
+/// changed(), and the caller decides whether it really differs.
+/// (immer::diff's default std::equal_to deep-compares every retained entry.)
+struct SameStorage {
+    bool operator()(const ImmerValue& a, const ImmerValue& b) const noexcept {
+        if (a.data.index() != b.data.index()) {
+            return false;
+        }
+        return std::visit(
+            [&b](const auto& lhs) -> bool {
+                using T = std::decay_t<decltype(lhs)>;
+                const T& rhs = *std::get_if<T>(&b.data);
+                if constexpr (std::is_same_v<T, std::monostate>) {
+                    return true;
+                } else if constexpr (requires { lhs.impl(); }) {
+                    return lhs.impl() == rhs.impl();
+                } else {
+                    return lhs == rhs;
+                }
+            },
+            a.data);
+    }
+
+    bool operator()(const ValueMap::value_type& a, const ValueMap::value_type& b) const noexcept {
+        return (*this)(a.second, b.second);
+    }
+
+    bool operator()(const TableEntry& a, const TableEntry& b) const noexcept {
+        return a.value.impl() == b.value.impl() || (*this)(*a.value, *b.value);
+    }
+};
+
+// ============================================================
+// RRB vector walk
+// ============================================================
+
+using vector_node = std::decay_t<decltype(*ValueVector{}.impl().root)>;
+inline constexpr auto VECTOR_B = vector_node::bits;
+inline constexpr auto VECTOR_BL = vector_node::bits_leaf;
+
+struct AlignedRoots {
+    const vector_node* old_root;
+    const vector_node* new_root;
+    unsigned shift;
+};
+
+/// Regular RRB trees place index i at the same position in both trees, and a
+/// tree that grew taller keeps the old root as its leftmost child: step down
+/// the taller tree until the heights match
+inline AlignedRoots aligned_roots(const ValueVector& old_vec, const ValueVector& new_vec) {
+    const auto& old_tree = old_vec.impl();
+    const auto& new_tree = new_vec.impl();
+    const vector_node* old_root = old_tree.root;
+    const vector_node* new_root = new_tree.root;
+    const auto shift = std::min(old_tree.shift, new_tree.shift);
+    for (auto s = old_tree.shift; s > shift; s -= VECTOR_B) {
+        old_root = const_cast<vector_node*>(old_root)->inner()[0];
+    }
+    for (auto s = new_tree.shift; s > shift; s -= VECTOR_B) {
+        new_root = const_cast<vector_node*>(new_root)->inner()[0];
+    }
+    return {old_root, new_root, static_cast<unsigned>(shift)};
+}
+
+/// Call fn(index, old_elem, new_elem) for indices [first, end) under two inner
+/// nodes at the same shift, skipping every subtree both trees share
+template <typename Fn>
+void for_each_unshared_element(const vector_node* old_node, const vector_node* new_node, unsigned shift,
+                               std::size_t first, std::size_t end, Fn&& fn) {
+    if (old_node == new_node) {
+        return; // Shared subtree
+    }
+    const std::size_t child_span = std::size_t{1} << shift;
+    auto** old_children = const_cast<vector_node*>(old_node)->inner();
+    auto** new_children = const_cast<vector_node*>(new_node)->inner();
+    for (std::size_t c = 0; c < (std::size_t{1} << VECTOR_B) && first + c * child_span < end; ++c) {
+        const vector_node* old_child = old_children[c];
+        const vector_node* new_child = new_children[c];
+        if (old_child == new_child) {
+            continue;
+        }
+        const std::size_t child_first = first + c * child_span;
+        if (shift == VECTOR_BL) {
+            // Children are leaves
+            const ImmerValue* old_elems = const_cast<vector_node*>(old_child)->leaf();
+            const ImmerValue* new_elems = const_cast<vector_node*>(new_child)->leaf();
+            const std::size_t count = std::min(child_span, end - child_first);
+            for (std::size_t j = 0; j < count; ++j) {
+                fn(child_first + j, old_elems[j], new_elems[j]);
+            }
+        } else {
+            for_each_unshared_element(old_child, new_child, shift - VECTOR_B, child_first, end, fn);
+        }
+    }
+}
+
+/// Call fn(index, old_elem, new_elem) for the indices both vectors hold, except
+/// those in RRB subtrees the two share. Elements past the first tail (at most
+/// one leaf plus the tail) are paired up by address.
+template <typename Fn>
+void for_each_unshared_element(const ValueVector& old_vec, const ValueVector& new_vec, Fn&& fn) {
+    const std::size_t common = std::min(old_vec.size(), new_vec.size());
+    const std::size_t tree_end = std::min(old_vec.impl().tail_offset(), new_vec.impl().tail_offset());
+    if (tree_end > 0) {
+        auto [old_root, new_root, shift] = aligned_roots(old_vec, new_vec);
+        for_each_unshared_element(old_root, new_root, shift, 0, tree_end, fn);
+    }
+    for (std::size_t i = tree_end; i < common; ++i) {
+        const ImmerValue& old_elem = old_vec[i];
+        const ImmerValue& new_elem = new_vec[i];
+        if (&old_elem != &new_elem) {
+            fn(i, old_elem, new_elem);
+        }
+    }
+}
+
+} // namespace lager_ext::detail
@@ -7,13 +7,220 @@
 #include <lager_ext/event_bus_ipc.h>
 #include <lager_ext/value.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <future>
 #include <span>
-#include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace lager_ext {
 
+namespace {
+
+/// Fixed header in front of every RemoteBus payload. Receivers dispatch on
+/// nameHash and only deserialize the payload that follows when a handler
+/// wants it, so an event costs no map or string allocations on either side.
+struct EventHeader {
+    uint32_t nameHash;   ///< ipc::detail::fnv1a_hash32(event name)
+    uint32_t requestId;  ///< send() correlation id, 0 for events
+    uint64_t timestamp;  ///< Sender's steady_clock ticks
+    uint8_t domain;      ///< ipc::MessageDomain
+    uint8_t flags;       ///< ipc::MessageFlags (IsRequest / IsResponse)
+    uint8_t version;     ///< ENVELOPE_VERSION
+    uint8_t reserved[5];
+};
+static_assert(sizeof(EventHeader) == 24, "EventHeader is part of the wire format");
+
+constexpr uint8_t ENVELOPE_VERSION = 1;
+
+/// Same compact format as Channel::post, so small events stay inline
+constexpr BinaryFormat ENVELOPE_FORMAT = BinaryFormat::Compact;
+
+/// steady_clock::now() + timeout, saturated so milliseconds::max() means "never"
+std::chrono::steady_clock::time_point deadline_after(std::chrono::milliseconds timeout) {
+    const auto now = std::chrono::steady_clock::now();
+    if (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::time_point::max() - now)) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return now + timeout;
+}
+
+/// Hashed timer wheel for send_async() timeouts: O(1) schedule and cancel.
+/// Each slot is an intrusive list of entries; a sweep visits only the slots of
+/// the ticks that passed, so expiry costs the ticks elapsed plus the entries
+/// found in those slots (entries due in a later lap are skipped over).
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr auto TICK = std::chrono::milliseconds(1);
+    static constexpr std::size_t SLOTS = 1024; // One lap = ~1 s; longer timeouts wait for later laps
+    static constexpr uint32_t NIL = UINT32_MAX; // End of a slot list / no entry
+
+    /// Names a scheduled entry; stale once the entry expired or was cancelled
+    struct Handle {
+        uint32_t index = NIL;
+        uint32_t generation = 0;
+    };
+
+    TimerWheel() : last_tick_(tick_of(Clock::now())) {
+        heads_.fill(NIL);
+        slot_min_.fill(INT64_MAX);
+    }
+
+    /// Schedule id to expire at deadline (time_point::max() never expires and returns an empty Handle)
+    Handle schedule(uint32_t id, Clock::time_point deadline) {
+        if (deadline == Clock::time_point::max()) {
+            return Handle{};
+        }
+        // Round up so an entry never fires before its deadline
+        const int64_t tick = std::max(tick_of(deadline + TICK - Clock::duration(1)), last_tick_ + 1);
+        const std::size_t slot = static_cast<std::size_t>(tick) % SLOTS;
+
+        uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(Node{});
+        }
+        Node& node = nodes_[index];
+        node.id = id;
+        node.tick = tick;
+        node.prev = NIL;
+        node.next = heads_[slot];
+        if (node.next != NIL) {
+            nodes_[node.next].prev = index;
+        }
+        heads_[slot] = index;
+
+        slot_min_[slot] = std::min(slot_min_[slot], tick);
+        soonest_ = std::min(soonest_, tick);
+        ++size_;
+        return Handle{index, node.generation};
+    }
+
+    /// Remove an entry before it expires (no-op for an empty or stale handle)
+    void cancel(Handle handle) {
+        if (handle.index >= nodes_.size() || nodes_[handle.index].generation != handle.generation) {
+            return;
+        }
+        // slot_min_ and soonest_ stay as lower bounds: at worst one early wake-up, fixed by the next sweep
+        release(handle.index);
+        if (size_ == 0) {
+            soonest_ = INT64_MAX;
+        }
+    }
+
+    /// Hand the id of every entry due by now to on_expired(uint32_t)
+    template <typename Fn>
+    void expire(Clock::time_point now, Fn&& on_expired) {
+        const int64_t now_tick = tick_of(now);
+        if (now_tick <= last_tick_) {
+            return;
+        }
+        const bool due = soonest_ <= now_tick;
+        if (due) {
+            // Only the slots of the ticks that passed can hold due entries (a full lap at most)
+            const int64_t first = std::max(last_tick_ + 1, now_tick - static_cast<int64_t>(SLOTS) + 1);
+            for (int64_t t = first; t <= now_tick; ++t) {
+                sweep(static_cast<std::size_t>(t) % SLOTS, now_tick, on_expired);
+            }
+        }
+        last_tick_ = now_tick;
+        if (due) {
+            find_soonest();
+        }
+    }
+
+    /// Earliest time an entry can expire, or time_point::max() if there is none
+    Clock::time_point next_deadline() const {
+        if (size_ == 0) {
+            return Clock::time_point::max();
+        }
+        return Clock::time_point(TICK * soonest_);
+    }
+
+    std::size_t size() const { return size_; }
+
+private:
+    struct Node {
+        uint32_t id = 0;
+        uint32_t generation = 0; ///< Bumped on release, so old handles stop matching
+        int64_t tick = 0;        ///< Expiry tick
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+    };
+
+    static int64_t tick_of(Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
+    }
+
+    /// Unlink an entry from its slot and recycle it
+    void release(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != NIL) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            heads_[static_cast<std::size_t>(node.tick) % SLOTS] = node.next;
+        }
+        if (node.next != NIL) {
+            nodes_[node.next].prev = node.prev;
+        }
+        ++node.generation;
+        free_.push_back(index);
+        --size_;
+    }
+
+    /// Expire the due entries of one slot and refresh its lower bound from the rest
+    template <typename Fn>
+    void sweep(std::size_t slot, int64_t now_tick, Fn& on_expired) {
+        int64_t remaining_min = INT64_MAX;
+        for (uint32_t index = heads_[slot]; index != NIL;) {
+            const Node& node = nodes_[index];
+            const uint32_t next = node.next;
+            if (node.tick <= now_tick) {
+                on_expired(node.id);
+                release(index);
+            } else {
+                remaining_min = std::min(remaining_min, node.tick); // Due in a later lap
+            }
+            index = next;
+        }
+        slot_min_[slot] = remaining_min;
+    }
+
+    /// Scan one lap forward from last_tick_: the first slot due in this lap
+    /// holds the soonest entry, otherwise it is the smallest later-lap tick
+    void find_soonest() {
+        soonest_ = INT64_MAX;
+        if (size_ == 0) {
+            return;
+        }
+        for (int64_t t = last_tick_ + 1; t <= last_tick_ + static_cast<int64_t>(SLOTS); ++t) {
+            const int64_t slot_min = slot_min_[static_cast<std::size_t>(t) % SLOTS];
+            if (slot_min == t) {
+                soonest_ = t;
+                return;
+            }
+            soonest_ = std::min(soonest_, slot_min);
+        }
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, SLOTS> heads_;   ///< First entry of each slot's list
+    std::array<int64_t, SLOTS> slot_min_; ///< Lower bound of the ticks in each slot
+    int64_t last_tick_;
+    int64_t soonest_ = INT64_MAX;
+    std::size_t size_ = 0;
+};
+
+} // namespace
+
 // ============================================================================
 // RemoteBus::Impl
 // ============================================================================
@@ -32,6 +239,13 @@ public:
         std::move_only_function<void(const RemoteBus::DomainEnvelope&, const ImmerValue&) const> handler;
     };
 
+    /// A received message: the decoded header, plus the payload if anyone wanted it
+    struct Incoming {
+        uint32_t msgId = 0; ///< IPC_EVT_EVENT / IPC_EVT_REQUEST / IPC_EVT_RESPONSE
+        EventHeader header{};
+        ImmerValue payload;
+    };
+
     Impl(std::string_view channel_name, EventBus& bus, Role role, std::size_t capacity)
         : channel_name_(channel_name), bus_(bus), role_(role) {
         try {
@@ -47,10 +261,11 @@ public:
                 break;
 
             case Role::Peer:
-                // Try create first, fallback to connect
-                channel_pair_ = ipc::ChannelPair::create(std::string(channel_name), capacity);
+                // Try connect first, fallback to create. Creating first would never
+                // fall back on POSIX: Channel::create replaces an existing segment.
+                channel_pair_ = ipc::ChannelPair::connect(std::string(channel_name));
                 if (!channel_pair_) {
-                    channel_pair_ = ipc::ChannelPair::connect(std::string(channel_name));
+                    channel_pair_ = ipc::ChannelPair::create(std::string(channel_name), capacity);
                 }
                 connected_ = (channel_pair_ != nullptr);
                 break;
@@ -63,46 +278,42 @@ public:
 
     ~Impl() = default;
 
-    bool post_remote(std::string_view event_name, const ImmerValue& payload) {
+    bool post_remote(uint32_t name_hash, MessageDomain domain, const ImmerValue& payload) {
         if (!connected_) {
             return false;
         }
-
-        // Envelope: {"n": name, "d": data}
-        ImmerValue envelope = ImmerValue::map({{"n", std::string(event_name)}, {"d", payload}});
-
-        if (channel_pair_) {
-            return channel_pair_->post(detail::IPC_EVT_EVENT, envelope);
-        }
-        if (channel_) {
-            return channel_->post(detail::IPC_EVT_EVENT, envelope);
-        }
-        return false;
+        return post_envelope(detail::IPC_EVT_EVENT, name_hash, domain, ipc::MessageFlags::None, 0, payload);
     }
 
     bool broadcast(std::string_view event_name, const ImmerValue& payload) {
         bus_.publish(event_name, payload);
-        return post_remote(event_name, payload);
+        return post_remote(ipc::detail::fnv1a_hash32(event_name), MessageDomain::Global, payload);
     }
 
     Connection subscribe_remote_impl(std::string_view event_name, std::move_only_function<void(const ImmerValue&) const> handler) {
+        uint32_t name_hash = ipc::detail::fnv1a_hash32(event_name);
+        if (!claim_name(name_hash, event_name)) {
+            return Connection{};
+        }
         uint64_t slot_id = next_slot_id_++;
-        std::string name(event_name);
-        
-        remote_handlers_[name].push_back({slot_id, std::move(handler)});
-        
+
+        remote_handlers_[name_hash].push_back({slot_id, std::move(handler)});
+
         // Return a Connection that actually disconnects
-        return Connection([this, name, slot_id]() {
-            remove_remote_handler(name, slot_id);
+        return Connection([this, name_hash, slot_id]() {
+            remove_remote_handler(name_hash, slot_id);
         });
     }
 
     Connection on_request_impl(std::string_view event_name, std::move_only_function<ImmerValue(const ImmerValue&)> handler) {
-        std::string name(event_name);
-        request_handlers_[name] = std::move(handler);
-        
-        return Connection([this, name]() {
-            request_handlers_.erase(name);
+        uint32_t name_hash = ipc::detail::fnv1a_hash32(event_name);
+        if (!claim_name(name_hash, event_name)) {
+            return Connection{};
+        }
+        request_handlers_[name_hash] = std::move(handler);
+
+        return Connection([this, name_hash]() {
+            request_handlers_.erase(name_hash);
         });
     }
 
@@ -117,22 +328,12 @@ public:
         }
 
         std::size_t count = 0;
-
-        auto process_received = [&](const ipc::Channel::ReceivedMessage& msg) {
-            process_message_full(msg);
+        Incoming msg;
+        while (receive_one(msg)) {
+            process_message(msg);
             ++count;
-        };
-
-        if (channel_pair_) {
-            while (auto msg = channel_pair_->tryReceive()) {
-                process_received(*msg);
-            }
-        } else if (channel_) {
-            while (auto msg = channel_->tryReceive()) {
-                process_received(*msg);
-            }
         }
-
+        expire_requests();
         return count;
     }
 
@@ -141,118 +342,263 @@ public:
             return 0;
         }
 
-        auto start = std::chrono::steady_clock::now();
+        const auto deadline = deadline_after(timeout);
         std::size_t total = 0;
 
-        while (std::chrono::steady_clock::now() - start < timeout) {
+        for (auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now()) {
             std::size_t count = poll();
             total += count;
+            // Sleep until the next message arrives (or a send_async() request times out)
+            // instead of re-polling on a timer
             if (count == 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                const auto wake = std::min(deadline, timers_.next_deadline());
+                if (!wait_for_message(wake - now) && wake == deadline) {
+                    break;
+                }
             }
         }
 
         return total;
     }
 
-    std::optional<ImmerValue> send(std::string_view event_name, const ImmerValue& payload,
-                              std::chrono::milliseconds timeout) {
+    std::size_t wait_and_poll(std::chrono::milliseconds timeout) {
+        if (!connected_) {
+            return 0;
+        }
+
+        if (std::size_t count = poll()) {
+            return count;
+        }
+        // Sleep until a message arrives, the next send_async() timeout is due, or timeout passes
+        const auto now = std::chrono::steady_clock::now();
+        auto wake = timers_.next_deadline();
+        if (timeout < std::chrono::ceil<std::chrono::milliseconds>(wake - now)) {
+            wake = now + timeout;
+        }
+        wait_for_message(wake - now);
+        return poll();
+    }
+
+    bool send_async(std::string_view event_name, const ImmerValue& payload, ResponseHandler handler,
+                    std::chrono::milliseconds timeout) {
         if (!connected_ || !channel_pair_) {
-            return std::nullopt;
+            return false;
         }
 
-        uint64_t req_id = next_request_id_++;
+        // 0 means "not a request"; after wrap-around, skip ids that are still pending
+        while (next_request_id_ == 0 || pending_.contains(next_request_id_)) {
+            ++next_request_id_;
+        }
+        const uint32_t req_id = next_request_id_++;
 
-        // Request envelope with ID
-        ImmerValue envelope =
-            ImmerValue::map({{"n", std::string(event_name)}, {"d", payload}, {"r", static_cast<int64_t>(req_id)}});
+        if (!post_envelope(detail::IPC_EVT_REQUEST, ipc::detail::fnv1a_hash32(event_name), MessageDomain::Global,
+                           ipc::MessageFlags::IsRequest, req_id, payload)) {
+            return false;
+        }
+
+        auto timer = timers_.schedule(req_id, deadline_after(timeout));
+        pending_.emplace(req_id, PendingRequest{std::move(handler), timer});
+        return true;
+    }
 
-        if (!channel_pair_->post(detail::IPC_EVT_REQUEST, envelope)) {
+    std::optional<ImmerValue> send(std::string_view event_name, const ImmerValue& payload,
+                              std::chrono::milliseconds timeout) {
+        std::optional<ImmerValue> result;
+        bool done = false;
+        if (!send_async(
+                event_name, payload,
+                [&](std::optional<ImmerValue> response) {
+                    result = std::move(response);
+                    done = true;
+                },
+                timeout)) {
             return std::nullopt;
         }
 
-        // Wait for response
-        auto start = std::chrono::steady_clock::now();
-        while (std::chrono::steady_clock::now() - start < timeout) {
-            if (auto msg = channel_pair_->tryReceive()) {
-                if (msg->msgId == detail::IPC_EVT_RESPONSE) {
-                    const ImmerValue& env = msg->data;
-                    if (auto rid = try_get_int(env, "r"); rid && static_cast<uint64_t>(*rid) == req_id) {
-                        return try_get_value(env, "d");
-                    }
-                } else {
-                    process_message(msg->msgId, msg->data);
-                }
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
+        // Dispatch everything that arrives meanwhile; on timeout the timer wheel
+        // completes the request with nullopt from inside poll()
+        while (!done) {
+            wait_and_poll(std::chrono::milliseconds::max());
         }
-
-        return std::nullopt;
+        return result;
     }
 
+    std::size_t pending_requests() const { return pending_.size(); }
+
     bool connected() const { return connected_; }
     const std::string& channel_name() const { return channel_name_; }
     const std::string& last_error() const { return last_error_; }
+    const RemoteBus::Stats& stats() const noexcept { return stats_; }
     EventBus& bus() { return bus_; }
 
 private:
-    // Full message processing with domain support
-    void process_message_full(const ipc::Channel::ReceivedMessage& msg) {
-        try {
-            // First, dispatch to domain handlers (regardless of msgId type)
-            // Domain handlers receive the raw payload
-            dispatch_to_domain_handlers(msg, msg.data);
+    /// Block until the incoming channel has a message (futex wake on Linux, see
+    /// ipc::Channel::waitForMessage). Returns false on timeout, or at once if this
+    /// side cannot receive (Server role).
+    bool wait_for_message(std::chrono::steady_clock::duration remaining) {
+        auto timeout = std::chrono::ceil<std::chrono::milliseconds>(remaining);
+        if (channel_pair_) {
+            return channel_pair_->waitForMessage(timeout);
+        }
+        if (channel_) {
+            return channel_->waitForMessage(timeout);
+        }
+        return false;
+    }
 
-            // Then process as before for named event handlers
-            process_message(msg.msgId, msg.data);
-        } catch (...) {
-            // Ignore malformed messages
+    /// Handlers are keyed by 32-bit name hash; refuse a second name with the same hash
+    bool claim_name(uint32_t name_hash, std::string_view event_name) {
+        auto [it, inserted] = names_.try_emplace(name_hash, event_name);
+        if (!inserted && it->second != event_name) {
+            last_error_ = "Event name hash collision: '" + std::string(event_name) + "' and '" + it->second + "'";
+            return false;
         }
+        return true;
     }
 
-    void process_message(uint32_t msgId, const ImmerValue& envelope) {
-        try {
-            auto name = try_get_string(envelope, "n");
-            auto payload = try_get_value(envelope, "d");
+    /// Header + serialized payload in one reused buffer, posted as raw bytes
+    bool post_envelope(uint32_t msg_id, uint32_t name_hash, MessageDomain domain, ipc::MessageFlags flags,
+                       uint32_t request_id, const ImmerValue& payload) {
+        const std::size_t payload_size = payload.is_null() ? 0 : serialized_size(payload, ENVELOPE_FORMAT);
+        send_buffer_.resize(sizeof(EventHeader) + payload_size);
+
+        EventHeader header{};
+        header.nameHash = name_hash;
+        header.requestId = request_id;
+        header.timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        header.domain = static_cast<uint8_t>(domain);
+        header.flags = static_cast<uint8_t>(flags);
+        header.version = ENVELOPE_VERSION;
+        std::memcpy(send_buffer_.data(), &header, sizeof(header));
+        if (payload_size > 0) {
+            serialize_to(payload, send_buffer_.data() + sizeof(header), payload_size, ENVELOPE_FORMAT);
+        }
+
+        if (channel_pair_) {
+            return channel_pair_->postRaw(msg_id, send_buffer_.data(), send_buffer_.size());
+        }
+        if (channel_) {
+            return channel_->postRaw(msg_id, send_buffer_.data(), send_buffer_.size(), domain);
+        }
+        return false;
+    }
 
-            if (!name || !payload) {
+    /// Take one message off the incoming channel. The payload is deserialized
+    /// only if a handler (or a pending request) wants it; dispatch happens after
+    /// the message is consumed, so handlers may post, send() or poll() again.
+    bool receive_one(Incoming& out) {
+        auto decode = [&](uint32_t msg_id, std::span<const uint8_t> bytes) {
+            ++stats_.received;
+            out.msgId = msg_id;
+            out.payload = ImmerValue{};
+            if (bytes.size() < sizeof(EventHeader)) [[unlikely]] {
+                out.header = EventHeader{}; // Not a RemoteBus message: dropped by process_message
+                return;
+            }
+            std::memcpy(&out.header, bytes.data(), sizeof(EventHeader));
+            if (out.header.version != ENVELOPE_VERSION || !wants_payload(out)) {
                 return;
             }
+            try {
+                out.payload = deserialize(bytes.data() + sizeof(EventHeader), bytes.size() - sizeof(EventHeader));
+                ++stats_.payloads_decoded;
+            } catch (...) {
+                out.header.version = 0; // Malformed payload: drop the message
+            }
+        };
 
-            if (msgId == detail::IPC_EVT_REQUEST) {
-                handle_request(*name, *payload, envelope);
-            } else {
-                dispatch_to_handlers(*name, *payload);
+        if (channel_pair_) {
+            return channel_pair_->drainRaw(decode, 1) > 0;
+        }
+        if (channel_) {
+            return channel_->drainRaw(decode, 1) > 0;
+        }
+        return false;
+    }
+
+    bool wants_payload(const Incoming& msg) const {
+        if (domain_handlers_.contains(msg.header.domain)) {
+            return true;
+        }
+        switch (msg.msgId) {
+        case detail::IPC_EVT_EVENT:
+            return remote_handlers_.contains(msg.header.nameHash);
+        case detail::IPC_EVT_REQUEST:
+            return request_handlers_.contains(msg.header.nameHash);
+        case detail::IPC_EVT_RESPONSE:
+            return pending_.contains(msg.header.requestId);
+        default:
+            return false;
+        }
+    }
+
+    void process_message(const Incoming& msg) {
+        if (msg.header.version != ENVELOPE_VERSION) {
+            ++stats_.dropped; // Foreign or malformed message
+            return;
+        }
+        try {
+            // Domain handlers see every message in their domain, then named handlers run
+            dispatch_to_domain_handlers(msg);
+
+            if (msg.msgId == detail::IPC_EVT_REQUEST) {
+                handle_request(msg);
+            } else if (msg.msgId == detail::IPC_EVT_RESPONSE) {
+                complete_request(msg.header.requestId, msg.payload);
+            } else if (msg.msgId == detail::IPC_EVT_EVENT) {
+                dispatch_to_handlers(msg.header.nameHash, msg.payload);
             }
         } catch (...) {
-            // Ignore malformed messages
+            // Ignore handler failures, like malformed messages
         }
     }
 
-    void handle_request(const std::string& name, const ImmerValue& payload, const ImmerValue& envelope) {
-        auto it = request_handlers_.find(name);
-        if (it == request_handlers_.end()) {
+    void handle_request(const Incoming& msg) {
+        auto it = request_handlers_.find(msg.header.nameHash);
+        if (it == request_handlers_.end() || msg.header.requestId == 0) {
             return;
         }
 
-        ImmerValue response = it->second(payload);
-        auto req_id = try_get_value(envelope, "r");
-        if (!req_id) {
+        ImmerValue response = it->second(msg.payload);
+        post_envelope(detail::IPC_EVT_RESPONSE, msg.header.nameHash, static_cast<MessageDomain>(msg.header.domain),
+                      ipc::MessageFlags::IsResponse, msg.header.requestId, response);
+    }
+
+    /// Complete a send_async() request with its response (late or unknown ids are dropped)
+    void complete_request(uint32_t request_id, const ImmerValue& response) {
+        auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
             return;
         }
+        ResponseHandler handler = std::move(it->second.handler);
+        timers_.cancel(it->second.timer);
+        pending_.erase(it); // Before the call: the handler may send again
+        if (handler) {
+            handler(response);
+        }
+    }
 
-        ImmerValue resp_envelope = ImmerValue::map({{"n", name}, {"d", response}, {"r", *req_id}});
-
-        if (channel_pair_) {
-            channel_pair_->post(detail::IPC_EVT_RESPONSE, resp_envelope);
-        } else if (channel_) {
-            channel_->post(detail::IPC_EVT_RESPONSE, resp_envelope);
+    /// Complete requests whose timeout passed with nullopt
+    void expire_requests() {
+        expired_.clear();
+        timers_.expire(std::chrono::steady_clock::now(), [this](uint32_t id) {
+            // Completed requests cancel their entry, so every expired id is still pending
+            auto it = pending_.find(id);
+            if (it != pending_.end()) {
+                expired_.push_back(std::move(it->second.handler));
+                pending_.erase(it);
+            }
+        });
+        // Handlers run after the sweep, so they may call send_async()
+        for (auto& handler : expired_) {
+            if (handler) {
+                handler(std::nullopt);
+            }
         }
     }
 
-    void dispatch_to_handlers(const std::string& name, const ImmerValue& payload) {
-        auto it = remote_handlers_.find(name);
+    void dispatch_to_handlers(uint32_t name_hash, const ImmerValue& payload) {
+        auto it = remote_handlers_.find(name_hash);
         if (it != remote_handlers_.end()) {
             for (const auto& rh : it->second) {
                 if (rh.handler) {
@@ -262,8 +608,8 @@ private:
         }
     }
 
-    void remove_remote_handler(const std::string& name, uint64_t slot_id) {
-        auto it = remote_handlers_.find(name);
+    void remove_remote_handler(uint32_t name_hash, uint64_t slot_id) {
+        auto it = remote_handlers_.find(name_hash);
         if (it != remote_handlers_.end()) {
             auto& handlers = it->second;
             std::erase_if(handlers, [slot_id](const RemoteHandler& rh) {
@@ -275,31 +621,6 @@ private:
         }
     }
 
-    // Helper functions for safe ImmerValue access
-    static std::optional<std::string> try_get_string(const ImmerValue& v, const char* key) {
-        try {
-            return v.at(key).as<std::string>();
-        } catch (...) {
-            return std::nullopt;
-        }
-    }
-
-    static std::optional<int64_t> try_get_int(const ImmerValue& v, const char* key) {
-        try {
-            return v.at(key).as<int64_t>();
-        } catch (...) {
-            return std::nullopt;
-        }
-    }
-
-    static std::optional<ImmerValue> try_get_value(const ImmerValue& v, const char* key) {
-        try {
-            return v.at(key);
-        } catch (...) {
-            return std::nullopt;
-        }
-    }
-
     std::string channel_name_;
     EventBus& bus_;
     Role role_;
@@ -309,17 +630,34 @@ private:
     std::unique_ptr<ipc::Channel> channel_;
     std::unique_ptr<ipc::ChannelPair> channel_pair_;
 
-    // Remote event handlers with lifecycle management
-    std::unordered_map<std::string, std::vector<RemoteHandler>> remote_handlers_;
+    // Remote event handlers with lifecycle management, keyed by event name hash
+    std::unordered_map<uint32_t, std::vector<RemoteHandler>> remote_handlers_;
     uint64_t next_slot_id_ = 1;
-    
-    // Request-response handlers
-    std::unordered_map<std::string, std::move_only_function<ImmerValue(const ImmerValue&)>> request_handlers_;
-    uint64_t next_request_id_ = 1;
+
+    // Request-response handlers, keyed by event name hash
+    std::unordered_map<uint32_t, std::move_only_function<ImmerValue(const ImmerValue&)>> request_handlers_;
+    uint32_t next_request_id_ = 1;
+
+    // Outstanding send_async() requests, keyed by request id, and their timeouts
+    struct PendingRequest {
+        ResponseHandler handler;
+        TimerWheel::Handle timer; ///< Cancelled when the response arrives
+    };
+    std::unordered_map<uint32_t, PendingRequest> pending_;
+    TimerWheel timers_;
+    std::vector<ResponseHandler> expired_;
+
+    // Names behind the hashes above, for collision checks
+    std::unordered_map<uint32_t, std::string> names_;
 
     // Domain handlers - keyed by domain enum
     std::unordered_map<uint8_t, std::vector<DomainHandler>> domain_handlers_;
 
+    // Outgoing envelope, reused so posting does not allocate once it has grown
+    std::vector<uint8_t> send_buffer_;
+
+    RemoteBus::Stats stats_;
+
 public:
     // Domain subscription implementation
     Connection subscribe_domain_impl(ipc::MessageDomain domain,
@@ -353,20 +691,19 @@ private:
         }
     }
 
-    void dispatch_to_domain_handlers(const ipc::Channel::ReceivedMessage& msg, const ImmerValue& payload) {
-        uint8_t domain_key = static_cast<uint8_t>(msg.domain);
-        auto it = domain_handlers_.find(domain_key);
+    void dispatch_to_domain_handlers(const Incoming& msg) {
+        auto it = domain_handlers_.find(msg.header.domain);
         if (it != domain_handlers_.end()) {
             RemoteBus::DomainEnvelope envelope{
-                .msgId = msg.msgId,
-                .timestamp = msg.timestamp,
-                .domain = msg.domain,
-                .flags = msg.flags,
-                .requestId = msg.requestId
+                .msgId = msg.header.nameHash,
+                .timestamp = msg.header.timestamp,
+                .domain = static_cast<MessageDomain>(msg.header.domain),
+                .flags = static_cast<MessageFlags>(msg.header.flags),
+                .requestId = msg.header.requestId
             };
             for (const auto& dh : it->second) {
                 if (dh.handler) {
-                    dh.handler(envelope, payload);
+                    dh.handler(envelope, msg.payload);
                 }
             }
         }
@@ -384,8 +721,12 @@ RemoteBus::~RemoteBus() = default;
 RemoteBus::RemoteBus(RemoteBus&&) noexcept = default;
 RemoteBus& RemoteBus::operator=(RemoteBus&&) noexcept = default;
 
-bool RemoteBus::post_remote(std::string_view event_name, const ImmerValue& payload) {
-    return impl_->post_remote(event_name, payload);
+bool RemoteBus::post_remote(std::string_view event_name, const ImmerValue& payload, MessageDomain domain) {
+    return impl_->post_remote(ipc::detail::fnv1a_hash32(event_name), domain, payload);
+}
+
+bool RemoteBus::post_remote_impl(uint32_t name_hash, MessageDomain domain, const ImmerValue& payload) {
+    return impl_->post_remote(name_hash, domain, payload);
 }
 
 bool RemoteBus::broadcast(std::string_view event_name, const ImmerValue& payload) {
@@ -412,11 +753,40 @@ std::size_t RemoteBus::poll(std::chrono::milliseconds timeout) {
     return impl_->poll(timeout);
 }
 
+std::size_t RemoteBus::wait_and_poll(std::chrono::milliseconds timeout) {
+    return impl_->wait_and_poll(timeout);
+}
+
 std::optional<ImmerValue> RemoteBus::send(std::string_view event_name, const ImmerValue& payload,
                                      std::chrono::milliseconds timeout) {
     return impl_->send(event_name, payload, timeout);
 }
 
+bool RemoteBus::send_async(std::string_view event_name, const ImmerValue& payload, ResponseHandler handler,
+                           std::chrono::milliseconds timeout) {
+    return impl_->send_async(event_name, payload, std::move(handler), timeout);
+}
+
+std::future<std::optional<ImmerValue>> RemoteBus::send_async(std::string_view event_name, const ImmerValue& payload,
+                                                             std::chrono::milliseconds timeout) {
+    std::promise<std::optional<ImmerValue>> promise;
+    auto future = promise.get_future();
+    auto handler = [p = std::move(promise)](std::optional<ImmerValue> response) mutable {
+        p.set_value(std::move(response));
+    };
+    if (!impl_->send_async(event_name, payload, std::move(handler), timeout)) {
+        // handler was moved into the failed call; report the failure through a fresh future
+        std::promise<std::optional<ImmerValue>> failed;
+        failed.set_value(std::nullopt);
+        return failed.get_future();
+    }
+    return future;
+}
+
+std::size_t RemoteBus::pending_requests() const {
+    return impl_->pending_requests();
+}
+
 bool RemoteBus::connected() const {
     return impl_->connected();
 }
@@ -429,6 +799,10 @@ const std::string& RemoteBus::last_error() const {
     return impl_->last_error();
 }
 
+RemoteBus::Stats RemoteBus::stats() const noexcept {
+    return impl_->stats();
+}
+
 EventBus& RemoteBus::bus_ref() {
     return impl_->bus();
 }
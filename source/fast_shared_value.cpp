@@ -0,0 +1,322 @@
+// Copyright (c) 2024 chenmou. All rights reserved.
+// Licensed under the MIT License. See LICENSE file in the project root.
+
+/// @file fast_shared_value.cpp
+/// @brief Multi-threaded construction of FastSharedValue (fast_deep_copy_to_shared_parallel)
+
+#include <lager_ext/fast_shared_value.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lager_ext {
+
+namespace {
+
+using ::shared_memory::SharedMemoryRegion;
+using ::shared_memory::SharedString;
+using ::shared_memory::shared_memory_error;
+
+// Elements claimed per fetch_add; large enough to amortize the atomic,
+// small enough to balance uneven subtrees
+constexpr std::size_t COPY_BATCH_SIZE = 64;
+
+// Sub-arena chunk bounds: small chunks waste less at the end of a build,
+// large chunks touch the shared cursor less often
+constexpr std::size_t MIN_ARENA_CHUNK = 4 * 1024;
+constexpr std::size_t MAX_ARENA_CHUNK = 1024 * 1024;
+
+// ============================================================
+// CopyWorkers - Worker threads with one sub-arena each
+//
+// Lives for one fast_deep_copy_to_shared_parallel call. Threads are
+// started on the first parallel container and reused for the rest.
+// Participant 0 is the calling thread; its sub-arena stays installed
+// as the current region for the whole build, so serial assembly on the
+// calling thread never touches the parent region's cursor.
+// ============================================================
+
+class CopyWorkers {
+public:
+    using Job = std::function<void(std::size_t)>;
+
+    CopyWorkers(SharedMemoryRegion& region, std::size_t num_threads)
+        : region_(region), previous_(::shared_memory::get_current_shared_region()), num_threads_(num_threads) {
+        region_.sync_allocation_cursor();
+        const auto* header = region_.header();
+        heap_cursor_.store(header->heap_used, std::memory_order_relaxed);
+
+        const std::size_t free_bytes = header->heap_size - header->heap_used;
+        const std::size_t chunk = std::clamp(free_bytes / (num_threads * 8), MIN_ARENA_CHUNK, MAX_ARENA_CHUNK);
+        arenas_.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            arenas_.push_back(region_.make_sub_arena(heap_cursor_, chunk));
+        }
+        ::shared_memory::set_current_shared_region(&arenas_[0]);
+    }
+
+    ~CopyWorkers() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+        ::shared_memory::set_current_shared_region(previous_);
+
+        // A failed chunk claim may have pushed the cursor past the end of the heap
+        region_.adopt_allocation_cursor(
+            std::min(heap_cursor_.load(std::memory_order_relaxed), region_.header()->heap_size));
+    }
+
+    CopyWorkers(const CopyWorkers&) = delete;
+    CopyWorkers& operator=(const CopyWorkers&) = delete;
+
+    /// Run job(i) for every i in [0, count) on all participants
+    /// @throws The first exception thrown by any job
+    void for_each(std::size_t count, const Job& job) {
+        if (threads_.empty()) [[unlikely]] {
+            start_threads();
+        }
+        {
+            std::lock_guard lock(mutex_);
+            job_ = &job;
+            job_count_ = count;
+            next_.store(0, std::memory_order_relaxed);
+            busy_ = threads_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        run_batches();
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        job_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+private:
+    void start_threads() {
+        threads_.reserve(num_threads_ - 1);
+        for (std::size_t i = 1; i < num_threads_; ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    void worker_loop(std::size_t index) {
+        ::shared_memory::set_current_shared_region(&arenas_[index]);
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+            }
+            run_batches();
+            {
+                std::lock_guard lock(mutex_);
+                --busy_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    void run_batches() {
+        try {
+            for (;;) {
+                const std::size_t begin = next_.fetch_add(COPY_BATCH_SIZE, std::memory_order_relaxed);
+                if (begin >= job_count_)
+                    break;
+                const std::size_t end = std::min(begin + COPY_BATCH_SIZE, job_count_);
+                for (std::size_t i = begin; i < end; ++i) {
+                    (*job_)(i);
+                }
+            }
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!error_)
+                error_ = std::current_exception();
+            next_.store(job_count_, std::memory_order_relaxed); // Make the others stop early
+        }
+    }
+
+    SharedMemoryRegion& region_;
+    SharedMemoryRegion* previous_;
+    std::size_t num_threads_;
+    std::atomic<std::size_t> heap_cursor_{0};
+    std::vector<SharedMemoryRegion> arenas_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;
+    std::size_t busy_ = 0;
+    bool stop_ = false;
+    const Job* job_ = nullptr;
+    std::size_t job_count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr error_;
+};
+
+// ============================================================
+// ParallelCopier
+//
+// Walks the tree on the calling thread. The children of large
+// containers are copied by the workers (each subtree serially, with
+// fast_deep_copy_to_shared); small containers are assembled here and
+// recursed into, so a large container nested under small ones still
+// gets split.
+// ============================================================
+
+class ParallelCopier {
+public:
+    ParallelCopier(SharedMemoryRegion& region, std::size_t num_threads) : workers_(region, num_threads) {}
+
+    FastSharedValue copy(const ImmerValue& local) {
+        if (auto* m = local.get_if<BoxedValueMap>())
+            return FastSharedValue{copy_map(m->get())};
+        if (auto* v = local.get_if<BoxedValueVector>())
+            return FastSharedValue{copy_vector(v->get())};
+        if (auto* a = local.get_if<BoxedValueArray>())
+            return FastSharedValue{copy_array(a->get())};
+        if (auto* t = local.get_if<BoxedValueTable>())
+            return FastSharedValue{copy_table(t->get())};
+        return fast_deep_copy_to_shared(local);
+    }
+
+private:
+    using KeyedEntries = std::vector<std::pair<const std::string*, const ImmerValue*>>;
+
+    struct KeyedResults {
+        std::vector<SharedString> keys;
+        std::vector<std::optional<FastSharedValueBox>> values;
+    };
+
+    KeyedResults copy_keyed(const KeyedEntries& entries) {
+        KeyedResults out;
+        out.keys.resize(entries.size());
+        out.values.resize(entries.size());
+        workers_.for_each(entries.size(), [&](std::size_t i) {
+            out.keys[i] = SharedString(*entries[i].first);
+            out.values[i].emplace(fast_deep_copy_to_shared(*entries[i].second));
+        });
+        return out;
+    }
+
+    template <typename Container>
+    std::vector<std::optional<FastSharedValueBox>> copy_elements(const Container& elements) {
+        std::vector<const ImmerValue*> sources;
+        sources.reserve(elements.size());
+        for (const auto& v : elements)
+            sources.push_back(&v);
+
+        std::vector<std::optional<FastSharedValueBox>> values(sources.size());
+        workers_.for_each(sources.size(),
+                          [&](std::size_t i) { values[i].emplace(fast_deep_copy_to_shared(*sources[i])); });
+        return values;
+    }
+
+    FastSharedValueMap copy_map(const ValueMap& map) {
+        auto transient = FastSharedValueMap{}.transient();
+        if (map.size() < PARALLEL_COPY_MIN_ELEMENTS) {
+            for (const auto& [key, value] : map)
+                transient.set(SharedString(key), FastSharedValueBox{copy(value)});
+            return transient.persistent();
+        }
+
+        KeyedEntries entries;
+        entries.reserve(map.size());
+        for (const auto& [key, value] : map)
+            entries.emplace_back(&key, &value);
+        auto results = copy_keyed(entries);
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            transient.set(std::move(results.keys[i]), std::move(*results.values[i]));
+        return transient.persistent();
+    }
+
+    FastSharedValueTable copy_table(const ValueTable& table) {
+        auto transient = FastSharedValueTable{}.transient();
+        if (table.size() < PARALLEL_COPY_MIN_ELEMENTS) {
+            for (const auto& entry : table)
+                transient.insert(FastSharedTableEntry{SharedString(entry.id), FastSharedValueBox{copy(entry.value.get())}});
+            return transient.persistent();
+        }
+
+        KeyedEntries entries;
+        entries.reserve(table.size());
+        for (const auto& entry : table)
+            entries.emplace_back(&entry.id, &entry.value.get());
+        auto results = copy_keyed(entries);
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            transient.insert(FastSharedTableEntry{std::move(results.keys[i]), std::move(*results.values[i])});
+        return transient.persistent();
+    }
+
+    FastSharedValueVector copy_vector(const ValueVector& vec) {
+        auto transient = FastSharedValueVector{}.transient();
+        if (vec.size() < PARALLEL_COPY_MIN_ELEMENTS) {
+            for (const auto& value : vec)
+                transient.push_back(FastSharedValueBox{copy(value)});
+            return transient.persistent();
+        }
+
+        for (auto& value : copy_elements(vec))
+            transient.push_back(std::move(*value));
+        return transient.persistent();
+    }
+
+    FastSharedValueArray copy_array(const ValueArray& arr) {
+        std::vector<FastSharedValueBox> boxes;
+        boxes.reserve(arr.size());
+        if (arr.size() < PARALLEL_COPY_MIN_ELEMENTS) {
+            for (const auto& value : arr)
+                boxes.emplace_back(copy(value));
+        } else {
+            for (auto& value : copy_elements(arr))
+                boxes.push_back(std::move(*value));
+        }
+        return FastSharedValueArray(boxes.begin(), boxes.end());
+    }
+
+    CopyWorkers workers_;
+};
+
+} // anonymous namespace
+
+FastSharedValue fast_deep_copy_to_shared_parallel(const ImmerValue& local, std::size_t num_threads) {
+    auto* region = ::shared_memory::get_current_shared_region();
+    if (!region) {
+        throw shared_memory_error(shared_memory_error::error_type::no_region);
+    }
+    if (!region->is_valid()) {
+        throw shared_memory_error(shared_memory_error::error_type::invalid_region);
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Nested use (from inside a worker) and single-threaded requests take the serial path
+    if (num_threads == 1 || region->is_sub_arena()) {
+        return fast_deep_copy_to_shared(local);
+    }
+
+    ParallelCopier copier(*region, num_threads);
+    return copier.copy(local);
+}
+
+} // namespace lager_ext
@@ -0,0 +1,334 @@
+// indexed_snapshot.cpp - Indexed snapshot writer and LazyValueView
+
+#include <lager_ext/indexed_snapshot.h>
+#include <lager_ext/serialization.h>
+
+#include "binary_tags.h"
+
+#include <immer/map_transient.hpp>
+#include <immer/table_transient.hpp>
+#include <immer/vector_transient.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace lager_ext {
+
+namespace {
+
+// Node tags, taken from the standard binary format
+constexpr uint8_t TAG_NULL = static_cast<uint8_t>(detail::TypeTag::Null);
+constexpr uint8_t TAG_STRING = static_cast<uint8_t>(detail::TypeTag::String);
+constexpr uint8_t TAG_MAP = static_cast<uint8_t>(detail::TypeTag::Map);
+constexpr uint8_t TAG_VECTOR = static_cast<uint8_t>(detail::TypeTag::Vector);
+constexpr uint8_t TAG_ARRAY = static_cast<uint8_t>(detail::TypeTag::Array);
+constexpr uint8_t TAG_TABLE = static_cast<uint8_t>(detail::TypeTag::Table);
+
+constexpr std::size_t NODE_HEADER_SIZE = 1 + sizeof(uint32_t); // tag + count
+constexpr std::size_t KEYED_ENTRY_SIZE = 3 * sizeof(uint32_t);  // key offset, key length, value offset
+constexpr std::size_t INDEXED_ENTRY_SIZE = sizeof(uint32_t);    // value offset
+
+uint32_t load_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("Corrupt indexed snapshot");
+}
+
+// ============================================================
+// IndexedWriter
+// ============================================================
+
+class IndexedWriter {
+public:
+    using KeyedEntries = std::vector<std::pair<const std::string*, const ImmerValue*>>;
+
+    ByteBuffer out;
+
+    void write_node(const ImmerValue& val) {
+        if (auto* m = val.get_if<BoxedValueMap>()) {
+            KeyedEntries entries;
+            entries.reserve(m->get().size());
+            for (const auto& [k, v] : m->get())
+                entries.emplace_back(&k, &v);
+            write_keyed(TAG_MAP, entries);
+        } else if (auto* tbl = val.get_if<BoxedValueTable>()) {
+            KeyedEntries entries;
+            entries.reserve(tbl->get().size());
+            for (const auto& entry : tbl->get())
+                entries.emplace_back(&entry.id, &entry.value.get());
+            write_keyed(TAG_TABLE, entries);
+        } else if (auto* vec = val.get_if<BoxedValueVector>()) {
+            write_indexed(TAG_VECTOR, vec->get());
+        } else if (auto* arr = val.get_if<BoxedValueArray>()) {
+            write_indexed(TAG_ARRAY, arr->get());
+        } else {
+            // Scalars and strings use the standard encoding unchanged
+            const std::size_t pos = out.size();
+            const std::size_t n = serialized_size(val);
+            out.resize(pos + n);
+            serialize_to(val, out.data() + pos, n);
+        }
+    }
+
+private:
+    std::size_t begin_node(uint8_t tag, std::size_t count, std::size_t entry_size) {
+        const std::size_t start = out.size();
+        out.push_back(tag);
+        put_u32(checked_u32(count));
+        out.resize(out.size() + count * entry_size); // Offset table, patched below
+        return start;
+    }
+
+    void write_keyed(uint8_t tag, KeyedEntries& entries) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& a, const auto& b) { return *a.first < *b.first; });
+
+        // Keys first, so a lookup's binary search touches one contiguous region
+        const std::size_t start = begin_node(tag, entries.size(), KEYED_ENTRY_SIZE);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const std::string& key = *entries[i].first;
+            const uint32_t key_offset = offset_from(start);
+            out.insert(out.end(), key.begin(), key.end());
+            store_u32(entry(start, i, KEYED_ENTRY_SIZE), key_offset);
+            store_u32(entry(start, i, KEYED_ENTRY_SIZE) + 4, checked_u32(key.size()));
+        }
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const uint32_t value_offset = offset_from(start);
+            write_node(*entries[i].second);
+            store_u32(entry(start, i, KEYED_ENTRY_SIZE) + 8, value_offset);
+        }
+    }
+
+    template <typename Container>
+    void write_indexed(uint8_t tag, const Container& elements) {
+        const std::size_t start = begin_node(tag, elements.size(), INDEXED_ENTRY_SIZE);
+        std::size_t i = 0;
+        for (const auto& v : elements) {
+            const uint32_t value_offset = offset_from(start);
+            write_node(v);
+            store_u32(entry(start, i, INDEXED_ENTRY_SIZE), value_offset);
+            ++i;
+        }
+    }
+
+    // Offset table entry of a node; recomputed after every write since `out` may reallocate
+    uint8_t* entry(std::size_t start, std::size_t i, std::size_t entry_size) {
+        return out.data() + start + NODE_HEADER_SIZE + i * entry_size;
+    }
+
+    uint32_t offset_from(std::size_t start) const { return checked_u32(out.size() - start); }
+
+    static uint32_t checked_u32(std::size_t n) {
+        if (n > std::numeric_limits<uint32_t>::max()) [[unlikely]]
+            throw std::runtime_error("Indexed snapshot: container exceeds 4 GB");
+        return static_cast<uint32_t>(n);
+    }
+
+    void put_u32(uint32_t v) {
+        const std::size_t pos = out.size();
+        out.resize(pos + sizeof(v));
+        std::memcpy(out.data() + pos, &v, sizeof(v));
+    }
+
+    static void store_u32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, sizeof(v)); }
+};
+
+} // anonymous namespace
+
+ByteBuffer serialize_indexed(const ImmerValue& val) {
+    IndexedWriter w;
+    // The offset tables add 4-12 bytes per element on top of the standard size
+    const std::size_t standard_size = serialized_size(val);
+    w.out.reserve(1 + standard_size + standard_size / 4);
+    w.out.push_back(INDEXED_FORMAT_MARKER);
+    w.write_node(val);
+    return std::move(w.out);
+}
+
+// ============================================================
+// LazyValueView
+// ============================================================
+
+LazyValueView::LazyValueView(const uint8_t* data, std::size_t size) {
+    if (size < 2 || data[0] != INDEXED_FORMAT_MARKER) {
+        throw std::runtime_error("Not an indexed snapshot");
+    }
+    node_ = data + 1;
+    end_ = data + size;
+}
+
+bool LazyValueView::is_null() const noexcept {
+    return node_ && *node_ == TAG_NULL;
+}
+
+bool LazyValueView::is_string() const noexcept {
+    return node_ && *node_ == TAG_STRING;
+}
+
+bool LazyValueView::is_map() const noexcept {
+    return node_ && *node_ == TAG_MAP;
+}
+
+bool LazyValueView::is_vector() const noexcept {
+    return node_ && *node_ == TAG_VECTOR;
+}
+
+bool LazyValueView::is_array() const noexcept {
+    return node_ && *node_ == TAG_ARRAY;
+}
+
+bool LazyValueView::is_table() const noexcept {
+    return node_ && *node_ == TAG_TABLE;
+}
+
+bool LazyValueView::keyed() const noexcept {
+    return is_map() || is_table();
+}
+
+bool LazyValueView::indexed() const noexcept {
+    return is_vector() || is_array();
+}
+
+std::size_t LazyValueView::size() const {
+    if (!keyed() && !indexed())
+        return 0;
+    if (end_ - node_ < static_cast<std::ptrdiff_t>(NODE_HEADER_SIZE)) [[unlikely]]
+        corrupt();
+    const std::size_t count = load_u32(node_ + 1);
+    const std::size_t entry_size = keyed() ? KEYED_ENTRY_SIZE : INDEXED_ENTRY_SIZE;
+    if (count > (static_cast<std::size_t>(end_ - node_) - NODE_HEADER_SIZE) / entry_size) [[unlikely]]
+        corrupt();
+    return count;
+}
+
+const uint8_t* LazyValueView::child(uint32_t offset) const {
+    // Children live after the offset table, so a valid offset always moves forward
+    const std::size_t entry_size = keyed() ? KEYED_ENTRY_SIZE : INDEXED_ENTRY_SIZE;
+    const std::size_t table_end = NODE_HEADER_SIZE + size() * entry_size;
+    if (offset < table_end || offset >= static_cast<std::size_t>(end_ - node_)) [[unlikely]]
+        corrupt();
+    return node_ + offset;
+}
+
+std::string_view LazyValueView::key_at(std::size_t i) const {
+    if (!keyed() || i >= size())
+        return {};
+    const uint8_t* entry = node_ + NODE_HEADER_SIZE + i * KEYED_ENTRY_SIZE;
+    const std::size_t offset = load_u32(entry);
+    const std::size_t length = load_u32(entry + 4);
+    if (offset + length > static_cast<std::size_t>(end_ - node_)) [[unlikely]]
+        corrupt();
+    return {reinterpret_cast<const char*>(node_ + offset), length};
+}
+
+LazyValueView LazyValueView::value_at(std::size_t i) const {
+    if (keyed()) {
+        if (i >= size())
+            return {};
+        return {child(load_u32(node_ + NODE_HEADER_SIZE + i * KEYED_ENTRY_SIZE + 8)), end_};
+    }
+    if (indexed()) {
+        if (i >= size())
+            return {};
+        return {child(load_u32(node_ + NODE_HEADER_SIZE + i * INDEXED_ENTRY_SIZE)), end_};
+    }
+    return {};
+}
+
+LazyValueView LazyValueView::at(std::string_view key) const {
+    if (!keyed())
+        return {};
+    // Binary search over the sorted key table
+    std::size_t lo = 0;
+    std::size_t hi = size();
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const int cmp = key_at(mid).compare(key);
+        if (cmp == 0)
+            return value_at(mid);
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return {};
+}
+
+LazyValueView LazyValueView::at(std::size_t index) const {
+    return indexed() ? value_at(index) : LazyValueView{};
+}
+
+LazyValueView LazyValueView::at_path(PathView path) const {
+    LazyValueView current = *this;
+    for (const auto& elem : path) {
+        if (!current)
+            break;
+        if (auto* key = std::get_if<std::string_view>(&elem))
+            current = current.at(*key);
+        else
+            current = current.at(std::get<std::size_t>(elem));
+    }
+    return current;
+}
+
+std::string_view LazyValueView::as_string_view() const {
+    if (!is_string())
+        return {};
+    if (end_ - node_ < static_cast<std::ptrdiff_t>(NODE_HEADER_SIZE)) [[unlikely]]
+        corrupt();
+    const std::size_t length = load_u32(node_ + 1);
+    if (length > static_cast<std::size_t>(end_ - node_) - NODE_HEADER_SIZE) [[unlikely]]
+        corrupt();
+    return {reinterpret_cast<const char*>(node_ + NODE_HEADER_SIZE), length};
+}
+
+ImmerValue LazyValueView::materialize() const {
+    if (!node_)
+        return ImmerValue{};
+
+    const std::size_t count = size();
+    switch (*node_) {
+    case TAG_MAP: {
+        auto transient = ValueMap{}.transient();
+        for (std::size_t i = 0; i < count; ++i)
+            transient.set(std::string{key_at(i)}, value_at(i).materialize());
+        return ImmerValue{BoxedValueMap{transient.persistent()}};
+    }
+    case TAG_TABLE: {
+        auto transient = ValueTable{}.transient();
+        for (std::size_t i = 0; i < count; ++i)
+            transient.insert(TableEntry{std::string{key_at(i)}, value_at(i).materialize()});
+        return ImmerValue{BoxedValueTable{transient.persistent()}};
+    }
+    case TAG_VECTOR: {
+        auto transient = ValueVector{}.transient();
+        for (std::size_t i = 0; i < count; ++i)
+            transient.push_back(value_at(i).materialize());
+        return ImmerValue{BoxedValueVector{transient.persistent()}};
+    }
+    case TAG_ARRAY: {
+        std::vector<ImmerValue> temp;
+        temp.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            temp.push_back(value_at(i).materialize());
+        return ImmerValue{BoxedValueArray{
+            ValueArray(std::make_move_iterator(temp.begin()), std::make_move_iterator(temp.end()))}};
+    }
+    case COMPACT_FORMAT_MARKER:
+    case DICTIONARY_FORMAT_MARKER:
+    case INDEXED_FORMAT_MARKER:
+        corrupt(); // Not a type tag; don't let deserialize() reinterpret the node
+    default:
+        // Scalars and strings: standard encoding, decoded in place
+        return deserialize(node_, static_cast<std::size_t>(end_ - node_));
+    }
+}
+
+} // namespace lager_ext
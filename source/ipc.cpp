@@ -6,6 +6,7 @@
 
 #include <lager_ext/ipc.h>
 #include <lager_ext/serialization.h>
+#include <lager_ext/shared_memory_pool.h>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -14,7 +15,9 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <boost/interprocess/mapped_region.hpp>
 // Use Windows native shared memory to avoid Boost intermodule singleton issues
 #ifdef _WIN32
@@ -23,12 +26,24 @@
 #include <boost/interprocess/shared_memory_object.hpp>
 #endif
 #include <cstring>
+#include <deque>
+#include <limits>
 #include <thread>
+#include <utility>
 
 #ifdef _MSC_VER
 #include <intrin.h>
 #endif
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#endif
+
 namespace bip = boost::interprocess;
 
 namespace lager_ext {
@@ -38,13 +53,18 @@ namespace ipc {
 // Helper wrappers for serialization (using lager_ext::serialize/deserialize)
 //=============================================================================
 
+/// Channel payloads use the compact wire format (varint counts/lengths/ints):
+/// small maps with short keys shrink enough that most messages stay within
+/// Message::INLINE_SIZE. deserialize() auto-detects the format.
+static constexpr BinaryFormat CHANNEL_FORMAT = BinaryFormat::Compact;
+
 /// Serialize ImmerValue directly to a pre-allocated buffer (zero-copy optimization)
 /// @return Number of bytes written, or 0 if buffer too small or null value
 static size_t serialize_value_to(const ImmerValue& value, uint8_t* buffer, size_t buffer_size) {
     if (value.is_null()) {
         return 0;
     }
-    return lager_ext::serialize_to(value, buffer, buffer_size);
+    return lager_ext::serialize_to(value, buffer, buffer_size, CHANNEL_FORMAT);
 }
 
 /// Get serialized size without allocating
@@ -52,7 +72,7 @@ static size_t get_serialized_size(const ImmerValue& value) {
     if (value.is_null()) {
         return 0;
     }
-    return lager_ext::serialized_size(value);
+    return lager_ext::serialized_size(value, CHANNEL_FORMAT);
 }
 
 /// Deserialize ImmerValue from bytes
@@ -63,12 +83,55 @@ static ImmerValue deserialize_value(const uint8_t* data, size_t size) {
     return lager_ext::deserialize(data, size);
 }
 
+//=============================================================================
+// Blocking Wait Helpers
+//=============================================================================
+
+/// CPU pause instruction for busy-wait
+static inline void cpu_pause() {
+#ifdef _MSC_VER
+    _mm_pause();
+#else
+    __builtin_ia32_pause();
+#endif
+}
+
+using WaitClock = std::chrono::steady_clock;
+
+/// milliseconds::max() means forever; now() + max() would overflow
+static WaitClock::time_point deadline_after(std::chrono::milliseconds timeout) {
+    const auto now = WaitClock::now();
+    if (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(WaitClock::time_point::max() - now)) {
+        return WaitClock::time_point::max();
+    }
+    return now + timeout;
+}
+
+#ifdef __linux__
+/// Sleep while *word == expected, at most timeout (nullptr = forever).
+/// Not FUTEX_PRIVATE: the word lives in shared memory mapped by another process.
+static void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, const timespec* timeout) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+static void futex_wake_one(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "futex word must be a plain 32-bit integer");
+#endif
+
 //=============================================================================
 // Lock-Free Ring Buffer (Shared Memory Layout)
 //=============================================================================
 
 /// Shared memory header for the queue
 /// Uses cache-line padding to prevent false sharing between producer and consumer
+///
+/// The data area (capacity * sizeof(Message) bytes) holds either Message slots
+/// (FixedSlots: indices count messages) or framed records (ByteRing: indices
+/// count bytes).
 struct alignas(CACHE_LINE_SIZE) QueueHeader {
     // Magic number for validation
     static constexpr uint64_t MAGIC = 0x535053435155454Eull; // "SPSCQUEN"
@@ -78,37 +141,105 @@ struct alignas(CACHE_LINE_SIZE) QueueHeader {
     uint32_t capacity;
     size_t messageSize;
     size_t totalSize;
+    uint64_t poolSize; // Size of the "<name>_pool" SharedMemoryPool, 0 if none
+    ChannelMode mode;
 
     // Producer-owned: write index (only producer writes, consumer reads)
+    // writeCount: messages published (ByteRing only; FixedSlots uses writeIndex)
     alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> writeIndex;
-    char producerPadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> writeCount;
+    char producerPadding[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<uint64_t>)];
 
     // Consumer-owned: read index (only consumer writes, producer reads)
     alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> readIndex;
-    char consumerPadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> readCount;
+    char consumerPadding[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<uint64_t>)];
+
+    // Blocking wait: the consumer sets consumerSleeping before it sleeps on wakeSeq;
+    // the producer bumps wakeSeq and wakes it only while the flag is set. Own cache
+    // line, so a busy consumer never invalidates it under the producer.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> consumerSleeping;
+    std::atomic<uint32_t> wakeSeq;
+    char waitPadding[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<uint32_t>)];
 
     // Data follows header
-    // Message messages[capacity];
+    // Message messages[capacity];  or  uint8_t ring[capacity * sizeof(Message)];
+
+    static constexpr uint32_t VERSION = 4; // Version 4: futex wait word
 
-    QueueHeader(uint32_t cap)
-        : magic(MAGIC), version(1), capacity(cap), messageSize(sizeof(Message)),
-          totalSize(sizeof(QueueHeader) + cap * sizeof(Message)) {
+    QueueHeader(uint32_t cap, uint64_t pool, ChannelMode m)
+        : magic(MAGIC), version(VERSION), capacity(cap), messageSize(sizeof(Message)),
+          totalSize(sizeof(QueueHeader) + cap * sizeof(Message)), poolSize(pool), mode(m) {
         writeIndex.store(0, std::memory_order_relaxed);
+        writeCount.store(0, std::memory_order_relaxed);
         readIndex.store(0, std::memory_order_relaxed);
+        readCount.store(0, std::memory_order_relaxed);
+        consumerSleeping.store(0, std::memory_order_relaxed);
+        wakeSeq.store(0, std::memory_order_relaxed);
         std::memset(producerPadding, 0, sizeof(producerPadding));
         std::memset(consumerPadding, 0, sizeof(consumerPadding));
+        std::memset(waitPadding, 0, sizeof(waitPadding));
     }
 
-    bool isValid() const { return magic == MAGIC && version == 1 && capacity > 0; }
+    bool isValid() const { return magic == MAGIC && version == VERSION && capacity > 0; }
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this) + sizeof(QueueHeader); }
 
     Message* messageAt(uint64_t index) {
-        auto* data = reinterpret_cast<char*>(this) + sizeof(QueueHeader);
-        return reinterpret_cast<Message*>(data + (index % capacity) * sizeof(Message));
+        return reinterpret_cast<Message*>(data() + (index % capacity) * sizeof(Message));
     }
 };
 
 static_assert(offsetof(QueueHeader, writeIndex) % CACHE_LINE_SIZE == 0, "writeIndex must be cache-line aligned");
 static_assert(offsetof(QueueHeader, readIndex) % CACHE_LINE_SIZE == 0, "readIndex must be cache-line aligned");
+static_assert(offsetof(QueueHeader, consumerSleeping) % CACHE_LINE_SIZE == 0,
+              "consumerSleeping must be cache-line aligned");
+
+/// Framed record of a ByteRing channel: this header, the inline payload (if
+/// any), then padding up to RECORD_ALIGN. A record never wraps; when it does
+/// not fit before the end of the ring, the producer fills the tail with a
+/// padding record (PADDING_RECORD bit set in recordSize) and starts at offset 0.
+struct RecordHeader {
+    static constexpr uint32_t PADDING_RECORD = 0x80000000u;
+
+    uint32_t recordSize; ///< Header + payload + padding, in bytes
+    uint32_t msgId;
+    uint32_t dataSize;   ///< Payload size (inline, or in the pool if LargePayload)
+    uint32_t poolBlock;  ///< SharedMemoryPool offset / MIN_BLOCK_SIZE (if LargePayload)
+    uint64_t timestamp;
+    MessageDomain domain;
+    MessageFlags flags;
+    uint16_t requestId;
+    uint32_t reserved;
+
+    [[nodiscard]] bool uses_pool() const noexcept { return has_flag(flags, MessageFlags::LargePayload); }
+    [[nodiscard]] bool is_padding() const noexcept { return (recordSize & PADDING_RECORD) != 0; }
+    [[nodiscard]] uint32_t size() const noexcept { return recordSize & ~PADDING_RECORD; }
+
+    uint8_t* inlineData() noexcept { return reinterpret_cast<uint8_t*>(this + 1); }
+    const uint8_t* inlineData() const noexcept { return reinterpret_cast<const uint8_t*>(this + 1); }
+};
+
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader layout changed");
+
+constexpr size_t RECORD_ALIGN = 8;
+
+constexpr size_t record_bytes(size_t inlineSize) {
+    return (sizeof(RecordHeader) + inlineSize + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+static const uint8_t* inline_data(const Message& msg) {
+    return msg.inlineData;
+}
+
+static const uint8_t* inline_data(const RecordHeader& rec) {
+    return rec.inlineData();
+}
+
+/// Name of the large-payload pool that belongs to a channel
+static std::string pool_name(const std::string& channel_name) {
+    return channel_name + "_pool";
+}
 
 //=============================================================================
 // Channel::Impl
@@ -118,10 +249,25 @@ class Channel::Impl {
 public:
     Impl() = default;
 
-    bool createAsProducer(const std::string& name, size_t capacity) {
+    /// Create the shared memory (and the pool) and take one side of the channel.
+    /// The creator removes both on destruction (POSIX).
+    bool createChannel(const std::string& name, size_t capacity, size_t poolSize, ChannelMode mode,
+                       bool asProducer) {
         name_ = name;
-        isProducer_ = true;
+        isProducer_ = asProducer;
+        isOwner_ = true;
         capacity_ = capacity;
+        mode_ = mode;
+        setRingGeometry();
+
+        // Create the pool before the queue: a consumer that can open the queue can open the pool
+        if (poolSize > 0) {
+            pool_ = SharedMemoryPool::create(pool_name(name), poolSize);
+            if (!pool_) {
+                lastError_ = "Failed to create payload pool: " + SharedMemoryPool::last_error();
+                return false;
+            }
+        }
 
         try {
             // Calculate total size
@@ -147,7 +293,7 @@ public:
 #endif
 
             // Initialize header using placement new
-            header_ = new (region_.get_address()) QueueHeader(static_cast<uint32_t>(capacity));
+            header_ = new (region_.get_address()) QueueHeader(static_cast<uint32_t>(capacity), poolSize, mode);
 
             return true;
         } catch (const std::exception& e) {
@@ -156,9 +302,11 @@ public:
         }
     }
 
-    bool openAsConsumer(const std::string& name) {
+    /// Attach to a channel created by another process and take one side of it
+    bool openChannel(const std::string& name, bool asProducer) {
         name_ = name;
-        isProducer_ = false;
+        isProducer_ = asProducer;
+        isOwner_ = false;
 
         try {
 #ifdef _WIN32
@@ -185,6 +333,17 @@ public:
             }
 
             capacity_ = header_->capacity;
+            mode_ = header_->mode;
+            setRingGeometry();
+            cachedRead_ = header_->readIndex.load(std::memory_order_acquire);
+
+            if (header_->poolSize > 0) {
+                pool_ = SharedMemoryPool::open(pool_name(name));
+                if (!pool_) {
+                    lastError_ = "Failed to open payload pool: " + SharedMemoryPool::last_error();
+                    return false;
+                }
+            }
 
             return true;
         } catch (const std::exception& e) {
@@ -203,100 +362,254 @@ public:
             return false;
         }
 
-        // Fast path: null value
-        if (data.is_null()) {
-            return postRaw(msgId, nullptr, 0, domain);
+        uint64_t currentWrite = header_->writeIndex.load(std::memory_order_relaxed);
+        if (!writeValue(currentWrite, msgId, data, domain)) [[unlikely]] {
+            return false;
         }
+        publish(currentWrite, 1);
+        return true;
+    }
 
-        // Check serialized size first (no allocation)
-        size_t dataSize = get_serialized_size(data);
-        if (dataSize > Message::INLINE_SIZE) [[unlikely]] {
-            // TODO: Support large data via SharedMemoryPool
-            lastError_ = "Data too large for inline storage (max 232 bytes)";
+    bool postRaw(uint32_t msgId, const void* data, size_t size, MessageDomain domain) {
+        if (!isProducer_ || !header_) [[unlikely]] {
+            lastError_ = "Not a producer";
             return false;
         }
 
-        // Check if queue is full
         uint64_t currentWrite = header_->writeIndex.load(std::memory_order_relaxed);
-        uint64_t currentRead = header_->readIndex.load(std::memory_order_relaxed);
-
-        if (currentWrite - currentRead >= capacity_) [[unlikely]] {
-            lastError_ = "Queue full";
+        if (!writeMessage(currentWrite, msgId, size, domain, [&](uint8_t* dest) { std::memcpy(dest, data, size); }))
+            [[unlikely]] {
             return false;
         }
+        publish(currentWrite, 1);
+        return true;
+    }
+
+    size_t postBatch(std::span<const Channel::OutgoingMessage> messages) {
+        if (!isProducer_ || !header_) [[unlikely]] {
+            lastError_ = "Not a producer";
+            return 0;
+        }
+
+        // Fill the slots, then publish them all with one store
+        uint64_t currentWrite = header_->writeIndex.load(std::memory_order_relaxed);
+        size_t written = 0;
+        try {
+            while (written < messages.size()) {
+                const auto& m = messages[written];
+                if (!writeValue(currentWrite, m.msgId, m.data, m.domain)) {
+                    break;
+                }
+                ++written;
+            }
+        } catch (...) {
+            if (written > 0) {
+                publish(currentWrite, written);
+            }
+            throw;
+        }
 
-        // Get message slot and serialize directly into it (zero-copy)
-        Message* msg = header_->messageAt(currentWrite);
-        msg->msgId = msgId;
-        msg->timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
-        msg->domain = domain;
-        msg->flags = MessageFlags::None;
-        msg->requestId = 0;
-        msg->poolOffset = 0;
+        if (written > 0) [[likely]] {
+            publish(currentWrite, written);
+        }
+        return written;
+    }
 
-        // Serialize directly to shared memory - no intermediate buffer
-        size_t written = serialize_value_to(data, msg->inlineData, Message::INLINE_SIZE);
-        msg->dataSize = static_cast<uint32_t>(written);
+    /// Make messages written up to write visible to the consumer
+    void publish(uint64_t write, size_t count) {
+        if (mode_ == ChannelMode::ByteRing) {
+            // Only the producer writes writeCount; relaxed, the release store below orders it
+            header_->writeCount.store(header_->writeCount.load(std::memory_order_relaxed) + count,
+                                      std::memory_order_relaxed);
+        }
+        // Release: all writes to the messages are visible before the index update
+        header_->writeIndex.store(write, std::memory_order_release);
+        wakeConsumer();
+    }
 
-        // Publish: increment write index with release semantics
-        header_->writeIndex.store(currentWrite + 1, std::memory_order_release);
+    /// Wake the consumer if it is asleep in waitForMessage
+    void wakeConsumer() {
+#ifdef __linux__
+        // Pairs with the fence in waitForMessage: either we see the flag, or the
+        // consumer sees the new writeIndex before it sleeps
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (header_->consumerSleeping.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+            header_->wakeSeq.fetch_add(1, std::memory_order_relaxed);
+            futex_wake_one(&header_->wakeSeq);
+        }
+#endif
+    }
 
-        return true;
+    /// Write a serialized value at write (not yet published) and advance write past it
+    bool writeValue(uint64_t& write, uint32_t msgId, const ImmerValue& data, MessageDomain domain) {
+        // Check serialized size first (no allocation); null values have no payload
+        size_t dataSize = get_serialized_size(data);
+        // Serialize directly into shared memory - no intermediate buffer
+        return writeMessage(write, msgId, dataSize, domain,
+                            [&](uint8_t* dest) { serialize_value_to(data, dest, dataSize); });
     }
 
-    bool postRaw(uint32_t msgId, const void* data, size_t size, MessageDomain domain) {
-        if (!isProducer_ || !header_) [[unlikely]] {
-            lastError_ = "Not a producer";
+    /// Write one message at write (not yet published) and advance write past it.
+    /// fill(dest) writes exactly size payload bytes, inline or into a pool block.
+    template <typename FillFn>
+    bool writeMessage(uint64_t& write, uint32_t msgId, size_t size, MessageDomain domain, FillFn&& fill) {
+        if (mode_ == ChannelMode::ByteRing) {
+            return writeRecord(write, msgId, size, domain, fill);
+        }
+
+        if (freeSlots(write) == 0) [[unlikely]] {
+            lastError_ = "Queue full";
             return false;
         }
 
-        // Check if data fits inline
+        Message* msg = header_->messageAt(write);
+        MessageFlags flags = MessageFlags::None;
+        uint64_t poolOffset = 0;
         if (size > Message::INLINE_SIZE) [[unlikely]] {
-            // TODO: Support large data via SharedMemoryPool
-            lastError_ = "Data too large for inline storage (max 232 bytes)";
-            return false;
+            if (!writeToPool(size, fill, poolOffset)) {
+                return false;
+            }
+            flags = MessageFlags::LargePayload;
+            inFlight_.push_back({write, poolOffset});
+        } else if (size > 0) [[likely]] {
+            fill(msg->inlineData);
         }
+        stamp(*msg, msgId, size, domain, flags, poolOffset);
 
-        // Check if queue is full
-        // Note: Producer only needs to know the value, not synchronize data
-        // Using relaxed for readIndex is safe here - we're just checking capacity
-        uint64_t currentWrite = header_->writeIndex.load(std::memory_order_relaxed);
-        uint64_t currentRead = header_->readIndex.load(std::memory_order_relaxed);
+        write += 1;
+        return true;
+    }
 
-        if (currentWrite - currentRead >= capacity_) [[unlikely]] {
+    /// ByteRing version of writeMessage: frame the message as a record
+    template <typename FillFn>
+    bool writeRecord(uint64_t& write, uint32_t msgId, size_t size, MessageDomain domain, FillFn& fill) {
+        const bool inlinePayload = size <= ringInlineLimit_;
+        const size_t bytes = record_bytes(inlinePayload ? size : 0);
+
+        // Records never wrap: skip the tail of the ring if this one does not fit there
+        const size_t offset = static_cast<size_t>(write % ringSize_);
+        const size_t tail = ringSize_ - offset;
+        const size_t skip = bytes <= tail ? 0 : tail;
+        if (freeBytes(write, skip + bytes) < skip + bytes) [[unlikely]] {
             lastError_ = "Queue full";
             return false;
         }
 
-        // Get message slot
-        Message* msg = header_->messageAt(currentWrite);
+        const uint64_t recordPos = write + skip;
+        auto* rec = recordAt(recordPos);
+        MessageFlags flags = MessageFlags::None;
+        uint64_t poolOffset = 0;
+        if (!inlinePayload) [[unlikely]] {
+            if (!writeToPool(size, fill, poolOffset)) {
+                return false;
+            }
+            flags = MessageFlags::LargePayload;
+            inFlight_.push_back({recordPos, poolOffset});
+        } else if (size > 0) [[likely]] {
+            fill(rec->inlineData());
+        }
+        stamp(*rec, msgId, size, domain, flags, poolOffset);
+        rec->recordSize = static_cast<uint32_t>(bytes);
+        rec->reserved = 0;
+
+        // Written last: the padding record is only needed once the real one is in place
+        if (skip > 0) {
+            recordAt(write)->recordSize = static_cast<uint32_t>(skip) | RecordHeader::PADDING_RECORD;
+        }
+
+        write = recordPos + bytes;
+        return true;
+    }
 
-        // Fill message (initialize all fields)
-        msg->msgId = msgId;
-        msg->dataSize = static_cast<uint32_t>(size);
-        msg->timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
-        msg->domain = domain;
-        msg->flags = MessageFlags::None;
-        msg->requestId = 0;
-        msg->poolOffset = 0;
+    template <typename Record>
+    static void stamp(Record& r, uint32_t msgId, size_t size, MessageDomain domain, MessageFlags flags,
+                      uint64_t poolOffset) {
+        r.msgId = msgId;
+        r.dataSize = static_cast<uint32_t>(size);
+        r.timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        r.domain = domain;
+        r.flags = flags;
+        r.requestId = 0;
+        r.poolBlock = static_cast<uint32_t>(poolOffset / MIN_BLOCK_SIZE);
+    }
 
-        if (size > 0) [[likely]] {
-            std::memcpy(msg->inlineData, data, size);
+    /// Slots the producer may fill starting at index write. Uses the cached
+    /// consumer index and only re-reads the shared one (a cache-line transfer
+    /// from the consumer's core) when the cached value says the queue is full.
+    size_t freeSlots(uint64_t write) {
+        if (write - cachedRead_ >= capacity_) {
+            // Acquire: the consumer's reads of the slots happen before we overwrite them
+            cachedRead_ = header_->readIndex.load(std::memory_order_acquire);
+        }
+        return capacity_ - static_cast<size_t>(write - cachedRead_);
+    }
+
+    /// ByteRing version of freeSlots: free bytes from write, refreshed when fewer than needed
+    size_t freeBytes(uint64_t write, size_t needed) {
+        if (ringSize_ - (write - cachedRead_) < needed) {
+            cachedRead_ = header_->readIndex.load(std::memory_order_acquire);
+        }
+        return ringSize_ - static_cast<size_t>(write - cachedRead_);
+    }
+
+    /// Write a payload that does not fit inline into a pool block. The block is
+    /// reclaimed by the producer once the consumer's readIndex has moved past the
+    /// message that carries it (see reclaimBlocks); the caller records it in inFlight_.
+    template <typename FillFn>
+    bool writeToPool(size_t size, FillFn& fill, uint64_t& outOffset) {
+        if (!pool_) {
+            lastError_ = "Data too large for inline storage and channel has no payload pool";
+            return false;
+        }
+        if (size > std::numeric_limits<uint32_t>::max()) {
+            lastError_ = "Data too large (max 4 GB)";
+            return false;
         }
 
-        // Publish: increment write index with release semantics
-        // This ensures all writes to the message are visible before the index update
-        header_->writeIndex.store(currentWrite + 1, std::memory_order_release);
+        reclaimBlocks();
+        SharedMemoryPool::Block block = pool_->allocate(size);
+        if (!block) {
+            // Backpressure: blocks come back as the consumer catches up
+            lastError_ = "Pool exhausted";
+            return false;
+        }
 
+        try {
+            fill(block.data());
+        } catch (...) {
+            pool_->deallocate(block.offset());
+            throw;
+        }
+        outOffset = block.offset();
         return true;
     }
 
+    /// Return the blocks of all messages the consumer has finished with.
+    /// Only the producer touches the pool's allocator state, so the pool
+    /// never sees concurrent allocate/deallocate calls.
+    void reclaimBlocks() {
+        if (inFlight_.empty()) {
+            return;
+        }
+        // Acquire: the consumer's reads of the block happen before it advances readIndex
+        uint64_t currentRead = header_->readIndex.load(std::memory_order_acquire);
+        cachedRead_ = currentRead;
+        while (!inFlight_.empty() && inFlight_.front().sequence < currentRead) {
+            pool_->deallocate(inFlight_.front().offset);
+            inFlight_.pop_front();
+        }
+    }
+
     bool canPost() const {
         if (!header_) [[unlikely]]
             return false;
         // Both can use relaxed - this is just a capacity check, not synchronizing data
         uint64_t write = header_->writeIndex.load(std::memory_order_relaxed);
         uint64_t read = header_->readIndex.load(std::memory_order_relaxed);
+        if (mode_ == ChannelMode::ByteRing) {
+            // Room for a payload-less record, ignoring a possible skip at the end of the ring
+            return ringSize_ - (write - read) >= sizeof(RecordHeader);
+        }
         return (write - read) < capacity_;
     }
 
@@ -304,6 +617,11 @@ public:
         if (!header_) [[unlikely]]
             return 0;
         // Relaxed is fine for approximate count - no data dependency
+        if (mode_ == ChannelMode::ByteRing) {
+            uint64_t written = header_->writeCount.load(std::memory_order_relaxed);
+            uint64_t read = header_->readCount.load(std::memory_order_relaxed);
+            return written > read ? static_cast<size_t>(written - read) : 0;
+        }
         uint64_t write = header_->writeIndex.load(std::memory_order_relaxed);
         uint64_t read = header_->readIndex.load(std::memory_order_relaxed);
         return static_cast<size_t>(write - read);
@@ -313,73 +631,229 @@ public:
     // Consumer Operations
     //-------------------------------------------------------------------------
 
+    /// Visit up to maxCount published messages in order and consume them with a
+    /// single readIndex store. visit(record) gets a Message or a RecordHeader
+    /// and returns false to stop before consuming that message. If visit
+    /// throws, the message it threw on is consumed too, so the queue keeps moving.
+    /// @return Number of messages consumed
+    template <typename VisitFn>
+    size_t consume(size_t maxCount, VisitFn&& visit) {
+        const uint64_t start = header_->readIndex.load(std::memory_order_relaxed);
+        uint64_t read = start;
+        size_t done = 0;
+
+        while (done < maxCount) {
+            if (read >= cachedWrite_) {
+                // Acquire: pairs with the producer's release store, making the messages visible.
+                // Uses the cached producer index otherwise, so the shared one moves once per batch.
+                cachedWrite_ = header_->writeIndex.load(std::memory_order_acquire);
+                if (read >= cachedWrite_) {
+                    break; // Empty - common case for polling
+                }
+            }
+
+            bool accepted = false;
+            uint64_t next = read;
+            try {
+                if (mode_ == ChannelMode::ByteRing) {
+                    const RecordHeader* rec = recordAt(read);
+                    if (rec->is_padding()) {
+                        // A padding record is always published together with the record after it
+                        read += rec->size();
+                        rec = recordAt(read);
+                    }
+                    next = read + rec->size();
+                    accepted = visit(*rec);
+                } else {
+                    next = read + 1;
+                    accepted = visit(*header_->messageAt(read));
+                }
+            } catch (...) {
+                release(next, done + 1);
+                throw;
+            }
+            if (!accepted) {
+                break;
+            }
+            read = next;
+            ++done;
+        }
+
+        if (read != start) {
+            release(read, done);
+        }
+        return done;
+    }
+
+    /// Hand consumed messages (and their pool blocks) back to the producer
+    void release(uint64_t read, size_t count) {
+        if (mode_ == ChannelMode::ByteRing) {
+            header_->readCount.store(header_->readCount.load(std::memory_order_relaxed) + count,
+                                     std::memory_order_relaxed);
+        }
+        // Release: our reads of the messages happen before the producer reuses them
+        header_->readIndex.store(read, std::memory_order_release);
+    }
+
+    /// Decode a message into result, deserializing in place from inline storage
+    /// or the pool block. Returns false (lastError_ says why) if the message
+    /// references a pool block that cannot be resolved; the caller drops it.
+    template <typename Record>
+    bool decodeMessage(const Record& msg, Channel::ReceivedMessage& result) {
+        result.msgId = msg.msgId;
+        result.timestamp = msg.timestamp;
+        result.domain = msg.domain;
+        result.flags = msg.flags;
+        result.requestId = msg.requestId;
+        result.data = ImmerValue{};
+
+        if (msg.dataSize > 0) {
+            const uint8_t* payload = payloadOf(msg);
+            if (!payload) [[unlikely]] {
+                return false;
+            }
+            result.data = deserialize_value(payload, msg.dataSize);
+        }
+        return true;
+    }
+
     std::optional<Channel::ReceivedMessage> tryReceive() {
         if (!header_) [[unlikely]] {
             lastError_ = "Channel not initialized";
             return std::nullopt;
         }
 
-        // Check if queue is empty
-        uint64_t currentRead = header_->readIndex.load(std::memory_order_relaxed);
-        uint64_t currentWrite = header_->writeIndex.load(std::memory_order_acquire);
+        // Broken messages are consumed and dropped; keep going until a good one or an empty queue
+        std::optional<Channel::ReceivedMessage> result;
+        while (!result && consume(1, [&](const auto& msg) {
+                   Channel::ReceivedMessage received;
+                   if (decodeMessage(msg, received)) [[likely]] {
+                       result = std::move(received);
+                   }
+                   return true;
+               }) > 0) {
+        }
+        return result;
+    }
 
-        if (currentRead >= currentWrite) [[likely]] {
-            return std::nullopt; // Empty - common case for polling
+    size_t receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return 0;
         }
 
-        // Get message
-        Message* msg = header_->messageAt(currentRead);
+        size_t appended = 0;
+        consume(maxCount, [&](const auto& msg) {
+            Channel::ReceivedMessage received;
+            if (decodeMessage(msg, received)) [[likely]] {
+                out.push_back(std::move(received));
+                ++appended;
+            }
+            return true;
+        });
+        return appended;
+    }
+
+    size_t drainRaw(const Channel::RawHandler& handler, size_t maxCount) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return 0;
+        }
 
-        ReceivedMessage result;
-        result.msgId = msg->msgId;
-        result.timestamp = msg->timestamp;
-        result.domain = msg->domain;
-        result.flags = msg->flags;
-        result.requestId = msg->requestId;
+        size_t handled = 0;
+        consume(maxCount, [&](const auto& msg) {
+            std::span<const uint8_t> payload;
+            if (msg.dataSize > 0) {
+                const uint8_t* data = payloadOf(msg);
+                if (!data) [[unlikely]] {
+                    return true; // Drop the broken message
+                }
+                payload = {data, msg.dataSize};
+            }
+            ++handled;
+            handler(msg.msgId, payload);
+            return true;
+        });
+        return handled;
+    }
 
-        // Deserialize data from inline storage
-        // TODO: If LargePayload flag is set, read from SharedMemoryPool using poolOffset
-        if (msg->dataSize > 0) {
-            result.data = deserialize_value(msg->inlineData, msg->dataSize);
-        } else {
-            result.data = ImmerValue{};
+    std::optional<Channel::ReceivedMessage> receive(std::chrono::milliseconds timeout) {
+        const auto deadline = deadline_after(timeout);
+        while (true) {
+            if (auto msg = tryReceive()) {
+                return msg;
+            }
+            if (!waitUntil(deadline)) {
+                return std::nullopt;
+            }
         }
+    }
 
-        // Consume: increment read index with release semantics
-        header_->readIndex.store(currentRead + 1, std::memory_order_release);
+    bool waitForMessage(std::chrono::milliseconds timeout) {
+        if (isProducer_ || !header_) [[unlikely]] {
+            lastError_ = "Not a consumer";
+            return false;
+        }
+        return waitUntil(deadline_after(timeout));
+    }
 
-        return result;
+    /// Check for a published, unconsumed message (consumer side)
+    bool hasMessage() {
+        uint64_t read = header_->readIndex.load(std::memory_order_relaxed);
+        if (read < cachedWrite_) {
+            return true;
+        }
+        cachedWrite_ = header_->writeIndex.load(std::memory_order_acquire);
+        return read < cachedWrite_;
     }
 
-    std::optional<Channel::ReceivedMessage> receive(std::chrono::milliseconds timeout) {
-        auto deadline = std::chrono::steady_clock::now() + timeout;
+    using Clock = WaitClock;
 
-        // Adaptive spinning: start with busy-wait, then sleep
-        int spinCount = 0;
+    /// Hybrid wait: bounded spin (a producer that is mid-burst answers within
+    /// microseconds), then sleep until the producer publishes or the deadline passes
+    bool waitUntil(Clock::time_point deadline) {
         constexpr int MAX_SPINS = 1000;
+        for (int spin = 0; spin < MAX_SPINS; ++spin) {
+            if (hasMessage()) {
+                return true;
+            }
+            cpu_pause();
+        }
 
         while (true) {
-            if (auto msg = tryReceive()) {
-                return msg;
+            if (hasMessage()) {
+                return true;
+            }
+            const auto now = Clock::now();
+            if (now >= deadline) {
+                return false;
             }
 
-            if (std::chrono::steady_clock::now() >= deadline) {
-                return std::nullopt;
+#ifdef __linux__
+            // Announce the sleep, then re-check: a publish that raced with us either
+            // shows up in the re-check or sees the flag and bumps wakeSeq
+            const uint32_t seq = header_->wakeSeq.load(std::memory_order_relaxed);
+            header_->consumerSleeping.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (hasMessage()) {
+                header_->consumerSleeping.store(0, std::memory_order_relaxed);
+                return true;
             }
 
-            // Adaptive backoff
-            if (spinCount < MAX_SPINS) {
-                spinCount++;
-// CPU pause instruction for busy-wait
-#ifdef _MSC_VER
-                _mm_pause();
-#else
-                __builtin_ia32_pause();
-#endif
+            if (deadline == Clock::time_point::max()) {
+                futex_wait(&header_->wakeSeq, seq, nullptr);
             } else {
-                // Sleep to avoid burning CPU
-                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+                timespec ts{};
+                ts.tv_sec = static_cast<time_t>(remaining.count() / 1000000000);
+                ts.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+                futex_wait(&header_->wakeSeq, seq, &ts);
             }
+            header_->consumerSleeping.store(0, std::memory_order_relaxed);
+#else
+            // Sleep to avoid burning CPU
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+#endif
         }
     }
 
@@ -388,27 +862,49 @@ public:
             return 0;
         }
 
-        uint64_t currentRead = header_->readIndex.load(std::memory_order_relaxed);
-        uint64_t currentWrite = header_->writeIndex.load(std::memory_order_acquire);
+        int result = 0;
+        bool dropped = false;
+        do {
+            dropped = false;
+            consume(1, [&](const auto& msg) {
+                // Copy inline or pool data
+                if (msg.dataSize > 0) [[likely]] {
+                    const uint8_t* payload = payloadOf(msg);
+                    if (!payload) [[unlikely]] {
+                        dropped = true; // Consume the broken message and try the next one
+                        return true;
+                    }
+                    if (msg.dataSize > maxSize) [[unlikely]] {
+                        outMsgId = msg.msgId;
+                        result = -1; // Buffer too small - leave the message in the queue
+                        return false;
+                    }
+                    std::memcpy(outData, payload, msg.dataSize);
+                }
+                outMsgId = msg.msgId;
+                result = static_cast<int>(msg.dataSize);
+                return true;
+            });
+        } while (dropped);
+        return result;
+    }
 
-        if (currentRead >= currentWrite) [[likely]] {
-            return 0; // Empty - common case for polling
+    /// Payload bytes of a message (inline or in the pool), nullptr if the pool block is invalid
+    template <typename Record>
+    const uint8_t* payloadOf(const Record& msg) {
+        if (!msg.uses_pool()) [[likely]] {
+            return inline_data(msg);
         }
-
-        Message* msg = header_->messageAt(currentRead);
-        outMsgId = msg->msgId;
-
-        // Copy inline data
-        if (msg->dataSize > 0) [[likely]] {
-            if (msg->dataSize > maxSize) [[unlikely]] {
-                return -1; // Buffer too small
-            }
-            std::memcpy(outData, msg->inlineData, msg->dataSize);
+        if (!pool_) [[unlikely]] {
+            lastError_ = "Large payload received but channel has no payload pool";
+            return nullptr;
         }
-
-        int result = static_cast<int>(msg->dataSize);
-        header_->readIndex.store(currentRead + 1, std::memory_order_release);
-        return result;
+        auto span = pool_->get(uint64_t{msg.poolBlock} * MIN_BLOCK_SIZE, msg.dataSize);
+        if (span.size() != msg.dataSize) [[unlikely]] {
+            lastError_ = "Invalid payload pool block";
+            return nullptr;
+        }
+        return span.data();
     }
 
     //-------------------------------------------------------------------------
@@ -418,13 +914,14 @@ public:
     const std::string& name() const { return name_; }
     bool isProducer() const { return isProducer_; }
     size_t capacity() const { return capacity_; }
+    ChannelMode mode() const { return mode_; }
     const std::string& lastError() const { return lastError_; }
 
     ~Impl() {
 #ifndef _WIN32
-        // POSIX: cleanup shared memory if we are producer
+        // POSIX: cleanup shared memory if we created it
         // Windows: kernel handles cleanup automatically via reference counting
-        if (isProducer_ && !name_.empty()) {
+        if (isOwner_ && !name_.empty()) {
             try {
                 bip::shared_memory_object::remove(name_.c_str());
             } catch (...) {}
@@ -433,9 +930,23 @@ public:
     }
 
 private:
+    /// ByteRing: ring size and the largest payload kept inline (larger ones use the pool)
+    void setRingGeometry() {
+        ringSize_ = capacity_ * sizeof(Message);
+        ringInlineLimit_ = std::min<size_t>(ringSize_ / 4, size_t{1} << 30);
+    }
+
+    RecordHeader* recordAt(uint64_t pos) {
+        return reinterpret_cast<RecordHeader*>(header_->data() + pos % ringSize_);
+    }
+
     std::string name_;
     bool isProducer_ = false;
+    bool isOwner_ = false;
     size_t capacity_ = 0;
+    ChannelMode mode_ = ChannelMode::FixedSlots;
+    size_t ringSize_ = 0;
+    size_t ringInlineLimit_ = 0;
     mutable std::string lastError_;
 
 #ifdef _WIN32
@@ -445,6 +956,19 @@ private:
 #endif
     bip::mapped_region region_;
     QueueHeader* header_ = nullptr;
+
+    // Last seen value of the other side's index (producer: readIndex, consumer: writeIndex).
+    // Re-read only when it says full/empty, so the shared cache line moves once per batch.
+    uint64_t cachedRead_ = 0;
+    uint64_t cachedWrite_ = 0;
+
+    // Large payloads: blocks posted but not yet reclaimed (producer only), in queue order
+    struct PoolLease {
+        uint64_t sequence; // Slot index / ring position of the message that carries the block
+        uint64_t offset;
+    };
+    std::unique_ptr<SharedMemoryPool> pool_;
+    std::deque<PoolLease> inFlight_;
 };
 
 //=============================================================================
@@ -456,9 +980,19 @@ Channel::~Channel() = default;
 Channel::Channel(Channel&&) noexcept = default;
 Channel& Channel::operator=(Channel&&) noexcept = default;
 
-std::unique_ptr<Channel> Channel::create(const std::string& name, size_t capacity) {
+std::unique_ptr<Channel> Channel::create(const std::string& name, size_t capacity, size_t poolSize,
+                                         ChannelMode mode) {
     auto channel = std::unique_ptr<Channel>(new Channel());
-    if (!channel->impl_->createAsProducer(name, capacity)) {
+    if (!channel->impl_->createChannel(name, capacity, poolSize, mode, true)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+std::unique_ptr<Channel> Channel::createForConsumer(const std::string& name, size_t capacity, size_t poolSize,
+                                                    ChannelMode mode) {
+    auto channel = std::unique_ptr<Channel>(new Channel());
+    if (!channel->impl_->createChannel(name, capacity, poolSize, mode, false)) {
         return nullptr;
     }
     return channel;
@@ -466,7 +1000,15 @@ std::unique_ptr<Channel> Channel::create(const std::string& name, size_t capacit
 
 std::unique_ptr<Channel> Channel::open(const std::string& name) {
     auto channel = std::unique_ptr<Channel>(new Channel());
-    if (!channel->impl_->openAsConsumer(name)) {
+    if (!channel->impl_->openChannel(name, false)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+std::unique_ptr<Channel> Channel::openForProducer(const std::string& name) {
+    auto channel = std::unique_ptr<Channel>(new Channel());
+    if (!channel->impl_->openChannel(name, true)) {
         return nullptr;
     }
     return channel;
@@ -480,6 +1022,10 @@ bool Channel::postRaw(uint32_t msgId, const void* data, size_t size, MessageDoma
     return impl_->postRaw(msgId, data, size, domain);
 }
 
+size_t Channel::postBatch(std::span<const OutgoingMessage> messages) {
+    return impl_->postBatch(messages);
+}
+
 bool Channel::canPost() const {
     return impl_->canPost();
 }
@@ -500,6 +1046,18 @@ int Channel::tryReceiveRaw(uint32_t& outMsgId, void* outData, size_t maxSize) {
     return impl_->tryReceiveRaw(outMsgId, outData, maxSize);
 }
 
+bool Channel::waitForMessage(std::chrono::milliseconds timeout) {
+    return impl_->waitForMessage(timeout);
+}
+
+size_t Channel::receiveBatch(std::vector<ReceivedMessage>& out, size_t maxCount) {
+    return impl_->receiveBatch(out, maxCount);
+}
+
+size_t Channel::drainRaw(const RawHandler& handler, size_t maxCount) {
+    return impl_->drainRaw(handler, maxCount);
+}
+
 const std::string& Channel::name() const {
     return impl_->name();
 }
@@ -512,6 +1070,10 @@ size_t Channel::capacity() const {
     return impl_->capacity();
 }
 
+ChannelMode Channel::mode() const {
+    return impl_->mode();
+}
+
 const std::string& Channel::lastError() const {
     return impl_->lastError();
 }
@@ -522,19 +1084,19 @@ const std::string& Channel::lastError() const {
 
 class ChannelPair::Impl {
 public:
-    bool createPair(const std::string& name, size_t capacity) {
+    bool createPair(const std::string& name, size_t capacity, size_t poolSize, ChannelMode mode) {
         name_ = name;
         isCreator_ = true;
 
         // Create A->B channel (we produce, they consume)
-        outChannel_ = Channel::create(name + "_AtoB", capacity);
+        outChannel_ = Channel::create(name + "_AtoB", capacity, poolSize, mode);
         if (!outChannel_) {
             lastError_ = "Failed to create outgoing channel";
             return false;
         }
 
         // Create B->A channel (they produce, we consume)
-        inChannel_ = Channel::create(name + "_BtoA", capacity);
+        inChannel_ = Channel::createForConsumer(name + "_BtoA", capacity, poolSize, mode);
         if (!inChannel_) {
             lastError_ = "Failed to create incoming channel";
             return false;
@@ -558,7 +1120,7 @@ public:
         // Note: We need to wait for creator to create this
         int retries = 100;
         while (retries-- > 0) {
-            outChannel_ = Channel::open(name + "_BtoA");
+            outChannel_ = Channel::openForProducer(name + "_BtoA");
             if (outChannel_)
                 break;
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -584,6 +1146,24 @@ public:
         return outChannel_->postRaw(msgId, data, size);
     }
 
+    size_t postBatch(std::span<const Channel::OutgoingMessage> messages) {
+        if (!outChannel_)
+            return 0;
+        return outChannel_->postBatch(messages);
+    }
+
+    size_t receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount) {
+        if (!inChannel_)
+            return 0;
+        return inChannel_->receiveBatch(out, maxCount);
+    }
+
+    size_t drainRaw(const Channel::RawHandler& handler, size_t maxCount) {
+        if (!inChannel_)
+            return 0;
+        return inChannel_->drainRaw(handler, maxCount);
+    }
+
     std::optional<Channel::ReceivedMessage> tryReceive() {
         if (!inChannel_)
             return std::nullopt;
@@ -602,6 +1182,12 @@ public:
         return inChannel_->receive(timeout);
     }
 
+    bool waitForMessage(std::chrono::milliseconds timeout) {
+        if (!inChannel_)
+            return false;
+        return inChannel_->waitForMessage(timeout);
+    }
+
     std::optional<ImmerValue> send(uint32_t msgId, const ImmerValue& data, std::chrono::milliseconds timeout) {
         if (!post(msgId, data)) {
             return std::nullopt;
@@ -636,9 +1222,10 @@ ChannelPair::~ChannelPair() = default;
 ChannelPair::ChannelPair(ChannelPair&&) noexcept = default;
 ChannelPair& ChannelPair::operator=(ChannelPair&&) noexcept = default;
 
-std::unique_ptr<ChannelPair> ChannelPair::create(const std::string& name, size_t capacity) {
+std::unique_ptr<ChannelPair> ChannelPair::create(const std::string& name, size_t capacity, size_t poolSize,
+                                                 ChannelMode mode) {
     auto pair = std::unique_ptr<ChannelPair>(new ChannelPair());
-    if (!pair->impl_->createPair(name, capacity)) {
+    if (!pair->impl_->createPair(name, capacity, poolSize, mode)) {
         return nullptr;
     }
     return pair;
@@ -660,6 +1247,18 @@ bool ChannelPair::postRaw(uint32_t msgId, const void* data, size_t size) {
     return impl_->postRaw(msgId, data, size);
 }
 
+size_t ChannelPair::postBatch(std::span<const Channel::OutgoingMessage> messages) {
+    return impl_->postBatch(messages);
+}
+
+size_t ChannelPair::receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount) {
+    return impl_->receiveBatch(out, maxCount);
+}
+
+size_t ChannelPair::drainRaw(const Channel::RawHandler& handler, size_t maxCount) {
+    return impl_->drainRaw(handler, maxCount);
+}
+
 std::optional<Channel::ReceivedMessage> ChannelPair::tryReceive() {
     return impl_->tryReceive();
 }
@@ -672,6 +1271,10 @@ std::optional<Channel::ReceivedMessage> ChannelPair::receive(std::chrono::millis
     return impl_->receive(timeout);
 }
 
+bool ChannelPair::waitForMessage(std::chrono::milliseconds timeout) {
+    return impl_->waitForMessage(timeout);
+}
+
 std::optional<ImmerValue> ChannelPair::send(uint32_t msgId, const ImmerValue& data,
                                        std::chrono::milliseconds timeout) {
     return impl_->send(msgId, data, timeout);
@@ -689,5 +1292,552 @@ const std::string& ChannelPair::lastError() const {
     return impl_->lastError();
 }
 
+//=============================================================================
+// ChannelMPMC (Shared Memory Layout)
+//=============================================================================
+
+/// One slot of a ChannelMPMC: the Vyukov sequence number and the message.
+/// sequence == position: free for the producer that claims position;
+/// sequence == position + 1: published, for the consumer that claims position;
+/// the consumer then sets it to position + capacity for the next lap.
+struct alignas(CACHE_LINE_SIZE) MPMCSlot {
+    std::atomic<uint64_t> sequence;
+    Message message;
+};
+
+static_assert(sizeof(MPMCSlot) % CACHE_LINE_SIZE == 0, "MPMCSlot must not share cache lines");
+
+/// Shared memory header of a ChannelMPMC, followed by capacity MPMCSlots
+struct alignas(CACHE_LINE_SIZE) MPMCQueueHeader {
+    static constexpr uint64_t MAGIC = 0x4D504D435155454Eull; // "MPMCQUEN"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t capacity; // Power of two
+    size_t slotSize;
+
+    // Claimed by producers / consumers with a CAS; each on its own cache line
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> enqueuePos;
+    char enqueuePadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dequeuePos;
+    char dequeuePadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+    // Blocking wait: like QueueHeader, but a count, as several consumers may sleep
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> consumersSleeping;
+    std::atomic<uint32_t> wakeSeq;
+    char waitPadding[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<uint32_t>)];
+
+    explicit MPMCQueueHeader(uint32_t cap)
+        : magic(MAGIC), version(VERSION), capacity(cap), slotSize(sizeof(MPMCSlot)) {
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos.store(0, std::memory_order_relaxed);
+        consumersSleeping.store(0, std::memory_order_relaxed);
+        wakeSeq.store(0, std::memory_order_relaxed);
+        std::memset(enqueuePadding, 0, sizeof(enqueuePadding));
+        std::memset(dequeuePadding, 0, sizeof(dequeuePadding));
+        std::memset(waitPadding, 0, sizeof(waitPadding));
+    }
+
+    bool isValid() const {
+        return magic == MAGIC && version == VERSION && capacity > 0 && (capacity & (capacity - 1)) == 0 &&
+               slotSize == sizeof(MPMCSlot);
+    }
+
+    MPMCSlot* slotAt(uint64_t pos) {
+        return reinterpret_cast<MPMCSlot*>(reinterpret_cast<uint8_t*>(this) + sizeof(MPMCQueueHeader)) +
+               (pos & (capacity - 1));
+    }
+};
+
+static_assert(offsetof(MPMCQueueHeader, enqueuePos) % CACHE_LINE_SIZE == 0, "enqueuePos must be cache-line aligned");
+static_assert(offsetof(MPMCQueueHeader, dequeuePos) % CACHE_LINE_SIZE == 0, "dequeuePos must be cache-line aligned");
+static_assert(offsetof(MPMCQueueHeader, consumersSleeping) % CACHE_LINE_SIZE == 0,
+              "consumersSleeping must be cache-line aligned");
+
+//=============================================================================
+// ChannelMPMC::Impl
+//=============================================================================
+
+class ChannelMPMC::Impl {
+public:
+    bool createQueue(const std::string& name, size_t capacity) {
+        name_ = name;
+        isOwner_ = true;
+        if (capacity == 0 || capacity > (size_t{1} << 31)) {
+            lastError_ = "Invalid capacity";
+            return false;
+        }
+        capacity_ = std::bit_ceil(capacity);
+
+        try {
+            size_t totalSize = sizeof(MPMCQueueHeader) + capacity_ * sizeof(MPMCSlot);
+
+#ifdef _WIN32
+            shm_ = std::make_unique<bip::windows_shared_memory>(
+                bip::create_only, name.c_str(), bip::read_write, totalSize);
+            region_ = bip::mapped_region(*shm_, bip::read_write);
+#else
+            bip::shared_memory_object::remove(name.c_str());
+            shm_ = bip::shared_memory_object(bip::create_only, name.c_str(), bip::read_write);
+            shm_.truncate(static_cast<bip::offset_t>(totalSize));
+            region_ = bip::mapped_region(shm_, bip::read_write);
+#endif
+
+            // Slots first: the header's magic is what open() checks
+            auto* slots = reinterpret_cast<MPMCSlot*>(static_cast<uint8_t*>(region_.get_address()) +
+                                                      sizeof(MPMCQueueHeader));
+            for (size_t i = 0; i < capacity_; ++i) {
+                auto* slot = new (&slots[i]) MPMCSlot();
+                slot->sequence.store(i, std::memory_order_relaxed);
+            }
+            header_ = new (region_.get_address()) MPMCQueueHeader(static_cast<uint32_t>(capacity_));
+            return true;
+        } catch (const std::exception& e) {
+            lastError_ = std::string("Failed to create queue: ") + e.what();
+            return false;
+        }
+    }
+
+    bool openQueue(const std::string& name) {
+        name_ = name;
+        isOwner_ = false;
+
+        try {
+#ifdef _WIN32
+            shm_ = std::make_unique<bip::windows_shared_memory>(bip::open_only, name.c_str(), bip::read_write);
+            region_ = bip::mapped_region(*shm_, bip::read_write);
+#else
+            shm_ = bip::shared_memory_object(bip::open_only, name.c_str(), bip::read_write);
+            region_ = bip::mapped_region(shm_, bip::read_write);
+#endif
+
+            header_ = static_cast<MPMCQueueHeader*>(region_.get_address());
+            if (!header_->isValid()) {
+                lastError_ = "Invalid shared memory header";
+                header_ = nullptr;
+                return false;
+            }
+            capacity_ = header_->capacity;
+            return true;
+        } catch (const std::exception& e) {
+            lastError_ = std::string("Failed to open queue: ") + e.what();
+            return false;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Producer Operations
+    //-------------------------------------------------------------------------
+
+    bool post(uint32_t msgId, const ImmerValue& data, MessageDomain domain) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return false;
+        }
+
+        // Serialize before claiming a slot: consumers wait on a claimed slot until
+        // it is published, so nothing that can be slow (or throw) happens in between
+        size_t dataSize = get_serialized_size(data);
+        if (dataSize > Message::INLINE_SIZE) [[unlikely]] {
+            lastError_ = "Data too large for ChannelMPMC (max Message::INLINE_SIZE bytes)";
+            return false;
+        }
+        uint8_t buffer[Message::INLINE_SIZE];
+        if (dataSize > 0) {
+            serialize_value_to(data, buffer, dataSize);
+        }
+        return enqueue(msgId, buffer, dataSize, domain);
+    }
+
+    bool postRaw(uint32_t msgId, const void* data, size_t size, MessageDomain domain) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return false;
+        }
+        if (size > Message::INLINE_SIZE) [[unlikely]] {
+            lastError_ = "Data too large for ChannelMPMC (max Message::INLINE_SIZE bytes)";
+            return false;
+        }
+        return enqueue(msgId, data, size, domain);
+    }
+
+    size_t postBatch(std::span<const Channel::OutgoingMessage> messages) {
+        size_t written = 0;
+        while (written < messages.size()) {
+            const auto& m = messages[written];
+            if (!post(m.msgId, m.data, m.domain)) {
+                break;
+            }
+            ++written;
+        }
+        return written;
+    }
+
+    /// Claim the next free slot, copy the message in and publish it
+    bool enqueue(uint32_t msgId, const void* data, size_t size, MessageDomain domain) {
+        uint64_t pos = header_->enqueuePos.load(std::memory_order_relaxed);
+        MPMCSlot* slot;
+        while (true) {
+            slot = header_->slotAt(pos);
+            // Acquire: the consumer that freed the slot is done reading it
+            const uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) [[likely]] {
+                if (header_->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                lastError_ = "Queue full";
+                return false;
+            } else {
+                // Another producer claimed pos; retry at the current position
+                pos = header_->enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        Message& msg = slot->message;
+        if (size > 0) [[likely]] {
+            std::memcpy(msg.inlineData, data, size);
+        }
+        msg.msgId = msgId;
+        msg.dataSize = static_cast<uint32_t>(size);
+        msg.timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        msg.domain = domain;
+        msg.flags = MessageFlags::None;
+        msg.requestId = 0;
+        msg.poolBlock = 0;
+
+        // Release: the message is visible before the slot reads as published
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        wakeConsumer();
+        return true;
+    }
+
+    /// Wake one consumer if any is asleep in waitForMessage
+    void wakeConsumer() {
+#ifdef __linux__
+        // Pairs with the fence in waitUntil (see Channel::Impl::wakeConsumer)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (header_->consumersSleeping.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+            header_->wakeSeq.fetch_add(1, std::memory_order_relaxed);
+            futex_wake_one(&header_->wakeSeq);
+        }
+#endif
+    }
+
+    bool canPost() const {
+        if (!header_) [[unlikely]]
+            return false;
+        uint64_t pos = header_->enqueuePos.load(std::memory_order_relaxed);
+        return header_->slotAt(pos)->sequence.load(std::memory_order_relaxed) == pos;
+    }
+
+    size_t pendingCount() const {
+        if (!header_) [[unlikely]]
+            return 0;
+        // Read dequeuePos first, so a concurrent receive cannot make the difference negative
+        uint64_t read = header_->dequeuePos.load(std::memory_order_relaxed);
+        uint64_t write = header_->enqueuePos.load(std::memory_order_relaxed);
+        return write > read ? static_cast<size_t>(write - read) : 0;
+    }
+
+    //-------------------------------------------------------------------------
+    // Consumer Operations
+    //-------------------------------------------------------------------------
+
+    /// Claim the next published slot, hand its message to visit and free the
+    /// slot, even if visit throws
+    /// @return false if the queue is empty
+    template <typename VisitFn>
+    bool dequeue(VisitFn&& visit) {
+        uint64_t pos = header_->dequeuePos.load(std::memory_order_relaxed);
+        MPMCSlot* slot;
+        while (true) {
+            slot = header_->slotAt(pos);
+            // Acquire: pairs with the producer's release store of the sequence
+            const uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(seq - (pos + 1));
+            if (diff == 0) [[likely]] {
+                if (header_->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Empty (or the next producer has not published yet)
+            } else {
+                pos = header_->dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        struct FreeSlot {
+            MPMCSlot* slot;
+            uint64_t next;
+            // Release: our reads of the message happen before a producer reuses the slot
+            ~FreeSlot() { slot->sequence.store(next, std::memory_order_release); }
+        } freeSlot{slot, pos + capacity_};
+        visit(std::as_const(slot->message));
+        return true;
+    }
+
+    static void decodeMessage(const Message& msg, Channel::ReceivedMessage& result) {
+        result.msgId = msg.msgId;
+        result.timestamp = msg.timestamp;
+        result.domain = msg.domain;
+        result.flags = msg.flags;
+        result.requestId = msg.requestId;
+        result.data = deserialize_value(msg.inlineData, msg.dataSize);
+    }
+
+    std::optional<Channel::ReceivedMessage> tryReceive() {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return std::nullopt;
+        }
+
+        std::optional<Channel::ReceivedMessage> result;
+        dequeue([&](const Message& msg) { decodeMessage(msg, result.emplace()); });
+        return result;
+    }
+
+    size_t receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return 0;
+        }
+
+        size_t done = 0;
+        while (done < maxCount && dequeue([&](const Message& msg) { decodeMessage(msg, out.emplace_back()); })) {
+            ++done;
+        }
+        return done;
+    }
+
+    size_t drainRaw(const Channel::RawHandler& handler, size_t maxCount) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return 0;
+        }
+
+        size_t done = 0;
+        while (done < maxCount && dequeue([&](const Message& msg) {
+                   handler(msg.msgId, std::span<const uint8_t>(msg.inlineData, msg.dataSize));
+               })) {
+            ++done;
+        }
+        return done;
+    }
+
+    int tryReceiveRaw(uint32_t& outMsgId, void* outData, size_t maxSize) {
+        if (!header_) [[unlikely]] {
+            return 0;
+        }
+
+        int result = 0;
+        dequeue([&](const Message& msg) {
+            outMsgId = msg.msgId;
+            if (msg.dataSize > maxSize) [[unlikely]] {
+                result = -1;
+                return;
+            }
+            if (msg.dataSize > 0) [[likely]] {
+                std::memcpy(outData, msg.inlineData, msg.dataSize);
+            }
+            result = static_cast<int>(msg.dataSize);
+        });
+        return result;
+    }
+
+    std::optional<Channel::ReceivedMessage> receive(std::chrono::milliseconds timeout) {
+        const auto deadline = deadline_after(timeout);
+        while (true) {
+            if (auto msg = tryReceive()) {
+                return msg;
+            }
+            if (!waitUntil(deadline)) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    bool waitForMessage(std::chrono::milliseconds timeout) {
+        if (!header_) [[unlikely]] {
+            lastError_ = "Channel not initialized";
+            return false;
+        }
+        return waitUntil(deadline_after(timeout));
+    }
+
+    /// Check for a published, unclaimed message
+    bool hasMessage() const {
+        uint64_t pos = header_->dequeuePos.load(std::memory_order_relaxed);
+        return header_->slotAt(pos)->sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    using Clock = WaitClock;
+
+    /// Same hybrid spin-then-futex wait as Channel::Impl::waitUntil, counting sleepers
+    bool waitUntil(Clock::time_point deadline) {
+        constexpr int MAX_SPINS = 1000;
+        for (int spin = 0; spin < MAX_SPINS; ++spin) {
+            if (hasMessage()) {
+                return true;
+            }
+            cpu_pause();
+        }
+
+        while (true) {
+            if (hasMessage()) {
+                return true;
+            }
+            const auto now = Clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+
+#ifdef __linux__
+            const uint32_t seq = header_->wakeSeq.load(std::memory_order_relaxed);
+            header_->consumersSleeping.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (hasMessage()) {
+                header_->consumersSleeping.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            if (deadline == Clock::time_point::max()) {
+                futex_wait(&header_->wakeSeq, seq, nullptr);
+            } else {
+                const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+                timespec ts{};
+                ts.tv_sec = static_cast<time_t>(remaining.count() / 1000000000);
+                ts.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+                futex_wait(&header_->wakeSeq, seq, &ts);
+            }
+            header_->consumersSleeping.fetch_sub(1, std::memory_order_relaxed);
+#else
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+#endif
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------
+
+    const std::string& name() const { return name_; }
+    size_t capacity() const { return capacity_; }
+    bool isCreator() const { return isOwner_; }
+    const std::string& lastError() const { return lastError_; }
+
+    ~Impl() {
+#ifndef _WIN32
+        if (isOwner_ && !name_.empty()) {
+            try {
+                bip::shared_memory_object::remove(name_.c_str());
+            } catch (...) {}
+        }
+#endif
+    }
+
+private:
+    std::string name_;
+    bool isOwner_ = false;
+    size_t capacity_ = 0;
+    mutable std::string lastError_;
+
+#ifdef _WIN32
+    std::unique_ptr<bip::windows_shared_memory> shm_;
+#else
+    bip::shared_memory_object shm_;
+#endif
+    bip::mapped_region region_;
+    MPMCQueueHeader* header_ = nullptr;
+};
+
+//=============================================================================
+// ChannelMPMC Public API
+//=============================================================================
+
+ChannelMPMC::ChannelMPMC() : impl_(std::make_unique<Impl>()) {}
+ChannelMPMC::~ChannelMPMC() = default;
+ChannelMPMC::ChannelMPMC(ChannelMPMC&&) noexcept = default;
+ChannelMPMC& ChannelMPMC::operator=(ChannelMPMC&&) noexcept = default;
+
+std::unique_ptr<ChannelMPMC> ChannelMPMC::create(const std::string& name, size_t capacity) {
+    auto channel = std::unique_ptr<ChannelMPMC>(new ChannelMPMC());
+    if (!channel->impl_->createQueue(name, capacity)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+std::unique_ptr<ChannelMPMC> ChannelMPMC::open(const std::string& name) {
+    auto channel = std::unique_ptr<ChannelMPMC>(new ChannelMPMC());
+    if (!channel->impl_->openQueue(name)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+bool ChannelMPMC::post(uint32_t msgId, const ImmerValue& data, MessageDomain domain) {
+    return impl_->post(msgId, data, domain);
+}
+
+bool ChannelMPMC::postRaw(uint32_t msgId, const void* data, size_t size, MessageDomain domain) {
+    return impl_->postRaw(msgId, data, size, domain);
+}
+
+size_t ChannelMPMC::postBatch(std::span<const Channel::OutgoingMessage> messages) {
+    return impl_->postBatch(messages);
+}
+
+bool ChannelMPMC::canPost() const {
+    return impl_->canPost();
+}
+
+size_t ChannelMPMC::pendingCount() const {
+    return impl_->pendingCount();
+}
+
+std::optional<Channel::ReceivedMessage> ChannelMPMC::tryReceive() {
+    return impl_->tryReceive();
+}
+
+std::optional<Channel::ReceivedMessage> ChannelMPMC::receive(std::chrono::milliseconds timeout) {
+    return impl_->receive(timeout);
+}
+
+bool ChannelMPMC::waitForMessage(std::chrono::milliseconds timeout) {
+    return impl_->waitForMessage(timeout);
+}
+
+int ChannelMPMC::tryReceiveRaw(uint32_t& outMsgId, void* outData, size_t maxSize) {
+    return impl_->tryReceiveRaw(outMsgId, outData, maxSize);
+}
+
+size_t ChannelMPMC::receiveBatch(std::vector<Channel::ReceivedMessage>& out, size_t maxCount) {
+    return impl_->receiveBatch(out, maxCount);
+}
+
+size_t ChannelMPMC::drainRaw(const Channel::RawHandler& handler, size_t maxCount) {
+    return impl_->drainRaw(handler, maxCount);
+}
+
+const std::string& ChannelMPMC::name() const {
+    return impl_->name();
+}
+
+size_t ChannelMPMC::capacity() const {
+    return impl_->capacity();
+}
+
+bool ChannelMPMC::isCreator() const {
+    return impl_->isCreator();
+}
+
+const std::string& ChannelMPMC::lastError() const {
+    return impl_->lastError();
+}
+
 } // namespace ipc
 } // namespace lager_ext
\ No newline at end of file
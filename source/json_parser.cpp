@@ -0,0 +1,721 @@
+// json_parser.cpp
+// High-throughput JSON parser for ImmerValue (parse_json)
+//
+// Parsing runs in two passes over the input:
+// 1. Structural scan: the input is classified 64 bytes at a time (AVX2, SSE2 or
+//    a portable table fallback) into bitmasks of quotes, backslashes, operators
+//    and whitespace. Escaped quotes are removed and string interiors masked out
+//    with a prefix-xor, which leaves the offset of every operator and every
+//    scalar start in a flat index. Whitespace and string bodies are never
+//    visited character by character.
+// 2. Tree build: a recursive walk over the index builds maps and vectors through
+//    immer transients, parses numbers with std::from_chars and copies strings in
+//    runs up to the next quote or backslash.
+//
+// Malformed input is reported through JsonParseResult (error code + byte offset);
+// no exceptions are thrown for parse errors.
+
+#include <lager_ext/serialization.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LAGER_EXT_JSON_SCAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAGER_EXT_JSON_SCAN_SSE2 1
+#endif
+
+// Carry-less multiply turns prefix-xor into a single instruction. GCC/Clang
+// advertise it with __PCLMUL__; MSVC has no macro, but every AVX2 CPU has it.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__PCLMUL__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#include <wmmintrin.h>
+#define LAGER_EXT_JSON_CLMUL 1
+#endif
+
+namespace lager_ext {
+
+namespace {
+
+// ============================================================
+// Character classes
+// ============================================================
+
+constexpr uint8_t CLASS_QUOTE = 0x01;
+constexpr uint8_t CLASS_BACKSLASH = 0x02;
+constexpr uint8_t CLASS_OP = 0x04; // { } [ ] : ,
+constexpr uint8_t CLASS_SPACE = 0x08;
+
+constexpr std::array<uint8_t, 256> make_char_classes() {
+    std::array<uint8_t, 256> t{};
+    t['"'] = CLASS_QUOTE;
+    t['\\'] = CLASS_BACKSLASH;
+    for (unsigned char c : {'{', '}', '[', ']', ':', ','})
+        t[c] = CLASS_OP;
+    for (unsigned char c : {' ', '\t', '\n', '\r'})
+        t[c] = CLASS_SPACE;
+    return t;
+}
+
+constexpr std::array<uint8_t, 256> CHAR_CLASSES = make_char_classes();
+
+// A scalar (number or literal) must be followed by whitespace, an operator or EOF
+inline bool is_scalar_terminator(char c) {
+    return (CHAR_CLASSES[static_cast<unsigned char>(c)] & (CLASS_OP | CLASS_SPACE)) != 0;
+}
+
+inline bool is_digit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// ============================================================
+// Block classification (64 bytes -> bitmasks)
+// ============================================================
+
+constexpr std::size_t BLOCK_SIZE = 64;
+
+struct BlockMasks {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t op = 0;
+    uint64_t space = 0;
+};
+
+#if defined(LAGER_EXT_JSON_SCAN_AVX2)
+
+inline uint64_t movemask32(__m256i v) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+}
+
+inline void classify32(const char* p, unsigned shift, BlockMasks& m) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    // '[' / '{' and ']' / '}' differ only in bit 0x20
+    const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    const __m256i op = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                        _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+    const __m256i space = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+    m.quote |= movemask32(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << shift;
+    m.backslash |= movemask32(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << shift;
+    m.op |= movemask32(op) << shift;
+    m.space |= movemask32(space) << shift;
+}
+
+inline BlockMasks classify_block(const char* p) {
+    BlockMasks m;
+    classify32(p, 0, m);
+    classify32(p + 32, 32, m);
+    return m;
+}
+
+#elif defined(LAGER_EXT_JSON_SCAN_SSE2)
+
+inline uint64_t movemask16(__m128i v) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(v));
+}
+
+inline void classify16(const char* p, unsigned shift, BlockMasks& m) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // '[' / '{' and ']' / '}' differ only in bit 0x20
+    const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i op =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+    const __m128i space =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+    m.quote |= movemask16(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+    m.backslash |= movemask16(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+    m.op |= movemask16(op) << shift;
+    m.space |= movemask16(space) << shift;
+}
+
+inline BlockMasks classify_block(const char* p) {
+    BlockMasks m;
+    classify16(p, 0, m);
+    classify16(p + 16, 16, m);
+    classify16(p + 32, 32, m);
+    classify16(p + 48, 48, m);
+    return m;
+}
+
+#else
+
+inline BlockMasks classify_block(const char* p) {
+    BlockMasks m;
+    for (unsigned i = 0; i < BLOCK_SIZE; ++i) {
+        const uint8_t cls = CHAR_CLASSES[static_cast<unsigned char>(p[i])];
+        const uint64_t bit = uint64_t{1} << i;
+        if (cls & CLASS_QUOTE)
+            m.quote |= bit;
+        if (cls & CLASS_BACKSLASH)
+            m.backslash |= bit;
+        if (cls & CLASS_OP)
+            m.op |= bit;
+        if (cls & CLASS_SPACE)
+            m.space |= bit;
+    }
+    return m;
+}
+
+#endif
+
+// Bit i of the result is the xor of bits 0..i of x (marks positions inside quotes)
+inline uint64_t prefix_xor(uint64_t x) {
+#if defined(LAGER_EXT_JSON_CLMUL)
+    const __m128i product =
+        _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(x)), _mm_set1_epi8(static_cast<char>(0xFF)), 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+#else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#endif
+}
+
+// ============================================================
+// Stage 1: structural index
+// ============================================================
+
+class StructuralScanner {
+public:
+    // Fills `index` with the offsets of all structural characters and scalar starts.
+    // Returns JsonError::None, or UnterminatedString if a quote is left open.
+    JsonError scan(std::string_view input, std::vector<uint32_t>& index) {
+        const char* data = input.data();
+        const std::size_t size = input.size();
+        std::size_t count = 0;
+        index.resize(std::max<std::size_t>(size / 8, BLOCK_SIZE) + BLOCK_SIZE);
+
+        for (std::size_t pos = 0; pos < size; pos += BLOCK_SIZE) {
+            const char* block = data + pos;
+            alignas(BLOCK_SIZE) char tail[BLOCK_SIZE];
+            if (size - pos < BLOCK_SIZE) [[unlikely]] {
+                // Pad the final partial block with whitespace
+                std::memset(tail, ' ', BLOCK_SIZE);
+                std::memcpy(tail, block, size - pos);
+                block = tail;
+            }
+
+            uint64_t structurals = next_block(classify_block(block));
+
+            if (count + BLOCK_SIZE > index.size()) [[unlikely]] {
+                index.resize(index.size() * 2);
+            }
+            uint32_t* out = index.data() + count;
+            count += static_cast<std::size_t>(std::popcount(structurals));
+            while (structurals != 0) {
+                *out++ = static_cast<uint32_t>(pos + static_cast<std::size_t>(std::countr_zero(structurals)));
+                structurals &= structurals - 1;
+            }
+        }
+
+        index.resize(count);
+        return prev_in_string_ != 0 ? JsonError::UnterminatedString : JsonError::None;
+    }
+
+private:
+    uint64_t prev_escaped_ = 0;   // First char of next block is escaped
+    uint64_t prev_in_string_ = 0; // All ones if the previous block ended inside a string
+    uint64_t prev_scalar_ = 0;    // Previous block ended inside an unquoted scalar
+
+    // Marks characters preceded by an odd-length run of backslashes
+    uint64_t find_escaped(uint64_t backslash) {
+        constexpr uint64_t EVEN_BITS = 0x5555555555555555ULL;
+
+        backslash &= ~prev_escaped_;
+        const uint64_t follows_escape = (backslash << 1) | prev_escaped_;
+
+        // Runs starting on an odd bit: adding the run to its start carries past the
+        // end of the run, which lets us tell odd- and even-length runs apart.
+        const uint64_t odd_starts = backslash & ~EVEN_BITS & ~follows_escape;
+        const uint64_t sum = odd_starts + backslash;
+        prev_escaped_ = sum < odd_starts ? 1 : 0;
+        const uint64_t invert_mask = sum << 1;
+
+        return (EVEN_BITS ^ invert_mask) & follows_escape;
+    }
+
+    uint64_t next_block(const BlockMasks& m) {
+        const uint64_t escaped = find_escaped(m.backslash);
+        const uint64_t quote = m.quote & ~escaped;
+
+        // Opening quote included, closing quote excluded
+        const uint64_t in_string = prefix_xor(quote) ^ prev_in_string_;
+        prev_in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        // A scalar starts at any non-space, non-operator char that does not follow
+        // another unquoted scalar char. Opening quotes count as scalar starts.
+        const uint64_t scalar = ~(m.op | m.space);
+        const uint64_t nonquote_scalar = scalar & ~quote;
+        const uint64_t follows_scalar = (nonquote_scalar << 1) | prev_scalar_;
+        prev_scalar_ = nonquote_scalar >> 63;
+        const uint64_t scalar_start = scalar & ~follows_scalar;
+
+        // String body plus closing quote
+        const uint64_t string_tail = in_string ^ quote;
+        return (m.op | scalar_start) & ~string_tail;
+    }
+};
+
+// ============================================================
+// Stage 2: tree builder
+// ============================================================
+
+constexpr unsigned MAX_NESTING_DEPTH = 512;
+
+// Offset of the first '"', '\\' or control character at or after `p`
+inline const char* find_string_special(const char* p, const char* end) {
+#if defined(LAGER_EXT_JSON_SCAN_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    while (end - p >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        // Unsigned v < 0x20  <=>  min(v, 0x1F) == v
+        const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+        const __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                                            ctrl);
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (mask != 0)
+            return p + std::countr_zero(mask);
+        p += 32;
+    }
+#elif defined(LAGER_EXT_JSON_SCAN_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // Unsigned v < 0x20  <=>  min(v, 0x1F) == v
+        const __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl_max), v);
+        const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)), ctrl);
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (mask != 0)
+            return p + std::countr_zero(mask);
+        p += 16;
+    }
+#endif
+    while (p < end) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\' || c < 0x20)
+            return p;
+        ++p;
+    }
+    return end;
+}
+
+inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    const char lower = static_cast<char>(c | 0x20);
+    if (lower >= 'a' && lower <= 'f')
+        return lower - 'a' + 10;
+    return -1;
+}
+
+inline void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+class TreeBuilder {
+public:
+    TreeBuilder(std::string_view input, const std::vector<uint32_t>& index)
+        : begin_(input.data()), end_(input.data() + input.size()), index_(index.data()), count_(index.size()) {}
+
+    JsonParseResult build() {
+        JsonParseResult result;
+        if (count_ == 0) {
+            result.error = JsonError::EmptyInput;
+            return result;
+        }
+        if (!parse_value(result.value, 0)) {
+            result.value = ImmerValue{};
+        } else if (cur_ != count_) {
+            fail(JsonError::TrailingCharacters, index_[cur_]);
+            result.value = ImmerValue{};
+        }
+        result.error = error_;
+        result.offset = offset_;
+        return result;
+    }
+
+private:
+    const char* begin_;
+    const char* end_;
+    const uint32_t* index_;
+    std::size_t count_;
+    std::size_t cur_ = 0;
+    JsonError error_ = JsonError::None;
+    std::size_t offset_ = 0;
+
+    bool fail(JsonError error, std::size_t offset) {
+        error_ = error;
+        offset_ = offset;
+        return false;
+    }
+
+    std::size_t input_size() const { return static_cast<std::size_t>(end_ - begin_); }
+
+    // Next structural offset, or false (with UnexpectedEnd) if the index is exhausted
+    bool next(std::size_t& offset) {
+        if (cur_ >= count_) [[unlikely]]
+            return fail(JsonError::UnexpectedEnd, input_size());
+        offset = index_[cur_++];
+        return true;
+    }
+
+    char peek_char() const { return cur_ < count_ ? begin_[index_[cur_]] : '\0'; }
+
+    bool parse_value(ImmerValue& out, unsigned depth) {
+        std::size_t at;
+        if (!next(at))
+            return false;
+
+        switch (begin_[at]) {
+        case '{':
+            return parse_object(at, out, depth);
+        case '[':
+            return parse_array(at, out, depth);
+        case '"': {
+            std::string str;
+            if (!parse_string(at, str))
+                return false;
+            out = ImmerValue{std::move(str)};
+            return true;
+        }
+        case 't':
+            return parse_literal(at, "true", ImmerValue{true}, out);
+        case 'f':
+            return parse_literal(at, "false", ImmerValue{false}, out);
+        case 'n':
+            return parse_literal(at, "null", ImmerValue{}, out);
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return parse_number(at, out);
+        default:
+            return fail(JsonError::UnexpectedCharacter, at);
+        }
+    }
+
+    bool parse_object(std::size_t open, ImmerValue& out, unsigned depth) {
+        if (depth >= MAX_NESTING_DEPTH) [[unlikely]]
+            return fail(JsonError::DepthLimitExceeded, open);
+
+        if (peek_char() == '}') {
+            ++cur_;
+            out = ImmerValue{BoxedValueMap{ValueMap{}}};
+            return true;
+        }
+
+        auto transient = ValueMap{}.transient();
+        std::size_t at;
+
+        while (true) {
+            if (!next(at))
+                return false;
+            if (begin_[at] != '"')
+                return fail(JsonError::UnexpectedCharacter, at);
+            std::string key;
+            if (!parse_string(at, key))
+                return false;
+
+            if (!next(at))
+                return false;
+            if (begin_[at] != ':')
+                return fail(JsonError::UnexpectedCharacter, at);
+
+            ImmerValue val;
+            if (!parse_value(val, depth + 1))
+                return false;
+            transient.set(std::move(key), std::move(val));
+
+            if (!next(at))
+                return false;
+            if (begin_[at] == '}')
+                break;
+            if (begin_[at] != ',')
+                return fail(JsonError::UnexpectedCharacter, at);
+        }
+
+        out = ImmerValue{BoxedValueMap{transient.persistent()}};
+        return true;
+    }
+
+    bool parse_array(std::size_t open, ImmerValue& out, unsigned depth) {
+        if (depth >= MAX_NESTING_DEPTH) [[unlikely]]
+            return fail(JsonError::DepthLimitExceeded, open);
+
+        if (peek_char() == ']') {
+            ++cur_;
+            out = ImmerValue{BoxedValueVector{ValueVector{}}};
+            return true;
+        }
+
+        auto transient = ValueVector{}.transient();
+        std::size_t at;
+
+        while (true) {
+            ImmerValue val;
+            if (!parse_value(val, depth + 1))
+                return false;
+            transient.push_back(std::move(val));
+
+            if (!next(at))
+                return false;
+            if (begin_[at] == ']')
+                break;
+            if (begin_[at] != ',')
+                return fail(JsonError::UnexpectedCharacter, at);
+        }
+
+        out = ImmerValue{BoxedValueVector{transient.persistent()}};
+        return true;
+    }
+
+    // `quote` is the offset of the opening quote; stage 1 guarantees a closing one
+    bool parse_string(std::size_t quote, std::string& out) {
+        const char* p = begin_ + quote + 1;
+
+        while (true) {
+            const char* special = find_string_special(p, end_);
+            out.append(p, static_cast<std::size_t>(special - p));
+            if (special == end_) [[unlikely]]
+                return fail(JsonError::UnterminatedString, quote);
+
+            p = special;
+            if (*p == '"')
+                return true;
+            if (*p != '\\')
+                return fail(JsonError::InvalidString, static_cast<std::size_t>(p - begin_));
+
+            const std::size_t escape_at = static_cast<std::size_t>(p - begin_);
+            if (end_ - p < 2) [[unlikely]]
+                return fail(JsonError::InvalidEscape, escape_at);
+            switch (p[1]) {
+            case '"':
+                out += '"';
+                break;
+            case '\\':
+                out += '\\';
+                break;
+            case '/':
+                out += '/';
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                uint32_t cp;
+                if (!parse_hex4(p + 2, cp))
+                    return fail(JsonError::InvalidEscape, escape_at);
+                p += 4;
+                // Combine a UTF-16 surrogate pair; a lone surrogate is encoded as-is
+                // (same as from_json)
+                uint32_t low;
+                if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p >= 8 && p[2] == '\\' && p[3] == 'u' &&
+                    parse_hex4(p + 4, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+                append_utf8(out, cp);
+                break;
+            }
+            default:
+                return fail(JsonError::InvalidEscape, escape_at);
+            }
+            p += 2;
+        }
+    }
+
+    bool parse_hex4(const char* p, uint32_t& cp) const {
+        if (end_ - p < 4)
+            return false;
+        cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int digit = hex_digit(p[i]);
+            if (digit < 0)
+                return false;
+            cp = (cp << 4) | static_cast<uint32_t>(digit);
+        }
+        return true;
+    }
+
+    bool parse_literal(std::size_t at, std::string_view word, ImmerValue value, ImmerValue& out) {
+        const char* p = begin_ + at;
+        if (static_cast<std::size_t>(end_ - p) < word.size() || std::memcmp(p, word.data(), word.size()) != 0 ||
+            (p + word.size() < end_ && !is_scalar_terminator(p[word.size()])))
+            return fail(JsonError::InvalidLiteral, at);
+        out = std::move(value);
+        return true;
+    }
+
+    bool parse_number(std::size_t at, ImmerValue& out) {
+        const char* const start = begin_ + at;
+        const char* p = start;
+        bool is_integer = true;
+
+        // Validate against the JSON grammar first; from_chars is more permissive
+        if (*p == '-')
+            ++p;
+        if (p == end_ || !is_digit(*p))
+            return fail(JsonError::InvalidNumber, at);
+        if (*p == '0') {
+            ++p;
+        } else {
+            while (p < end_ && is_digit(*p))
+                ++p;
+        }
+        if (p < end_ && *p == '.') {
+            is_integer = false;
+            ++p;
+            if (p == end_ || !is_digit(*p))
+                return fail(JsonError::InvalidNumber, at);
+            while (p < end_ && is_digit(*p))
+                ++p;
+        }
+        if (p < end_ && (*p == 'e' || *p == 'E')) {
+            is_integer = false;
+            ++p;
+            if (p < end_ && (*p == '+' || *p == '-'))
+                ++p;
+            if (p == end_ || !is_digit(*p))
+                return fail(JsonError::InvalidNumber, at);
+            while (p < end_ && is_digit(*p))
+                ++p;
+        }
+        if (p < end_ && !is_scalar_terminator(*p))
+            return fail(JsonError::InvalidNumber, at);
+
+        if (is_integer) {
+            int64_t value = 0;
+            auto [ptr, ec] = std::from_chars(start, p, value);
+            if (ec == std::errc{}) [[likely]] {
+                // Use int if it fits, otherwise int64_t
+                if (value >= INT_MIN && value <= INT_MAX)
+                    out = ImmerValue{static_cast<int>(value)};
+                else
+                    out = ImmerValue{value};
+                return true;
+            }
+            // Out of int64 range: fall back to double, as from_json does
+        }
+
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(start, p, value);
+        if (ec != std::errc{})
+            return fail(JsonError::InvalidNumber, at);
+        out = ImmerValue{value};
+        return true;
+    }
+};
+
+} // anonymous namespace
+
+// ============================================================
+// Public API
+// ============================================================
+
+JsonParseResult parse_json(std::string_view json) {
+    if (json.size() > std::numeric_limits<uint32_t>::max()) [[unlikely]] {
+        JsonParseResult result;
+        result.error = JsonError::InputTooLarge;
+        return result;
+    }
+
+    std::vector<uint32_t> index;
+    StructuralScanner scanner;
+    if (JsonError error = scanner.scan(json, index); error != JsonError::None) {
+        JsonParseResult result;
+        result.error = error;
+        result.offset = json.size();
+        return result;
+    }
+
+    return TreeBuilder{json, index}.build();
+}
+
+const char* json_error_message(JsonError error) noexcept {
+    switch (error) {
+    case JsonError::None:
+        return "No error";
+    case JsonError::EmptyInput:
+        return "Empty JSON input";
+    case JsonError::UnexpectedEnd:
+        return "Unexpected end of input";
+    case JsonError::UnexpectedCharacter:
+        return "Unexpected character";
+    case JsonError::UnterminatedString:
+        return "Unterminated string";
+    case JsonError::InvalidString:
+        return "Unescaped control character in string";
+    case JsonError::InvalidEscape:
+        return "Invalid escape sequence";
+    case JsonError::InvalidNumber:
+        return "Invalid number";
+    case JsonError::InvalidLiteral:
+        return "Invalid literal";
+    case JsonError::TrailingCharacters:
+        return "Unexpected characters after JSON value";
+    case JsonError::DepthLimitExceeded:
+        return "Nesting depth limit exceeded";
+    case JsonError::InputTooLarge:
+        return "Input too large";
+    }
+    return "Unknown error";
+}
+
+} // namespace lager_ext
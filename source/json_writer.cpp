@@ -0,0 +1,415 @@
+// json_writer.cpp
+// Streaming JSON writer for ImmerValue
+//
+// Output is produced through a sink instead of std::ostringstream:
+// - StringSink appends straight into a caller-owned std::string (growable buffer)
+// - BufferedSink stages output in a fixed stack buffer and flushes it to a
+//   FILE* or file descriptor, so arbitrarily large values stream in O(1) memory
+//
+// No per-key or per-string temporaries are created: numbers are formatted with
+// std::to_chars into a stack buffer, and strings are copied in runs between
+// characters that need escaping (found with SSE2 when available).
+//
+// The produced text is byte-for-byte identical to the previous ostringstream
+// implementation in both compact and pretty modes.
+
+#include <lager_ext/serialization.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAGER_EXT_JSON_SSE2 1
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace lager_ext {
+
+namespace {
+
+// ============================================================
+// Sinks
+// ============================================================
+
+// Appends directly into a std::string; capacity is reused across calls
+struct StringSink {
+    std::string& out;
+
+    void write(const char* data, std::size_t size) { out.append(data, size); }
+    void put(char c) { out.push_back(c); }
+};
+
+// Fixed-size staging buffer flushed to an external target (FILE*, fd)
+class BufferedSink {
+public:
+    using FlushFn = bool (*)(void* target, const char* data, std::size_t size);
+
+    BufferedSink(FlushFn fn, void* target) : fn_(fn), target_(target) {}
+
+    void write(const char* data, std::size_t size) {
+        if (size > CAPACITY - used_) {
+            flush();
+            if (size >= CAPACITY) {
+                // Large run (e.g. a long string): bypass the staging buffer
+                ok_ = ok_ && fn_(target_, data, size);
+                return;
+            }
+        }
+        std::memcpy(buffer_ + used_, data, size);
+        used_ += size;
+    }
+
+    void put(char c) {
+        if (used_ == CAPACITY) [[unlikely]] {
+            flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    bool flush() {
+        if (used_ > 0) {
+            ok_ = ok_ && fn_(target_, buffer_, used_);
+            used_ = 0;
+        }
+        return ok_;
+    }
+
+private:
+    static constexpr std::size_t CAPACITY = 16 * 1024;
+
+    FlushFn fn_;
+    void* target_;
+    std::size_t used_ = 0;
+    bool ok_ = true;
+    char buffer_[CAPACITY];
+};
+
+bool flush_to_file(void* target, const char* data, std::size_t size) {
+    return std::fwrite(data, 1, size, static_cast<std::FILE*>(target)) == size;
+}
+
+bool flush_to_fd(void* target, const char* data, std::size_t size) {
+    const int fd = *static_cast<const int*>(target);
+    while (size > 0) {
+#ifdef _WIN32
+        const int chunk = static_cast<int>(std::min<std::size_t>(size, 1u << 30));
+        const int written = ::_write(fd, data, static_cast<unsigned>(chunk));
+#else
+        const auto written = ::write(fd, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+// ============================================================
+// String escaping
+// ============================================================
+
+// Index of the first character that must be escaped ('"', '\\' or < 0x20),
+// or size if the string can be copied verbatim
+std::size_t find_escape(const char* s, std::size_t size) {
+    std::size_t i = 0;
+#ifdef LAGER_EXT_JSON_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        // Unsigned c <= 0x1F  <=>  min(c, 0x1F) == c
+        const __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, ctrl_max), chunk);
+        const __m128i special =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), ctrl);
+        const int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        const auto c = static_cast<unsigned char>(s[i]);
+        if (c < 0x20 || c == '"' || c == '\\')
+            return i;
+    }
+    return size;
+}
+
+// ============================================================
+// JsonWriter - formats an ImmerValue tree into a sink
+// ============================================================
+
+template <typename Sink>
+class JsonWriter {
+public:
+    JsonWriter(Sink& sink, bool compact) : sink_(sink), compact_(compact) {}
+
+    void write_value(const ImmerValue& val, int indent_level) {
+        std::visit(
+            [&](const auto& arg) {
+                using T = std::decay_t<decltype(arg)>;
+
+                if constexpr (std::is_same_v<T, std::monostate>) {
+                    write_literal("null");
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    write_literal(arg ? "true" : "false");
+                } else if constexpr (std::is_same_v<T, int8_t>) {
+                    write_integer(static_cast<int>(arg));
+                } else if constexpr (std::is_same_v<T, uint8_t>) {
+                    write_integer(static_cast<unsigned>(arg));
+                } else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t> ||
+                                     std::is_same_v<T, int64_t> || std::is_same_v<T, uint16_t> ||
+                                     std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
+                    write_integer(arg);
+                } else if constexpr (std::is_same_v<T, float>) {
+                    write_floating(arg, 7);
+                } else if constexpr (std::is_same_v<T, double>) {
+                    write_floating(arg, 15);
+                } else if constexpr (std::is_same_v<T, BoxedString>) {
+                    // Container Boxing: strings are now BoxedString
+                    write_string(arg.get());
+                } else if constexpr (std::is_same_v<T, Vec2> || std::is_same_v<T, Vec3> || std::is_same_v<T, Vec4>) {
+                    write_float_array(arg);
+                } else if constexpr (std::is_same_v<T, ImmerValue::boxed_mat3> ||
+                                     std::is_same_v<T, ImmerValue::boxed_mat4x3> ||
+                                     std::is_same_v<T, ImmerValue::boxed_mat4>) {
+                    write_float_array(arg.get());
+                } else if constexpr (std::is_same_v<T, BoxedValueMap>) {
+                    // Container Boxing: unbox the map
+                    const ValueMap& m = arg.get();
+                    write_object(m.size() == 0, indent_level, [&](auto&& emit) {
+                        for (const auto& [k, v] : m) {
+                            emit(k, v);
+                        }
+                    });
+                } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
+                    const ValueVector& vec = arg.get();
+                    write_array(vec.size() == 0, indent_level, [&](auto&& emit) {
+                        for (const auto& v : vec) {
+                            emit(v);
+                        }
+                    });
+                } else if constexpr (std::is_same_v<T, BoxedValueArray>) {
+                    const ValueArray& arr = arg.get();
+                    write_array(arr.size() == 0, indent_level, [&](auto&& emit) {
+                        for (const auto& v : arr) {
+                            emit(v);
+                        }
+                    });
+                } else if constexpr (std::is_same_v<T, BoxedValueTable>) {
+                    const ValueTable& tbl = arg.get();
+                    write_object(tbl.size() == 0, indent_level, [&](auto&& emit) {
+                        for (const auto& entry : tbl) {
+                            emit(entry.id, entry.value.get()); // TableEntry::value is still ValueBox
+                        }
+                    });
+                }
+            },
+            val.data);
+    }
+
+private:
+    Sink& sink_;
+    bool compact_;
+
+    void write_literal(std::string_view s) { sink_.write(s.data(), s.size()); }
+
+    template <typename Int>
+    void write_integer(Int value) {
+        char buf[24];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        sink_.write(buf, static_cast<std::size_t>(end - buf));
+    }
+
+    // Equivalent to ostream << setprecision(precision) << value (i.e. "%.*g")
+    void write_floating(double value, int precision) {
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, precision);
+        sink_.write(buf, static_cast<std::size_t>(end - buf));
+    }
+
+    template <std::size_t N>
+    void write_float_array(const std::array<float, N>& arr) {
+        sink_.put('[');
+        for (std::size_t i = 0; i < N; ++i) {
+            if (i > 0)
+                sink_.put(',');
+            write_floating(arr[i], 7);
+        }
+        sink_.put(']');
+    }
+
+    void write_string(std::string_view s) {
+        sink_.put('"');
+        while (!s.empty()) {
+            const std::size_t clean = find_escape(s.data(), s.size());
+            if (clean > 0) {
+                sink_.write(s.data(), clean);
+            }
+            if (clean == s.size())
+                break;
+            write_escape(s[clean]);
+            s.remove_prefix(clean + 1);
+        }
+        sink_.put('"');
+    }
+
+    void write_escape(char c) {
+        switch (c) {
+        case '"':
+            write_literal("\\\"");
+            break;
+        case '\\':
+            write_literal("\\\\");
+            break;
+        case '\b':
+            write_literal("\\b");
+            break;
+        case '\f':
+            write_literal("\\f");
+            break;
+        case '\n':
+            write_literal("\\n");
+            break;
+        case '\r':
+            write_literal("\\r");
+            break;
+        case '\t':
+            write_literal("\\t");
+            break;
+        default: {
+            // Control characters as \uXXXX
+            static constexpr char hex[] = "0123456789abcdef";
+            const auto u = static_cast<unsigned char>(c);
+            const char buf[6] = {'\\', 'u', '0', '0', hex[u >> 4], hex[u & 0xF]};
+            sink_.write(buf, sizeof(buf));
+            break;
+        }
+        }
+    }
+
+    void newline() {
+        if (!compact_)
+            sink_.put('\n');
+    }
+
+    void indent(int level) {
+        if (compact_)
+            return;
+        static constexpr std::string_view spaces = "                                                                ";
+        std::size_t remaining = static_cast<std::size_t>(level) * 2;
+        while (remaining > 0) {
+            const std::size_t n = std::min(remaining, spaces.size());
+            sink_.write(spaces.data(), n);
+            remaining -= n;
+        }
+    }
+
+    // "{" NL (indent "key": value) ("," NL ...)* NL indent "}"
+    template <typename ForEach>
+    void write_object(bool empty, int indent_level, ForEach&& for_each) {
+        if (empty) {
+            write_literal("{}");
+            return;
+        }
+        sink_.put('{');
+        newline();
+        bool first = true;
+        for_each([&](std::string_view key, const ImmerValue& v) {
+            if (!first) {
+                sink_.put(',');
+                newline();
+            }
+            first = false;
+            indent(indent_level + 1);
+            write_string(key);
+            sink_.put(':');
+            if (!compact_)
+                sink_.put(' ');
+            write_value(v, indent_level + 1);
+        });
+        newline();
+        indent(indent_level);
+        sink_.put('}');
+    }
+
+    // "[" NL (indent value) ("," NL ...)* NL indent "]"
+    template <typename ForEach>
+    void write_array(bool empty, int indent_level, ForEach&& for_each) {
+        if (empty) {
+            write_literal("[]");
+            return;
+        }
+        sink_.put('[');
+        newline();
+        bool first = true;
+        for_each([&](const ImmerValue& v) {
+            if (!first) {
+                sink_.put(',');
+                newline();
+            }
+            first = false;
+            indent(indent_level + 1);
+            write_value(v, indent_level + 1);
+        });
+        newline();
+        indent(indent_level);
+        sink_.put(']');
+    }
+};
+
+} // anonymous namespace
+
+// ============================================================
+// Public API
+// ============================================================
+
+std::string to_json(const ImmerValue& val, bool compact) {
+    std::string out;
+    to_json(val, out, compact);
+    return out;
+}
+
+void to_json(const ImmerValue& val, std::string& out, bool compact) {
+    StringSink sink{out};
+    JsonWriter<StringSink> writer(sink, compact);
+    writer.write_value(val, 0);
+}
+
+bool to_json_file(const ImmerValue& val, std::FILE* file, bool compact) {
+    if (!file)
+        return false;
+    BufferedSink sink(&flush_to_file, file);
+    JsonWriter<BufferedSink> writer(sink, compact);
+    writer.write_value(val, 0);
+    return sink.flush();
+}
+
+bool to_json_fd(const ImmerValue& val, int fd, bool compact) {
+    if (fd < 0)
+        return false;
+    BufferedSink sink(&flush_to_fd, &fd);
+    JsonWriter<BufferedSink> writer(sink, compact);
+    writer.write_value(val, 0);
+    return sink.flush();
+}
+
+} // namespace lager_ext
@@ -66,6 +66,9 @@ ImmerValue set_at_path_element_vivify(const ImmerValue& current, const PathEleme
             auto new_map = boxed_map->get().set(key_str, std::move(new_val));
             return ImmerValue{BoxedValueMap{std::move(new_map)}};
         }
+        if (current.get_if<BoxedValueTable>()) {
+            return current.set(*key, std::move(new_val)); // Inserts or replaces the entry
+        }
         if (current.is_null()) {
             // Auto-vivification: create new map
             auto new_map = ValueMap{}.set(key_str, std::move(new_val));
@@ -91,6 +94,16 @@ ImmerValue set_at_path_element_vivify(const ImmerValue& current, const PathEleme
             trans.set(idx, std::move(new_val));
             return ImmerValue{BoxedValueVector{trans.persistent()}};
         }
+        if (auto* boxed_arr = current.get_if<BoxedValueArray>()) {
+            if (idx < boxed_arr->get().size()) {
+                return current.set(idx, std::move(new_val));
+            }
+            auto arr = boxed_arr->get();
+            while (arr.size() < idx) {
+                arr = std::move(arr).push_back(ImmerValue{});
+            }
+            return ImmerValue{BoxedValueArray{std::move(arr).push_back(std::move(new_val))}};
+        }
         if (current.is_null()) {
             auto trans = ValueVector{}.transient();
             for (std::size_t i = 0; i < idx; ++i) {
@@ -145,31 +158,21 @@ ImmerValue erase_at_path(const ImmerValue& root, PathView path) {
         return ImmerValue{}; // Erase entire root
     }
 
-    // If last element is a string key, we can erase from map
-    if (path.size() == 1) {
-        if (auto* key = std::get_if<std::string_view>(&path[0])) {
-            return detail::erase_key_from_map(root, *key);
+    auto erase_element = [](const ImmerValue& parent, const PathElement& elem) {
+        if (auto* key = std::get_if<std::string_view>(&elem)) {
+            return detail::erase_key(parent, *key);
         }
-        // For index, set to null (cannot truly remove without reindexing)
-        return set_at_path(root, path, ImmerValue{});
-    }
+        return detail::erase_index(parent, std::get<std::size_t>(elem));
+    };
 
-    // Navigate to parent and erase from there
-    Path parent_path;
-    parent_path.reserve(path.size() - 1);
-    for (std::size_t i = 0; i < path.size() - 1; ++i) {
-        parent_path.push_back(path[i]);
-    }
-    const auto& last = path.back();
-
-    if (auto* key = std::get_if<std::string_view>(&last)) {
-        ImmerValue parent = get_at_path(root, parent_path);
-        ImmerValue new_parent = detail::erase_key_from_map(parent, *key);
-        return set_at_path(root, parent_path, new_parent);
+    if (path.size() == 1) {
+        return erase_element(root, path[0]);
     }
 
-    // For index removal, set to null
-    return set_at_path(root, path, ImmerValue{});
+    // Navigate to parent and erase from there
+    const PathView parent_path = path.subpath(0, path.size() - 1);
+    ImmerValue parent = get_at_path(root, parent_path);
+    return set_at_path(root, parent_path, erase_element(parent, path.back()));
 }
 
 // ============================================================
@@ -3,6 +3,11 @@
 
 #include <lager_ext/path_watcher.h>
 
+#include "diff_walk.h"
+
+#include <immer/algorithm.hpp>
+
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
@@ -14,71 +19,183 @@ namespace lager_ext {
 
 namespace {
 
-// Hash function for PathElement (string_view or size_t)
-struct PathElementHash {
-    std::size_t operator()(const PathElement& elem) const {
-        return std::visit(
-            [](const auto& v) -> std::size_t {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (std::is_same_v<T, std::string_view>) {
-                    return std::hash<std::string_view>{}(v);
-                } else {
-                    return std::hash<std::size_t>{}(v);
-                }
-            },
-            elem);
-    }
-};
+// Wildcard segments of a watched pattern
+constexpr std::string_view ANY_SEGMENT = "*";
+constexpr std::string_view ANY_DEPTH_SEGMENT = "**";
+
+// Stands in for a child missing on one side, so children can be passed by reference
+const ImmerValue& null_value() {
+    static const ImmerValue null;
+    return null;
+}
+
+using detail::SameStorage;
 
-// Helper to check if two Values share the same underlying data (structural sharing)
+// Whether two Values share the same underlying data (structural sharing):
+// the same box for containers, equal values for primitives. Containers with
+// equal content in different boxes are not "shared"; callbacks decide those
+// with a full comparison.
 bool values_share_structure(const ImmerValue& a, const ImmerValue& b) {
-    // Quick check: same variant index?
-    if (a.type_index() != b.type_index())
-        return false;
+    return SameStorage{}(a, b);
+}
 
-    // For containers, check if they share the same immer internal pointer
-    // Container Boxing: use BoxedValueMap, BoxedValueVector, etc.
-    if (auto* boxed_map_a = a.get_if<BoxedValueMap>()) {
-        if (auto* boxed_map_b = b.get_if<BoxedValueMap>()) {
-            // immer::map uses structural sharing - same identity means same data
-            return boxed_map_a->get().identity() == boxed_map_b->get().identity();
+// Get child value at path element, by reference into the parent
+const ImmerValue& get_child(const ImmerValue& parent, std::string_view key) {
+    if (auto* m = parent.get_if<BoxedValueMap>()) {
+        if (auto* found = m->get().find(key)) {
+            return *found;
         }
-    }
-    if (auto* boxed_vec_a = a.get_if<BoxedValueVector>()) {
-        if (auto* boxed_vec_b = b.get_if<BoxedValueVector>()) {
-            return boxed_vec_a->get().identity() == boxed_vec_b->get().identity();
+    } else if (auto* t = parent.get_if<BoxedValueTable>()) {
+        if (auto* found = t->get().find(key)) {
+            return *found->value;
         }
     }
-    if (auto* boxed_arr_a = a.get_if<BoxedValueArray>()) {
-        if (auto* boxed_arr_b = b.get_if<BoxedValueArray>()) {
-            // ValueArray doesn't have identity(), fall back to equality
-            return a == b;
+    return null_value();
+}
+
+const ImmerValue& get_child(const ImmerValue& parent, std::size_t index) {
+    if (auto* v = parent.get_if<BoxedValueVector>()) {
+        if (index < v->get().size()) {
+            return v->get()[index];
+        }
+    } else if (auto* a = parent.get_if<BoxedValueArray>()) {
+        if (index < a->get().size()) {
+            return a->get()[index];
         }
     }
-    if (auto* boxed_tab_a = a.get_if<BoxedValueTable>()) {
-        if (auto* boxed_tab_b = b.get_if<BoxedValueTable>()) {
-            // ValueTable doesn't expose identity(), fall back to equality
-            return a == b;
+    return null_value();
+}
+
+const ImmerValue& get_child(const ImmerValue& parent, const PathElement& elem) {
+    return std::visit([&parent](const auto& key) -> const ImmerValue& { return get_child(parent, key); }, elem);
+}
+
+// Call fn(elem, child) for every child of a container
+template <typename Fn>
+void for_each_child(const ImmerValue& val, Fn&& fn) {
+    if (auto* m = val.get_if<BoxedValueMap>()) {
+        for (const auto& [key, child] : m->get()) {
+            fn(PathElement{std::string_view{key}}, child);
+        }
+    } else if (auto* t = val.get_if<BoxedValueTable>()) {
+        for (const auto& entry : t->get()) {
+            fn(PathElement{std::string_view{entry.id}}, *entry.value);
+        }
+    } else if (auto* v = val.get_if<BoxedValueVector>()) {
+        std::size_t index = 0;
+        for (const auto& child : v->get()) {
+            fn(PathElement{index++}, child);
+        }
+    } else if (auto* a = val.get_if<BoxedValueArray>()) {
+        std::size_t index = 0;
+        for (const auto& child : a->get()) {
+            fn(PathElement{index++}, child);
         }
     }
+}
 
-    // For primitives, just compare values
-    return a == b;
+// Vectors skip the RRB subtrees both versions share, like diff_values()
+template <typename Fn>
+void for_each_changed_element(const ValueVector& old_vec, const ValueVector& new_vec, Fn&& fn) {
+    detail::for_each_unshared_element(old_vec, new_vec,
+                                      [&fn](std::size_t i, const ImmerValue& old_elem, const ImmerValue& new_elem) {
+                                          if (!values_share_structure(old_elem, new_elem)) {
+                                              fn(PathElement{i}, old_elem, new_elem);
+                                          }
+                                      });
+    for (std::size_t i = old_vec.size(); i < new_vec.size(); ++i) {
+        fn(PathElement{i}, null_value(), new_vec[i]);
+    }
+    for (std::size_t i = new_vec.size(); i < old_vec.size(); ++i) {
+        fn(PathElement{i}, old_vec[i], null_value());
+    }
 }
 
-// Get child value at path element
-ImmerValue get_child(const ImmerValue& parent, const PathElement& elem) {
-    return std::visit(
-        [&parent](const auto& key) -> ImmerValue {
-            using T = std::decay_t<decltype(key)>;
-            if constexpr (std::is_same_v<T, std::string_view>) {
-                // Convert string_view to string for map lookup
-                return parent.at(std::string{key});
-            } else {
-                return parent.at(key); // size_t index
-            }
-        },
-        elem);
+template <typename Fn>
+void for_each_changed_element(const ValueArray& old_arr, const ValueArray& new_arr, Fn&& fn) {
+    const std::size_t common = std::min(old_arr.size(), new_arr.size());
+    for (std::size_t i = 0; i < common; ++i) {
+        if (!values_share_structure(old_arr[i], new_arr[i])) {
+            fn(PathElement{i}, old_arr[i], new_arr[i]);
+        }
+    }
+    for (std::size_t i = common; i < new_arr.size(); ++i) {
+        fn(PathElement{i}, null_value(), new_arr[i]);
+    }
+    for (std::size_t i = common; i < old_arr.size(); ++i) {
+        fn(PathElement{i}, old_arr[i], null_value());
+    }
+}
+
+// Call fn(elem, old_child, new_child) for every child whose storage differs.
+// Maps and tables are walked with immer's diff, which skips the HAMT nodes the
+// two versions share, so only the children that actually changed are visited.
+template <typename Fn>
+void for_each_changed_child(const ImmerValue& old_val, const ImmerValue& new_val, Fn&& fn) {
+    auto* old_map = old_val.get_if<BoxedValueMap>();
+    auto* new_map = new_val.get_if<BoxedValueMap>();
+    if (old_map && new_map) {
+        // The entry types must match the stored ones exactly: a converting
+        // parameter (e.g. pair<const string, ...>) would bind to a copy
+        old_map->get().impl().template diff<SameStorage>(
+            new_map->get().impl(),
+            immer::make_differ(
+                [&fn](const ValueMap::value_type& added) {
+                    fn(PathElement{std::string_view{added.first}}, null_value(), added.second);
+                },
+                [&fn](const ValueMap::value_type& removed) {
+                    fn(PathElement{std::string_view{removed.first}}, removed.second, null_value());
+                },
+                [&fn](const ValueMap::value_type& old_kv, const ValueMap::value_type& new_kv) {
+                    fn(PathElement{std::string_view{old_kv.first}}, old_kv.second, new_kv.second);
+                }));
+        return;
+    }
+
+    auto* old_table = old_val.get_if<BoxedValueTable>();
+    auto* new_table = new_val.get_if<BoxedValueTable>();
+    if (old_table && new_table) {
+        old_table->get().impl().template diff<SameStorage>(
+            new_table->get().impl(),
+            immer::make_differ(
+                [&fn](const TableEntry& added) {
+                    fn(PathElement{std::string_view{added.id}}, null_value(), *added.value);
+                },
+                [&fn](const TableEntry& removed) {
+                    fn(PathElement{std::string_view{removed.id}}, *removed.value, null_value());
+                },
+                [&fn](const TableEntry& old_entry, const TableEntry& new_entry) {
+                    fn(PathElement{std::string_view{old_entry.id}}, *old_entry.value, *new_entry.value);
+                }));
+        return;
+    }
+
+    auto* old_vec = old_val.get_if<BoxedValueVector>();
+    auto* new_vec = new_val.get_if<BoxedValueVector>();
+    if (old_vec && new_vec) {
+        for_each_changed_element(old_vec->get(), new_vec->get(), fn);
+        return;
+    }
+
+    auto* old_arr = old_val.get_if<BoxedValueArray>();
+    auto* new_arr = new_val.get_if<BoxedValueArray>();
+    if (old_arr && new_arr) {
+        for_each_changed_element(old_arr->get(), new_arr->get(), fn);
+        return;
+    }
+
+    // Different kinds of value: pair children up by lookup, each path once
+    for_each_child(old_val, [&](const PathElement& elem, const ImmerValue& old_child) {
+        const ImmerValue& new_child = get_child(new_val, elem);
+        if (!values_share_structure(old_child, new_child)) {
+            fn(elem, old_child, new_child);
+        }
+    });
+    for_each_child(new_val, [&](const PathElement& elem, const ImmerValue& new_child) {
+        if (&get_child(old_val, elem) == &null_value()) {
+            fn(elem, null_value(), new_child);
+        }
+    });
 }
 
 } // anonymous namespace
@@ -89,33 +206,135 @@ ImmerValue get_child(const ImmerValue& parent, const PathElement& elem) {
 
 struct PathWatcher::WatchNode {
     // Callbacks registered at this exact path
-    std::vector<ChangeCallback> callbacks;
+    std::vector<PathChangeCallback> callbacks;
+
+    // Children indexed by next path element. Keys are owned: the Path given
+    // to watch() does not outlive the call.
+    std::unordered_map<std::string, std::unique_ptr<WatchNode>, TransparentStringHash, TransparentStringEqual> keys;
+    std::unordered_map<std::size_t, std::unique_ptr<WatchNode>> indices;
+
+    // Wildcard children: "*" (any one segment) and "**" (any number of segments)
+    std::unique_ptr<WatchNode> any;
+    std::unique_ptr<WatchNode> any_depth;
+
+    // This node is its parent's "**" child: it also matches every deeper segment
+    bool matches_any_depth = false;
+
+    // Whether checking this node has to see every changed child, not only the exact ones
+    [[nodiscard]] bool needs_all_children() const noexcept { return any || matches_any_depth; }
+
+    // Child slot for a path element, created on demand
+    std::unique_ptr<WatchNode>& slot(const PathElement& elem) {
+        if (auto* index = std::get_if<std::size_t>(&elem)) {
+            return indices[*index];
+        }
+        const std::string_view key = std::get<std::string_view>(elem);
+        if (key == ANY_SEGMENT) {
+            return any;
+        }
+        if (key == ANY_DEPTH_SEGMENT) {
+            return any_depth;
+        }
+        auto it = keys.find(key);
+        if (it == keys.end()) {
+            it = keys.emplace(std::string{key}, nullptr).first;
+        }
+        return it->second;
+    }
+
+    // Child for a path element, wildcards included; nullptr if absent
+    [[nodiscard]] WatchNode* find(const PathElement& elem) const {
+        if (auto* index = std::get_if<std::size_t>(&elem)) {
+            auto it = indices.find(*index);
+            return it != indices.end() ? it->second.get() : nullptr;
+        }
+        const std::string_view key = std::get<std::string_view>(elem);
+        if (key == ANY_SEGMENT) {
+            return any.get();
+        }
+        if (key == ANY_DEPTH_SEGMENT) {
+            return any_depth.get();
+        }
+        return find_exact(key);
+    }
+
+    // Exact child for a concrete key or index; nullptr if absent
+    [[nodiscard]] WatchNode* find_exact(std::string_view key) const {
+        auto it = keys.find(key);
+        return it != keys.end() ? it->second.get() : nullptr;
+    }
+    [[nodiscard]] WatchNode* find_exact(std::size_t index) const {
+        auto it = indices.find(index);
+        return it != indices.end() ? it->second.get() : nullptr;
+    }
+    [[nodiscard]] WatchNode* find_exact(const PathElement& elem) const {
+        return std::visit([this](const auto& key) { return find_exact(key); }, elem);
+    }
+
+    // Remove the child for a path element
+    void erase(const PathElement& elem) {
+        if (auto* index = std::get_if<std::size_t>(&elem)) {
+            indices.erase(*index);
+            return;
+        }
+        const std::string_view key = std::get<std::string_view>(elem);
+        if (key == ANY_SEGMENT) {
+            any.reset();
+        } else if (key == ANY_DEPTH_SEGMENT) {
+            any_depth.reset();
+        } else if (auto it = keys.find(key); it != keys.end()) {
+            keys.erase(it);
+        }
+    }
 
-    // Children indexed by next path element
-    std::unordered_map<PathElement, std::unique_ptr<WatchNode>, PathElementHash> children;
+    // Call fn(child) for every child, wildcards included
+    template <typename Fn>
+    void for_each_child_node(Fn&& fn) const {
+        for (const auto& [_, child] : keys) {
+            if (child)
+                fn(*child);
+        }
+        for (const auto& [_, child] : indices) {
+            if (child)
+                fn(*child);
+        }
+        if (any)
+            fn(*any);
+        if (any_depth)
+            fn(*any_depth);
+    }
 
     // Check if this node or any descendant has callbacks
     [[nodiscard]] bool has_any_watches() const {
         if (!callbacks.empty())
             return true;
-        for (const auto& [_, child] : children) {
-            if (child && child->has_any_watches())
-                return true;
-        }
-        return false;
+        bool found = false;
+        for_each_child_node([&found](const WatchNode& child) { found = found || child.has_any_watches(); });
+        return found;
     }
 
     // Count total watches in this subtree
     [[nodiscard]] std::size_t count_watches() const {
         std::size_t count = callbacks.size();
-        for (const auto& [_, child] : children) {
-            if (child)
-                count += child->count_watches();
-        }
+        for_each_child_node([&count](const WatchNode& child) { count += child.count_watches(); });
         return count;
     }
 };
 
+namespace {
+
+// Add a trie node to the set matching the current path, with the "**"
+// children that match it through zero extra segments
+template <typename Node>
+void add_node(std::vector<const Node*>& nodes, const Node* node) {
+    while (node && std::find(nodes.begin(), nodes.end(), node) == nodes.end()) {
+        nodes.push_back(node);
+        node = node->any_depth.get();
+    }
+}
+
+} // anonymous namespace
+
 // ============================================================
 // Constructor / Destructor / Move Operations
 // ============================================================
@@ -135,10 +354,19 @@ void PathWatcher::watch(const std::string& path_str, ChangeCallback callback) {
 }
 
 void PathWatcher::watch(Path path, ChangeCallback callback) {
+    insert_path(path, [callback = std::move(callback)](PathView, const ImmerValue& old_val,
+                                                       const ImmerValue& new_val) { callback(old_val, new_val); });
+}
+
+void PathWatcher::watch(const std::string& path_str, PathChangeCallback callback) {
+    watch(Path{path_str}, std::move(callback));
+}
+
+void PathWatcher::watch(Path path, PathChangeCallback callback) {
     insert_path(path, std::move(callback));
 }
 
-void PathWatcher::insert_path(const Path& path, ChangeCallback callback) {
+void PathWatcher::insert_path(const Path& path, PathChangeCallback callback) {
     if (!root_) {
         root_ = std::make_unique<WatchNode>();
     }
@@ -147,9 +375,10 @@ void PathWatcher::insert_path(const Path& path, ChangeCallback callback) {
 
     // Traverse/create trie nodes for each path element
     for (const auto& elem : path) {
-        auto& child = node->children[elem];
+        auto& child = node->slot(elem);
         if (!child) {
             child = std::make_unique<WatchNode>();
+            child->matches_any_depth = (&child == &node->any_depth);
         }
         node = child.get();
     }
@@ -177,12 +406,12 @@ bool PathWatcher::remove_path(const Path& path) {
 
     // Traverse to the target node
     for (const auto& elem : path) {
-        auto it = node->children.find(elem);
-        if (it == node->children.end() || !it->second) {
+        WatchNode* child = node->find(elem);
+        if (!child) {
             return false; // Path not found
         }
         ancestors.push_back({node, &elem});
-        node = it->second.get();
+        node = child;
     }
 
     if (node->callbacks.empty()) {
@@ -199,9 +428,9 @@ bool PathWatcher::remove_path(const Path& path) {
         WatchNode* parent = it->first;
         const PathElement* elem = it->second;
 
-        auto child_it = parent->children.find(*elem);
-        if (child_it != parent->children.end() && child_it->second && !child_it->second->has_any_watches()) {
-            parent->children.erase(child_it);
+        WatchNode* child = parent->find(*elem);
+        if (child && !child->has_any_watches()) {
+            parent->erase(*elem);
         } else {
             break; // Stop if this subtree still has watches
         }
@@ -240,48 +469,132 @@ std::size_t PathWatcher::check(const ImmerValue& old_state, const ImmerValue& ne
     }
 
     // Optimization 3: Trie-based traversal with pruning
-    std::size_t triggered = check_node(root_.get(), old_state, new_state);
+    NodeSet nodes;
+    add_node(nodes, static_cast<const WatchNode*>(root_.get()));
+    path_.clear();
+    std::size_t triggered = check_node(nodes, old_state, new_state);
     stats_.callbacks_triggered += triggered;
 
     return triggered;
 }
 
-std::size_t PathWatcher::check_node(WatchNode* node, const ImmerValue& old_val, const ImmerValue& new_val) {
-    if (!node)
-        return 0;
-
-    ++stats_.nodes_visited;
+std::size_t PathWatcher::check_node(const NodeSet& nodes, const ImmerValue& old_val, const ImmerValue& new_val) {
+    stats_.nodes_visited += nodes.size();
 
     std::size_t triggered = 0;
 
-    // Trigger callbacks at this node if values differ
-    if (!node->callbacks.empty()) {
-        if (old_val != new_val) {
-            for (const auto& callback : node->callbacks) {
-                callback(old_val, new_val);
-                ++triggered;
-            }
+    // Trigger callbacks if values differ. Callers only get here when the
+    // storage differs, so the full comparison runs at callback nodes only,
+    // and at most once per concrete path.
+    bool compared = false;
+    bool differs = false;
+    for (const WatchNode* node : nodes) {
+        if (node->callbacks.empty())
+            continue;
+        if (!compared) {
+            differs = old_val != new_val;
+            compared = true;
+        }
+        if (!differs)
+            break;
+        for (const auto& callback : node->callbacks) {
+            callback(PathView{path_}, old_val, new_val);
+            ++triggered;
         }
     }
 
-    // Recurse into children
-    for (const auto& [elem, child] : node->children) {
-        if (!child)
-            continue;
+    const bool all_children =
+        std::any_of(nodes.begin(), nodes.end(), [](const WatchNode* node) { return node->needs_all_children(); });
+
+    if (all_children) {
+        // Wildcard level: walk only the children whose storage changed
+        for_each_changed_child(old_val, new_val,
+                               [&](const PathElement& elem, const ImmerValue& old_child, const ImmerValue& new_child) {
+                                   NodeSet next;
+                                   for (const WatchNode* node : nodes) {
+                                       add_node(next, static_cast<const WatchNode*>(node->find_exact(elem)));
+                                       add_node(next, static_cast<const WatchNode*>(node->any.get()));
+                                       if (node->matches_any_depth) {
+                                           add_node(next, node);
+                                       }
+                                   }
+                                   if (!next.empty()) {
+                                       triggered += check_child(elem, next, old_child, new_child);
+                                   }
+                               });
+        return triggered;
+    }
 
-        ImmerValue old_child = get_child(old_val, elem);
-        ImmerValue new_child = get_child(new_val, elem);
+    // Exact children only: look each one up
+    if (nodes.size() == 1) {
+        const WatchNode& node = *nodes.front();
+        for (const auto& [key, child] : node.keys) {
+            if (child)
+                triggered += check_exact_child(PathElement{std::string_view{key}}, *child, old_val, new_val);
+        }
+        for (const auto& [index, child] : node.indices) {
+            if (child)
+                triggered += check_exact_child(PathElement{index}, *child, old_val, new_val);
+        }
+        return triggered;
+    }
 
-        // Optimization: Prune if children share structure (haven't changed)
-        if (values_share_structure(old_child, new_child)) {
-            ++stats_.nodes_pruned;
-            continue; // Skip entire subtree!
+    // Several nodes (reached through wildcards): group the ones sharing a key
+    std::vector<std::pair<PathElement, NodeSet>> children;
+    auto add_child = [&children](const PathElement& elem, const WatchNode* child) {
+        auto it = std::find_if(children.begin(), children.end(),
+                               [&elem](const auto& entry) { return entry.first == elem; });
+        if (it == children.end()) {
+            children.emplace_back(elem, NodeSet{});
+            it = std::prev(children.end());
+        }
+        add_node(it->second, child);
+    };
+    for (const WatchNode* node : nodes) {
+        for (const auto& [key, child] : node->keys) {
+            if (child)
+                add_child(PathElement{std::string_view{key}}, child.get());
         }
+        for (const auto& [index, child] : node->indices) {
+            if (child)
+                add_child(PathElement{index}, child.get());
+        }
+    }
 
-        triggered += check_node(child.get(), old_child, new_child);
+    for (const auto& [elem, next] : children) {
+        triggered += check_exact_child(elem, next, old_val, new_val);
     }
 
     return triggered;
 }
 
+std::size_t PathWatcher::check_exact_child(const PathElement& elem, const WatchNode& child,
+                                           const ImmerValue& old_val, const ImmerValue& new_val) {
+    NodeSet next;
+    add_node(next, &child);
+    return check_exact_child(elem, next, old_val, new_val);
+}
+
+std::size_t PathWatcher::check_exact_child(const PathElement& elem, const NodeSet& nodes, const ImmerValue& old_val,
+                                           const ImmerValue& new_val) {
+    const ImmerValue& old_child = get_child(old_val, elem);
+    const ImmerValue& new_child = get_child(new_val, elem);
+
+    // Optimization: Prune if children share structure (haven't changed)
+    if (values_share_structure(old_child, new_child)) {
+        ++stats_.nodes_pruned;
+        return 0; // Skip entire subtree!
+    }
+
+    return check_child(elem, nodes, old_child, new_child);
+}
+
+std::size_t PathWatcher::check_child(const PathElement& elem, const NodeSet& nodes, const ImmerValue& old_child,
+                                     const ImmerValue& new_child) {
+    path_.push_back(elem);
+    std::size_t triggered = check_node(nodes, old_child, new_child);
+    path_.pop_back();
+    return triggered;
+}
+
 } // namespace lager_ext
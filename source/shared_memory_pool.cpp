@@ -2,13 +2,14 @@
 // Licensed under the MIT License. See LICENSE file in the project root.
 
 /// @file shared_memory_pool.cpp
-/// @brief Implementation of shared memory pool optimized for SPSC IPC pattern
+/// @brief Implementation of the TLSF shared memory pool
 
 #include <lager_ext/shared_memory_pool.h>
 
-#include <atomic>
-#include <cstring>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 
 // Boost.Interprocess (hidden from headers)
 #include <boost/interprocess/mapped_region.hpp>
@@ -31,187 +32,164 @@ namespace ipc {
 static std::string s_lastError;
 
 //=============================================================================
-// SPSC LIFO Cache Entry (in shared memory)
+// Block Addressing
 //=============================================================================
 
-/// Entry in the SPSC LIFO cache - stored in shared memory
-struct alignas(8) SPSCCacheEntry {
-    uint32_t offset;     // Block offset in pool (UINT32_MAX = invalid)
-    uint32_t blockSize;  // Block size (for quick matching)
-};
+/// Blocks are addressed by a 32-bit reference counting MIN_BLOCK_SIZE granules:
+/// the top bits select the segment, the rest the granule within it. Public
+/// offsets are simply ref * MIN_BLOCK_SIZE, so 32 bits cover 256 GB while the
+/// block headers and free lists keep 4-byte links.
+inline constexpr uint32_t GRANULE = static_cast<uint32_t>(MIN_BLOCK_SIZE);
+inline constexpr uint32_t SEGMENT_SHIFT = 28;
+inline constexpr uint32_t LOCAL_MASK = (1u << SEGMENT_SHIFT) - 1;
+static_assert(MAX_POOL_SEGMENTS == (size_t{1} << (32 - SEGMENT_SHIFT)), "Segment bits mismatch");
+static_assert(MAX_SEGMENT_SIZE < (uint64_t{1} << SEGMENT_SHIFT) * GRANULE, "Segment must leave NIL unused");
 
-static_assert(sizeof(SPSCCacheEntry) == 8, "SPSCCacheEntry should be 8 bytes");
+/// Null block reference (end of a free list / no neighbour)
+inline constexpr uint32_t NIL = UINT32_MAX;
+
+inline uint32_t segment_of(uint32_t ref) noexcept { return ref >> SEGMENT_SHIFT; }
+inline uint32_t local_of(uint32_t ref) noexcept { return ref & LOCAL_MASK; }
 
 //=============================================================================
-// SPSC LIFO Cache (in shared memory)
+// Free Block Index (TLSF)
 //=============================================================================
 
-/// SPSC LIFO cache structure - lives in shared memory header
-/// 
-/// Design:
-/// - Consumer (deallocate) pushes to head
-/// - Producer (allocate) pops from head  
-/// - LIFO order ensures most recently freed blocks are reused first
-/// - Single atomic counter for SPSC safety
-///
-/// Memory Layout:
-/// - count: number of valid entries (atomic, both sides update)
-/// - entries[]: array of cache entries (LIFO stack)
-///
-/// Size calculation:
-/// - atomic<uint32_t>: 4 bytes
-/// - reserved[3]: 12 bytes  
-/// - entries[8]: 8 * 8 = 64 bytes
-/// - Total: 80 bytes, padded to 128 bytes (2 cache lines)
-struct alignas(64) SPSCLifoCache {
-    // Atomic count of valid entries in cache
-    // Consumer increments on push, Producer decrements on pop
-    std::atomic<uint32_t> count;
-    
-    // Padding to separate atomic from data
-    uint32_t reserved[3];
-    
-    // Cache entries - LIFO stack
-    // Index 0 is the "top" of the LIFO stack
-    SPSCCacheEntry entries[SPSC_LIFO_CACHE_SIZE];  // 8 entries * 8 bytes = 64 bytes
-    
-    // Padding to fill to 128 bytes (2 cache lines)
-    // 4 + 12 + 64 = 80 bytes used, need 48 bytes padding
-    uint8_t padding[48];
-    
-    void init() noexcept {
-        count.store(0, std::memory_order_relaxed);
-        for (auto& entry : entries) {
-            entry.offset = UINT32_MAX;
-            entry.blockSize = 0;
-        }
-    }
-    
-    /// Push a freed block to the cache (Consumer side)
-    /// @return true if pushed, false if cache is full
-    bool push(uint32_t offset, uint32_t blockSize) noexcept {
-        uint32_t currentCount = count.load(std::memory_order_acquire);
-        if (currentCount >= SPSC_LIFO_CACHE_SIZE) {
-            return false;  // Cache full
-        }
-        
-        // Shift entries down to make room at index 0 (LIFO top)
-        for (size_t i = SPSC_LIFO_CACHE_SIZE - 1; i > 0; --i) {
-            entries[i] = entries[i - 1];
-        }
-        
-        // Insert at top
-        entries[0] = {offset, blockSize};
-        
-        // Increment count with release semantics (makes entries visible to Producer)
-        count.store(currentCount + 1, std::memory_order_release);
-        return true;
-    }
-    
-    /// Pop a suitable block from the cache (Producer side)
-    /// @param minSize Minimum block size required
-    /// @return Offset of suitable block, or UINT32_MAX if none found
-    uint32_t pop(uint32_t minSize) noexcept {
-        uint32_t currentCount = count.load(std::memory_order_acquire);
-        if (currentCount == 0) {
-            return UINT32_MAX;  // Cache empty
-        }
-        
-        // Search for a suitable block (starting from top)
-        for (size_t i = 0; i < currentCount && i < SPSC_LIFO_CACHE_SIZE; ++i) {
-            if (entries[i].offset != UINT32_MAX && entries[i].blockSize >= minSize) {
-                // Found suitable block
-                uint32_t offset = entries[i].offset;
-                
-                // Remove this entry by shifting remaining entries up
-                for (size_t j = i; j < SPSC_LIFO_CACHE_SIZE - 1; ++j) {
-                    entries[j] = entries[j + 1];
-                }
-                entries[SPSC_LIFO_CACHE_SIZE - 1] = {UINT32_MAX, 0};
-                
-                // Decrement count with release semantics
-                count.store(currentCount - 1, std::memory_order_release);
-                return offset;
-            }
-        }
-        
-        return UINT32_MAX;  // No suitable block found
-    }
-    
-    /// Peek at cache state (for debugging/stats)
-    uint32_t size() const noexcept {
-        return count.load(std::memory_order_relaxed);
-    }
+/// Free blocks are binned by a two-level segregated fit index (TLSF) on their
+/// size in granules:
+/// - Below SL_COUNT granules (1 KB): one exact bin per size (fl = 0)
+/// - Above: first level is the power of two, second level SL_COUNT linear
+///   subdivisions of it
+/// A bitmap per level finds the smallest non-empty bin that fits a request
+/// with two count-trailing-zeros, so allocate and free are O(1) regardless of
+/// how large the pool is or how many blocks are free.
+inline constexpr uint32_t SL_LOG2 = 4;
+inline constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+inline constexpr uint32_t FL_COUNT = 32;
+
+struct BinIndex {
+    uint32_t fl;
+    uint32_t sl;
 };
 
-// Verify cache fits in a cache line multiple
-static_assert(sizeof(SPSCLifoCache) == 128, "SPSCLifoCache should be 128 bytes");
+/// Bin holding free blocks of exactly this many granules
+inline BinIndex bin_for(uint32_t granules) noexcept {
+    if (granules < SL_COUNT) {
+        return {0, granules};
+    }
+    uint32_t msb = static_cast<uint32_t>(std::bit_width(granules)) - 1;
+    return {msb - SL_LOG2 + 1, (granules >> (msb - SL_LOG2)) - SL_COUNT};
+}
 
 //=============================================================================
-// Pool Header (in shared memory)
+// Pool Header (in shared memory, at the start of segment 0)
 //=============================================================================
 
-/// Pool header structure - located at the beginning of shared memory
-/// 
-/// Layout (total 448 bytes):
-/// - Cache Line 0 (64B): magic, version, poolSize, dataOffset, padding
-/// - Cache Line 1 (64B): freeHead atomic, padding
-/// - Cache Line 2 (64B): statistics (allocatedCount, totalAlloc, totalDealloc), padding
-/// - Cache Lines 3-4 (128B): SPSC LIFO Cache
-/// - Cache Lines 5-6 (128B): Bitmap for block tracking
+/// Pool header structure - located at the beginning of the first segment
+///
+/// Layout (total 2560 bytes):
+/// - Cache Line 0 (64B): magic, version, segment count, sizes, padding
+/// - Cache Line 1 (64B): deferred free stack head (pushed by any side)
+/// - Cache Line 2 (64B): statistics, padding
+/// - Cache Lines 3-5 (192B): TLSF first/second level bitmaps
+/// - Cache Lines 6-37 (2048B): TLSF free list heads
+/// - Cache Lines 38-39 (128B): segment sizes
 struct PoolHeader {
     static constexpr uint32_t MAGIC = 0x4C475058;  // "LGPX"
-    static constexpr uint16_t VERSION = 3;  // Version 3: SPSC LIFO cache in shared memory
+    static constexpr uint16_t VERSION = 5;  // Version 5: granule refs, chained segments
 
     // === Cache Line 0: Basic info (64 bytes) ===
-    uint32_t magic;              // 4 bytes
-    uint16_t version;            // 2 bytes
-    uint16_t reserved1;          // 2 bytes
-    uint32_t poolSize;           // 4 bytes - Total pool size in bytes
-    uint32_t dataOffset;         // 4 bytes - Offset where data region starts
-    uint8_t headerPadding[48];   // 48 bytes padding (64 - 16 = 48)
-    
-    // === Cache Line 1: Free list head (64 bytes) ===
-    alignas(64) std::atomic<uint32_t> freeHead;  // 4 bytes
-    uint8_t freeHeadPadding[60];                 // 60 bytes padding
-    
+    uint32_t magic;                           // 4 bytes
+    uint16_t version;                         // 2 bytes
+    uint16_t reserved1;                       // 2 bytes
+    uint32_t dataOffset;                      // 4 bytes - Offset where segment 0's data starts
+    std::atomic<uint32_t> segmentCount;       // 4 bytes - Published after the segment is initialized
+    uint64_t maxPoolSize;                     // 8 bytes - Growth limit (total of all segments)
+    std::atomic<uint64_t> poolSize;           // 8 bytes - Current total of all segments
+    uint8_t headerPadding[32];                // 32 bytes padding (64 - 32 = 32)
+
+    // === Cache Line 1: Deferred free stack (64 bytes) ===
+    // Blocks freed by deallocate(), linked through BlockHeader::nextFree.
+    // Any side pushes with CAS; the allocating side takes the whole stack
+    // with one exchange, so there is no ABA problem.
+    alignas(64) std::atomic<uint32_t> deferredHead;  // 4 bytes
+    uint8_t deferredPadding[60];                     // 60 bytes padding
+
     // === Cache Line 2: Statistics (64 bytes) ===
-    alignas(64) std::atomic<uint32_t> allocatedCount;      // 4 bytes
-    std::atomic<uint32_t> totalAllocations;                // 4 bytes
-    std::atomic<uint32_t> totalDeallocations;              // 4 bytes
-    uint8_t statsPadding[52];                              // 52 bytes padding (64 - 12 = 52)
-    
-    // === Cache Lines 3-4: SPSC LIFO Cache (128 bytes) ===
-    alignas(64) SPSCLifoCache spscCache;
-    
-    // === Cache Lines 5-6: Bitmap for allocation tracking (128 bytes) ===
-    alignas(64) uint8_t bitmap[128];
+    alignas(64) std::atomic<uint64_t> allocatedCount;      // 8 bytes
+    std::atomic<uint64_t> totalAllocations;                // 8 bytes
+    std::atomic<uint64_t> totalDeallocations;              // 8 bytes
+    std::atomic<uint64_t> freeBytes;                       // 8 bytes - In TLSF bins
+    std::atomic<uint64_t> freeBlocks;                      // 8 bytes - In TLSF bins
+    std::atomic<uint64_t> deferredBytes;                   // 8 bytes - On the deferred stack
+    uint8_t statsPadding[16];                              // 16 bytes padding (64 - 48 = 16)
+
+    // === Cache Lines 3-5: TLSF bitmaps (192 bytes, allocating side only) ===
+    alignas(64) uint32_t flBitmap;       // Bit fl set: some slBitmap[fl] bit is set
+    uint32_t slBitmap[FL_COUNT];         // Bit sl set: freeLists[fl][sl] is non-empty
+    uint8_t indexPadding[60];            // 60 bytes padding (192 - 132 = 60)
+
+    // === Cache Lines 6-37: TLSF free list heads (2048 bytes, allocating side only) ===
+    alignas(64) uint32_t freeLists[FL_COUNT][SL_COUNT];
+
+    // === Cache Lines 38-39: Segment sizes (128 bytes) ===
+    // Entry i is written before segmentCount is raised past i
+    alignas(64) uint64_t segmentSizes[MAX_POOL_SEGMENTS];
 
     bool is_valid() const { return magic == MAGIC && version == VERSION; }
 };
 
 // Layout verification:
-// Cache Line 0: 64 bytes (16 used + 48 padding)
+// Cache Line 0: 64 bytes (32 used + 32 padding)
 // Cache Line 1: 64 bytes (4 used + 60 padding)
-// Cache Line 2: 64 bytes (12 used + 52 padding)
-// Cache Lines 3-4: 128 bytes (SPSCLifoCache)
-// Cache Lines 5-6: 128 bytes (bitmap)
-// Total: 64 + 64 + 64 + 128 + 128 = 448 bytes
-static_assert(sizeof(PoolHeader) == 448, "PoolHeader size mismatch");
+// Cache Line 2: 64 bytes (48 used + 16 padding)
+// Cache Lines 3-5: 192 bytes (132 used + 60 padding)
+// Cache Lines 6-37: 2048 bytes (free list heads)
+// Cache Lines 38-39: 128 bytes (segment sizes)
+// Total: 64 + 64 + 64 + 192 + 2048 + 128 = 2560 bytes
+static_assert(sizeof(PoolHeader) == 2560, "PoolHeader size mismatch");
+
+/// Header at the start of every chained segment (segment 1 onwards)
+struct alignas(64) SegmentHeader {
+    static constexpr uint32_t MAGIC = 0x4C475053;  // "LGPS"
+
+    uint32_t magic;
+    uint32_t index;
+    uint64_t size;  // Data bytes after this header
 
-/// Block header - prepended to each allocated block
+    bool is_valid() const { return magic == MAGIC; }
+};
+
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader should be one cache line");
+
+/// Block header - prepended to every block, free or allocated
+///
+/// prevPhys is the boundary tag: together with blockSize it links each block
+/// to both physical neighbours, so a freed block merges with free neighbours
+/// in O(1). The fields the reading side checks (magic, size, blockSize, state)
+/// are never written while the block is allocated; neighbours only update
+/// prevPhys. Blocks never span segments.
 struct BlockHeader {
     static constexpr uint32_t MAGIC = 0x424C4B48;  // "BLKH"
 
+    enum State : uint32_t {
+        Free = 0,       // In a TLSF bin
+        Allocated = 1,  // Owned by the user
+        Deferred = 2    // Deallocated, waiting on the deferred stack
+    };
+
     uint32_t magic;
-    uint32_t size;          // User-requested size
-    uint32_t blockSize;     // Actual block size (including header, aligned)
-    uint32_t nextFree;      // Offset of next free block (when in free list)
+    std::atomic<uint32_t> state;  // State (read by neighbours during coalescing)
+    uint64_t size;                // User-requested size in bytes
+    uint32_t blockSize;           // Block size in granules (including header)
+    uint32_t prevPhys;            // Ref of the physically preceding block (NIL for a segment's first)
+    uint32_t nextFree;            // Next block in its free list or on the deferred stack
+    uint32_t prevFree;            // Previous block in its free list
 
     bool is_valid() const { return magic == MAGIC; }
 };
 
-static_assert(sizeof(BlockHeader) == 16, "BlockHeader should be 16 bytes");
+static_assert(sizeof(BlockHeader) == 32, "BlockHeader should be 32 bytes");
 
 //=============================================================================
 // SharedMemoryPool::Impl
@@ -226,63 +204,55 @@ public:
         // POSIX: cleanup shared memory if we created it
         // Windows: kernel handles cleanup automatically via reference counting
         if (isCreator_ && !name_.empty()) {
-            try {
-                bip::shared_memory_object::remove(name_.c_str());
-            } catch (...) {}
+            uint32_t count = header_ ? header_->segmentCount.load(std::memory_order_acquire) : 1;
+            for (uint32_t seg = 0; seg < count; ++seg) {
+                try {
+                    bip::shared_memory_object::remove(segmentName(seg).c_str());
+                } catch (...) {}
+            }
         }
 #endif
     }
 
-    bool create(std::string_view name, size_t poolSize) {
+    bool create(std::string_view name, size_t poolSize, size_t maxPoolSize) {
         name_ = std::string(name);
         isCreator_ = true;
-        poolSize_ = poolSize;
-
-        try {
-            // Total size = header + pool
-            size_t totalSize = sizeof(PoolHeader) + poolSize;
-
-#ifdef _WIN32
-            // Windows: use native shared memory
-            shm_ = std::make_unique<bip::windows_shared_memory>(
-                bip::create_only, name_.c_str(), bip::read_write, totalSize);
+        // Whole granules only
+        uint64_t firstSize = std::min<uint64_t>(poolSize, MAX_SEGMENT_SIZE) / GRANULE * GRANULE;
 
-            // Map region
-            region_ = bip::mapped_region(*shm_, bip::read_write);
-#else
-            // POSIX: Remove any existing
-            bip::shared_memory_object::remove(name_.c_str());
-
-            // Create shared memory
-            shm_ = bip::shared_memory_object(bip::create_only, name_.c_str(), bip::read_write);
-            shm_.truncate(static_cast<bip::offset_t>(totalSize));
+        if (firstSize < GRANULE) {
+            s_lastError = "Pool size must be at least " + std::to_string(MIN_BLOCK_SIZE) + " bytes";
+            return false;
+        }
 
-            // Map region
-            region_ = bip::mapped_region(shm_, bip::read_write);
+        try {
+#ifndef _WIN32
+            // POSIX: Remove any existing (including chained segments of an old pool)
+            for (uint32_t seg = 0; seg < MAX_POOL_SEGMENTS; ++seg) {
+                bip::shared_memory_object::remove(segmentName(seg).c_str());
+            }
 #endif
+            // Total size = header + first segment
+            mapSegment(0, sizeof(PoolHeader) + firstSize, true);
 
-            // Initialize header
-            header_ = new (region_.get_address()) PoolHeader{};
+            // Initialize header (value-initialized: empty bins, zero bitmaps and stats)
+            header_ = new (segments_[0].region.get_address()) PoolHeader{};
             header_->magic = PoolHeader::MAGIC;
             header_->version = PoolHeader::VERSION;
             header_->reserved1 = 0;
-            header_->poolSize = static_cast<uint32_t>(poolSize);
             header_->dataOffset = sizeof(PoolHeader);
-            header_->freeHead.store(0, std::memory_order_relaxed);
-            header_->allocatedCount.store(0, std::memory_order_relaxed);
-            header_->totalAllocations.store(0, std::memory_order_relaxed);
-            header_->totalDeallocations.store(0, std::memory_order_relaxed);
-            std::memset(header_->bitmap, 0, sizeof(header_->bitmap));
-            
-            // Initialize SPSC LIFO cache
-            header_->spscCache.init();
-
-            // Initialize entire pool as one big free block
-            auto* firstBlock = reinterpret_cast<BlockHeader*>(dataRegion());
-            firstBlock->magic = BlockHeader::MAGIC;
-            firstBlock->size = 0;
-            firstBlock->blockSize = static_cast<uint32_t>(poolSize);
-            firstBlock->nextFree = UINT32_MAX;  // End of list
+            header_->maxPoolSize = std::max<uint64_t>(maxPoolSize, firstSize);
+            header_->poolSize.store(firstSize, std::memory_order_relaxed);
+            header_->segmentSizes[0] = firstSize;
+            header_->deferredHead.store(NIL, std::memory_order_relaxed);
+            for (auto& lists : header_->freeLists) {
+                std::fill(std::begin(lists), std::end(lists), NIL);
+            }
+            segmentData_[0] = static_cast<uint8_t*>(segments_[0].region.get_address()) + sizeof(PoolHeader);
+
+            // Initialize the whole segment as one big free block
+            initSegmentBlock(0);
+            header_->segmentCount.store(1, std::memory_order_release);
 
             return true;
         } catch (const std::exception& e) {
@@ -296,30 +266,17 @@ public:
         isCreator_ = false;
 
         try {
-#ifdef _WIN32
-            // Windows: open existing native shared memory
-            shm_ = std::make_unique<bip::windows_shared_memory>(
-                bip::open_only, name_.c_str(), bip::read_write);
-
-            // Map region
-            region_ = bip::mapped_region(*shm_, bip::read_write);
-#else
-            // POSIX: Open existing
-            shm_ = bip::shared_memory_object(bip::open_only, name_.c_str(), bip::read_write);
-
-            // Map region
-            region_ = bip::mapped_region(shm_, bip::read_write);
-#endif
+            mapSegment(0, 0, false);
 
             // Get header
-            header_ = static_cast<PoolHeader*>(region_.get_address());
+            header_ = static_cast<PoolHeader*>(segments_[0].region.get_address());
 
             if (!header_->is_valid()) {
                 s_lastError = "Invalid pool header (version mismatch or corruption)";
                 return false;
             }
 
-            poolSize_ = header_->poolSize;
+            segmentData_[0] = static_cast<uint8_t*>(segments_[0].region.get_address()) + header_->dataOffset;
             return true;
         } catch (const std::exception& e) {
             s_lastError = std::string("Failed to open pool: ") + e.what();
@@ -333,229 +290,448 @@ public:
             return {};
         }
 
-        // Calculate actual block size needed (header + data, aligned to MIN_BLOCK_SIZE)
-        size_t totalNeeded = sizeof(BlockHeader) + requestedSize;
-        size_t blockSize = ((totalNeeded + MIN_BLOCK_SIZE - 1) / MIN_BLOCK_SIZE) * MIN_BLOCK_SIZE;
-
-        if (blockSize > poolSize_) {
+        if (requestedSize > MAX_SEGMENT_SIZE - sizeof(BlockHeader) ||
+            requestedSize > header_->maxPoolSize - sizeof(BlockHeader)) {
             s_lastError = "Requested size exceeds pool size";
             return {};
         }
 
-        // =====================================================================
-        // SPSC LIFO Cache Fast Path - O(1) for recently freed blocks
-        // =====================================================================
-        uint32_t cachedOffset = header_->spscCache.pop(static_cast<uint32_t>(blockSize));
-        if (cachedOffset != UINT32_MAX) {
-            auto* block = blockAt(cachedOffset);
-            if (block->is_valid()) {
-                block->size = static_cast<uint32_t>(requestedSize);
-                
-                // Mark as allocated in bitmap
-                size_t blockIndex = cachedOffset / MIN_BLOCK_SIZE;
-                if (blockIndex < sizeof(header_->bitmap) * 8) {
-                    header_->bitmap[blockIndex / 8] |= (1 << (blockIndex % 8));
-                }
-
-                header_->allocatedCount.fetch_add(1, std::memory_order_relaxed);
-                header_->totalAllocations.fetch_add(1, std::memory_order_relaxed);
-                ++cacheHits_;
-
-                return SharedMemoryPool::Block(
-                    cachedOffset,
-                    static_cast<uint32_t>(requestedSize),
-                    reinterpret_cast<uint8_t*>(block) + sizeof(BlockHeader)
-                );
-            }
-        }
-        
-        ++cacheMisses_;
+        // Block size in granules (header + data, aligned to MIN_BLOCK_SIZE)
+        uint32_t granules = static_cast<uint32_t>((sizeof(BlockHeader) + requestedSize + GRANULE - 1) / GRANULE);
 
-        // =====================================================================
-        // Slow Path - First-fit from free list
-        // =====================================================================
-        uint32_t prevOffset = UINT32_MAX;
-        uint32_t currentOffset = header_->freeHead.load(std::memory_order_acquire);
+        // Merge everything deallocated since the last call back into the bins
+        drainDeferred();
 
-        while (currentOffset != UINT32_MAX && currentOffset < poolSize_) {
-            auto* block = blockAt(currentOffset);
-            if (!block->is_valid()) {
-                s_lastError = "Corrupted free list";
+        uint32_t ref = findFree(granules);
+        if (ref == NIL) {
+            if (!grow(granules)) {
                 return {};
             }
+            ref = findFree(granules);
+        }
 
-            if (block->blockSize >= blockSize) {
-                // Found a suitable block
-                uint32_t remaining = block->blockSize - static_cast<uint32_t>(blockSize);
-
-                if (remaining >= MIN_BLOCK_SIZE + sizeof(BlockHeader)) {
-                    // Split the block
-                    uint32_t newBlockOffset = currentOffset + static_cast<uint32_t>(blockSize);
-                    auto* newBlock = blockAt(newBlockOffset);
-                    newBlock->magic = BlockHeader::MAGIC;
-                    newBlock->size = 0;
-                    newBlock->blockSize = remaining;
-                    newBlock->nextFree = block->nextFree;
-
-                    block->blockSize = static_cast<uint32_t>(blockSize);
-                    block->nextFree = UINT32_MAX;
-
-                    // Update free list
-                    if (prevOffset == UINT32_MAX) {
-                        header_->freeHead.store(newBlockOffset, std::memory_order_release);
-                    } else {
-                        blockAt(prevOffset)->nextFree = newBlockOffset;
-                    }
-                } else {
-                    // Use the entire block
-                    if (prevOffset == UINT32_MAX) {
-                        header_->freeHead.store(block->nextFree, std::memory_order_release);
-                    } else {
-                        blockAt(prevOffset)->nextFree = block->nextFree;
-                    }
-                    block->nextFree = UINT32_MAX;
-                }
-
-                block->size = static_cast<uint32_t>(requestedSize);
-                
-                // Mark as allocated in bitmap
-                size_t blockIndex = currentOffset / MIN_BLOCK_SIZE;
-                if (blockIndex < sizeof(header_->bitmap) * 8) {
-                    header_->bitmap[blockIndex / 8] |= (1 << (blockIndex % 8));
-                }
-
-                header_->allocatedCount.fetch_add(1, std::memory_order_relaxed);
-                header_->totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        removeFree(ref);
+        auto* block = blockAt(ref);
+        uint32_t remaining = block->blockSize - granules;
+
+        if (remaining > 0) {
+            // Split: the tail becomes a new free block. Its physical successor
+            // cannot be free (it would have been merged), so no coalescing here.
+            uint32_t tailRef = ref + granules;
+            auto* tail = new (blockAt(tailRef)) BlockHeader{};
+            tail->magic = BlockHeader::MAGIC;
+            tail->blockSize = remaining;
+            tail->prevPhys = ref;
+            linkNext(tailRef);
+            insertFree(tailRef);
+
+            block->blockSize = granules;
+            ++cacheMisses_;
+        } else {
+            // A recycled block of the right size class, reused whole
+            ++cacheHits_;
+        }
 
-                return SharedMemoryPool::Block(
-                    currentOffset,
-                    static_cast<uint32_t>(requestedSize),
-                    reinterpret_cast<uint8_t*>(block) + sizeof(BlockHeader)
-                );
-            }
+        block->size = requestedSize;
+        block->nextFree = NIL;
+        block->prevFree = NIL;
+        block->state.store(BlockHeader::Allocated, std::memory_order_release);
 
-            prevOffset = currentOffset;
-            currentOffset = block->nextFree;
-        }
+        header_->allocatedCount.fetch_add(1, std::memory_order_relaxed);
+        header_->totalAllocations.fetch_add(1, std::memory_order_relaxed);
 
-        s_lastError = "Pool exhausted (no suitable free block)";
-        return {};
+        return SharedMemoryPool::Block(
+            uint64_t{ref} * GRANULE,
+            requestedSize,
+            reinterpret_cast<uint8_t*>(block) + sizeof(BlockHeader)
+        );
     }
 
-    void deallocate(uint32_t offset) {
-        if (!header_ || offset >= poolSize_) {
+    void deallocate(uint64_t offset) {
+        uint32_t ref = resolve(offset);
+        if (ref == NIL) {
             return;
         }
 
-        auto* block = blockAt(offset);
-        if (!block->is_valid()) {
-            return;
-        }
-
-        // Clear bitmap
-        size_t blockIndex = offset / MIN_BLOCK_SIZE;
-        if (blockIndex < sizeof(header_->bitmap) * 8) {
-            header_->bitmap[blockIndex / 8] &= ~(1 << (blockIndex % 8));
+        auto* block = blockAt(ref);
+        uint32_t expected = BlockHeader::Allocated;
+        if (!block->state.compare_exchange_strong(expected, BlockHeader::Deferred, std::memory_order_acq_rel)) {
+            return;  // Not an allocated block (stale offset or double free)
         }
 
         // =====================================================================
-        // SPSC LIFO Cache - Push to shared cache for fast reuse by Producer
+        // Deferred free - push for the allocating side to merge
         // =====================================================================
-        bool pushedToCache = header_->spscCache.push(offset, block->blockSize);
-        
-        if (!pushedToCache) {
-            // Cache full - add to free list as fallback
-            block->size = 0;
-            block->nextFree = header_->freeHead.load(std::memory_order_acquire);
-            header_->freeHead.store(offset, std::memory_order_release);
-        }
+        // The bins and boundary tags are only ever modified by allocate(), so
+        // whichever process frees the block, it just goes on a lock-free stack.
+        header_->deferredBytes.fetch_add(uint64_t{block->blockSize} * GRANULE, std::memory_order_relaxed);
+        uint32_t head = header_->deferredHead.load(std::memory_order_relaxed);
+        do {
+            block->nextFree = head;
+        } while (!header_->deferredHead.compare_exchange_weak(head, ref, std::memory_order_release,
+                                                              std::memory_order_relaxed));
 
         header_->allocatedCount.fetch_sub(1, std::memory_order_relaxed);
         header_->totalDeallocations.fetch_add(1, std::memory_order_relaxed);
     }
 
-    std::span<uint8_t> get(uint32_t offset, uint32_t size) {
-        if (!header_ || offset >= poolSize_) {
+    std::span<uint8_t> get(uint64_t offset, size_t size) {
+        uint32_t ref = resolve(offset);
+        if (ref == NIL) {
             return {};
         }
 
-        auto* block = blockAt(offset);
-        if (!block->is_valid()) {
-            return {};
-        }
-
-        // Verify allocated in bitmap
-        size_t blockIndex = offset / MIN_BLOCK_SIZE;
-        if (blockIndex < sizeof(header_->bitmap) * 8) {
-            if (!(header_->bitmap[blockIndex / 8] & (1 << (blockIndex % 8)))) {
-                return {};  // Not allocated
-            }
+        auto* block = blockAt(ref);
+        if (block->state.load(std::memory_order_acquire) != BlockHeader::Allocated) {
+            return {};  // Not allocated
         }
 
         uint8_t* data = reinterpret_cast<uint8_t*>(block) + sizeof(BlockHeader);
-        size_t available = block->blockSize - sizeof(BlockHeader);
+        size_t available = size_t{block->blockSize} * GRANULE - sizeof(BlockHeader);
         size_t actual = (size <= available) ? size : available;
 
         return {data, actual};
     }
 
-    std::span<const uint8_t> get(uint32_t offset, uint32_t size) const {
+    std::span<const uint8_t> get(uint64_t offset, size_t size) const {
         return const_cast<Impl*>(this)->get(offset, size);
     }
 
     const std::string& name() const { return name_; }
     bool isCreator() const { return isCreator_; }
-    size_t poolSize() const { return poolSize_; }
+
+    size_t poolSize() const {
+        if (!header_) return 0;
+        return header_->poolSize.load(std::memory_order_relaxed);
+    }
+
+    size_t segmentCount() const {
+        if (!header_) return 0;
+        return header_->segmentCount.load(std::memory_order_relaxed);
+    }
 
     size_t freeSpace() const {
         if (!header_) return 0;
-        
-        size_t total = 0;
-        uint32_t offset = header_->freeHead.load(std::memory_order_acquire);
-        while (offset != UINT32_MAX && offset < poolSize_) {
-            auto* block = blockAt(offset);
-            if (!block->is_valid()) break;
-            total += block->blockSize;
-            offset = block->nextFree;
-        }
-        return total;
+        return header_->freeBytes.load(std::memory_order_relaxed) +
+               header_->deferredBytes.load(std::memory_order_relaxed);
+    }
+
+    SharedMemoryPool::FragmentationStats fragmentationStats() const {
+        SharedMemoryPool::FragmentationStats stats;
+        if (!header_) return stats;
+
+        stats.free_bytes = header_->freeBytes.load(std::memory_order_relaxed);
+        stats.free_blocks = header_->freeBlocks.load(std::memory_order_relaxed);
+        stats.deferred_bytes = header_->deferredBytes.load(std::memory_order_relaxed);
+
+        // The largest free block is in the highest non-empty bin; bins span a
+        // size range, so check every block in that one list
+        if (header_->flBitmap != 0) {
+            uint32_t fl = static_cast<uint32_t>(std::bit_width(header_->flBitmap)) - 1;
+            uint32_t sl = static_cast<uint32_t>(std::bit_width(header_->slBitmap[fl])) - 1;
+            uint32_t ref = header_->freeLists[fl][sl];
+            for (size_t n = 0; ref != NIL && n < stats.free_blocks && isMapped(ref); ++n) {
+                const auto* block = blockAt(ref);
+                if (!block->is_valid()) break;
+                stats.largest_free_block = std::max<size_t>(stats.largest_free_block,
+                                                            size_t{block->blockSize} * GRANULE - sizeof(BlockHeader));
+                ref = block->nextFree;
+            }
+        }
+
+        if (stats.free_bytes > sizeof(BlockHeader)) {
+            stats.fragmentation =
+                1.0 - static_cast<double>(stats.largest_free_block) / (stats.free_bytes - sizeof(BlockHeader));
+        }
+        return stats;
     }
 
     size_t allocatedCount() const {
         if (!header_) return 0;
         return header_->allocatedCount.load(std::memory_order_relaxed);
     }
-    
+
     size_t cacheHits() const { return cacheHits_; }
     size_t cacheMisses() const { return cacheMisses_; }
 
 private:
-    uint8_t* dataRegion() {
-        return reinterpret_cast<uint8_t*>(header_) + sizeof(PoolHeader);
+    //-------------------------------------------------------------------------
+    // Segments
+    //-------------------------------------------------------------------------
+
+    /// Segment 0 uses the pool name; chained segments append their index
+    std::string segmentName(uint32_t seg) const {
+        return seg == 0 ? name_ : name_ + "_seg" + std::to_string(seg);
     }
 
-    BlockHeader* blockAt(uint32_t offset) {
-        return reinterpret_cast<BlockHeader*>(dataRegion() + offset);
+    /// Create (size > 0) or open one segment's shared memory and map it
+    void mapSegment(uint32_t seg, uint64_t size, bool create) {
+        std::string name = segmentName(seg);
+        auto& segment = segments_[seg];
+#ifdef _WIN32
+        // Windows: use native shared memory
+        if (create) {
+            segment.shm = std::make_unique<bip::windows_shared_memory>(
+                bip::create_only, name.c_str(), bip::read_write, size);
+        } else {
+            segment.shm = std::make_unique<bip::windows_shared_memory>(
+                bip::open_only, name.c_str(), bip::read_write);
+        }
+        segment.region = bip::mapped_region(*segment.shm, bip::read_write);
+#else
+        // POSIX: shared_memory_object + truncate
+        if (create) {
+            segment.shm = bip::shared_memory_object(bip::create_only, name.c_str(), bip::read_write);
+            segment.shm.truncate(static_cast<bip::offset_t>(size));
+        } else {
+            segment.shm = bip::shared_memory_object(bip::open_only, name.c_str(), bip::read_write);
+        }
+        segment.region = bip::mapped_region(segment.shm, bip::read_write);
+#endif
+    }
+
+    /// Map a chained segment another process created (opened lazily on first use)
+    bool ensureMapped(uint32_t seg) {
+        if (segmentData_[seg]) [[likely]] {
+            return true;
+        }
+        if (seg >= header_->segmentCount.load(std::memory_order_acquire)) {
+            return false;
+        }
+        try {
+            mapSegment(seg, 0, false);
+            auto* segHeader = static_cast<SegmentHeader*>(segments_[seg].region.get_address());
+            if (!segHeader->is_valid() || segHeader->index != seg) {
+                return false;
+            }
+            segmentData_[seg] = reinterpret_cast<uint8_t*>(segHeader + 1);
+            return true;
+        } catch (const std::exception& e) {
+            s_lastError = std::string("Failed to open pool segment: ") + e.what();
+            return false;
+        }
+    }
+
+    bool isMapped(uint32_t ref) const { return segmentData_[segment_of(ref)] != nullptr; }
+
+    /// Chain a new segment large enough for granules, if the growth limit allows
+    bool grow(uint32_t granules) {
+        uint32_t seg = header_->segmentCount.load(std::memory_order_relaxed);
+        uint64_t current = header_->poolSize.load(std::memory_order_relaxed);
+        uint64_t needed = uint64_t{granules} * GRANULE;
+        // Same size as the first segment, or as large as the request needs
+        uint64_t size = std::max(header_->segmentSizes[0], needed);
+        size = std::min({size, header_->maxPoolSize - current, uint64_t{MAX_SEGMENT_SIZE}}) / GRANULE * GRANULE;
+
+        if (seg >= MAX_POOL_SEGMENTS || size < needed) {
+            s_lastError = "Pool exhausted (no free block large enough)";
+            return false;
+        }
+
+        try {
+            mapSegment(seg, sizeof(SegmentHeader) + size, true);
+        } catch (const std::exception& e) {
+            s_lastError = std::string("Pool exhausted (failed to add segment: ") + e.what() + ")";
+            return false;
+        }
+
+        auto* segHeader = new (segments_[seg].region.get_address()) SegmentHeader{};
+        segHeader->magic = SegmentHeader::MAGIC;
+        segHeader->index = seg;
+        segHeader->size = size;
+        segmentData_[seg] = reinterpret_cast<uint8_t*>(segHeader + 1);
+
+        header_->segmentSizes[seg] = size;
+        initSegmentBlock(seg);
+        header_->poolSize.fetch_add(size, std::memory_order_relaxed);
+        // Release: the segment is initialized before other processes can see it
+        header_->segmentCount.store(seg + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Turn a fresh segment into one free block
+    void initSegmentBlock(uint32_t seg) {
+        uint32_t ref = seg << SEGMENT_SHIFT;
+        auto* block = new (blockAt(ref)) BlockHeader{};
+        block->magic = BlockHeader::MAGIC;
+        block->blockSize = static_cast<uint32_t>(header_->segmentSizes[seg] / GRANULE);
+        block->prevPhys = NIL;
+        insertFree(ref);
     }
 
-    const BlockHeader* blockAt(uint32_t offset) const {
+    uint32_t segmentGranules(uint32_t seg) const {
+        return static_cast<uint32_t>(header_->segmentSizes[seg] / GRANULE);
+    }
+
+    /// Validate a public offset and map its segment; NIL if it cannot be a block
+    uint32_t resolve(uint64_t offset) {
+        if (!header_ || offset % GRANULE != 0 || offset / GRANULE >= NIL) {
+            return NIL;
+        }
+        uint32_t ref = static_cast<uint32_t>(offset / GRANULE);
+        uint32_t seg = segment_of(ref);
+        if (!ensureMapped(seg) || local_of(ref) >= segmentGranules(seg) || !blockAt(ref)->is_valid()) {
+            return NIL;
+        }
+        return ref;
+    }
+
+    BlockHeader* blockAt(uint32_t ref) {
+        return reinterpret_cast<BlockHeader*>(segmentData_[segment_of(ref)] + uint64_t{local_of(ref)} * GRANULE);
+    }
+
+    const BlockHeader* blockAt(uint32_t ref) const {
         return reinterpret_cast<const BlockHeader*>(
-            reinterpret_cast<const uint8_t*>(header_) + sizeof(PoolHeader) + offset
+            segmentData_[segment_of(ref)] + uint64_t{local_of(ref)} * GRANULE
         );
     }
 
-    std::string name_;
-    bool isCreator_ = false;
-    size_t poolSize_ = 0;
+    //-------------------------------------------------------------------------
+    // TLSF index (allocating side only)
+    //-------------------------------------------------------------------------
+
+    /// A free block of at least granules, or NIL
+    uint32_t findFree(uint32_t granules) {
+        // Round up to the next bin boundary so any block in the bin fits
+        uint32_t rounded = granules;
+        if (granules >= SL_COUNT) {
+            rounded += (1u << (std::bit_width(granules) - 1 - SL_LOG2)) - 1;
+        }
+        auto [fl, sl] = bin_for(rounded);
+        uint32_t slMap = header_->slBitmap[fl] & (~0u << sl);
+        if (slMap == 0) {
+            uint32_t flMap = fl + 1 < FL_COUNT ? header_->flBitmap & (~0u << (fl + 1)) : 0;
+            if (flMap != 0) {
+                fl = static_cast<uint32_t>(std::countr_zero(flMap));
+                slMap = header_->slBitmap[fl];
+            }
+        }
+        if (slMap != 0) [[likely]] {
+            return header_->freeLists[fl][static_cast<uint32_t>(std::countr_zero(slMap))];
+        }
+
+        // Nothing in the larger bins: a block in the request's own bin may
+        // still be big enough. Only reached when the pool is nearly full.
+        auto [ownFl, ownSl] = bin_for(granules);
+        for (uint32_t ref = header_->freeLists[ownFl][ownSl]; ref != NIL; ref = blockAt(ref)->nextFree) {
+            if (blockAt(ref)->blockSize >= granules) {
+                return ref;
+            }
+        }
+        return NIL;
+    }
+
+    void insertFree(uint32_t ref) {
+        auto* block = blockAt(ref);
+        auto [fl, sl] = bin_for(block->blockSize);
+        uint32_t head = header_->freeLists[fl][sl];
+
+        block->state.store(BlockHeader::Free, std::memory_order_relaxed);
+        block->size = 0;
+        block->prevFree = NIL;
+        block->nextFree = head;
+        if (head != NIL) {
+            blockAt(head)->prevFree = ref;
+        }
+        header_->freeLists[fl][sl] = ref;
+        header_->slBitmap[fl] |= 1u << sl;
+        header_->flBitmap |= 1u << fl;
+
+        header_->freeBytes.fetch_add(uint64_t{block->blockSize} * GRANULE, std::memory_order_relaxed);
+        header_->freeBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void removeFree(uint32_t ref) {
+        auto* block = blockAt(ref);
+        auto [fl, sl] = bin_for(block->blockSize);
+
+        if (block->prevFree != NIL) {
+            blockAt(block->prevFree)->nextFree = block->nextFree;
+        } else {
+            header_->freeLists[fl][sl] = block->nextFree;
+            if (block->nextFree == NIL) {
+                header_->slBitmap[fl] &= ~(1u << sl);
+                if (header_->slBitmap[fl] == 0) {
+                    header_->flBitmap &= ~(1u << fl);
+                }
+            }
+        }
+        if (block->nextFree != NIL) {
+            blockAt(block->nextFree)->prevFree = block->prevFree;
+        }
+
+        header_->freeBytes.fetch_sub(uint64_t{block->blockSize} * GRANULE, std::memory_order_relaxed);
+        header_->freeBlocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// Physical successor of a block in its segment, or NIL at the segment end
+    uint32_t nextPhys(uint32_t ref) const {
+        uint32_t next = local_of(ref) + blockAt(ref)->blockSize;
+        return next < segmentGranules(segment_of(ref)) ? ref + blockAt(ref)->blockSize : NIL;
+    }
+
+    /// Point the physical successor's boundary tag back at this block
+    void linkNext(uint32_t ref) {
+        uint32_t next = nextPhys(ref);
+        if (next != NIL) {
+            blockAt(next)->prevPhys = ref;
+        }
+    }
+
+    /// Return a deferred block to the bins, merging it with free neighbours
+    void release(uint32_t ref) {
+        auto* block = blockAt(ref);
+        header_->deferredBytes.fetch_sub(uint64_t{block->blockSize} * GRANULE, std::memory_order_relaxed);
+
+        uint32_t prev = block->prevPhys;
+        if (prev != NIL && blockAt(prev)->state.load(std::memory_order_relaxed) == BlockHeader::Free) {
+            removeFree(prev);
+            blockAt(prev)->blockSize += block->blockSize;
+            block->magic = 0;  // Stale offsets into the merged block must fail validation
+            ref = prev;
+            block = blockAt(prev);
+        }
+
+        uint32_t next = nextPhys(ref);
+        if (next != NIL && blockAt(next)->state.load(std::memory_order_relaxed) == BlockHeader::Free) {
+            removeFree(next);
+            block->blockSize += blockAt(next)->blockSize;
+            blockAt(next)->magic = 0;
+        }
+
+        linkNext(ref);
+        insertFree(ref);
+    }
+
+    void drainDeferred() {
+        if (header_->deferredHead.load(std::memory_order_relaxed) == NIL) [[likely]] {
+            return;
+        }
+        // Acquire: pairs with the release push, making nextFree visible
+        uint32_t ref = header_->deferredHead.exchange(NIL, std::memory_order_acquire);
+        while (ref != NIL) {
+            uint32_t next = blockAt(ref)->nextFree;
+            release(ref);
+            ref = next;
+        }
+    }
 
+    struct Segment {
 #ifdef _WIN32
-    std::unique_ptr<bip::windows_shared_memory> shm_;
+        std::unique_ptr<bip::windows_shared_memory> shm;
 #else
-    bip::shared_memory_object shm_;
+        bip::shared_memory_object shm;
 #endif
-    bip::mapped_region region_;
+        bip::mapped_region region;
+    };
+
+    std::string name_;
+    bool isCreator_ = false;
+
+    std::array<Segment, MAX_POOL_SEGMENTS> segments_;
+    std::array<uint8_t*, MAX_POOL_SEGMENTS> segmentData_{};  // Data start of each mapped segment
     PoolHeader* header_ = nullptr;
-    
+
     // Local statistics (per-process)
     size_t cacheHits_ = 0;
     size_t cacheMisses_ = 0;
@@ -573,9 +749,10 @@ SharedMemoryPool::SharedMemoryPool(SharedMemoryPool&&) noexcept = default;
 
 SharedMemoryPool& SharedMemoryPool::operator=(SharedMemoryPool&&) noexcept = default;
 
-std::unique_ptr<SharedMemoryPool> SharedMemoryPool::create(std::string_view name, size_t poolSize) {
+std::unique_ptr<SharedMemoryPool> SharedMemoryPool::create(std::string_view name, size_t poolSize,
+                                                           size_t maxPoolSize) {
     auto pool = std::unique_ptr<SharedMemoryPool>(new SharedMemoryPool());
-    if (!pool->impl_->create(name, poolSize)) {
+    if (!pool->impl_->create(name, poolSize, maxPoolSize)) {
         return nullptr;
     }
     return pool;
@@ -597,15 +774,15 @@ SharedMemoryPool::Block SharedMemoryPool::allocate(size_t size) {
     return impl_->allocate(size);
 }
 
-void SharedMemoryPool::deallocate(uint32_t offset) {
+void SharedMemoryPool::deallocate(uint64_t offset) {
     impl_->deallocate(offset);
 }
 
-std::span<uint8_t> SharedMemoryPool::get(uint32_t offset, uint32_t size) {
+std::span<uint8_t> SharedMemoryPool::get(uint64_t offset, size_t size) {
     return impl_->get(offset, size);
 }
 
-std::span<const uint8_t> SharedMemoryPool::get(uint32_t offset, uint32_t size) const {
+std::span<const uint8_t> SharedMemoryPool::get(uint64_t offset, size_t size) const {
     return impl_->get(offset, size);
 }
 
@@ -621,10 +798,18 @@ size_t SharedMemoryPool::pool_size() const {
     return impl_->poolSize();
 }
 
+size_t SharedMemoryPool::segment_count() const {
+    return impl_->segmentCount();
+}
+
 size_t SharedMemoryPool::free_space() const {
     return impl_->freeSpace();
 }
 
+SharedMemoryPool::FragmentationStats SharedMemoryPool::fragmentation_stats() const {
+    return impl_->fragmentationStats();
+}
+
 size_t SharedMemoryPool::allocated_count() const {
     return impl_->allocatedCount();
 }
@@ -638,4 +823,4 @@ size_t SharedMemoryPool::cache_misses() const {
 }
 
 } // namespace ipc
-} // namespace lager_ext
\ No newline at end of file
+} // namespace lager_ext
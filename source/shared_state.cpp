@@ -5,6 +5,7 @@
 
 #include <lager_ext/path_utils.h>
 #include <lager_ext/shared_state.h>
+#include <lager_ext/value_diff.h>
 
 #include <boost/interprocess/creation_tags.hpp>
 #include <boost/interprocess/mapped_region.hpp>
@@ -15,11 +16,14 @@
 #include <boost/interprocess/shared_memory_object.hpp>
 #endif
 #include <boost/interprocess/sync/named_semaphore.hpp>
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <iostream>
 #include <mutex>
+#include <new>
+#include <optional>
 #include <thread>
 
 namespace bip = boost::interprocess;
@@ -27,31 +31,121 @@ namespace bip = boost::interprocess;
 namespace lager_ext {
 
 // ============================================================
-// Shared Memory Header Layout
+// Shared Memory Layout (versioned ring)
 // ============================================================
-// Offset  Size    Field
-// 0       8       magic (0x494D4D4552535453 = "IMMERSST")
-// 8       8       version (monotonically increasing)
-// 16      8       timestamp (unix ms)
-// 24      1       update_type (0=full, 1=diff)
-// 25      3       reserved
-// 28      4       data_size
-// 32      N       data (serialized ImmerValue or diff)
+// Offset                  Size                         Field
+// 0                       64                           RingHeader
+// 64                      N * (32 + slot_capacity)     update slots [0, N)
+// 64 + N * stride         32                           snapshot header
+// + 32                    snapshot_capacity            snapshot data
+//
+// Update v (v >= 1) is written into slot (v - 1) % N. Each slot, and the
+// snapshot area, is guarded by a seqlock whose sequence encodes the version
+// it currently holds:
+//   seq == 2 * v      slot holds a complete copy of update v
+//   seq == 2 * v - 1  publisher is writing update v into the slot
+// A reader that sees any other sequence, or a sequence that changed while it
+// was copying, knows the slot was recycled underneath it.
+//
+// Full updates are written to the snapshot area and leave only a marker in
+// their ring slot. The publisher also refreshes the snapshot every
+// snapshot_interval diffs, so a subscriber that falls more than N versions
+// behind can resync from the snapshot and replay the diffs after it.
 // ============================================================
 
 static constexpr uint64_t SHARED_MEMORY_MAGIC = 0x494D4D4552535453ULL; // "IMMERSST"
-static constexpr std::size_t HEADER_SIZE = 32;
+static constexpr uint32_t RING_LAYOUT_VERSION = 2;
+static constexpr std::size_t RING_HEADER_SIZE = 64;
+static constexpr std::size_t SLOT_HEADER_SIZE = 32;
+static constexpr std::size_t MAX_RING_SLOTS = 4096;
+
+/// Full states and snapshots intern their map keys: a document of many
+/// similarly-shaped maps stores each key once. Subscribers auto-detect it.
+static constexpr BinaryFormat FULL_STATE_FORMAT = BinaryFormat::Dictionary;
 
-struct SharedMemoryHeader {
+struct alignas(64) RingHeader {
     uint64_t magic;
-    uint64_t version;
+    uint32_t layout_version;
+    uint32_t slot_count;
+    uint64_t slot_capacity;
+    uint64_t snapshot_capacity;
+    std::atomic<uint64_t> version; // Publish gate: latest complete update
+    uint8_t reserved[24];
+};
+
+struct SlotHeader {
+    std::atomic<uint64_t> seq; // Seqlock sequence (2 * version when stable)
     uint64_t timestamp;
     uint8_t update_type;
     uint8_t reserved[3];
     uint32_t data_size;
+    uint64_t reserved2;
 };
 
-static_assert(sizeof(SharedMemoryHeader) == HEADER_SIZE, "Header size mismatch");
+static_assert(sizeof(RingHeader) == RING_HEADER_SIZE, "Ring header size mismatch");
+static_assert(sizeof(SlotHeader) == SLOT_HEADER_SIZE, "Slot header size mismatch");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Seqlock requires lock-free 64-bit atomics");
+
+// Resolved geometry of the ring inside a mapped region
+struct RingLayout {
+    uint32_t slot_count = 0;
+    std::size_t slot_capacity = 0;
+    std::size_t snapshot_capacity = 0;
+
+    [[nodiscard]] std::size_t slot_stride() const noexcept { return SLOT_HEADER_SIZE + slot_capacity; }
+    [[nodiscard]] std::size_t snapshot_offset() const noexcept {
+        return RING_HEADER_SIZE + static_cast<std::size_t>(slot_count) * slot_stride();
+    }
+    [[nodiscard]] std::size_t total_size() const noexcept {
+        return snapshot_offset() + SLOT_HEADER_SIZE + snapshot_capacity;
+    }
+
+    [[nodiscard]] std::size_t slot_offset(uint64_t version) const noexcept {
+        return RING_HEADER_SIZE + static_cast<std::size_t>((version - 1) % slot_count) * slot_stride();
+    }
+
+    // Derive the layout the publisher will create from its configuration.
+    // Unless slot_size is given, half of the region backs the ring and the
+    // other half the snapshot area.
+    static std::optional<RingLayout> from_config(const SharedMemoryConfig& cfg) {
+        if (cfg.ring_slots == 0 || cfg.ring_slots > MAX_RING_SLOTS)
+            return std::nullopt;
+
+        const std::size_t fixed = RING_HEADER_SIZE + SLOT_HEADER_SIZE * (cfg.ring_slots + 1);
+        if (cfg.size <= fixed)
+            return std::nullopt;
+
+        RingLayout layout;
+        layout.slot_count = static_cast<uint32_t>(cfg.ring_slots);
+        if (cfg.slot_size != 0) {
+            layout.slot_capacity = (cfg.slot_size + 7) & ~std::size_t{7};
+        } else {
+            layout.slot_capacity = ((cfg.size - fixed) / (2 * cfg.ring_slots)) & ~std::size_t{7};
+        }
+
+        const std::size_t used = layout.snapshot_offset() + SLOT_HEADER_SIZE;
+        if (layout.slot_capacity == 0 || used >= cfg.size)
+            return std::nullopt;
+        layout.snapshot_capacity = cfg.size - used;
+        return layout;
+    }
+
+    // Read the layout the publisher recorded in the ring header
+    static std::optional<RingLayout> from_header(const RingHeader& header, std::size_t region_size) {
+        if (header.magic != SHARED_MEMORY_MAGIC || header.layout_version != RING_LAYOUT_VERSION)
+            return std::nullopt;
+        if (header.slot_count == 0 || header.slot_count > MAX_RING_SLOTS)
+            return std::nullopt;
+
+        RingLayout layout;
+        layout.slot_count = header.slot_count;
+        layout.slot_capacity = static_cast<std::size_t>(header.slot_capacity);
+        layout.snapshot_capacity = static_cast<std::size_t>(header.snapshot_capacity);
+        if (layout.total_size() > region_size)
+            return std::nullopt;
+        return layout;
+    }
+};
 
 // ============================================================
 // Boost.Interprocess shared memory implementation
@@ -84,13 +178,8 @@ public:
                 region_ = std::make_unique<bip::mapped_region>(*shm_, bip::read_write);
 #endif
 
-                // Initialize header
-                auto* header = reinterpret_cast<SharedMemoryHeader*>(region_->get_address());
-                header->magic = SHARED_MEMORY_MAGIC;
-                header->version = 0;
-                header->timestamp = 0;
-                header->update_type = 0;
-                header->data_size = 0;
+                // Zero the region; StatePublisher lays out the ring header and slots
+                std::memset(region_->get_address(), 0, region_->get_size());
             } else {
 #ifdef _WIN32
                 // Windows: open existing native shared memory (read-only for subscriber)
@@ -182,13 +271,6 @@ private:
     std::string name_;
 };
 
-// ============================================================
-// Cross-platform memory barrier
-// ============================================================
-static inline void memory_barrier() {
-    std::atomic_thread_fence(std::memory_order_seq_cst);
-}
-
 // ============================================================
 // Helper: Get current timestamp in milliseconds
 // ============================================================
@@ -217,8 +299,15 @@ struct StatePublisher::Impl {
     std::unique_ptr<bip::named_semaphore> notify_sem;
     std::string sem_name;
 
+    RingLayout layout;
+    bool ring_ready = false;
+    std::size_t snapshot_interval = 1;
+    std::size_t diffs_since_snapshot = 0;
+
     Impl(const SharedMemoryConfig& cfg)
         : shm(cfg.name, cfg.size, true), config(cfg), sem_name(semaphore_name_for(cfg.name)) {
+        init_ring();
+
         // Remove and create semaphore for notification
         try {
             bip::named_semaphore::remove(sem_name.c_str());
@@ -238,35 +327,120 @@ struct StatePublisher::Impl {
         }
     }
 
-    void write_update(StateUpdate::Type type, const ByteBuffer& data) {
+    [[nodiscard]] bool is_valid() const noexcept { return ring_ready && shm.is_valid(); }
+
+    uint8_t* base() noexcept { return reinterpret_cast<uint8_t*>(shm.data()); }
+    RingHeader* header() noexcept { return reinterpret_cast<RingHeader*>(shm.data()); }
+    SlotHeader* snapshot_header() noexcept { return reinterpret_cast<SlotHeader*>(base() + layout.snapshot_offset()); }
+
+    void init_ring() {
         if (!shm.is_valid())
             return;
 
-        auto* header = reinterpret_cast<SharedMemoryHeader*>(shm.data());
-
-        // Check size
-        if (HEADER_SIZE + data.size() > shm.size()) {
-            std::cerr << "[StatePublisher] Data too large for shared memory: " << data.size() << " > "
-                      << (shm.size() - HEADER_SIZE) << "\n";
+        auto computed = RingLayout::from_config(config);
+        if (!computed || computed->total_size() > shm.size()) {
+            std::cerr << "[StatePublisher] Shared memory too small for " << config.ring_slots
+                      << " ring slots: " << config.size << " bytes\n";
             return;
         }
+        layout = *computed;
+
+        // Refreshing the snapshot at least once per ring revolution guarantees that
+        // a lapped subscriber finds every diff after the snapshot still in the ring
+        snapshot_interval = config.snapshot_interval != 0 ? config.snapshot_interval : layout.slot_count / 2;
+        snapshot_interval = std::clamp<std::size_t>(snapshot_interval, 1, layout.slot_count);
+
+        // Region is zeroed on creation: every slot starts at seq 0 (version 0),
+        // and an empty snapshot at version 0 represents the null state
+        auto* h = new (shm.data()) RingHeader{};
+        h->slot_count = layout.slot_count;
+        h->slot_capacity = layout.slot_capacity;
+        h->snapshot_capacity = layout.snapshot_capacity;
+        h->layout_version = RING_LAYOUT_VERSION;
+        for (uint32_t i = 0; i < layout.slot_count; ++i) {
+            new (base() + RING_HEADER_SIZE + i * layout.slot_stride()) SlotHeader{};
+        }
+        new (snapshot_header()) SlotHeader{};
+
+        // Magic last: subscribers treat the ring as valid only once it is visible
+        std::atomic_thread_fence(std::memory_order_release);
+        h->magic = SHARED_MEMORY_MAGIC;
+        ring_ready = true;
+    }
+
+    // Seqlock write: odd sequence while the payload is in flux, 2 * version when done
+    static void write_slot(SlotHeader* slot, uint8_t* dst, uint64_t version, StateUpdate::Type type,
+                           const uint8_t* data, std::size_t size) {
+        slot->seq.store(2 * version - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (size > 0) {
+            std::memcpy(dst, data, size);
+        }
+        slot->data_size = static_cast<uint32_t>(size);
+        slot->update_type = static_cast<uint8_t>(type);
+        slot->timestamp = current_timestamp_ms();
+
+        slot->seq.store(2 * version, std::memory_order_release);
+    }
 
-        // Write data first (before updating header)
-        uint8_t* data_ptr = reinterpret_cast<uint8_t*>(shm.data()) + HEADER_SIZE;
-        std::memcpy(data_ptr, data.data(), data.size());
+    void write_snapshot(uint64_t version, const ByteBuffer& data) {
+        auto* snap = snapshot_header();
+        write_slot(snap, reinterpret_cast<uint8_t*>(snap) + SLOT_HEADER_SIZE, version, StateUpdate::Type::Full,
+                   data.data(), data.size());
+        diffs_since_snapshot = 0;
+        stats.snapshot_writes++;
+    }
+
+    // Publish one update into the ring.
+    // Full updates go to the snapshot area (plus a marker slot); diffs go into
+    // their ring slot and refresh the snapshot from full_state when it is due.
+    // Returns false without publishing if the payload does not fit.
+    bool write_update(StateUpdate::Type type, const ByteBuffer& data, const ByteBuffer* full_state = nullptr) {
+        if (!is_valid())
+            return false;
 
-        // Update header metadata fields (before version update)
-        header->data_size = static_cast<uint32_t>(data.size());
-        header->update_type = static_cast<uint8_t>(type);
-        header->timestamp = current_timestamp_ms();
+        const bool snapshot_due =
+            type == StateUpdate::Type::Diff && full_state && diffs_since_snapshot + 1 >= snapshot_interval;
+
+        if (type == StateUpdate::Type::Full) {
+            if (data.size() > layout.snapshot_capacity) {
+                std::cerr << "[StatePublisher] Data too large for shared memory: " << data.size() << " > "
+                          << layout.snapshot_capacity << "\n";
+                stats.rejected_publishes++;
+                return false;
+            }
+        } else if (data.size() > layout.slot_capacity) {
+            return false; // Caller falls back to a full update
+        } else if (snapshot_due && full_state->size() > layout.snapshot_capacity) {
+            // Publishing the diff without its snapshot refresh would leave any
+            // lapped subscriber with nothing to resync from
+            std::cerr << "[StatePublisher] State too large for snapshot refresh: " << full_state->size() << " > "
+                      << layout.snapshot_capacity << "\n";
+            stats.rejected_publishes++;
+            return false;
+        }
 
-        // Memory barrier to ensure all data and metadata are visible
-        // before updating version (which acts as the "publish gate")
-        memory_barrier();
+        auto* h = header();
+        const uint64_t version = h->version.load(std::memory_order_relaxed) + 1;
+        auto* slot = reinterpret_cast<SlotHeader*>(base() + layout.slot_offset(version));
+        auto* slot_data = reinterpret_cast<uint8_t*>(slot) + SLOT_HEADER_SIZE;
+
+        if (type == StateUpdate::Type::Full) {
+            write_snapshot(version, data);
+            write_slot(slot, slot_data, version, type, nullptr, 0);
+        } else {
+            write_slot(slot, slot_data, version, type, data.data(), data.size());
+            if (snapshot_due) {
+                write_snapshot(version, *full_state);
+            } else {
+                diffs_since_snapshot++;
+            }
+        }
 
         // Version update is the "publish gate" - readers check this first,
-        // so it must be updated AFTER all other writes are visible
-        header->version++;
+        // so it must be updated AFTER the slot is complete
+        h->version.store(version, std::memory_order_release);
 
         // Signal subscribers that an update is available
         if (notify_sem) {
@@ -282,6 +456,7 @@ struct StatePublisher::Impl {
         }
         stats.total_bytes_written += data.size();
         stats.last_update_size = data.size();
+        return true;
     }
 };
 
@@ -305,49 +480,46 @@ void StatePublisher::publish(const ImmerValue& state) {
 }
 
 bool StatePublisher::publish_diff(const ImmerValue& old_state, const ImmerValue& new_state) {
-    if (!impl_->shm.is_valid())
+    if (!impl_->is_valid())
         return false;
 
-    // Collect diff
-    DiffResult diff = collect_diff(old_state, new_state);
+    // Encode diff straight from the traversal
+    ByteBuffer diff_data = encode_diff(old_state, new_state);
 
     // If no changes, don't publish
-    if (diff.added.empty() && diff.removed.empty() && diff.modified.empty()) {
+    if (diff_data.empty()) {
         return true; // No update needed
     }
 
-    // Encode diff
-    ByteBuffer diff_data = encode_diff(diff);
-
-    // Serialize full state for comparison
-    ByteBuffer full_data = serialize(new_state);
+    // Serialize full state for comparison (and for periodic snapshot refresh)
+    ByteBuffer full_data = serialize(new_state, FULL_STATE_FORMAT);
 
-    // Use diff if it's smaller than full state
-    if (diff_data.size() < full_data.size()) {
-        impl_->write_update(StateUpdate::Type::Diff, diff_data);
+    // Use diff if it's smaller than full state and fits in a ring slot
+    if (diff_data.size() < full_data.size() &&
+        impl_->write_update(StateUpdate::Type::Diff, diff_data, &full_data)) {
         impl_->last_state = new_state;
         return true;
-    } else {
-        impl_->write_update(StateUpdate::Type::Full, full_data);
+    }
+    if (impl_->write_update(StateUpdate::Type::Full, full_data)) {
         impl_->last_state = new_state;
-        return false;
     }
+    return false;
 }
 
 void StatePublisher::publish_full(const ImmerValue& state) {
-    if (!impl_->shm.is_valid())
+    if (!impl_->is_valid())
         return;
 
-    ByteBuffer data = serialize(state);
-    impl_->write_update(StateUpdate::Type::Full, data);
-    impl_->last_state = state;
+    ByteBuffer data = serialize(state, FULL_STATE_FORMAT);
+    if (impl_->write_update(StateUpdate::Type::Full, data)) {
+        impl_->last_state = state;
+    }
 }
 
 uint64_t StatePublisher::version() const noexcept {
-    if (!impl_->shm.is_valid())
+    if (!impl_->is_valid())
         return 0;
-    auto* header = reinterpret_cast<const SharedMemoryHeader*>(impl_->shm.data());
-    return header->version;
+    return impl_->header()->version.load(std::memory_order_acquire);
 }
 
 StatePublisher::Stats StatePublisher::stats() const noexcept {
@@ -355,7 +527,7 @@ StatePublisher::Stats StatePublisher::stats() const noexcept {
 }
 
 bool StatePublisher::is_valid() const noexcept {
-    return impl_->shm.is_valid();
+    return impl_->is_valid();
 }
 
 // ============================================================
@@ -380,6 +552,14 @@ struct StateSubscriber::Impl {
     std::unique_ptr<bip::named_semaphore> notify_sem;
     std::string sem_name;
 
+    // Ring geometry, read from the publisher's header on first access
+    RingLayout layout;
+    bool ring_ready = false;
+
+    // Bounds for catching up within a single poll
+    static constexpr int MAX_SNAPSHOT_RETRIES = 64;
+    static constexpr int MAX_RESYNCS_PER_POLL = 4;
+
     Impl(const SharedMemoryConfig& cfg)
         : shm(cfg.name, cfg.size, false) // Open existing, don't create
           ,
@@ -415,59 +595,176 @@ struct StateSubscriber::Impl {
         }
     }
 
-    bool check_and_read() {
+    const uint8_t* base() const noexcept { return reinterpret_cast<const uint8_t*>(shm.data()); }
+    const RingHeader* header() const noexcept { return reinterpret_cast<const RingHeader*>(shm.data()); }
+
+    bool attach_ring() {
+        if (ring_ready)
+            return true;
         if (!shm.is_valid())
             return false;
 
-        auto* header = reinterpret_cast<const SharedMemoryHeader*>(shm.data());
+        const auto* h = header();
+        if (h->magic != SHARED_MEMORY_MAGIC)
+            return false; // Publisher has not finished initializing
+        std::atomic_thread_fence(std::memory_order_acquire);
 
-        // Check magic
-        if (header->magic != SHARED_MEMORY_MAGIC) {
+        auto parsed = RingLayout::from_header(*h, shm.size());
+        if (!parsed) {
+            std::cerr << "[StateSubscriber] Incompatible shared memory layout\n";
             return false;
         }
+        layout = *parsed;
+        ring_ready = true;
+        return true;
+    }
 
-        // Check version
-        if (header->version == current_version) {
-            return false; // No update
+    // Seqlock view of a slot: payload is decoded straight from shared memory,
+    // and only trusted if the sequence is unchanged once decoding is done
+    struct SlotView {
+        const SlotHeader* slot = nullptr;
+        uint64_t seq = 0;
+        StateUpdate::Type type = StateUpdate::Type::Full;
+        const uint8_t* data = nullptr;
+        std::size_t size = 0;
+
+        [[nodiscard]] bool still_valid() const noexcept {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot->seq.load(std::memory_order_relaxed) == seq;
         }
+    };
+
+    // Open a seqlock read on slot; fails if the sequence is odd (mid-write),
+    // differs from expected_seq (when given), or metadata is out of range
+    static bool begin_read(const SlotHeader* slot, std::size_t capacity, uint64_t expected_seq, SlotView& view) {
+        view.slot = slot;
+        view.seq = slot->seq.load(std::memory_order_acquire);
+        if ((view.seq & 1) || (expected_seq != 0 && view.seq != expected_seq))
+            return false;
 
-        // Check for missed updates
-        if (header->version > current_version + 1) {
-            stats.missed_updates += (header->version - current_version - 1);
-        }
+        view.type = static_cast<StateUpdate::Type>(slot->update_type);
+        view.size = slot->data_size;
+        view.data = reinterpret_cast<const uint8_t*>(slot) + SLOT_HEADER_SIZE;
+        return view.size <= capacity;
+    }
 
-        // Read data
-        const uint8_t* data_ptr = reinterpret_cast<const uint8_t*>(shm.data()) + HEADER_SIZE;
-        std::size_t data_size = header->data_size;
-        auto update_type = static_cast<StateUpdate::Type>(header->update_type);
-        uint64_t new_version = header->version;
+    // Replace current state with the latest snapshot.
+    // Returns false if the snapshot could not be read consistently or is not
+    // newer than what we already have.
+    bool load_snapshot() {
+        const auto* snap = reinterpret_cast<const SlotHeader*>(base() + layout.snapshot_offset());
+
+        for (int attempt = 0; attempt < MAX_SNAPSHOT_RETRIES; ++attempt) {
+            SlotView view;
+            if (!begin_read(snap, layout.snapshot_capacity, 0, view)) {
+                std::this_thread::yield(); // Publisher is mid-write
+                continue;
+            }
 
-        // Memory barrier before reading data
-        memory_barrier();
+            const uint64_t snapshot_version = view.seq / 2;
+            if (snapshot_version <= current_version)
+                return false;
 
-        // Copy data (to avoid race conditions)
-        ByteBuffer data(data_ptr, data_ptr + data_size);
+            ImmerValue state;
+            std::string error;
+            try {
+                if (view.size > 0) {
+                    state = deserialize(view.data, view.size);
+                }
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
 
-        // Process update
-        try {
-            if (update_type == StateUpdate::Type::Full) {
-                current_state = deserialize(data);
-                stats.full_updates++;
-            } else {
-                DiffResult diff = decode_diff(data);
-                current_state = apply_diff(current_state, diff);
-                stats.diff_updates++;
+            if (!view.still_valid()) {
+                stats.torn_reads++;
+                continue;
+            }
+            if (!error.empty()) {
+                std::cerr << "[StateSubscriber] Failed to process snapshot: " << error << "\n";
+                return false;
             }
 
-            current_version = new_version;
+            if (snapshot_version > current_version + 1) {
+                stats.missed_updates += snapshot_version - current_version - 1;
+            }
+            current_state = std::move(state);
+            current_version = snapshot_version;
+            stats.full_updates++;
             stats.total_updates++;
-            stats.total_bytes_read += data_size;
-
+            stats.total_bytes_read += view.size;
             return true;
-        } catch (const std::exception& e) {
-            std::cerr << "[StateSubscriber] Failed to process update: " << e.what() << "\n";
+        }
+        return false;
+    }
+
+    bool check_and_read() {
+        if (!attach_ring())
             return false;
+
+        const uint64_t latest = header()->version.load(std::memory_order_acquire);
+        if (latest == current_version) {
+            return false; // No update
+        }
+
+        bool updated = false;
+        int resyncs = 0;
+
+        // Replay every version still in the ring; resync from the snapshot when
+        // we have fallen further behind than the ring depth or hit a full update
+        while (current_version < latest) {
+            const uint64_t next = current_version + 1;
+            SlotView view;
+            bool lapped = latest - current_version > layout.slot_count;
+
+            if (!lapped) {
+                const auto* slot = reinterpret_cast<const SlotHeader*>(base() + layout.slot_offset(next));
+                lapped = !begin_read(slot, layout.slot_capacity, 2 * next, view);
+            }
+
+            if (!lapped && view.type == StateUpdate::Type::Diff) {
+                DiffResult diff;
+                std::string error;
+                try {
+                    diff = decode_diff(view.data, view.size);
+                } catch (const std::exception& e) {
+                    error = e.what();
+                }
+
+                if (view.still_valid()) {
+                    if (!error.empty()) {
+                        std::cerr << "[StateSubscriber] Failed to process update: " << error << "\n";
+                        break;
+                    }
+                    try {
+                        current_state = apply_diff(current_state, diff);
+                    } catch (const std::exception& e) {
+                        std::cerr << "[StateSubscriber] Failed to apply update: " << e.what() << "\n";
+                        break;
+                    }
+
+                    current_version = next;
+                    stats.diff_updates++;
+                    stats.total_updates++;
+                    stats.total_bytes_read += view.size;
+                    updated = true;
+                    continue;
+                }
+
+                // Publisher recycled the slot while we were decoding it
+                stats.torn_reads++;
+                lapped = true;
+            }
+
+            if (lapped) {
+                stats.snapshot_fallbacks++;
+            }
+            if (resyncs++ >= MAX_RESYNCS_PER_POLL || !load_snapshot()) {
+                break;
+            }
+            updated = true;
         }
+
+        return updated;
     }
 
     void invoke_callbacks() {
@@ -615,168 +912,38 @@ bool StateSubscriber::is_valid() const noexcept {
 }
 
 // ============================================================
-// Collect Diff - Recursive difference collection
+// Collect Diff - DiffResult sink over diff_values()
 // ============================================================
 
-// Helper: Compare two Values and collect differences
-// OPTIMIZATION: Uses path_stack for zero-allocation path building during recursion.
-// Only creates Path objects when adding to result (unavoidable copy at that point).
-static void collect_diff_recursive(const ImmerValue& old_val, const ImmerValue& new_val, std::vector<PathElement>& path_stack,
-                                   std::size_t path_depth, DiffResult& result) {
-    // Same value (early exit for identical data)
-    // Note: For ImmerValue types, we compare the variant data directly
-    // Structural sharing is detected at the box level in container comparisons below
-    if (old_val.data == new_val.data) [[likely]] {
-        return;
-    }
-
-    // Different types or both primitives - report as modification
-    if (old_val.type_index() != new_val.type_index()) [[unlikely]] {
-        Path current_path;
-        current_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth));
-        result.modified.push_back({std::move(current_path), old_val, new_val});
-        return;
-    }
-
-    // Both are maps - Container Boxing: use BoxedValueMap
-    if (auto* old_boxed_map = old_val.get_if<BoxedValueMap>()) [[likely]] {
-        auto* new_boxed_map = new_val.get_if<BoxedValueMap>();
-        const auto& old_map = old_boxed_map->get();
-        const auto& new_map = new_boxed_map->get();
-
-        // Ensure path_stack has space for one more element
-        if (path_stack.size() <= path_depth) {
-            path_stack.resize(path_depth + 1);
-        }
-
-        // Container Boxing: ValueMap now stores ImmerValue directly
-        // Check for added and modified entries
-        for (const auto& [key, new_child] : new_map) {
-            path_stack[path_depth] = std::string_view{key};
+namespace {
 
-            if (auto* old_child_ptr = old_map.find(key)) {
-                // Key exists in both - check if same value (by address for identity)
-                if (&old_child_ptr->data != &new_child.data) [[unlikely]] {
-                    collect_diff_recursive(*old_child_ptr, new_child, path_stack, path_depth + 1, result);
-                }
-            } else {
-                // Key only in new - added
-                Path child_path;
-                child_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth + 1));
-                result.added.emplace_back(std::move(child_path), new_child);
-            }
-        }
+class DiffResultSink final : public DiffSink {
+public:
+    explicit DiffResultSink(DiffResult& result) : result_(result) {}
 
-        // Check for removed entries
-        for (const auto& [key, old_child] : old_map) {
-            if (!new_map.find(key)) [[unlikely]] {
-                path_stack[path_depth] = std::string_view{key};
-                Path child_path;
-                child_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth + 1));
-                result.removed.emplace_back(std::move(child_path), old_child);
-            }
-        }
-        return;
+    void on_add(PathView path, const ImmerValue& value) override { result_.added.emplace_back(Path{path}, value); }
+    void on_remove(PathView path, const ImmerValue& value) override {
+        result_.removed.emplace_back(Path{path}, value);
     }
-
-    // Both are vectors - Container Boxing: use BoxedValueVector
-    if (auto* old_boxed_vec = old_val.get_if<BoxedValueVector>()) {
-        auto* new_boxed_vec = new_val.get_if<BoxedValueVector>();
-        const auto& old_vec = old_boxed_vec->get();
-        const auto& new_vec = new_boxed_vec->get();
-
-        // Ensure path_stack has space for one more element
-        if (path_stack.size() <= path_depth) {
-            path_stack.resize(path_depth + 1);
-        }
-
-        std::size_t min_size = std::min(old_vec.size(), new_vec.size());
-
-        // Container Boxing: ValueVector now stores ImmerValue directly
-        // Compare common elements
-        for (std::size_t i = 0; i < min_size; ++i) {
-            const ImmerValue& old_child = old_vec[i];
-            const ImmerValue& new_child = new_vec[i];
-
-            // Check if same value (by address for identity)
-            if (&old_child.data != &new_child.data) [[unlikely]] {
-                path_stack[path_depth] = i;
-                collect_diff_recursive(old_child, new_child, path_stack, path_depth + 1, result);
-            }
-        }
-
-        // Elements added to new vector
-        for (std::size_t i = min_size; i < new_vec.size(); ++i) {
-            path_stack[path_depth] = i;
-            Path child_path;
-            child_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth + 1));
-            result.added.emplace_back(std::move(child_path), new_vec[i]);
-        }
-
-        // Elements removed from old vector
-        for (std::size_t i = min_size; i < old_vec.size(); ++i) {
-            path_stack[path_depth] = i;
-            Path child_path;
-            child_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth + 1));
-            result.removed.emplace_back(std::move(child_path), old_vec[i]);
-        }
-        return;
+    void on_change(PathView path, const ImmerValue& old_value, const ImmerValue& new_value) override {
+        result_.modified.push_back({Path{path}, old_value, new_value});
     }
 
-    // Both are arrays - Container Boxing: use BoxedValueArray
-    if (auto* old_boxed_arr = old_val.get_if<BoxedValueArray>()) {
-        auto* new_boxed_arr = new_val.get_if<BoxedValueArray>();
-        const auto& old_arr = old_boxed_arr->get();
-        const auto& new_arr = new_boxed_arr->get();
-
-        // Ensure path_stack has space for one more element
-        if (path_stack.size() <= path_depth) {
-            path_stack.resize(path_depth + 1);
-        }
-
-        std::size_t min_size = std::min(old_arr.size(), new_arr.size());
-
-        // Container Boxing: ValueArray now stores ImmerValue directly
-        for (std::size_t i = 0; i < min_size; ++i) {
-            const ImmerValue& old_child = old_arr[i];
-            const ImmerValue& new_child = new_arr[i];
-
-            // Check if same value (by address for identity)
-            if (&old_child.data != &new_child.data) [[unlikely]] {
-                path_stack[path_depth] = i;
-                collect_diff_recursive(old_child, new_child, path_stack, path_depth + 1, result);
-            }
-        }
-
-        for (std::size_t i = min_size; i < new_arr.size(); ++i) {
-            path_stack[path_depth] = i;
-            Path child_path;
-            child_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth + 1));
-            result.added.emplace_back(std::move(child_path), new_arr[i]);
-        }
+private:
+    DiffResult& result_;
+};
 
-        for (std::size_t i = min_size; i < old_arr.size(); ++i) {
-            path_stack[path_depth] = i;
-            Path child_path;
-            child_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth + 1));
-            result.removed.emplace_back(std::move(child_path), old_arr[i]);
-        }
-        return;
-    }
+/// Whole added/removed subtrees are one entry each
+constexpr DiffOptions COLLECT_DIFF_OPTIONS{.recursive = true, .expand_subtrees = false};
 
-    // Primitive types - compare by value
-    if (old_val.data != new_val.data) [[unlikely]] {
-        Path current_path;
-        current_path.assign(path_stack.begin(), path_stack.begin() + static_cast<std::ptrdiff_t>(path_depth));
-        result.modified.push_back({std::move(current_path), old_val, new_val});
-    }
-}
+} // namespace
 
-DiffResult collect_diff(const ImmerValue& old_val, const ImmerValue& new_val) {
+DiffResult collect_diff(const ImmerValue& old_val, const ImmerValue& new_val, std::size_t num_threads) {
     DiffResult result;
-    std::vector<PathElement> path_stack;
-    path_stack.reserve(16); // Pre-allocate for typical path depths
-    collect_diff_recursive(old_val, new_val, path_stack, 0, result);
+    DiffResultSink sink(result);
+    DiffOptions options = COLLECT_DIFF_OPTIONS;
+    options.num_threads = num_threads;
+    diff_values(old_val, new_val, sink, options);
     return result;
 }
 
@@ -792,7 +959,7 @@ DiffResult collect_diff(const ImmerValue& old_val, const ImmerValue& new_val) {
 // [entries] modified entries: [path_len][path_data][old_value_data][new_value_data]
 // ============================================================
 
-static void write_path(ByteBuffer& buf, const Path& path) {
+static void write_path(ByteBuffer& buf, PathView path) {
     // Write path element count
     uint32_t count = static_cast<uint32_t>(path.size());
     buf.push_back(count & 0xFF);
@@ -827,7 +994,7 @@ static Path read_path(const uint8_t*& ptr, const uint8_t* end) {
     ptr += 4;
 
     Path path;
-    path.reserve(count);
+    path.reserve(std::min<std::size_t>(count, static_cast<std::size_t>(end - ptr)));
 
     for (uint32_t i = 0; i < count; ++i) {
         if (ptr >= end)
@@ -839,7 +1006,7 @@ static Path read_path(const uint8_t*& ptr, const uint8_t* end) {
                 throw std::runtime_error("Invalid string length");
             uint32_t len = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
             ptr += 4;
-            if (ptr + len > end)
+            if (len > static_cast<std::size_t>(end - ptr))
                 throw std::runtime_error("Invalid string data");
             path.push_back(std::string(reinterpret_cast<const char*>(ptr), len));
             ptr += len;
@@ -873,6 +1040,15 @@ static uint32_t read_uint32(const uint8_t*& ptr, const uint8_t* end) {
     return val;
 }
 
+/// [4 bytes size][serialized value], written in place
+static void write_value(ByteBuffer& buf, const ImmerValue& value) {
+    const std::size_t size = serialized_size(value);
+    write_uint32(buf, static_cast<uint32_t>(size));
+    const std::size_t offset = buf.size();
+    buf.resize(offset + size);
+    serialize_to(value, buf.data() + offset, size);
+}
+
 ByteBuffer encode_diff(const DiffResult& diff) {
     ByteBuffer buf;
     buf.reserve(1024); // Pre-allocate
@@ -881,9 +1057,7 @@ ByteBuffer encode_diff(const DiffResult& diff) {
     write_uint32(buf, static_cast<uint32_t>(diff.added.size()));
     for (const auto& [path, value] : diff.added) {
         write_path(buf, path);
-        ByteBuffer value_data = serialize(value);
-        write_uint32(buf, static_cast<uint32_t>(value_data.size()));
-        buf.insert(buf.end(), value_data.begin(), value_data.end());
+        write_value(buf, value);
     }
 
     // Write removed entries
@@ -897,26 +1071,93 @@ ByteBuffer encode_diff(const DiffResult& diff) {
     write_uint32(buf, static_cast<uint32_t>(diff.modified.size()));
     for (const auto& mod : diff.modified) {
         write_path(buf, mod.path);
-        ByteBuffer new_value_data = serialize(mod.new_value);
-        write_uint32(buf, static_cast<uint32_t>(new_value_data.size()));
-        buf.insert(buf.end(), new_value_data.begin(), new_value_data.end());
+        write_value(buf, mod.new_value);
     }
 
     return buf;
 }
 
+namespace {
+
+/// Encodes straight from the diff walk, in the same format as encode_diff(DiffResult).
+/// Entries arrive interleaved, so removed and modified entries go to their own
+/// section buffers and are appended behind the added section at the end.
+class DiffEncoder final : public DiffSink {
+public:
+    DiffEncoder() {
+        added_.reserve(1024);
+        write_uint32(added_, 0); // Patched in finish()
+    }
+
+    void on_add(PathView path, const ImmerValue& value) override {
+        ++added_count_;
+        write_path(added_, path);
+        write_value(added_, value);
+    }
+    void on_remove(PathView path, const ImmerValue& /*value*/) override {
+        ++removed_count_;
+        write_path(removed_, path);
+    }
+    void on_change(PathView path, const ImmerValue& /*old_value*/, const ImmerValue& new_value) override {
+        ++modified_count_;
+        write_path(modified_, path);
+        write_value(modified_, new_value);
+    }
+
+    [[nodiscard]] bool empty() const { return added_count_ == 0 && removed_count_ == 0 && modified_count_ == 0; }
+
+    [[nodiscard]] ByteBuffer finish() {
+        for (int i = 0; i < 4; ++i) {
+            added_[i] = static_cast<uint8_t>((added_count_ >> (i * 8)) & 0xFF);
+        }
+        added_.reserve(added_.size() + 8 + removed_.size() + modified_.size());
+        write_uint32(added_, removed_count_);
+        added_.insert(added_.end(), removed_.begin(), removed_.end());
+        write_uint32(added_, modified_count_);
+        added_.insert(added_.end(), modified_.begin(), modified_.end());
+        return std::move(added_);
+    }
+
+private:
+    ByteBuffer added_;
+    ByteBuffer removed_;
+    ByteBuffer modified_;
+    uint32_t added_count_ = 0;
+    uint32_t removed_count_ = 0;
+    uint32_t modified_count_ = 0;
+};
+
+} // namespace
+
+ByteBuffer encode_diff(const ImmerValue& old_val, const ImmerValue& new_val) {
+    DiffEncoder encoder;
+    diff_values(old_val, new_val, encoder, COLLECT_DIFF_OPTIONS);
+    if (encoder.empty()) {
+        return {};
+    }
+    return encoder.finish();
+}
+
 DiffResult decode_diff(const ByteBuffer& data) {
+    return decode_diff(data.data(), data.size());
+}
+
+DiffResult decode_diff(const uint8_t* data, std::size_t size) {
     DiffResult diff;
-    const uint8_t* ptr = data.data();
-    const uint8_t* end = ptr + data.size();
+    const uint8_t* ptr = data;
+    const uint8_t* end = ptr + size;
+
+    // Counts may come straight from shared memory that is being overwritten;
+    // never reserve more entries than the remaining bytes could encode
+    auto remaining = [&](std::size_t min_entry_size) { return static_cast<std::size_t>(end - ptr) / min_entry_size; };
 
     // Read added entries
     uint32_t added_count = read_uint32(ptr, end);
-    diff.added.reserve(added_count);
+    diff.added.reserve(std::min<std::size_t>(added_count, remaining(8)));
     for (uint32_t i = 0; i < added_count; ++i) {
         Path path = read_path(ptr, end);
         uint32_t value_size = read_uint32(ptr, end);
-        if (ptr + value_size > end)
+        if (value_size > static_cast<std::size_t>(end - ptr))
             throw std::runtime_error("Invalid value data");
         ImmerValue value = deserialize(ptr, value_size);
         ptr += value_size;
@@ -925,7 +1166,7 @@ DiffResult decode_diff(const ByteBuffer& data) {
 
     // Read removed entries
     uint32_t removed_count = read_uint32(ptr, end);
-    diff.removed.reserve(removed_count);
+    diff.removed.reserve(std::min<std::size_t>(removed_count, remaining(4)));
     for (uint32_t i = 0; i < removed_count; ++i) {
         Path path = read_path(ptr, end);
         diff.removed.emplace_back(std::move(path), ImmerValue{}); // Empty value for removed
@@ -933,11 +1174,11 @@ DiffResult decode_diff(const ByteBuffer& data) {
 
     // Read modified entries
     uint32_t modified_count = read_uint32(ptr, end);
-    diff.modified.reserve(modified_count);
+    diff.modified.reserve(std::min<std::size_t>(modified_count, remaining(8)));
     for (uint32_t i = 0; i < modified_count; ++i) {
         Path path = read_path(ptr, end);
         uint32_t value_size = read_uint32(ptr, end);
-        if (ptr + value_size > end)
+        if (value_size > static_cast<std::size_t>(end - ptr))
             throw std::runtime_error("Invalid value data");
         ImmerValue new_value = deserialize(ptr, value_size);
         ptr += value_size;
@@ -951,14 +1192,15 @@ DiffResult decode_diff(const ByteBuffer& data) {
 // Apply Diff
 // ============================================================
 
-// Uses path_core.h functions: set_at_path, erase_at_path
+// Uses path_utils.h functions: set_at_path, set_at_path_vivify, erase_at_path
 
 ImmerValue apply_diff(const ImmerValue& base, const DiffResult& diff) {
     ImmerValue result = base;
 
-    // Apply removals first (erase from maps or set to null for arrays)
-    for (const auto& [path, _] : diff.removed) {
-        result = erase_at_path(result, path);
+    // Apply removals first, last to first: removed elements at the end of a
+    // vector or array arrive in ascending order, so each one is then the last
+    for (auto it = diff.removed.rbegin(); it != diff.removed.rend(); ++it) {
+        result = erase_at_path(result, it->first);
     }
 
     // Apply modifications
@@ -966,9 +1208,9 @@ ImmerValue apply_diff(const ImmerValue& base, const DiffResult& diff) {
         result = set_at_path(result, mod.path, mod.new_value);
     }
 
-    // Apply additions
+    // Apply additions (in ascending order, so elements past the end append)
     for (const auto& [path, value] : diff.added) {
-        result = set_at_path(result, path, value);
+        result = set_at_path_vivify(result, path, value);
     }
 
     return result;
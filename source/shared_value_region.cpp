@@ -10,6 +10,8 @@
 
 #include <lager_ext/shared_value.h>
 
+#include <algorithm>
+
 // Boost.Interprocess headers - private to this translation unit
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/windows_shared_memory.hpp>
@@ -30,6 +32,12 @@ struct SharedMemoryRegion::Impl {
     std::string name;
     size_t local_heap_cursor = 0;
 
+    // Sub-arena state (see make_sub_arena): borrows the parent's mapping
+    const SharedMemoryRegion* parent = nullptr;
+    std::atomic<size_t>* heap_cursor = nullptr; // Shared by all sub-arenas of one build
+    size_t chunk_size = 0;
+    size_t chunk_end = 0; // local_heap_cursor .. chunk_end is this arena's current chunk
+
     Impl() = default;
 
     ~Impl() { close(); }
@@ -39,6 +47,10 @@ struct SharedMemoryRegion::Impl {
         shm.reset();
         size = 0;
         is_owner = false;
+        parent = nullptr;
+        heap_cursor = nullptr;
+        local_heap_cursor = 0;
+        chunk_end = 0;
     }
 
     void swap(Impl& other) noexcept {
@@ -48,6 +60,10 @@ struct SharedMemoryRegion::Impl {
         std::swap(is_owner, other.is_owner);
         std::swap(name, other.name);
         std::swap(local_heap_cursor, other.local_heap_cursor);
+        std::swap(parent, other.parent);
+        std::swap(heap_cursor, other.heap_cursor);
+        std::swap(chunk_size, other.chunk_size);
+        std::swap(chunk_end, other.chunk_end);
     }
 };
 
@@ -157,14 +173,20 @@ void SharedMemoryRegion::close() {
 }
 
 bool SharedMemoryRegion::is_valid() const {
+    if (impl_->parent)
+        return impl_->parent->is_valid();
     return impl_->region && impl_->region->get_address() != nullptr;
 }
 
 void* SharedMemoryRegion::base() const {
+    if (impl_->parent)
+        return impl_->parent->base();
     return impl_->region ? impl_->region->get_address() : nullptr;
 }
 
 size_t SharedMemoryRegion::size() const {
+    if (impl_->parent)
+        return impl_->parent->size();
     return impl_->size;
 }
 
@@ -188,6 +210,23 @@ void* SharedMemoryRegion::allocate(size_t size, size_t alignment) {
         return nullptr;
 
     auto* h = header();
+
+    if (impl_->heap_cursor) {
+        // Sub-arena: bump within the current chunk, claim a new one when it runs out
+        size_t offset = (impl_->local_heap_cursor + alignment - 1) & ~(alignment - 1);
+        if (offset + size > impl_->chunk_end) [[unlikely]] {
+            size_t claim = std::max(impl_->chunk_size, size + alignment);
+            size_t start = impl_->heap_cursor->fetch_add(claim, std::memory_order_relaxed);
+            if (start + claim > h->heap_size) {
+                return nullptr; // Out of memory
+            }
+            impl_->chunk_end = start + claim;
+            offset = (start + alignment - 1) & ~(alignment - 1);
+        }
+        impl_->local_heap_cursor = offset + size;
+        return reinterpret_cast<char*>(heap_base()) + offset;
+    }
+
     size_t aligned_size = (size + alignment - 1) & ~(alignment - 1);
 
     // Initialize local cursor from shared state if needed
@@ -207,7 +246,8 @@ void* SharedMemoryRegion::allocate(size_t size, size_t alignment) {
 }
 
 void SharedMemoryRegion::sync_allocation_cursor() {
-    if (impl_->local_heap_cursor > 0 && base()) {
+    // Sub-arenas report through adopt_allocation_cursor() on the parent instead
+    if (impl_->local_heap_cursor > 0 && base() && !impl_->parent) {
         header()->heap_used = impl_->local_heap_cursor;
     }
 }
@@ -220,4 +260,20 @@ size_t SharedMemoryRegion::local_cursor() const {
     return impl_->local_heap_cursor;
 }
 
+SharedMemoryRegion SharedMemoryRegion::make_sub_arena(std::atomic<size_t>& heap_cursor, size_t chunk_size) {
+    SharedMemoryRegion arena;
+    arena.impl_->parent = this;
+    arena.impl_->heap_cursor = &heap_cursor;
+    arena.impl_->chunk_size = chunk_size;
+    return arena;
+}
+
+void SharedMemoryRegion::adopt_allocation_cursor(size_t heap_cursor) {
+    impl_->local_heap_cursor = heap_cursor;
+}
+
+bool SharedMemoryRegion::is_sub_arena() const {
+    return impl_->parent != nullptr;
+}
+
 } // namespace shared_memory
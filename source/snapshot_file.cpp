@@ -0,0 +1,313 @@
+// snapshot_file.cpp - Memory-mapped ImmerValue snapshot files
+
+#include <lager_ext/serialization.h>
+#include <lager_ext/snapshot_file.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+
+namespace bip = boost::interprocess;
+
+namespace lager_ext {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'L', 'X', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t format;
+    uint8_t reserved[3];
+    uint64_t payload_size;
+    uint64_t checksum;
+};
+static_assert(sizeof(SnapshotHeader) == 32, "SnapshotHeader layout must stay 32 bytes");
+
+// ============================================================
+// XXH64 (seed 0): ~10x faster than byte-wise FNV-1a on large payloads
+// ============================================================
+
+constexpr uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read_u64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxh_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME2;
+    return rotl64(acc, 31) * XXH_PRIME1;
+}
+
+inline uint64_t xxh_merge(uint64_t acc, uint64_t val) {
+    acc ^= xxh_round(0, val);
+    return acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+uint64_t xxh64(const uint8_t* p, std::size_t len) {
+    const uint8_t* const end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = XXH_PRIME1 + XXH_PRIME2;
+        uint64_t v2 = XXH_PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - XXH_PRIME1;
+        const uint8_t* const limit = end - 32;
+        do {
+            v1 = xxh_round(v1, read_u64(p));
+            v2 = xxh_round(v2, read_u64(p + 8));
+            v3 = xxh_round(v3, read_u64(p + 16));
+            v4 = xxh_round(v4, read_u64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    } else {
+        h = XXH_PRIME5;
+    }
+
+    h += static_cast<uint64_t>(len);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh_round(0, read_u64(p));
+        h = rotl64(h, 27) * XXH_PRIME1 + XXH_PRIME4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read_u32(p)) * XXH_PRIME1;
+        h = rotl64(h, 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * XXH_PRIME5;
+        h = rotl64(h, 11) * XXH_PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME2;
+    h ^= h >> 29;
+    h *= XXH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+ByteBuffer encode_payload(const ImmerValue& val, SnapshotFormat format) {
+    switch (format) {
+    case SnapshotFormat::Compact:
+        return serialize(val, BinaryFormat::Compact);
+    case SnapshotFormat::Dictionary:
+        return serialize(val, BinaryFormat::Dictionary);
+    case SnapshotFormat::Indexed:
+        return serialize_indexed(val);
+    default:
+        return serialize(val, BinaryFormat::Standard);
+    }
+}
+
+bool report(std::string* error_out, std::string message) {
+    if (error_out)
+        *error_out = std::move(message);
+    return false;
+}
+
+} // anonymous namespace
+
+// ============================================================
+// save_snapshot / load_snapshot
+// ============================================================
+
+bool save_snapshot(const std::string& path, const ImmerValue& val, SnapshotFormat format, std::string* error_out) {
+    ByteBuffer payload;
+    try {
+        payload = encode_payload(val, format);
+    } catch (const std::exception& e) {
+        return report(error_out, std::string("Failed to serialize snapshot: ") + e.what());
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.format = static_cast<uint8_t>(format);
+    header.payload_size = payload.size();
+    header.checksum = xxh64(payload.data(), payload.size());
+
+    // Write next to the target, then rename over it: readers see the old file or the new one
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return report(error_out, "Failed to create " + temp_path);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        out.flush();
+        if (!out) {
+            out.close();
+            std::error_code ignored;
+            std::filesystem::remove(temp_path, ignored);
+            return report(error_out, "Failed to write " + temp_path);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(temp_path, ignored);
+        return report(error_out, "Failed to replace " + path + ": " + ec.message());
+    }
+    return true;
+}
+
+ImmerValue load_snapshot(const std::string& path, std::string* error_out) {
+    MappedSnapshot snapshot;
+    if (!snapshot.open(path, SnapshotOpenMode::Verified)) {
+        report(error_out, snapshot.last_error());
+        return ImmerValue{};
+    }
+    try {
+        return snapshot.materialize();
+    } catch (const std::exception& e) {
+        report(error_out, std::string("Failed to decode snapshot: ") + e.what());
+        return ImmerValue{};
+    }
+}
+
+// ============================================================
+// MappedSnapshot
+// ============================================================
+
+struct MappedSnapshot::Impl {
+    bip::file_mapping file;
+    bip::mapped_region region;
+    const uint8_t* payload = nullptr;
+    std::size_t payload_size = 0;
+    uint64_t checksum = 0;
+    SnapshotFormat format = SnapshotFormat::Standard;
+    std::string last_error;
+
+    void close() {
+        region = bip::mapped_region{};
+        file = bip::file_mapping{};
+        payload = nullptr;
+        payload_size = 0;
+    }
+
+    bool fail(std::string message) {
+        close();
+        last_error = std::move(message);
+        return false;
+    }
+};
+
+MappedSnapshot::MappedSnapshot() : impl_(std::make_unique<Impl>()) {}
+MappedSnapshot::~MappedSnapshot() = default;
+MappedSnapshot::MappedSnapshot(MappedSnapshot&&) noexcept = default;
+MappedSnapshot& MappedSnapshot::operator=(MappedSnapshot&&) noexcept = default;
+
+bool MappedSnapshot::open(const std::string& path, SnapshotOpenMode mode) {
+    Impl& s = *impl_;
+    s.close();
+    s.last_error.clear();
+
+    try {
+        s.file = bip::file_mapping(path.c_str(), bip::read_only);
+        s.region = bip::mapped_region(s.file, bip::read_only);
+    } catch (const std::exception& e) {
+        return s.fail("Failed to map " + path + ": " + e.what());
+    }
+
+    const auto* base = static_cast<const uint8_t*>(s.region.get_address());
+    const std::size_t file_size = s.region.get_size();
+    if (file_size < sizeof(SnapshotHeader))
+        return s.fail("Not a snapshot file (too small): " + path);
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+        return s.fail("Not a snapshot file (bad magic): " + path);
+    if (header.version != SNAPSHOT_VERSION)
+        return s.fail("Unsupported snapshot version " + std::to_string(header.version) + ": " + path);
+    if (header.format > static_cast<uint8_t>(SnapshotFormat::Indexed))
+        return s.fail("Unknown snapshot format " + std::to_string(header.format) + ": " + path);
+    if (header.payload_size != file_size - sizeof(SnapshotHeader))
+        return s.fail("Truncated snapshot: " + path);
+
+    s.payload = base + sizeof(SnapshotHeader);
+    s.payload_size = static_cast<std::size_t>(header.payload_size);
+    s.checksum = header.checksum;
+    s.format = static_cast<SnapshotFormat>(header.format);
+
+    if (s.format == SnapshotFormat::Indexed && (s.payload_size < 2 || s.payload[0] != INDEXED_FORMAT_MARKER))
+        return s.fail("Corrupt indexed snapshot: " + path);
+    if (mode == SnapshotOpenMode::Verified && !verify())
+        return s.fail("Snapshot checksum mismatch: " + path);
+    return true;
+}
+
+void MappedSnapshot::close() {
+    impl_->close();
+}
+
+bool MappedSnapshot::is_open() const noexcept {
+    return impl_->payload != nullptr;
+}
+
+const std::string& MappedSnapshot::last_error() const noexcept {
+    return impl_->last_error;
+}
+
+SnapshotFormat MappedSnapshot::format() const noexcept {
+    return impl_->format;
+}
+
+const uint8_t* MappedSnapshot::data() const noexcept {
+    return impl_->payload;
+}
+
+std::size_t MappedSnapshot::size() const noexcept {
+    return impl_->payload_size;
+}
+
+bool MappedSnapshot::verify() const {
+    return is_open() && xxh64(impl_->payload, impl_->payload_size) == impl_->checksum;
+}
+
+LazyValueView MappedSnapshot::view() const {
+    if (!is_open() || impl_->format != SnapshotFormat::Indexed)
+        return {};
+    return LazyValueView(impl_->payload, impl_->payload_size);
+}
+
+ImmerValue MappedSnapshot::materialize() const {
+    if (!is_open())
+        return ImmerValue{};
+    return deserialize(impl_->payload, impl_->payload_size);
+}
+
+} // namespace lager_ext
@@ -1,19 +1,27 @@
 // value.cpp - ImmerValue type utilities and serialization
 
 #include <lager_ext/builders.h>
+#include <lager_ext/indexed_snapshot.h>
 #include <lager_ext/serialization.h>
 #include <lager_ext/value.h>
 
+#include "binary_tags.h"
+
 #include <immer/array_transient.hpp>
 #include <immer/map_transient.hpp>
 #include <immer/table_transient.hpp>
 #include <immer/vector_transient.hpp>
 
+#include <algorithm> // for std::min
 #include <cstring>   // for std::memcpy
 #include <iomanip>   // for std::setprecision
 #include <iostream>  // for std::cout (print_value)
+#include <limits>    // for std::numeric_limits
+#include <optional>
 #include <sstream>   // for std::ostringstream
 #include <stdexcept> // for std::runtime_error
+#include <string_view>
+#include <unordered_map>
 
 namespace lager_ext {
 
@@ -160,6 +168,117 @@ void print_value(const ImmerValue& val, const std::string& prefix, std::size_t d
 
 // to_dot_notation() is implemented in path_types.cpp as PathView::to_dot_notation()
 
+// ============================================================
+// Content hash
+// ============================================================
+
+namespace {
+
+/// splitmix64 finalizer
+constexpr std::size_t mix_hash(std::size_t h) noexcept {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+}
+
+/// Order-dependent combination: combine(combine(s, a), b) != combine(combine(s, b), a)
+constexpr std::size_t combine_hash(std::size_t seed, std::size_t h) noexcept {
+    return mix_hash(seed + 0x9e3779b97f4a7c15ull + h);
+}
+
+std::size_t float_hash(double f) noexcept {
+    if (f == 0.0) {
+        f = 0.0; // -0.0 == 0.0
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return static_cast<std::size_t>(bits);
+}
+
+template <std::size_t N>
+std::size_t float_array_hash(std::size_t seed, const std::array<float, N>& arr) noexcept {
+    for (float f : arr) {
+        seed = combine_hash(seed, float_hash(f));
+    }
+    return seed;
+}
+
+std::size_t hash_value(const ImmerValue& val);
+
+/// The container's cached hash, computed by compute(container) on first use
+template <typename Box, typename Compute>
+std::size_t cached_hash(const Box& box, Compute&& compute) {
+    auto& slot = box.impl()->content_hash;
+    std::size_t hash = slot.load(std::memory_order_relaxed);
+    if (hash == 0) {
+        hash = compute(box.get());
+        if (hash == 0) {
+            hash = 1; // 0 means "not computed"
+        }
+        slot.store(hash, std::memory_order_relaxed);
+    }
+    return hash;
+}
+
+std::size_t hash_value(const ImmerValue& val) {
+    // The type is part of the hash, as it is part of equality (int32 1 != int64 1)
+    const std::size_t seed = mix_hash(val.data.index() + 1);
+    return std::visit(
+        [seed](const auto& arg) -> std::size_t {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, std::monostate>) {
+                return seed;
+            } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+                return combine_hash(seed, float_hash(arg));
+            } else if constexpr (std::is_integral_v<T>) {
+                return combine_hash(seed, static_cast<std::size_t>(arg));
+            } else if constexpr (std::is_same_v<T, BoxedString>) {
+                return combine_hash(seed, TransparentStringHash::fnv1a(arg.get()));
+            } else if constexpr (std::is_same_v<T, Vec2> || std::is_same_v<T, Vec3> || std::is_same_v<T, Vec4>) {
+                return float_array_hash(seed, arg);
+            } else if constexpr (std::is_same_v<T, BoxedMat3> || std::is_same_v<T, BoxedMat4x3> ||
+                                 std::is_same_v<T, BoxedMat4>) {
+                return float_array_hash(seed, arg.get());
+            } else if constexpr (std::is_same_v<T, BoxedValueMap>) {
+                return cached_hash(arg, [seed](const ValueMap& map) {
+                    // Iteration order depends on the map's history: sum the entries
+                    std::size_t sum = 0;
+                    for (const auto& [key, child] : map) {
+                        sum += combine_hash(TransparentStringHash::fnv1a(key), hash_value(child));
+                    }
+                    return combine_hash(combine_hash(seed, map.size()), sum);
+                });
+            } else if constexpr (std::is_same_v<T, BoxedValueTable>) {
+                return cached_hash(arg, [seed](const ValueTable& table) {
+                    std::size_t sum = 0;
+                    for (const auto& entry : table) {
+                        sum += combine_hash(TransparentStringHash::fnv1a(entry.id), hash_value(*entry.value));
+                    }
+                    return combine_hash(combine_hash(seed, table.size()), sum);
+                });
+            } else {
+                // BoxedValueVector, BoxedValueArray
+                return cached_hash(arg, [seed](const auto& seq) {
+                    std::size_t hash = combine_hash(seed, seq.size());
+                    for (const auto& child : seq) {
+                        hash = combine_hash(hash, hash_value(child));
+                    }
+                    return hash;
+                });
+            }
+        },
+        val.data);
+}
+
+} // namespace
+
+std::size_t content_hash(const ImmerValue& val) {
+    return hash_value(val);
+}
+
 ImmerValue create_sample_data() {
     // Create user 1 using Builder API for O(n) construction
     ImmerValue user1 = MapBuilder().set("name", ImmerValue{std::string{"Alice"}}).set("age", ImmerValue{25}).finish();
@@ -179,34 +298,114 @@ ImmerValue create_sample_data() {
 
 namespace {
 
-// Type tags for binary format
-enum class TypeTag : uint8_t {
-    Null = 0x00,
-    Int32 = 0x01, // int32_t (renamed from Int for clarity)
-    Float = 0x02,
-    Double = 0x03,
-    Bool = 0x04,
-    String = 0x05,
-    Map = 0x06,
-    Vector = 0x07,
-    Array = 0x08,
-    Table = 0x09,
-    Int64 = 0x0A, // int64_t
-    // New integer types (0x0B - 0x0F)
-    Int8 = 0x0B,   // int8_t
-    Int16 = 0x0C,  // int16_t
-    UInt8 = 0x0D,  // uint8_t
-    UInt16 = 0x0E, // uint16_t
-    UInt32 = 0x0F, // uint32_t
-    // Math types (0x10 - 0x15)
-    Vec2 = 0x10,
-    Vec3 = 0x11,
-    Vec4 = 0x12,
-    Mat3 = 0x13,
-    Mat4x3 = 0x14,
-    Mat4 = 0x15, // 4x4 matrix
-    // Extended integer types (0x16)
-    UInt64 = 0x16, // uint64_t
+using detail::TypeTag;
+
+// Compact format helpers: LEB128 varints, zigzag-mapped signed integers
+inline uint64_t zigzag_encode(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline std::size_t varint_size(uint64_t v) {
+    std::size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+// Integer tags whose payload is a varint in the compact format
+inline bool is_varint_tag(TypeTag tag) {
+    switch (tag) {
+    case TypeTag::Int16:
+    case TypeTag::Int32:
+    case TypeTag::Int64:
+    case TypeTag::UInt16:
+    case TypeTag::UInt32:
+    case TypeTag::UInt64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+template <typename T>
+T checked_varint_cast(int64_t v) {
+    if (v < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+        v > static_cast<int64_t>(std::numeric_limits<T>::max())) [[unlikely]]
+        throw std::runtime_error("Varint out of range");
+    return static_cast<T>(v);
+}
+
+template <typename T>
+T checked_varint_cast(uint64_t v) {
+    if (v > static_cast<uint64_t>(std::numeric_limits<T>::max())) [[unlikely]]
+        throw std::runtime_error("Varint out of range");
+    return static_cast<T>(v);
+}
+
+// Decode the varint payload of an integer tag (compact format)
+ImmerValue decode_compact_int(TypeTag tag, uint64_t raw) {
+    switch (tag) {
+    case TypeTag::Int16:
+        return ImmerValue{checked_varint_cast<int16_t>(zigzag_decode(raw))};
+    case TypeTag::Int32:
+        return ImmerValue{checked_varint_cast<int32_t>(zigzag_decode(raw))};
+    case TypeTag::Int64:
+        return ImmerValue{zigzag_decode(raw)};
+    case TypeTag::UInt16:
+        return ImmerValue{checked_varint_cast<uint16_t>(raw)};
+    case TypeTag::UInt32:
+        return ImmerValue{checked_varint_cast<uint32_t>(raw)};
+    default:
+        return ImmerValue{raw};
+    }
+}
+
+// Distinct map keys of a value tree in first-seen order (dictionary format).
+// Holds pointers into the tree, so it must not outlive the value it was built from.
+class KeyDictionary {
+public:
+    explicit KeyDictionary(const ImmerValue& root) { collect(root); }
+
+    const std::vector<const std::string*>& keys() const { return keys_; }
+
+    uint32_t index_of(const std::string& key) const { return index_.find(key)->second; }
+
+    // Varint count + (varint length + bytes) per key
+    std::size_t encoded_size() const {
+        std::size_t size = varint_size(keys_.size());
+        for (const std::string* k : keys_)
+            size += varint_size(k->size()) + k->size();
+        return size;
+    }
+
+private:
+    void collect(const ImmerValue& val) {
+        if (auto* m = val.get_if<BoxedValueMap>()) {
+            for (const auto& [k, v] : m->get()) {
+                if (index_.try_emplace(k, static_cast<uint32_t>(keys_.size())).second)
+                    keys_.push_back(&k);
+                collect(v);
+            }
+        } else if (auto* vec = val.get_if<BoxedValueVector>()) {
+            for (const auto& v : vec->get())
+                collect(v);
+        } else if (auto* arr = val.get_if<BoxedValueArray>()) {
+            for (const auto& v : arr->get())
+                collect(v);
+        } else if (auto* tbl = val.get_if<BoxedValueTable>()) {
+            for (const auto& entry : tbl->get())
+                collect(entry.value.get());
+        }
+    }
+
+    std::unordered_map<std::string_view, uint32_t> index_;
+    std::vector<const std::string*> keys_;
 };
 
 // Helper: write bytes to buffer
@@ -215,10 +414,75 @@ enum class TypeTag : uint8_t {
 class ByteWriter {
 public:
     ByteBuffer buffer;
+    bool compact = false;                // LEB128 counts/lengths and varint integers
+    const KeyDictionary* dict = nullptr; // Dictionary format: map keys as varint indices
 
     // Single byte - no optimization needed
     void write_u8(uint8_t v) { buffer.push_back(v); }
 
+    void write_varint(uint64_t v) {
+        while (v >= 0x80) {
+            buffer.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(v));
+    }
+
+    // Container counts and string lengths
+    void write_count(uint32_t n) {
+        if (compact)
+            write_varint(n);
+        else
+            write_u32(n);
+    }
+
+    // Integer payloads: fixed width in the standard format, (zigzag) varint in compact
+    void write_int16(int16_t v) {
+        if (compact) {
+            write_varint(zigzag_encode(v));
+        } else {
+            write_u8(static_cast<uint8_t>(v & 0xFF));
+            write_u8(static_cast<uint8_t>((v >> 8) & 0xFF));
+        }
+    }
+
+    void write_uint16(uint16_t v) {
+        if (compact) {
+            write_varint(v);
+        } else {
+            write_u8(static_cast<uint8_t>(v & 0xFF));
+            write_u8(static_cast<uint8_t>((v >> 8) & 0xFF));
+        }
+    }
+
+    void write_int32(int32_t v) {
+        if (compact)
+            write_varint(zigzag_encode(v));
+        else
+            write_i32(v);
+    }
+
+    void write_uint32(uint32_t v) {
+        if (compact)
+            write_varint(v);
+        else
+            write_u32(v);
+    }
+
+    void write_int64(int64_t v) {
+        if (compact)
+            write_varint(zigzag_encode(v));
+        else
+            write_i64(v);
+    }
+
+    void write_uint64(uint64_t v) {
+        if (compact)
+            write_varint(v);
+        else
+            write_i64(static_cast<int64_t>(v));
+    }
+
     // 16-bit write with memcpy
     void write_u16(uint16_t v) {
         std::size_t old_size = buffer.size();
@@ -265,12 +529,26 @@ public:
     }
 
     void write_string(const std::string& s) {
-        write_u32(static_cast<uint32_t>(s.size()));
+        write_count(static_cast<uint32_t>(s.size()));
         std::size_t old_size = buffer.size();
         buffer.resize(old_size + s.size());
         std::memcpy(buffer.data() + old_size, s.data(), s.size());
     }
 
+    // Map key: inline string, or its dictionary index
+    void write_key(const std::string& k) {
+        if (dict)
+            write_varint(dict->index_of(k));
+        else
+            write_string(k);
+    }
+
+    void write_dictionary(const KeyDictionary& d) {
+        write_varint(d.keys().size());
+        for (const std::string* k : d.keys())
+            write_string(*k);
+    }
+
     // OPTIMIZATION: Batch write entire float array with single memcpy
     template <std::size_t N>
     void write_float_array(const std::array<float, N>& arr) {
@@ -296,8 +574,10 @@ public:
     const uint8_t* data;
     std::size_t size;
     std::size_t pos = 0;
+    bool compact = false;                           // LEB128 counts/lengths and varint integers
+    const std::vector<std::string>* dict = nullptr; // Dictionary format: decoded key table
 
-    ByteReader(const uint8_t* d, std::size_t s) : data(d), size(s) {}
+    ByteReader(const uint8_t* d, std::size_t s, bool c = false) : data(d), size(s), compact(c) {}
 
     bool has_bytes(std::size_t n) const { return pos + n <= size; }
 
@@ -370,8 +650,26 @@ public:
         return v;
     }
 
+    uint64_t read_varint() {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t b = read_u8();
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+                return v;
+        }
+        throw std::runtime_error("Varint too long");
+    }
+
+    // Container counts and string lengths
+    uint32_t read_count() {
+        if (compact)
+            return checked_varint_cast<uint32_t>(read_varint());
+        return read_u32();
+    }
+
     std::string read_string() {
-        uint32_t len = read_u32();
+        uint32_t len = read_count();
         if (!has_bytes(len))
             throw std::runtime_error("Unexpected end of buffer");
         std::string s(reinterpret_cast<const char*>(data + pos), len);
@@ -379,6 +677,26 @@ public:
         return s;
     }
 
+    // Map key: inline string, or a copy of its dictionary entry
+    std::string read_key() {
+        if (!dict)
+            return read_string();
+        const uint64_t index = read_varint();
+        if (index >= dict->size()) [[unlikely]]
+            throw std::runtime_error("Key index out of range");
+        return (*dict)[index];
+    }
+
+    std::vector<std::string> read_dictionary() {
+        const uint32_t count = read_count();
+        std::vector<std::string> keys;
+        // Every key takes at least one byte; don't trust count beyond that
+        keys.reserve(std::min<std::size_t>(count, size - pos));
+        for (uint32_t i = 0; i < count; ++i)
+            keys.push_back(read_string());
+        return keys;
+    }
+
     // OPTIMIZATION: Batch read entire float array with single memcpy
     template <std::size_t N>
     std::array<float, N> read_float_array() {
@@ -420,27 +738,25 @@ void serialize_value(ByteWriter& w, const ImmerValue& val) {
                 w.write_u8(static_cast<uint8_t>(arg));
             } else if constexpr (std::is_same_v<T, int16_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Int16));
-                w.write_u8(static_cast<uint8_t>(arg & 0xFF));
-                w.write_u8(static_cast<uint8_t>((arg >> 8) & 0xFF));
+                w.write_int16(arg);
             } else if constexpr (std::is_same_v<T, int32_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Int32));
-                w.write_i32(arg);
+                w.write_int32(arg);
             } else if constexpr (std::is_same_v<T, int64_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Int64));
-                w.write_i64(arg);
+                w.write_int64(arg);
             } else if constexpr (std::is_same_v<T, uint8_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt8));
                 w.write_u8(arg);
             } else if constexpr (std::is_same_v<T, uint16_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt16));
-                w.write_u8(static_cast<uint8_t>(arg & 0xFF));
-                w.write_u8(static_cast<uint8_t>((arg >> 8) & 0xFF));
+                w.write_uint16(arg);
             } else if constexpr (std::is_same_v<T, uint32_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt32));
-                w.write_u32(arg);
+                w.write_uint32(arg);
             } else if constexpr (std::is_same_v<T, uint64_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt64));
-                w.write_i64(static_cast<int64_t>(arg)); // reuse i64 write
+                w.write_uint64(arg);
             } else if constexpr (std::is_same_v<T, float>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Float));
                 w.write_f32(arg);
@@ -458,16 +774,16 @@ void serialize_value(ByteWriter& w, const ImmerValue& val) {
                 // Container Boxing: unbox and serialize
                 const ValueMap& m = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Map));
-                w.write_u32(static_cast<uint32_t>(m.size()));
+                w.write_count(static_cast<uint32_t>(m.size()));
                 for (const auto& [k, v] : m) {
-                    w.write_string(k);
+                    w.write_key(k);
                     serialize_value(w, v);  // v is ImmerValue directly, no dereference
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
                 // Container Boxing: unbox and serialize
                 const ValueVector& vec = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Vector));
-                w.write_u32(static_cast<uint32_t>(vec.size()));
+                w.write_count(static_cast<uint32_t>(vec.size()));
                 for (const auto& v : vec) {
                     serialize_value(w, v);  // v is ImmerValue directly, no dereference
                 }
@@ -475,7 +791,7 @@ void serialize_value(ByteWriter& w, const ImmerValue& val) {
                 // Container Boxing: unbox and serialize
                 const ValueArray& arr = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Array));
-                w.write_u32(static_cast<uint32_t>(arr.size()));
+                w.write_count(static_cast<uint32_t>(arr.size()));
                 for (std::size_t i = 0; i < arr.size(); ++i) {
                     serialize_value(w, arr[i]);  // arr[i] is ImmerValue directly, no dereference
                 }
@@ -483,7 +799,7 @@ void serialize_value(ByteWriter& w, const ImmerValue& val) {
                 // Container Boxing: unbox and serialize
                 const ValueTable& tbl = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Table));
-                w.write_u32(static_cast<uint32_t>(tbl.size()));
+                w.write_count(static_cast<uint32_t>(tbl.size()));
                 for (const auto& entry : tbl) {
                     w.write_string(entry.id);
                     serialize_value(w, entry.value.get());  // TableEntry::value is still ValueBox
@@ -514,6 +830,10 @@ void serialize_value(ByteWriter& w, const ImmerValue& val) {
 ImmerValue deserialize_value(ByteReader& r) {
     TypeTag tag = static_cast<TypeTag>(r.read_u8());
 
+    if (r.compact && is_varint_tag(tag)) {
+        return decode_compact_int(tag, r.read_varint());
+    }
+
     switch (tag) {
     case TypeTag::Null:
         return ImmerValue{};
@@ -564,10 +884,10 @@ ImmerValue deserialize_value(ByteReader& r) {
 
     // Container types - Container Boxing: wrap in immer::box
     case TypeTag::Map: {
-        uint32_t count = r.read_u32();
+        uint32_t count = r.read_count();
         auto transient = ValueMap{}.transient();
         for (uint32_t i = 0; i < count; ++i) {
-            std::string key = r.read_string();
+            std::string key = r.read_key();
             ImmerValue val = deserialize_value(r);
             // Container Boxing: map now stores ImmerValue directly
             transient.set(std::move(key), std::move(val));
@@ -576,7 +896,7 @@ ImmerValue deserialize_value(ByteReader& r) {
     }
 
     case TypeTag::Vector: {
-        uint32_t count = r.read_u32();
+        uint32_t count = r.read_count();
         auto transient = ValueVector{}.transient();
         for (uint32_t i = 0; i < count; ++i) {
             ImmerValue val = deserialize_value(r);
@@ -590,9 +910,10 @@ ImmerValue deserialize_value(ByteReader& r) {
         // Container Boxing: Deserialize as immer::array, wrap in BoxedValueArray
         // Note: immer::array's transient may not work with custom MemoryPolicy,
         // so we use std::vector + range constructor for O(n) construction.
-        uint32_t count = r.read_u32();
+        uint32_t count = r.read_count();
         std::vector<ImmerValue> temp;
-        temp.reserve(count);
+        // Every element takes at least one byte; don't trust count beyond that
+        temp.reserve(std::min<std::size_t>(count, r.size - r.pos));
         for (uint32_t i = 0; i < count; ++i) {
             ImmerValue val = deserialize_value(r);
             temp.emplace_back(std::move(val));
@@ -602,7 +923,7 @@ ImmerValue deserialize_value(ByteReader& r) {
     }
 
     case TypeTag::Table: {
-        uint32_t count = r.read_u32();
+        uint32_t count = r.read_count();
         auto transient = ValueTable{}.transient();
         for (uint32_t i = 0; i < count; ++i) {
             std::string id = r.read_string();
@@ -637,23 +958,26 @@ ImmerValue deserialize_value(ByteReader& r) {
     }
 }
 
-std::size_t calc_serialized_size(const ImmerValue& val) {
+std::size_t calc_serialized_size(const ImmerValue& val, bool compact, const KeyDictionary* dict = nullptr) {
     std::size_t size = 1; // type tag
 
+    // Container count / string length prefix
+    auto count_size = [compact](std::size_t n) -> std::size_t { return compact ? varint_size(n) : 4; };
+
     std::visit(
-        [&size](const auto& arg) {
+        [&size, &count_size, compact, dict](const auto& arg) {
             using T = std::decay_t<decltype(arg)>;
 
             if constexpr (std::is_same_v<T, std::monostate>) {
                 // no extra data
             } else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) {
                 size += 1;
-            } else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) {
-                size += 2;
-            } else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) {
-                size += 4;
-            } else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) {
-                size += 8;
+            } else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t> ||
+                                 std::is_same_v<T, int64_t>) {
+                size += compact ? varint_size(zigzag_encode(arg)) : sizeof(T);
+            } else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t> ||
+                                 std::is_same_v<T, uint64_t>) {
+                size += compact ? varint_size(arg) : sizeof(T);
             } else if constexpr (std::is_same_v<T, float>) {
                 size += 4;
             } else if constexpr (std::is_same_v<T, double>) {
@@ -662,33 +986,33 @@ std::size_t calc_serialized_size(const ImmerValue& val) {
                 size += 1;
             } else if constexpr (std::is_same_v<T, BoxedString>) {
                 // Container Boxing: strings are now BoxedString
-                size += 4 + arg.get().size();
+                size += count_size(arg.get().size()) + arg.get().size();
             } else if constexpr (std::is_same_v<T, BoxedValueMap>) {
                 // Container Boxing: unbox to iterate
                 const ValueMap& m = arg.get();
-                size += 4; // count
+                size += count_size(m.size());
                 for (const auto& [k, v] : m) {
-                    size += 4 + k.size(); // key string
-                    size += calc_serialized_size(v);  // v is ImmerValue directly
+                    size += dict ? varint_size(dict->index_of(k)) : count_size(k.size()) + k.size(); // key
+                    size += calc_serialized_size(v, compact, dict); // v is ImmerValue directly
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
                 const ValueVector& vec = arg.get();
-                size += 4; // count
+                size += count_size(vec.size());
                 for (const auto& v : vec) {
-                    size += calc_serialized_size(v);  // v is ImmerValue directly
+                    size += calc_serialized_size(v, compact, dict); // v is ImmerValue directly
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueArray>) {
                 const ValueArray& arr = arg.get();
-                size += 4; // count
+                size += count_size(arr.size());
                 for (std::size_t i = 0; i < arr.size(); ++i) {
-                    size += calc_serialized_size(arr[i]);  // arr[i] is ImmerValue directly
+                    size += calc_serialized_size(arr[i], compact, dict); // arr[i] is ImmerValue directly
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueTable>) {
                 const ValueTable& tbl = arg.get();
-                size += 4; // count
+                size += count_size(tbl.size());
                 for (const auto& entry : tbl) {
-                    size += 4 + entry.id.size(); // id string
-                    size += calc_serialized_size(entry.value.get());  // TableEntry::value is still ValueBox
+                    size += count_size(entry.id.size()) + entry.id.size(); // id string
+                    size += calc_serialized_size(entry.value.get(), compact, dict); // TableEntry::value is still ValueBox
                 }
             } else if constexpr (std::is_same_v<T, Vec2>) {
                 size += 2 * sizeof(float); // 2 floats
@@ -709,11 +1033,35 @@ std::size_t calc_serialized_size(const ImmerValue& val) {
     return size;
 }
 
+// Whole-buffer size: format marker, key dictionary and value tree
+std::size_t calc_buffer_size(const ImmerValue& val, BinaryFormat format, const KeyDictionary* dict) {
+    switch (format) {
+    case BinaryFormat::Compact:
+        return 1 + calc_serialized_size(val, true);
+    case BinaryFormat::Dictionary:
+        return 1 + dict->encoded_size() + calc_serialized_size(val, true, dict);
+    default:
+        return calc_serialized_size(val, false);
+    }
+}
+
 } // anonymous namespace
 
-ByteBuffer serialize(const ImmerValue& val) {
+ByteBuffer serialize(const ImmerValue& val, BinaryFormat format) {
+    std::optional<KeyDictionary> dict;
+    if (format == BinaryFormat::Dictionary) {
+        dict.emplace(val);
+    }
     ByteWriter w;
-    w.buffer.reserve(calc_serialized_size(val));
+    w.compact = format != BinaryFormat::Standard;
+    w.buffer.reserve(calc_buffer_size(val, format, dict ? &*dict : nullptr));
+    if (dict) {
+        w.write_u8(DICTIONARY_FORMAT_MARKER);
+        w.write_dictionary(*dict);
+        w.dict = &*dict;
+    } else if (w.compact) {
+        w.write_u8(COMPACT_FORMAT_MARKER);
+    }
     serialize_value(w, val);
     return std::move(w.buffer);
 }
@@ -726,12 +1074,29 @@ ImmerValue deserialize(const uint8_t* data, std::size_t size) {
     if (size == 0) {
         return ImmerValue{};
     }
+    if (data[0] == COMPACT_FORMAT_MARKER) {
+        ByteReader r(data + 1, size - 1, true);
+        return deserialize_value(r);
+    }
+    if (data[0] == DICTIONARY_FORMAT_MARKER) {
+        ByteReader r(data + 1, size - 1, true);
+        const std::vector<std::string> keys = r.read_dictionary();
+        r.dict = &keys;
+        return deserialize_value(r);
+    }
+    if (data[0] == INDEXED_FORMAT_MARKER) {
+        return LazyValueView(data, size).materialize();
+    }
     ByteReader r(data, size);
     return deserialize_value(r);
 }
 
-std::size_t serialized_size(const ImmerValue& val) {
-    return calc_serialized_size(val);
+std::size_t serialized_size(const ImmerValue& val, BinaryFormat format) {
+    if (format == BinaryFormat::Dictionary) {
+        KeyDictionary dict(val);
+        return calc_buffer_size(val, format, &dict);
+    }
+    return calc_buffer_size(val, format, nullptr);
 }
 
 // Helper class to write directly to a pre-allocated buffer
@@ -747,8 +1112,10 @@ public:
     uint8_t* buffer;
     std::size_t capacity;
     std::size_t pos = 0;
+    bool compact = false;                // LEB128 counts/lengths and varint integers
+    const KeyDictionary* dict = nullptr; // Dictionary format: map keys as varint indices
 
-    DirectByteWriter(uint8_t* buf, std::size_t cap) : buffer(buf), capacity(cap) {}
+    DirectByteWriter(uint8_t* buf, std::size_t cap, bool c = false) : buffer(buf), capacity(cap), compact(c) {}
 
     void write_u8(uint8_t v) {
         if (pos >= capacity) [[unlikely]]
@@ -756,6 +1123,67 @@ public:
         buffer[pos++] = v;
     }
 
+    void write_varint(uint64_t v) {
+        if (pos + varint_size(v) > capacity) [[unlikely]]
+            throw std::runtime_error("Buffer overflow");
+        while (v >= 0x80) {
+            buffer[pos++] = static_cast<uint8_t>(v | 0x80);
+            v >>= 7;
+        }
+        buffer[pos++] = static_cast<uint8_t>(v);
+    }
+
+    // Container counts and string lengths
+    void write_count(uint32_t n) {
+        if (compact)
+            write_varint(n);
+        else
+            write_u32(n);
+    }
+
+    // Integer payloads: fixed width in the standard format, (zigzag) varint in compact
+    void write_int16(int16_t v) {
+        if (compact)
+            write_varint(zigzag_encode(v));
+        else
+            write_u16(static_cast<uint16_t>(v));
+    }
+
+    void write_uint16(uint16_t v) {
+        if (compact)
+            write_varint(v);
+        else
+            write_u16(v);
+    }
+
+    void write_int32(int32_t v) {
+        if (compact)
+            write_varint(zigzag_encode(v));
+        else
+            write_i32(v);
+    }
+
+    void write_uint32(uint32_t v) {
+        if (compact)
+            write_varint(v);
+        else
+            write_u32(v);
+    }
+
+    void write_int64(int64_t v) {
+        if (compact)
+            write_varint(zigzag_encode(v));
+        else
+            write_i64(v);
+    }
+
+    void write_uint64(uint64_t v) {
+        if (compact)
+            write_varint(v);
+        else
+            write_i64(static_cast<int64_t>(v));
+    }
+
     // 16-bit write with memcpy
     void write_u16(uint16_t v) {
         if (pos + sizeof(v) > capacity) [[unlikely]]
@@ -808,13 +1236,27 @@ public:
     }
 
     void write_string(const std::string& s) {
-        write_u32(static_cast<uint32_t>(s.size()));
+        write_count(static_cast<uint32_t>(s.size()));
         if (pos + s.size() > capacity) [[unlikely]]
             throw std::runtime_error("Buffer overflow");
         std::memcpy(buffer + pos, s.data(), s.size());
         pos += s.size();
     }
 
+    // Map key: inline string, or its dictionary index
+    void write_key(const std::string& k) {
+        if (dict)
+            write_varint(dict->index_of(k));
+        else
+            write_string(k);
+    }
+
+    void write_dictionary(const KeyDictionary& d) {
+        write_varint(d.keys().size());
+        for (const std::string* k : d.keys())
+            write_string(*k);
+    }
+
     // OPTIMIZATION: Batch write entire float array with single memcpy
     template <std::size_t N>
     void write_float_array(const std::array<float, N>& arr) {
@@ -839,27 +1281,25 @@ void serialize_value_direct(DirectByteWriter& w, const ImmerValue& val) {
                 w.write_u8(static_cast<uint8_t>(arg));
             } else if constexpr (std::is_same_v<T, int16_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Int16));
-                w.write_u8(static_cast<uint8_t>(arg & 0xFF));
-                w.write_u8(static_cast<uint8_t>((arg >> 8) & 0xFF));
+                w.write_int16(arg);
             } else if constexpr (std::is_same_v<T, int32_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Int32));
-                w.write_i32(arg);
+                w.write_int32(arg);
             } else if constexpr (std::is_same_v<T, int64_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Int64));
-                w.write_i64(arg);
+                w.write_int64(arg);
             } else if constexpr (std::is_same_v<T, uint8_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt8));
                 w.write_u8(arg);
             } else if constexpr (std::is_same_v<T, uint16_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt16));
-                w.write_u8(static_cast<uint8_t>(arg & 0xFF));
-                w.write_u8(static_cast<uint8_t>((arg >> 8) & 0xFF));
+                w.write_uint16(arg);
             } else if constexpr (std::is_same_v<T, uint32_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt32));
-                w.write_u32(arg);
+                w.write_uint32(arg);
             } else if constexpr (std::is_same_v<T, uint64_t>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::UInt64));
-                w.write_i64(static_cast<int64_t>(arg));
+                w.write_uint64(arg);
             } else if constexpr (std::is_same_v<T, float>) {
                 w.write_u8(static_cast<uint8_t>(TypeTag::Float));
                 w.write_f32(arg);
@@ -877,29 +1317,29 @@ void serialize_value_direct(DirectByteWriter& w, const ImmerValue& val) {
                 // Container Boxing: unbox and serialize
                 const ValueMap& m = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Map));
-                w.write_u32(static_cast<uint32_t>(m.size()));
+                w.write_count(static_cast<uint32_t>(m.size()));
                 for (const auto& [k, v] : m) {
-                    w.write_string(k);
+                    w.write_key(k);
                     serialize_value_direct(w, v);  // v is ImmerValue directly
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
                 const ValueVector& vec = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Vector));
-                w.write_u32(static_cast<uint32_t>(vec.size()));
+                w.write_count(static_cast<uint32_t>(vec.size()));
                 for (const auto& v : vec) {
                     serialize_value_direct(w, v);  // v is ImmerValue directly
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueArray>) {
                 const ValueArray& arr = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Array));
-                w.write_u32(static_cast<uint32_t>(arr.size()));
+                w.write_count(static_cast<uint32_t>(arr.size()));
                 for (std::size_t i = 0; i < arr.size(); ++i) {
                     serialize_value_direct(w, arr[i]);  // arr[i] is ImmerValue directly
                 }
             } else if constexpr (std::is_same_v<T, BoxedValueTable>) {
                 const ValueTable& tbl = arg.get();
                 w.write_u8(static_cast<uint8_t>(TypeTag::Table));
-                w.write_u32(static_cast<uint32_t>(tbl.size()));
+                w.write_count(static_cast<uint32_t>(tbl.size()));
                 for (const auto& entry : tbl) {
                     w.write_string(entry.id);
                     serialize_value_direct(w, entry.value.get());  // TableEntry::value is still ValueBox
@@ -928,191 +1368,536 @@ void serialize_value_direct(DirectByteWriter& w, const ImmerValue& val) {
 }
 } // anonymous namespace
 
-std::size_t serialize_to(const ImmerValue& val, uint8_t* buffer, std::size_t buffer_size) {
-    std::size_t required = calc_serialized_size(val);
+std::size_t serialize_to(const ImmerValue& val, uint8_t* buffer, std::size_t buffer_size, BinaryFormat format) {
+    std::optional<KeyDictionary> dict;
+    if (format == BinaryFormat::Dictionary) {
+        dict.emplace(val);
+    }
+    std::size_t required = calc_buffer_size(val, format, dict ? &*dict : nullptr);
     if (required > buffer_size) {
         throw std::runtime_error("Buffer too small: need " + std::to_string(required) + " bytes, got " +
                                  std::to_string(buffer_size));
     }
-    DirectByteWriter w(buffer, buffer_size);
+    DirectByteWriter w(buffer, buffer_size, format != BinaryFormat::Standard);
+    if (dict) {
+        w.write_u8(DICTIONARY_FORMAT_MARKER);
+        w.write_dictionary(*dict);
+        w.dict = &*dict;
+    } else if (w.compact) {
+        w.write_u8(COMPACT_FORMAT_MARKER);
+    }
     serialize_value_direct(w, val);
     return w.pos;
 }
 
 // ============================================================
-// JSON Serialization / Deserialization Implementation
+// Streaming Deserialization Implementation
 // ============================================================
 
 namespace {
 
-// JSON escape special characters in strings
-// OPTIMIZATION: Use string::reserve + append instead of ostringstream for better performance
-std::string json_escape_string(const std::string& s) {
-    std::string result;
-    // Pre-allocate with some extra space for potential escapes
-    result.reserve(s.size() + 16);
-
-    for (char c : s) {
-        switch (c) {
-        case '"':
-            result += "\\\"";
+constexpr std::size_t NOT_A_SCALAR = static_cast<std::size_t>(-1);
+
+// Payload size following the tag for scalar and math types,
+// or NOT_A_SCALAR for strings, containers and unknown tags
+std::size_t scalar_payload_size(TypeTag tag) {
+    switch (tag) {
+    case TypeTag::Null:
+        return 0;
+    case TypeTag::Int8:
+    case TypeTag::UInt8:
+    case TypeTag::Bool:
+        return 1;
+    case TypeTag::Int16:
+    case TypeTag::UInt16:
+        return 2;
+    case TypeTag::Int32:
+    case TypeTag::UInt32:
+    case TypeTag::Float:
+        return 4;
+    case TypeTag::Int64:
+    case TypeTag::UInt64:
+    case TypeTag::Double:
+    case TypeTag::Vec2:
+        return 8;
+    case TypeTag::Vec3:
+        return 12;
+    case TypeTag::Vec4:
+        return 16;
+    case TypeTag::Mat3:
+        return 36;
+    case TypeTag::Mat4x3:
+        return 48;
+    case TypeTag::Mat4:
+        return 64;
+    default:
+        return NOT_A_SCALAR;
+    }
+}
+
+bool is_container_tag(TypeTag tag) {
+    return tag == TypeTag::Map || tag == TypeTag::Vector || tag == TypeTag::Array || tag == TypeTag::Table;
+}
+
+} // anonymous namespace
+
+struct StreamingDeserializer::Impl {
+    // What the decoder expects next in the byte stream
+    enum class Phase : uint8_t {
+        Tag,        // 1-byte type tag
+        Scalar,     // Tag + fixed-size payload, partially buffered in scratch
+        Count,      // 4-byte element count of a container
+        StringLen,  // 4-byte string length (value, map key or table id)
+        StringBody, // String bytes
+        Varint,     // Compact format: varint, decoded into varint_target
+    };
+
+    // What a finished varint (Phase::Varint) is decoded as
+    enum class VarintTarget : uint8_t {
+        Integer,   // Integer payload of pending_tag
+        Count,     // Element count of a container
+        StringLen, // String length (value, map key, table id or dictionary entry)
+        DictCount, // Dictionary format: number of keys
+        KeyIndex,  // Dictionary format: map key as a dictionary index
+    };
+
+    // Where a finished string goes
+    enum class StringTarget : uint8_t {
+        Value,     // String value
+        Key,       // Map key or table id of the next element
+        DictEntry, // Dictionary format: next key of the dictionary
+    };
+
+    // Container under construction
+    struct Frame {
+        using Builder = std::variant<ValueMap::transient_type, ValueVector::transient_type,
+                                     ValueTable::transient_type, std::vector<ImmerValue>>;
+
+        TypeTag kind;
+        uint32_t remaining;
+        std::size_t index = 0; // Position of the element being decoded
+        std::string key;       // Key / id of the element being decoded (map, table)
+        Builder builder;
+
+        Frame(TypeTag k, uint32_t count) : kind(k), remaining(count), builder(make_builder(k)) {}
+
+        static Builder make_builder(TypeTag k) {
+            switch (k) {
+            case TypeTag::Map:
+                return ValueMap{}.transient();
+            case TypeTag::Vector:
+                return ValueVector{}.transient();
+            case TypeTag::Table:
+                return ValueTable{}.transient();
+            default:
+                return std::vector<ImmerValue>{};
+            }
+        }
+
+        bool keyed() const { return kind == TypeTag::Map || kind == TypeTag::Table; }
+
+        void add(ImmerValue&& val) {
+            switch (kind) {
+            case TypeTag::Map:
+                std::get<ValueMap::transient_type>(builder).set(std::move(key), std::move(val));
+                break;
+            case TypeTag::Vector:
+                std::get<ValueVector::transient_type>(builder).push_back(std::move(val));
+                break;
+            case TypeTag::Table:
+                std::get<ValueTable::transient_type>(builder).insert(TableEntry{std::move(key), std::move(val)});
+                break;
+            default:
+                std::get<std::vector<ImmerValue>>(builder).push_back(std::move(val));
+                break;
+            }
+        }
+
+        ImmerValue finish() {
+            switch (kind) {
+            case TypeTag::Map:
+                return ImmerValue{BoxedValueMap{std::get<ValueMap::transient_type>(builder).persistent()}};
+            case TypeTag::Vector:
+                return ImmerValue{BoxedValueVector{std::get<ValueVector::transient_type>(builder).persistent()}};
+            case TypeTag::Table:
+                return ImmerValue{BoxedValueTable{std::get<ValueTable::transient_type>(builder).persistent()}};
+            default: {
+                auto& temp = std::get<std::vector<ImmerValue>>(builder);
+                return ImmerValue{BoxedValueArray{
+                    ValueArray(std::make_move_iterator(temp.begin()), std::make_move_iterator(temp.end()))}};
+            }
+            }
+        }
+    };
+
+    // Largest token buffered across chunks: tag + Mat4 payload
+    static constexpr std::size_t SCRATCH_SIZE = 1 + 64;
+
+    Status status = Status::NeedMoreData;
+    std::string error;
+    std::size_t consumed = 0;
+
+    Phase phase = Phase::Tag;
+    bool at_start = true; // Next byte is the first of the buffer (format marker check)
+    bool compact = false;
+    bool dictionary = false;
+    TypeTag pending_tag = TypeTag::Null;
+    VarintTarget varint_target = VarintTarget::Integer;
+    uint64_t varint_value = 0;
+    unsigned varint_shift = 0;
+    StringTarget string_target = StringTarget::Value;
+    std::vector<std::string> dict;
+    uint32_t dict_remaining = 0;
+    uint8_t scratch[SCRATCH_SIZE];
+    std::size_t scratch_len = 0;
+    std::size_t scratch_need = 0;
+    std::string str;
+    uint32_t str_remaining = 0;
+
+    std::vector<Frame> stack;
+    ImmerValue result;
+
+    std::size_t callback_depth = 0;
+    SubtreeCallback callback;
+    std::vector<PathElement> path_buf;
+
+    void reset() {
+        status = Status::NeedMoreData;
+        error.clear();
+        consumed = 0;
+        phase = Phase::Tag;
+        at_start = true;
+        compact = false;
+        dictionary = false;
+        dict.clear();
+        scratch_len = 0;
+        str.clear();
+        stack.clear();
+        result = ImmerValue{};
+    }
+
+    void fail(std::string message) {
+        status = Status::Error;
+        error = std::move(message);
+        stack.clear();
+    }
+
+    // Get `n` contiguous bytes, from the chunk if possible, otherwise via scratch.
+    // Returns nullptr if the chunk ran out first (the partial token stays in scratch).
+    const uint8_t* take(const uint8_t*& p, const uint8_t* end, std::size_t n) {
+        if (scratch_len == 0 && static_cast<std::size_t>(end - p) >= n) [[likely]] {
+            const uint8_t* out = p;
+            p += n;
+            return out;
+        }
+        std::size_t copy = std::min(n - scratch_len, static_cast<std::size_t>(end - p));
+        std::memcpy(scratch + scratch_len, p, copy);
+        scratch_len += copy;
+        p += copy;
+        if (scratch_len < n)
+            return nullptr;
+        scratch_len = 0;
+        return scratch;
+    }
+
+    uint32_t read_u32(const uint8_t* bytes) {
+        uint32_t v;
+        std::memcpy(&v, bytes, sizeof(v));
+        return v;
+    }
+
+    // Hand a subtree to the callback; returns whether to keep it in the tree
+    bool offer_subtree(const ImmerValue& val) {
+        path_buf.clear();
+        for (const Frame& f : stack) {
+            if (f.keyed())
+                path_buf.emplace_back(std::string_view{f.key});
+            else
+                path_buf.emplace_back(f.index);
+        }
+        return callback(PathView{path_buf.data(), path_buf.size()}, val);
+    }
+
+    // Route a finished value into its parent; pops every container it completes
+    void complete_value(ImmerValue val) {
+        while (true) {
+            const bool keep = !callback || stack.size() != callback_depth || offer_subtree(val);
+
+            if (stack.empty()) {
+                if (keep)
+                    result = std::move(val);
+                status = Status::Complete;
+                return;
+            }
+
+            Frame& top = stack.back();
+            if (keep)
+                top.add(std::move(val));
+            ++top.index;
+
+            if (--top.remaining > 0) {
+                next_element(top);
+                return;
+            }
+            val = top.finish();
+            stack.pop_back();
+        }
+    }
+
+    void next_element(const Frame& top) {
+        if (dictionary && top.kind == TypeTag::Map) {
+            expect_varint(VarintTarget::KeyIndex);
+        } else if (top.keyed()) {
+            string_target = StringTarget::Key;
+            expect_length(Phase::StringLen);
+        } else {
+            phase = Phase::Tag;
+        }
+    }
+
+    // Count or string length: fixed 4 bytes, or a varint in the compact format
+    void expect_length(Phase target) {
+        if (compact)
+            expect_varint(target == Phase::Count ? VarintTarget::Count : VarintTarget::StringLen);
+        else
+            phase = target;
+    }
+
+    void expect_varint(VarintTarget target) {
+        phase = Phase::Varint;
+        varint_target = target;
+        varint_value = 0;
+        varint_shift = 0;
+    }
+
+    void begin_string(uint32_t len) {
+        str_remaining = len;
+        str.clear();
+        phase = Phase::StringBody;
+    }
+
+    void begin_container(TypeTag tag, uint32_t count) {
+        if (count == 0) {
+            phase = Phase::Tag;
+            complete_value(Frame{tag, 0}.finish());
+            return;
+        }
+        stack.emplace_back(tag, count);
+        next_element(stack.back());
+    }
+
+    void finish_string() {
+        switch (string_target) {
+        case StringTarget::Key:
+            stack.back().key = std::move(str);
+            phase = Phase::Tag;
             break;
-        case '\\':
-            result += "\\\\";
+        case StringTarget::DictEntry:
+            dict.push_back(std::move(str));
+            next_dict_entry();
             break;
-        case '\b':
-            result += "\\b";
+        default:
+            phase = Phase::Tag;
+            complete_value(ImmerValue{std::move(str)});
             break;
-        case '\f':
-            result += "\\f";
+        }
+    }
+
+    void next_dict_entry() {
+        if (dict_remaining == 0) {
+            phase = Phase::Tag;
+            return;
+        }
+        --dict_remaining;
+        expect_varint(VarintTarget::StringLen);
+    }
+
+    void step(const uint8_t*& p, const uint8_t* end) {
+        switch (phase) {
+        case Phase::Tag: {
+            if (at_start) [[unlikely]] {
+                at_start = false;
+                if (*p == COMPACT_FORMAT_MARKER) {
+                    compact = true;
+                    ++p;
+                    return;
+                }
+                if (*p == DICTIONARY_FORMAT_MARKER) {
+                    compact = true;
+                    dictionary = true;
+                    string_target = StringTarget::DictEntry;
+                    ++p;
+                    expect_varint(VarintTarget::DictCount);
+                    return;
+                }
+            }
+            const TypeTag tag = static_cast<TypeTag>(*p);
+            if (is_container_tag(tag)) {
+                ++p;
+                pending_tag = tag;
+                expect_length(Phase::Count);
+            } else if (tag == TypeTag::String) {
+                ++p;
+                string_target = StringTarget::Value;
+                expect_length(Phase::StringLen);
+            } else if (compact && is_varint_tag(tag)) {
+                ++p;
+                pending_tag = tag;
+                expect_varint(VarintTarget::Integer);
+            } else {
+                const std::size_t payload = scalar_payload_size(tag);
+                if (payload == NOT_A_SCALAR) [[unlikely]] {
+                    fail("Unknown type tag: " + std::to_string(static_cast<int>(tag)));
+                    return;
+                }
+                if (static_cast<std::size_t>(end - p) > payload) [[likely]] {
+                    // Whole scalar is in this chunk: decode straight from the input
+                    ByteReader r(p, payload + 1);
+                    p += payload + 1;
+                    complete_value(deserialize_value(r));
+                } else {
+                    scratch_need = payload + 1;
+                    phase = Phase::Scalar;
+                }
+            }
             break;
-        case '\n':
-            result += "\\n";
+        }
+
+        case Phase::Scalar: {
+            const uint8_t* bytes = take(p, end, scratch_need);
+            if (!bytes)
+                return;
+            ByteReader r(bytes, scratch_need);
+            phase = Phase::Tag;
+            complete_value(deserialize_value(r));
             break;
-        case '\r':
-            result += "\\r";
+        }
+
+        case Phase::Count: {
+            const uint8_t* bytes = take(p, end, sizeof(uint32_t));
+            if (!bytes)
+                return;
+            begin_container(pending_tag, read_u32(bytes));
             break;
-        case '\t':
-            result += "\\t";
+        }
+
+        case Phase::StringLen: {
+            const uint8_t* bytes = take(p, end, sizeof(uint32_t));
+            if (!bytes)
+                return;
+            begin_string(read_u32(bytes));
+            [[fallthrough]];
+        }
+
+        case Phase::StringBody: {
+            const std::size_t n = std::min<std::size_t>(str_remaining, static_cast<std::size_t>(end - p));
+            str.append(reinterpret_cast<const char*>(p), n);
+            p += n;
+            str_remaining -= static_cast<uint32_t>(n);
+            if (str_remaining == 0)
+                finish_string();
             break;
-        default:
-            if (static_cast<unsigned char>(c) < 0x20) {
-                // Control characters as \uXXXX
-                char buf[7];
-                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
-                result += buf;
-            } else {
-                result += c;
+        }
+
+        case Phase::Varint: {
+            while (p < end) {
+                const uint8_t b = *p++;
+                if (varint_shift >= 64) [[unlikely]] {
+                    fail("Varint too long");
+                    return;
+                }
+                varint_value |= static_cast<uint64_t>(b & 0x7F) << varint_shift;
+                varint_shift += 7;
+                if ((b & 0x80) == 0) {
+                    finish_varint();
+                    return;
+                }
             }
+            break;
+        }
         }
     }
-    return result;
-}
 
-// Forward declaration
-void to_json_impl(const ImmerValue& val, std::ostringstream& oss, bool compact, int indent_level);
+    void finish_varint() {
+        switch (varint_target) {
+        case VarintTarget::Count:
+            begin_container(pending_tag, checked_varint_cast<uint32_t>(varint_value));
+            break;
+        case VarintTarget::StringLen:
+            begin_string(checked_varint_cast<uint32_t>(varint_value));
+            if (str_remaining == 0)
+                finish_string();
+            break;
+        case VarintTarget::DictCount:
+            dict_remaining = checked_varint_cast<uint32_t>(varint_value);
+            next_dict_entry();
+            break;
+        case VarintTarget::KeyIndex:
+            if (varint_value >= dict.size()) [[unlikely]]
+                throw std::runtime_error("Key index out of range");
+            stack.back().key = dict[varint_value];
+            phase = Phase::Tag;
+            break;
+        case VarintTarget::Integer:
+            phase = Phase::Tag;
+            complete_value(decode_compact_int(pending_tag, varint_value));
+            break;
+        }
+    }
+};
 
-// Write float array as JSON array
-template <std::size_t N>
-void write_float_array_json(const std::array<float, N>& arr, std::ostringstream& oss) {
-    oss << "[";
-    for (std::size_t i = 0; i < N; ++i) {
-        if (i > 0)
-            oss << ",";
-        oss << std::setprecision(7) << arr[i];
+StreamingDeserializer::StreamingDeserializer() : impl_(std::make_unique<Impl>()) {}
+StreamingDeserializer::~StreamingDeserializer() = default;
+StreamingDeserializer::StreamingDeserializer(StreamingDeserializer&&) noexcept = default;
+StreamingDeserializer& StreamingDeserializer::operator=(StreamingDeserializer&&) noexcept = default;
+
+void StreamingDeserializer::on_subtree(std::size_t depth, SubtreeCallback callback) {
+    impl_->callback_depth = depth;
+    impl_->callback = std::move(callback);
+}
+
+StreamingDeserializer::Status StreamingDeserializer::feed(const uint8_t* data, std::size_t size) {
+    Impl& s = *impl_;
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    try {
+        while (p < end && s.status == Status::NeedMoreData) {
+            s.step(p, end);
+        }
+    } catch (const std::exception& e) {
+        s.fail(e.what());
     }
-    oss << "]";
+    s.consumed += static_cast<std::size_t>(p - data);
+    return s.status;
 }
 
-void to_json_impl(const ImmerValue& val, std::ostringstream& oss, bool compact, int indent_level) {
-    const std::string indent = compact ? "" : std::string(indent_level * 2, ' ');
-    const std::string child_indent = compact ? "" : std::string((indent_level + 1) * 2, ' ');
-    const std::string newline = compact ? "" : "\n";
-    const std::string space_after_colon = compact ? "" : " ";
+StreamingDeserializer::Status StreamingDeserializer::status() const noexcept {
+    return impl_->status;
+}
 
-    std::visit(
-        [&](const auto& arg) {
-            using T = std::decay_t<decltype(arg)>;
+ImmerValue StreamingDeserializer::take_result() {
+    return std::move(impl_->result);
+}
 
-            if constexpr (std::is_same_v<T, std::monostate>) {
-                oss << "null";
-            } else if constexpr (std::is_same_v<T, bool>) {
-                oss << (arg ? "true" : "false");
-            } else if constexpr (std::is_same_v<T, int8_t>) {
-                oss << static_cast<int>(arg);
-            } else if constexpr (std::is_same_v<T, uint8_t>) {
-                oss << static_cast<unsigned>(arg);
-            } else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t> ||
-                                 std::is_same_v<T, int64_t> || std::is_same_v<T, uint16_t> ||
-                                 std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
-                oss << arg;
-            } else if constexpr (std::is_same_v<T, float>) {
-                oss << std::setprecision(7) << arg;
-            } else if constexpr (std::is_same_v<T, double>) {
-                oss << std::setprecision(15) << arg;
-            } else if constexpr (std::is_same_v<T, BoxedString>) {
-                // Container Boxing: strings are now BoxedString
-                oss << "\"" << json_escape_string(arg.get()) << "\"";
-            } else if constexpr (std::is_same_v<T, Vec2>) {
-                write_float_array_json(arg, oss);
-            } else if constexpr (std::is_same_v<T, Vec3>) {
-                write_float_array_json(arg, oss);
-            } else if constexpr (std::is_same_v<T, Vec4>) {
-                write_float_array_json(arg, oss);
-            } else if constexpr (std::is_same_v<T, ImmerValue::boxed_mat3>) {
-                write_float_array_json(arg.get(), oss);
-            } else if constexpr (std::is_same_v<T, ImmerValue::boxed_mat4x3>) {
-                write_float_array_json(arg.get(), oss);
-            } else if constexpr (std::is_same_v<T, ImmerValue::boxed_mat4>) {
-                write_float_array_json(arg.get(), oss);
-            } else if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                // Container Boxing: unbox the map
-                const ValueMap& m = arg.get();
-                if (m.size() == 0) {
-                    oss << "{}";
-                } else {
-                    oss << "{" << newline;
-                    bool first = true;
-                    for (const auto& [k, v] : m) {
-                        if (!first)
-                            oss << "," << newline;
-                        first = false;
-                        oss << child_indent << "\"" << json_escape_string(k) << "\":" << space_after_colon;
-                        to_json_impl(v, oss, compact, indent_level + 1);  // v is ImmerValue directly
-                    }
-                    oss << newline << indent << "}";
-                }
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                const ValueVector& vec = arg.get();
-                if (vec.size() == 0) {
-                    oss << "[]";
-                } else {
-                    oss << "[" << newline;
-                    bool first = true;
-                    for (const auto& v : vec) {
-                        if (!first)
-                            oss << "," << newline;
-                        first = false;
-                        oss << child_indent;
-                        to_json_impl(v, oss, compact, indent_level + 1);  // v is ImmerValue directly
-                    }
-                    oss << newline << indent << "]";
-                }
-            } else if constexpr (std::is_same_v<T, BoxedValueArray>) {
-                const ValueArray& arr = arg.get();
-                if (arr.size() == 0) {
-                    oss << "[]";
-                } else {
-                    oss << "[" << newline;
-                    for (std::size_t i = 0; i < arr.size(); ++i) {
-                        if (i > 0)
-                            oss << "," << newline;
-                        oss << child_indent;
-                        to_json_impl(arr[i], oss, compact, indent_level + 1);  // arr[i] is ImmerValue directly
-                    }
-                    oss << newline << indent << "]";
-                }
-            } else if constexpr (std::is_same_v<T, BoxedValueTable>) {
-                const ValueTable& tbl = arg.get();
-                if (tbl.size() == 0) {
-                    oss << "{}";
-                } else {
-                    oss << "{" << newline;
-                    bool first = true;
-                    for (const auto& entry : tbl) {
-                        if (!first)
-                            oss << "," << newline;
-                        first = false;
-                        oss << child_indent << "\"" << json_escape_string(entry.id) << "\":" << space_after_colon;
-                        to_json_impl(entry.value.get(), oss, compact, indent_level + 1);  // TableEntry::value is still ValueBox
-                    }
-                    oss << newline << indent << "}";
-                }
-            }
-        },
-        val.data);
+const std::string& StreamingDeserializer::error() const noexcept {
+    return impl_->error;
+}
+
+std::size_t StreamingDeserializer::bytes_consumed() const noexcept {
+    return impl_->consumed;
+}
+
+void StreamingDeserializer::reset() {
+    impl_->reset();
 }
 
+// ============================================================
+// JSON Deserialization Implementation
+// (JSON serialization lives in json_writer.cpp)
+// ============================================================
+
+namespace {
+
 // ============================================================
 // Simple JSON Parser
 // ============================================================
@@ -1382,12 +2167,6 @@ private:
 
 } // anonymous namespace
 
-std::string to_json(const ImmerValue& val, bool compact) {
-    std::ostringstream oss;
-    to_json_impl(val, oss, compact, 0);
-    return oss.str();
-}
-
 ImmerValue from_json(const std::string& json_str, std::string* error_out) {
     JsonParser parser(json_str);
     return parser.parse(error_out);
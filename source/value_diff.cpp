@@ -3,33 +3,720 @@
 #include <lager_ext/path_utils.h>
 #include <lager_ext/value_diff.h>
 
+#include "diff_walk.h"
+
 #include <immer/algorithm.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 namespace lager_ext {
 
 // ============================================================
-// DiffEntryCollector Implementation
+// Diff Traversal Core
+// ============================================================
+// The cost of a diff is proportional to what changed, not to the size of the
+// trees: every container is compared by identity before it is opened.
+//   - boxes (maps, vectors, arrays, tables, strings, matrices) that share storage are equal
+//   - maps and tables are walked with immer::diff, which skips HAMT nodes both share
+//   - vectors are walked node by node, skipping RRB subtrees both vectors share
+// Only the entries that are left are compared, and only containers recurse.
 // ============================================================
 
-void DiffEntryCollector::diff(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive) {
-    diffs_.clear();
-    recursive_ = recursive;
+namespace {
+
+using detail::aligned_roots;
+using detail::SameStorage;
+using detail::vector_node;
+using detail::VECTOR_B;
+using detail::VECTOR_BL;
+
+// ============================================================
+// DiffWorkers - Worker threads for one parallel diff_values call
+//
+// Same scheme as the parallel FastSharedValue copy: threads start on the
+// first container large enough to split and are reused for the rest;
+// every participant (the caller included) claims the next task with a
+// fetch_add, so uneven subtrees balance out.
+// ============================================================
+
+class DiffWorkers {
+public:
+    using Job = std::function<void(std::size_t)>;
+
+    explicit DiffWorkers(std::size_t num_threads) : num_threads_(num_threads) {}
+
+    ~DiffWorkers() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    DiffWorkers(const DiffWorkers&) = delete;
+    DiffWorkers& operator=(const DiffWorkers&) = delete;
+
+    /// Run job(i) for every i in [0, count) on all participants
+    /// @throws The first exception thrown by any job
+    void for_each(std::size_t count, const Job& job) {
+        if (threads_.empty()) [[unlikely]] {
+            start_threads();
+        }
+        {
+            std::lock_guard lock(mutex_);
+            job_ = &job;
+            job_count_ = count;
+            next_.store(0, std::memory_order_relaxed);
+            busy_ = threads_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        run_jobs();
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        job_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+private:
+    void start_threads() {
+        threads_.reserve(num_threads_ - 1);
+        for (std::size_t i = 1; i < num_threads_; ++i) {
+            threads_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    void worker_loop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+            }
+            run_jobs();
+            {
+                std::lock_guard lock(mutex_);
+                --busy_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    void run_jobs() {
+        try {
+            for (;;) {
+                const std::size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+                if (i >= job_count_)
+                    break;
+                (*job_)(i);
+            }
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!error_)
+                error_ = std::current_exception();
+            next_.store(job_count_, std::memory_order_relaxed); // Make the others stop early
+        }
+    }
+
+    std::size_t num_threads_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;
+    std::size_t busy_ = 0;
+    bool stop_ = false;
+    const Job* job_ = nullptr;
+    std::size_t job_count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr error_;
+};
+
+/// Buffers one task's callbacks so they can be replayed on the calling
+/// thread in task order. Values are referenced, not copied: they live in the
+/// two trees being diffed. Path elements are copied (string_views into keys).
+class RecordingSink final : public DiffSink {
+public:
+    void on_add(PathView path, const ImmerValue& value) override { record(Op::Add, path, &value, nullptr); }
+    void on_remove(PathView path, const ImmerValue& value) override { record(Op::Remove, path, &value, nullptr); }
+    void on_change(PathView path, const ImmerValue& old_value, const ImmerValue& new_value) override {
+        record(Op::Change, path, &old_value, &new_value);
+    }
+    void enter(PathView path) override { record(Op::Enter, path, nullptr, nullptr); }
+    void leave(PathView path) override { record(Op::Leave, path, nullptr, nullptr); }
+
+    void replay(DiffSink& sink) const {
+        for (const auto& e : events_) {
+            const PathView path{paths_.data() + e.path_begin, e.path_size};
+            switch (e.op) {
+            case Op::Add:
+                sink.on_add(path, *e.first);
+                break;
+            case Op::Remove:
+                sink.on_remove(path, *e.first);
+                break;
+            case Op::Change:
+                sink.on_change(path, *e.first, *e.second);
+                break;
+            case Op::Enter:
+                sink.enter(path);
+                break;
+            case Op::Leave:
+                sink.leave(path);
+                break;
+            }
+        }
+    }
+
+private:
+    enum class Op : uint8_t { Add, Remove, Change, Enter, Leave };
+
+    struct Event {
+        Op op;
+        std::size_t path_begin;
+        std::size_t path_size;
+        const ImmerValue* first;
+        const ImmerValue* second;
+    };
+
+    void record(Op op, PathView path, const ImmerValue* first, const ImmerValue* second) {
+        events_.push_back({op, paths_.size(), path.size(), first, second});
+        paths_.insert(paths_.end(), path.begin(), path.end());
+    }
+
+    std::vector<Event> events_;
+    std::vector<PathElement> paths_;
+};
+
+/// Children per task when a large sequence (or an added/removed container) is split
+constexpr std::size_t PARALLEL_DIFF_CHUNK = 1024;
+
+class DiffWalker {
+public:
+    /// @param workers Non-null to split large containers across threads (calling thread only)
+    DiffWalker(DiffSink& sink, const DiffOptions& options, DiffWorkers* workers = nullptr, PathView prefix = {})
+        : sink_(sink), options_(options), recursive_(options.recursive),
+          expand_(options.recursive && options.expand_subtrees), workers_(workers) {
+        path_stack_.reserve(std::max<std::size_t>(16, prefix.size() + 1));
+        path_stack_.assign(prefix.begin(), prefix.end());
+    }
+
+    void diff(const ImmerValue& old_val, const ImmerValue& new_val, std::size_t depth) {
+        if (old_val.data.index() != new_val.data.index()) [[unlikely]] {
+            sink_.on_change(path(depth), old_val, new_val);
+            return;
+        }
+
+        std::visit(
+            [&](const auto& old_arg) {
+                using T = std::decay_t<decltype(old_arg)>;
+                const T& new_arg = *std::get_if<T>(&new_val.data);
+
+                if constexpr (std::is_same_v<T, std::monostate>) {
+                    // Both null
+                } else if constexpr (is_container<T>) {
+                    if (old_arg.impl() == new_arg.impl() || same_structure(old_arg.get(), new_arg.get())) [[likely]] {
+                        return;
+                    }
+                    if (options_.prune_by_hash && content_hash(old_val) == content_hash(new_val)) {
+                        return;
+                    }
+                    if (!recursive_) {
+                        sink_.on_change(path(depth), old_val, new_val);
+                        return;
+                    }
+                    reserve_level(depth);
+                    sink_.enter(path(depth));
+                    if (!split(old_arg.get(), new_arg.get(), depth)) {
+                        diff_container(old_arg.get(), new_arg.get(), depth);
+                    }
+                    sink_.leave(path(depth));
+                } else if (!(old_arg == new_arg)) {
+                    // Scalars, strings and matrices (box operator== checks identity first)
+                    sink_.on_change(path(depth), old_val, new_val);
+                }
+            },
+            old_val.data);
+    }
+
+private:
+    using Task = std::function<void(DiffWalker&)>;
+
+    template <typename T>
+    static constexpr bool is_container = std::is_same_v<T, BoxedValueMap> || std::is_same_v<T, BoxedValueVector> ||
+                                         std::is_same_v<T, BoxedValueArray> || std::is_same_v<T, BoxedValueTable>;
+
+    /// Two boxes around the same immer structure (e.g. rebuilt from the same
+    /// map, or two empty containers) - equal without opening them
+    static bool same_structure(const ValueMap& a, const ValueMap& b) { return a.impl().root == b.impl().root; }
+    static bool same_structure(const ValueTable& a, const ValueTable& b) { return a.impl().root == b.impl().root; }
+    static bool same_structure(const ValueVector& a, const ValueVector& b) {
+        return a.impl().root == b.impl().root && a.impl().tail == b.impl().tail && a.size() == b.size();
+    }
+    static bool same_structure(const ValueArray& a, const ValueArray& b) {
+        return a.data() == b.data() && a.size() == b.size();
+    }
+
+    // --------------------------------------------------------
+    // Serial walk
+    // --------------------------------------------------------
+
+    /// The entry types must match the stored ones exactly: a converting
+    /// parameter (e.g. pair<const string, ...>) would bind to a copy
+    auto keyed_differ(const ValueMap&, std::size_t depth) {
+        return immer::make_differ(
+            [this, depth](const ValueMap::value_type& added) {
+                path_stack_[depth] = std::string_view{added.first};
+                report(added.second, depth + 1, DiffEntry::Type::Add);
+            },
+            [this, depth](const ValueMap::value_type& removed) {
+                path_stack_[depth] = std::string_view{removed.first};
+                report(removed.second, depth + 1, DiffEntry::Type::Remove);
+            },
+            [this, depth](const ValueMap::value_type& old_kv, const ValueMap::value_type& new_kv) {
+                path_stack_[depth] = std::string_view{old_kv.first};
+                diff(old_kv.second, new_kv.second, depth + 1);
+            });
+    }
+
+    auto keyed_differ(const ValueTable&, std::size_t depth) {
+        return immer::make_differ(
+            [this, depth](const TableEntry& added) {
+                path_stack_[depth] = std::string_view{added.id};
+                report(*added.value, depth + 1, DiffEntry::Type::Add);
+            },
+            [this, depth](const TableEntry& removed) {
+                path_stack_[depth] = std::string_view{removed.id};
+                report(*removed.value, depth + 1, DiffEntry::Type::Remove);
+            },
+            [this, depth](const TableEntry& old_entry, const TableEntry& new_entry) {
+                path_stack_[depth] = std::string_view{old_entry.id};
+                diff(*old_entry.value, *new_entry.value, depth + 1);
+            });
+    }
+
+    template <typename Keyed>
+        requires std::is_same_v<Keyed, ValueMap> || std::is_same_v<Keyed, ValueTable>
+    void diff_container(const Keyed& old_keyed, const Keyed& new_keyed, std::size_t depth) {
+        auto differ = keyed_differ(old_keyed, depth);
+        old_keyed.impl().template diff<SameStorage>(new_keyed.impl(), differ);
+    }
+
+    auto element_differ(std::size_t depth) {
+        return [this, depth](std::size_t index, const ImmerValue& old_elem, const ImmerValue& new_elem) {
+            path_stack_[depth] = index;
+            diff(old_elem, new_elem, depth + 1);
+        };
+    }
+
+    void diff_container(const ValueVector& old_vec, const ValueVector& new_vec, std::size_t depth) {
+        const std::size_t common = std::min(old_vec.size(), new_vec.size());
+        detail::for_each_unshared_element(old_vec, new_vec, element_differ(depth));
+        report_range(new_vec, common, new_vec.size(), depth, DiffEntry::Type::Add);
+        report_range(old_vec, common, old_vec.size(), depth, DiffEntry::Type::Remove);
+    }
+
+    /// Diff indices [first, end) under two inner nodes at the same shift
+    void diff_vector_node(const vector_node* old_node, const vector_node* new_node, unsigned shift,
+                          std::size_t first, std::size_t end, std::size_t depth) {
+        detail::for_each_unshared_element(old_node, new_node, shift, first, end, element_differ(depth));
+    }
+
+    void diff_container(const ValueArray& old_arr, const ValueArray& new_arr, std::size_t depth) {
+        const std::size_t common = std::min(old_arr.size(), new_arr.size());
+        diff_range(old_arr, new_arr, 0, common, depth);
+        report_range(new_arr, common, new_arr.size(), depth, DiffEntry::Type::Add);
+        report_range(old_arr, common, old_arr.size(), depth, DiffEntry::Type::Remove);
+    }
+
+    /// Elementwise diff of indices [first, end) present in both sequences
+    template <typename Seq>
+    void diff_range(const Seq& old_seq, const Seq& new_seq, std::size_t first, std::size_t end, std::size_t depth) {
+        for (std::size_t i = first; i < end; ++i) {
+            const ImmerValue& old_child = old_seq[i];
+            const ImmerValue& new_child = new_seq[i];
+            if (&old_child != &new_child) {
+                path_stack_[depth] = i;
+                diff(old_child, new_child, depth + 1);
+            }
+        }
+    }
+
+    /// Report indices [first, end) of a sequence as added or removed
+    template <typename Seq>
+    void report_range(const Seq& seq, std::size_t first, std::size_t end, std::size_t depth, DiffEntry::Type type) {
+        for (std::size_t i = first; i < end; ++i) {
+            path_stack_[depth] = i;
+            report(seq[i], depth + 1, type);
+        }
+    }
+
+    /// Report a value that exists on one side only, leaf by leaf when expanding
+    void report(const ImmerValue& val, std::size_t depth, DiffEntry::Type type) {
+        if (!expand_) {
+            emit(val, depth, type);
+            return;
+        }
+        std::visit(
+            [&](const auto& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, std::monostate>) {
+                    // Null leaves are not reported
+                } else if constexpr (is_container<T>) {
+                    const auto& container = arg.get();
+                    if (container.empty()) {
+                        emit(val, depth, type);
+                        return;
+                    }
+                    reserve_level(depth);
+                    sink_.enter(path(depth));
+                    if (!split_report(container, depth, type)) {
+                        report_children(container, depth, type);
+                    }
+                    sink_.leave(path(depth));
+                } else {
+                    emit(val, depth, type);
+                }
+            },
+            val.data);
+    }
+
+    void report_children(const ValueMap& map, std::size_t depth, DiffEntry::Type type) {
+        for (const auto& [key, child] : map) {
+            path_stack_[depth] = std::string_view{key};
+            report(child, depth + 1, type);
+        }
+    }
+
+    void report_children(const ValueTable& table, std::size_t depth, DiffEntry::Type type) {
+        for (const auto& entry : table) {
+            path_stack_[depth] = std::string_view{entry.id};
+            report(*entry.value, depth + 1, type);
+        }
+    }
+
+    template <typename Seq>
+    void report_children(const Seq& seq, std::size_t depth, DiffEntry::Type type) {
+        report_range(seq, 0, seq.size(), depth, type);
+    }
+
+    void emit(const ImmerValue& val, std::size_t depth, DiffEntry::Type type) {
+        if (type == DiffEntry::Type::Add) {
+            sink_.on_add(path(depth), val);
+        } else {
+            sink_.on_remove(path(depth), val);
+        }
+    }
+
+    // --------------------------------------------------------
+    // Parallel split (calling thread only)
+    //
+    // A large container is cut into tasks that cover its children in the
+    // order the serial walk visits them. Each task runs on its own walker
+    // into a RecordingSink; the recordings are replayed in task order, so
+    // the sink sees exactly the serial sequence of callbacks.
+    //
+    // Tasks only read the trees and never copy a value: immer refcounts are
+    // not atomic (IMMER_NO_THREAD_SAFETY), so copies happen at replay.
+    // --------------------------------------------------------
+
+    [[nodiscard]] bool splittable(std::size_t old_size, std::size_t new_size) const {
+        return workers_ && std::max(old_size, new_size) >= PARALLEL_DIFF_MIN_ELEMENTS;
+    }
+
+    /// Split per root HAMT bucket, in the order champ::diff visits them:
+    /// buckets only in new, buckets only in old, then buckets in both
+    template <typename Keyed>
+        requires std::is_same_v<Keyed, ValueMap> || std::is_same_v<Keyed, ValueTable>
+    bool split(const Keyed& old_keyed, const Keyed& new_keyed, std::size_t depth) {
+        if (!splittable(old_keyed.size(), new_keyed.size())) {
+            return false;
+        }
+        const auto& champ = old_keyed.impl();
+        const auto* old_root = champ.root;
+        const auto* new_root = new_keyed.impl().root;
+        using bitmap_t = std::decay_t<decltype(old_root->nodemap())>;
+
+        const bitmap_t old_nodemap = old_root->nodemap();
+        const bitmap_t new_nodemap = new_root->nodemap();
+        const bitmap_t old_datamap = old_root->datamap();
+        const bitmap_t new_datamap = new_root->datamap();
+        const bitmap_t old_bits = old_nodemap | old_datamap;
+        const bitmap_t new_bits = new_nodemap | new_datamap;
+        const bitmap_t changes = old_bits ^ new_bits;
+
+        auto for_each_bit = [](bitmap_t bits, auto&& fn) {
+            for (; bits != 0; bits &= bits - 1) {
+                fn(static_cast<bitmap_t>(bits & (~bits + 1)));
+            }
+        };
+
+        std::vector<Task> tasks;
+        // Buckets only on one side: every entry below them is added or removed
+        auto one_side = [&](const auto* root, bitmap_t nodemap, DiffEntry::Type type) {
+            return [&champ, &old_keyed, root, nodemap, type, depth](bitmap_t bit) {
+                return [&champ, &old_keyed, root, nodemap, type, depth, bit](DiffWalker& w) {
+                    auto differ = w.keyed_differ(old_keyed, depth);
+                    auto emit = [&](const auto& entry) {
+                        type == DiffEntry::Type::Add ? differ.added(entry) : differ.removed(entry);
+                    };
+                    if (nodemap & bit) {
+                        champ.for_each_chunk_traversal(root->children()[root->children_count(bit)], 1,
+                                                       [&](auto begin, auto end) {
+                                                           for (auto it = begin; it != end; ++it) {
+                                                               emit(*it);
+                                                           }
+                                                       });
+                    } else {
+                        emit(root->values()[root->data_count(bit)]);
+                    }
+                };
+            };
+        };
+        auto added_task = one_side(new_root, new_nodemap, DiffEntry::Type::Add);
+        auto removed_task = one_side(old_root, old_nodemap, DiffEntry::Type::Remove);
+        for_each_bit(new_bits & changes, [&](bitmap_t bit) { tasks.push_back(added_task(bit)); });
+        for_each_bit(old_bits & changes, [&](bitmap_t bit) { tasks.push_back(removed_task(bit)); });
+
+        for_each_bit(old_bits & new_bits, [&](bitmap_t bit) {
+            const bool old_node = old_nodemap & bit;
+            const bool new_node = new_nodemap & bit;
+            if (old_node && new_node &&
+                old_root->children()[old_root->children_count(bit)] ==
+                    new_root->children()[new_root->children_count(bit)]) {
+                return; // Shared bucket
+            }
+            tasks.push_back([&champ, &old_keyed, old_root, new_root, old_node, new_node, depth, bit](DiffWalker& w) {
+                auto differ = w.keyed_differ(old_keyed, depth);
+                if (old_node && new_node) {
+                    champ.template diff<SameStorage>(old_root->children()[old_root->children_count(bit)],
+                                                     new_root->children()[new_root->children_count(bit)], 1, differ);
+                } else if (new_node) {
+                    champ.template diff_data_node<SameStorage>(old_root, new_root, bit, 0, differ);
+                } else if (old_node) {
+                    champ.template diff_node_data<SameStorage>(old_root, new_root, bit, 0, differ);
+                } else {
+                    champ.template diff_data_data<SameStorage>(old_root, new_root, bit, differ);
+                }
+            });
+        });
+
+        run_tasks(tasks, depth);
+        return true;
+    }
+
+    /// Split per child of the aligned RRB roots, then the part past the first
+    /// tail, then added and removed tails in chunks
+    bool split(const ValueVector& old_vec, const ValueVector& new_vec, std::size_t depth) {
+        if (!splittable(old_vec.size(), new_vec.size())) {
+            return false;
+        }
+        const std::size_t common = std::min(old_vec.size(), new_vec.size());
+        const std::size_t tree_end = std::min(old_vec.impl().tail_offset(), new_vec.impl().tail_offset());
+
+        std::vector<Task> tasks;
+        if (tree_end > 0) {
+            auto [old_root, new_root, shift] = aligned_roots(old_vec, new_vec);
+            if (shift == VECTOR_BL) {
+                tasks.push_back([=](DiffWalker& w) { w.diff_vector_node(old_root, new_root, shift, 0, tree_end, depth); });
+            } else if (old_root != new_root) {
+                // One task per root child: diff_vector_node on a single-child range
+                const std::size_t child_span = std::size_t{1} << shift;
+                auto** old_children = const_cast<vector_node*>(old_root)->inner();
+                auto** new_children = const_cast<vector_node*>(new_root)->inner();
+                for (std::size_t c = 0; c < (std::size_t{1} << VECTOR_B) && c * child_span < tree_end; ++c) {
+                    const vector_node* old_child = old_children[c];
+                    const vector_node* new_child = new_children[c];
+                    if (old_child == new_child) {
+                        continue;
+                    }
+                    const std::size_t end = std::min(tree_end, (c + 1) * child_span);
+                    tasks.push_back([=](DiffWalker& w) {
+                        w.diff_vector_node(old_child, new_child, shift - VECTOR_B, c * child_span, end, depth);
+                    });
+                }
+            }
+        }
+        tasks.push_back([&old_vec, &new_vec, tree_end, common, depth](DiffWalker& w) {
+            w.diff_range(old_vec, new_vec, tree_end, common, depth);
+        });
+        add_report_chunks(tasks, new_vec, common, depth, DiffEntry::Type::Add);
+        add_report_chunks(tasks, old_vec, common, depth, DiffEntry::Type::Remove);
+
+        run_tasks(tasks, depth);
+        return true;
+    }
+
+    bool split(const ValueArray& old_arr, const ValueArray& new_arr, std::size_t depth) {
+        if (!splittable(old_arr.size(), new_arr.size())) {
+            return false;
+        }
+        const std::size_t common = std::min(old_arr.size(), new_arr.size());
+        std::vector<Task> tasks;
+        for (std::size_t first = 0; first < common; first += PARALLEL_DIFF_CHUNK) {
+            const std::size_t end = std::min(common, first + PARALLEL_DIFF_CHUNK);
+            tasks.push_back([&old_arr, &new_arr, first, end, depth](DiffWalker& w) {
+                w.diff_range(old_arr, new_arr, first, end, depth);
+            });
+        }
+        add_report_chunks(tasks, new_arr, common, depth, DiffEntry::Type::Add);
+        add_report_chunks(tasks, old_arr, common, depth, DiffEntry::Type::Remove);
+
+        run_tasks(tasks, depth);
+        return true;
+    }
+
+    template <typename Seq>
+    void add_report_chunks(std::vector<Task>& tasks, const Seq& seq, std::size_t first, std::size_t depth,
+                           DiffEntry::Type type) {
+        for (; first < seq.size(); first += PARALLEL_DIFF_CHUNK) {
+            const std::size_t end = std::min(seq.size(), first + PARALLEL_DIFF_CHUNK);
+            tasks.push_back([&seq, first, end, depth, type](DiffWalker& w) { w.report_range(seq, first, end, depth, type); });
+        }
+    }
+
+    /// Expanding a large added/removed container: chunks of its children in iteration order
+    template <typename Container>
+    bool split_report(const Container& container, std::size_t depth, DiffEntry::Type type) {
+        if (!splittable(container.size(), 0)) {
+            return false;
+        }
+        std::vector<Task> tasks;
+        if constexpr (std::is_same_v<Container, ValueVector> || std::is_same_v<Container, ValueArray>) {
+            add_report_chunks(tasks, container, 0, depth, type);
+        } else {
+            // Hash containers have no index: collect the children once, in iteration order
+            auto children = std::make_shared<std::vector<std::pair<std::string_view, const ImmerValue*>>>();
+            children->reserve(container.size());
+            for (const auto& entry : container) {
+                if constexpr (std::is_same_v<Container, ValueMap>) {
+                    children->emplace_back(entry.first, &entry.second);
+                } else {
+                    children->emplace_back(entry.id, &*entry.value);
+                }
+            }
+            for (std::size_t first = 0; first < children->size(); first += PARALLEL_DIFF_CHUNK) {
+                const std::size_t end = std::min(children->size(), first + PARALLEL_DIFF_CHUNK);
+                tasks.push_back([children, first, end, depth, type](DiffWalker& w) {
+                    for (std::size_t i = first; i < end; ++i) {
+                        w.path_stack_[depth] = (*children)[i].first;
+                        w.report(*(*children)[i].second, depth + 1, type);
+                    }
+                });
+            }
+        }
+        run_tasks(tasks, depth);
+        return true;
+    }
+
+    /// Run tasks on the workers, each on a walker that starts at path(depth),
+    /// then replay their recordings into sink_ in task order
+    void run_tasks(const std::vector<Task>& tasks, std::size_t depth) {
+        std::vector<RecordingSink> recordings(tasks.size());
+        const PathView prefix = path(depth);
+        workers_->for_each(tasks.size(), [&](std::size_t i) {
+            DiffWalker walker(recordings[i], options_, nullptr, prefix);
+            walker.reserve_level(depth);
+            tasks[i](walker);
+        });
+        for (const auto& recording : recordings) {
+            recording.replay(sink_);
+        }
+    }
+
+    void reserve_level(std::size_t depth) {
+        if (path_stack_.size() <= depth) {
+            path_stack_.resize(depth + 1);
+        }
+    }
+
+    [[nodiscard]] PathView path(std::size_t depth) const noexcept { return PathView{path_stack_.data(), depth}; }
+
+    DiffSink& sink_;
+    const DiffOptions& options_;
+    bool recursive_;
+    bool expand_;
+    DiffWorkers* workers_;
+    std::vector<PathElement> path_stack_;
+};
 
-    // Fast path: if both Values share the same variant storage, no changes
-    // This handles the case where the same ImmerValue object is compared to itself
+} // namespace
+
+void diff_values(const ImmerValue& old_val, const ImmerValue& new_val, DiffSink& sink, const DiffOptions& options) {
+    // Fast path: the same ImmerValue object compared to itself
     if (&old_val.data == &new_val.data) {
         return;
     }
+    std::size_t num_threads = options.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (num_threads == 1) {
+        DiffWalker(sink, options).diff(old_val, new_val, 0);
+        return;
+    }
+    // Threads only start if some container is large enough to split
+    DiffWorkers workers(num_threads);
+    DiffWalker(sink, options, &workers).diff(old_val, new_val, 0);
+}
+
+// ============================================================
+// DiffEntryCollector Implementation
+// ============================================================
+
+namespace {
+
+class EntrySink final : public DiffSink {
+public:
+    explicit EntrySink(std::vector<DiffEntry>& diffs) : diffs_(diffs) {}
+
+    void on_add(PathView path, const ImmerValue& value) override {
+        diffs_.emplace_back(DiffEntry::Type::Add, Path{path}, value, value);
+    }
+    void on_remove(PathView path, const ImmerValue& value) override {
+        diffs_.emplace_back(DiffEntry::Type::Remove, Path{path}, value, value);
+    }
+    void on_change(PathView path, const ImmerValue& old_value, const ImmerValue& new_value) override {
+        diffs_.emplace_back(DiffEntry::Type::Change, Path{path}, old_value, new_value);
+    }
+
+private:
+    std::vector<DiffEntry>& diffs_;
+};
+
+} // namespace
+
+void DiffEntryCollector::diff(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive,
+                              std::size_t num_threads) {
+    diffs_.clear();
+    recursive_ = recursive;
 
     // Pre-allocate to reduce reallocations during diff collection
     diffs_.reserve(32);
 
-    // OPTIMIZATION: Use path stack instead of Path object for better performance
-    path_stack_.clear();
-    path_stack_.reserve(16); // Pre-allocate for typical nesting depth
-    diff_value_optimized(old_val, new_val, 0);
+    EntrySink sink(diffs_);
+    diff_values(old_val, new_val, sink,
+                DiffOptions{.recursive = recursive, .expand_subtrees = true, .num_threads = num_threads});
 
     // Shrink to fit if we over-allocated significantly
     if (diffs_.size() > 0 && diffs_.capacity() > diffs_.size() * 2) {
@@ -79,185 +766,6 @@ void DiffEntryCollector::print_diffs() const {
     }
 }
 
-// ============================================================
-// Optimized Path Stack Implementation
-// These methods use the path_stack_ member for zero-allocation path building
-// ============================================================
-
-void DiffEntryCollector::diff_value_optimized(const ImmerValue& old_val, const ImmerValue& new_val, std::size_t path_depth) {
-    const auto old_index = old_val.data.index();
-    const auto new_index = new_val.data.index();
-    if (old_index != new_index) [[unlikely]] {
-        Path current_path(current_path_view(path_depth));
-        diffs_.emplace_back(DiffEntry::Type::Change, std::move(current_path), old_val, new_val);
-        return;
-    }
-
-    std::visit(
-        [&](const auto& old_arg) {
-            using T = std::decay_t<decltype(old_arg)>;
-
-            // Container Boxing: variant now holds BoxedValueMap, BoxedValueVector, etc.
-            if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                const auto& new_boxed = std::get<BoxedValueMap>(new_val.data);
-                // OPTIMIZATION: box identity check - O(1)
-                if (old_arg.get().impl().root == new_boxed.get().impl().root &&
-                    old_arg.get().impl().size == new_boxed.get().impl().size) [[likely]] {
-                    return;
-                }
-                // Shallow mode: report container change without recursing
-                if (!recursive_) {
-                    Path current_path(current_path_view(path_depth));
-                    diffs_.emplace_back(DiffEntry::Type::Change, std::move(current_path), old_val, new_val);
-                    return;
-                }
-                diff_map_optimized(old_arg.get(), new_boxed.get(), path_depth);
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                const auto& new_boxed = std::get<BoxedValueVector>(new_val.data);
-                // OPTIMIZATION: box identity check - O(1)
-                if (old_arg.get().impl().root == new_boxed.get().impl().root &&
-                    old_arg.get().impl().tail == new_boxed.get().impl().tail &&
-                    old_arg.get().impl().size == new_boxed.get().impl().size) [[likely]] {
-                    return;
-                }
-                // Shallow mode: report container change without recursing
-                if (!recursive_) {
-                    Path current_path(current_path_view(path_depth));
-                    diffs_.emplace_back(DiffEntry::Type::Change, std::move(current_path), old_val, new_val);
-                    return;
-                }
-                diff_vector_optimized(old_arg.get(), new_boxed.get(), path_depth);
-            } else if constexpr (std::is_same_v<T, std::monostate>) {
-                // Both null, no change
-            } else {
-                // Primitive types and BoxedString: direct comparison (already verified same type)
-                const auto& new_arg = std::get<T>(new_val.data);
-                if (old_arg != new_arg) {
-                    Path current_path(current_path_view(path_depth));
-                    diffs_.emplace_back(DiffEntry::Type::Change, std::move(current_path), old_val, new_val);
-                }
-            }
-        },
-        old_val.data);
-}
-
-void DiffEntryCollector::diff_map_optimized(const ValueMap& old_map, const ValueMap& new_map, std::size_t path_depth) {
-    // Ensure path stack has enough capacity
-    if (path_stack_.size() <= path_depth) {
-        path_stack_.resize(path_depth + 1);
-    }
-
-    // Container Boxing: ValueMap now stores ImmerValue directly, not ValueBox
-    auto map_differ = immer::make_differ(
-        // added
-        [&](const std::pair<const std::string, ImmerValue>& added_kv) {
-            path_stack_[path_depth] = PathElement{added_kv.first};
-            collect_added_optimized(added_kv.second, path_depth + 1);
-        },
-        // removed
-        [&](const std::pair<const std::string, ImmerValue>& removed_kv) {
-            path_stack_[path_depth] = PathElement{removed_kv.first};
-            collect_removed_optimized(removed_kv.second, path_depth + 1);
-        },
-        // changed (retained key)
-        [&](const std::pair<const std::string, ImmerValue>& old_kv,
-            const std::pair<const std::string, ImmerValue>& new_kv) {
-            path_stack_[path_depth] = PathElement{old_kv.first};
-            diff_value_optimized(old_kv.second, new_kv.second, path_depth + 1);
-        });
-
-    immer::diff(old_map, new_map, map_differ);
-}
-
-void DiffEntryCollector::diff_vector_optimized(const ValueVector& old_vec, const ValueVector& new_vec,
-                                               std::size_t path_depth) {
-    const size_t old_size = old_vec.size();
-    const size_t new_size = new_vec.size();
-    const size_t common_size = std::min(old_size, new_size);
-
-    // Ensure path stack has enough capacity
-    if (path_stack_.size() <= path_depth) {
-        path_stack_.resize(path_depth + 1);
-    }
-
-    // Container Boxing: ValueVector now stores ImmerValue directly, not ValueBox
-    for (size_t i = 0; i < common_size; ++i) {
-        const ImmerValue& old_val = old_vec[i];
-        const ImmerValue& new_val = new_vec[i];
-
-        path_stack_[path_depth] = PathElement{i};
-        diff_value_optimized(old_val, new_val, path_depth + 1);
-    }
-
-    // Removed tail elements
-    for (size_t i = common_size; i < old_size; ++i) {
-        path_stack_[path_depth] = PathElement{i};
-        collect_removed_optimized(old_vec[i], path_depth + 1);
-    }
-
-    // Added tail elements
-    for (size_t i = common_size; i < new_size; ++i) {
-        path_stack_[path_depth] = PathElement{i};
-        collect_added_optimized(new_vec[i], path_depth + 1);
-    }
-}
-
-void DiffEntryCollector::collect_entries_optimized(const ImmerValue& val, std::size_t path_depth, bool is_add) {
-    // In shallow mode, just record the value at current path (no recursion)
-    if (!recursive_) {
-        Path current_path(current_path_view(path_depth));
-        if (is_add) {
-            diffs_.emplace_back(DiffEntry::Type::Add, std::move(current_path), val, val);
-        } else {
-            diffs_.emplace_back(DiffEntry::Type::Remove, std::move(current_path), val, val);
-        }
-        return;
-    }
-
-    // Recursive mode: descend into containers
-    // Container Boxing: variant now holds BoxedValueMap, BoxedValueVector, etc.
-    std::visit(
-        [&](const auto& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                // Ensure path stack has enough capacity for next level
-                if (path_stack_.size() <= path_depth) {
-                    path_stack_.resize(path_depth + 1);
-                }
-                // Container Boxing: map now stores ImmerValue directly
-                for (const auto& [k, v] : arg.get()) {
-                    path_stack_[path_depth] = PathElement{k};
-                    collect_entries_optimized(v, path_depth + 1, is_add);
-                }
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                // Ensure path stack has enough capacity for next level
-                if (path_stack_.size() <= path_depth) {
-                    path_stack_.resize(path_depth + 1);
-                }
-                // Container Boxing: vector now stores ImmerValue directly
-                const auto& vec = arg.get();
-                for (size_t i = 0; i < vec.size(); ++i) {
-                    path_stack_[path_depth] = PathElement{i};
-                    collect_entries_optimized(vec[i], path_depth + 1, is_add);
-                }
-            } else if constexpr (!std::is_same_v<T, std::monostate>) {
-                // Leaf value: record it - both fields reference the same value
-                Path current_path(current_path_view(path_depth));
-                diffs_.emplace_back(is_add ? DiffEntry::Type::Add : DiffEntry::Type::Remove, std::move(current_path),
-                                    val, val);
-            }
-        },
-        val.data);
-}
-
-void DiffEntryCollector::collect_removed_optimized(const ImmerValue& val, std::size_t path_depth) {
-    collect_entries_optimized(val, path_depth, false);
-}
-
-void DiffEntryCollector::collect_added_optimized(const ImmerValue& val, std::size_t path_depth) {
-    collect_entries_optimized(val, path_depth, true);
-}
-
 ImmerValue DiffEntryCollector::as_value_tree() const {
     if (diffs_.empty()) {
         return ImmerValue{}; // Empty tree for no changes
@@ -285,125 +793,32 @@ ImmerValue DiffEntryCollector::as_value_tree() const {
     return tree;
 }
 
-bool has_any_difference(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive) {
-    // Fast path: same object
-    if (&old_val.data == &new_val.data) {
-        return false;
-    }
-    return detail::values_differ(old_val, new_val, recursive);
-}
-
-namespace detail {
-
-bool values_differ(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive) {
-    // Fast path: different types
-    const auto old_index = old_val.data.index();
-    const auto new_index = new_val.data.index();
-    if (old_index != new_index) [[unlikely]] {
-        return true;
-    }
-
-    // Container Boxing: variant now holds BoxedValueMap, BoxedValueVector, etc.
-    return std::visit(
-        [&](const auto& old_arg) -> bool {
-            using T = std::decay_t<decltype(old_arg)>;
-
-            if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                const auto& new_boxed = std::get<BoxedValueMap>(new_val.data);
-                const auto& old_map = old_arg.get();
-                const auto& new_map = new_boxed.get();
-                // O(1) identity check
-                if (old_map.impl().root == new_map.impl().root && old_map.impl().size == new_map.impl().size)
-                    [[likely]] {
-                    return false;
-                }
-                // Shallow mode: identity check failed, containers are different
-                if (!recursive) {
-                    return true;
-                }
-                return maps_differ(old_map, new_map, recursive);
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                const auto& new_boxed = std::get<BoxedValueVector>(new_val.data);
-                const auto& old_vec = old_arg.get();
-                const auto& new_vec = new_boxed.get();
-                // O(1) identity check
-                if (old_vec.impl().root == new_vec.impl().root && old_vec.impl().tail == new_vec.impl().tail &&
-                    old_vec.impl().size == new_vec.impl().size) [[likely]] {
-                    return false;
-                }
-                // Shallow mode: identity check failed, containers are different
-                if (!recursive) {
-                    return true;
-                }
-                return vectors_differ(old_vec, new_vec, recursive);
-            } else if constexpr (std::is_same_v<T, std::monostate>) {
-                return false; // Both null
-            } else {
-                // Primitive types: direct comparison
-                const auto& new_arg = std::get<T>(new_val.data);
-                return old_arg != new_arg;
-            }
-        },
-        old_val.data);
-}
-
-bool maps_differ(const ValueMap& old_map, const ValueMap& new_map, bool recursive) {
-    // Quick size check
-    if (old_map.size() != new_map.size()) {
-        return true;
-    }
+namespace {
 
-    // Use immer::diff with early exit
-    // Container Boxing: ValueMap now stores ImmerValue directly, not ValueBox
-    bool found_difference = false;
-
-    auto differ = immer::make_differ(
-        // added - any addition means difference
-        [&](const std::pair<const std::string, ImmerValue>&) { found_difference = true; },
-        // removed - any removal means difference
-        [&](const std::pair<const std::string, ImmerValue>&) { found_difference = true; },
-        // retained - check if values differ
-        [&](const std::pair<const std::string, ImmerValue>& old_kv,
-            const std::pair<const std::string, ImmerValue>& new_kv) {
-            if (found_difference)
-                return; // Already found, skip
-
-            // Recurse
-            if (values_differ(old_kv.second, new_kv.second, recursive)) {
-                found_difference = true;
-            }
-        });
+/// Thrown by AnyDifferenceSink to unwind diff_values() at the first difference
+/// (immer::diff has no way to stop a walk from inside a callback)
+struct FirstDifference {};
 
-    immer::diff(old_map, new_map, differ);
-    return found_difference;
-}
+class AnyDifferenceSink final : public DiffSink {
+public:
+    void on_add(PathView, const ImmerValue&) override { throw FirstDifference{}; }
+    void on_remove(PathView, const ImmerValue&) override { throw FirstDifference{}; }
+    void on_change(PathView, const ImmerValue&, const ImmerValue&) override { throw FirstDifference{}; }
+};
 
-bool vectors_differ(const ValueVector& old_vec, const ValueVector& new_vec, bool recursive) {
-    const size_t old_size = old_vec.size();
-    const size_t new_size = new_vec.size();
+} // namespace
 
-    // Size difference means there's a change
-    if (old_size != new_size) {
+bool has_any_difference(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive) {
+    // Not expanded: an added or removed subtree is one difference, even if all its leaves are null
+    AnyDifferenceSink sink;
+    try {
+        diff_values(old_val, new_val, sink, DiffOptions{.recursive = recursive, .expand_subtrees = false});
+    } catch (const FirstDifference&) {
         return true;
     }
-
-    // Container Boxing: ValueVector now stores ImmerValue directly, not ValueBox
-    // Check each element (early exit on first difference)
-    for (size_t i = 0; i < old_size; ++i) {
-        const ImmerValue& old_val = old_vec[i];
-        const ImmerValue& new_val = new_vec[i];
-
-        // Recurse - early exit if different
-        if (values_differ(old_val, new_val, recursive)) {
-            return true;
-        }
-    }
-
     return false;
 }
 
-} // namespace detail
-
 // ============================================================
 // DiffValueCollector - Single-pass diff to ImmerValue tree
 // ============================================================
@@ -447,323 +862,91 @@ inline const std::string& get_index_string(size_t i) {
     large_index = std::to_string(i);
     return large_index;
 }
-} // namespace
-
-void DiffValueCollector::diff(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive) {
-    clear();
-    recursive_ = recursive;
-
-    // Fast path: if both Values share the same variant storage, no changes
-    if (&old_val.data == &new_val.data) {
-        return;
-    }
 
-    bool changed = false;
-    result_ = diff_value_impl(old_val, new_val, changed);
-    has_changes_ = changed;
-}
-
-void DiffValueCollector::clear() {
-    result_ = ImmerValue{};
-    has_changes_ = false;
-}
-
-ImmerValue DiffValueCollector::make_diff_node(DiffEntry::Type type, const ValueBox& val_box) {
+/// Leaf diff node for Add (only _new) or Remove (only _old)
+ImmerValue make_diff_node(DiffEntry::Type type, const ImmerValue& val) {
     // Use transient for better performance (in-place mutation)
     auto transient = ValueMap{}.transient();
 
     // Use cached type box to avoid repeated allocation
     transient.set(diff_keys::TYPE, get_type_box(type));
-
-    // Store the value box directly - no copy, just reference count increment
-    // Add: only _new (value being added)
-    // Remove: only _old (value being removed)
-    // Change: should not use this overload - use the two-value version
-    if (type == DiffEntry::Type::Add) {
-        transient.set(diff_keys::NEW, val_box);
-    } else if (type == DiffEntry::Type::Remove) {
-        transient.set(diff_keys::OLD, val_box);
-    }
-
+    transient.set(type == DiffEntry::Type::Add ? diff_keys::NEW : diff_keys::OLD, val);
     return ImmerValue{transient.persistent()};
 }
 
-ImmerValue DiffValueCollector::make_diff_node(DiffEntry::Type type, const ValueBox& old_box, const ValueBox& new_box) {
-    // For Change type, we need both values - use transient for better performance
-    if (type == DiffEntry::Type::Change) {
-        auto transient = ValueMap{}.transient();
-        transient.set(diff_keys::TYPE, get_type_box(type));
-        transient.set(diff_keys::OLD, old_box);
-        transient.set(diff_keys::NEW, new_box);
-        return ImmerValue{transient.persistent()};
-    }
-
-    // For Add/Remove, delegate to single-value version using the meaningful value
-    return make_diff_node(type, (type == DiffEntry::Type::Add) ? new_box : old_box);
-}
-
-// Convenience overloads for ImmerValue& (wraps into ValueBox)
-ImmerValue DiffValueCollector::make_diff_node(DiffEntry::Type type, const ImmerValue& val) {
-    return make_diff_node(type, ValueBox{val});
-}
-
-ImmerValue DiffValueCollector::make_diff_node(DiffEntry::Type type, const ImmerValue& old_val, const ImmerValue& new_val) {
-    return make_diff_node(type, ValueBox{old_val}, ValueBox{new_val});
-}
-
-ImmerValue DiffValueCollector::diff_value_impl(const ImmerValue& old_val, const ImmerValue& new_val, bool& changed) {
-    const auto old_index = old_val.data.index();
-    const auto new_index = new_val.data.index();
-
-    // Different types - whole value changed
-    if (old_index != new_index) [[unlikely]] {
-        changed = true;
-        return make_diff_node(DiffEntry::Type::Change, old_val, new_val);
-    }
-
-    // Container Boxing: variant now holds BoxedValueMap, BoxedValueVector, etc.
-    return std::visit(
-        [&](const auto& old_arg) -> ImmerValue {
-            using T = std::decay_t<decltype(old_arg)>;
-
-            if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                const auto& new_boxed = std::get<BoxedValueMap>(new_val.data);
-                const auto& old_map = old_arg.get();
-                const auto& new_map = new_boxed.get();
-                // O(1) identity check
-                if (old_map.impl().root == new_map.impl().root && old_map.impl().size == new_map.impl().size)
-                    [[likely]] {
-                    return ImmerValue{}; // No change
-                }
-                // Shallow mode: report container change without recursing
-                if (!recursive_) {
-                    changed = true;
-                    return make_diff_node(DiffEntry::Type::Change, old_val, new_val);
-                }
-                return diff_map_impl(old_map, new_map, changed);
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                const auto& new_boxed = std::get<BoxedValueVector>(new_val.data);
-                const auto& old_vec = old_arg.get();
-                const auto& new_vec = new_boxed.get();
-                // O(1) identity check
-                if (old_vec.impl().root == new_vec.impl().root && old_vec.impl().tail == new_vec.impl().tail &&
-                    old_vec.impl().size == new_vec.impl().size) [[likely]] {
-                    return ImmerValue{}; // No change
-                }
-                // Shallow mode: report container change without recursing
-                if (!recursive_) {
-                    changed = true;
-                    return make_diff_node(DiffEntry::Type::Change, old_val, new_val);
-                }
-                return diff_vector_impl(old_vec, new_vec, changed);
-            } else if constexpr (std::is_same_v<T, std::monostate>) {
-                return ImmerValue{}; // Both null, no change
-            } else {
-                // Primitive types: direct comparison
-                const auto& new_arg = std::get<T>(new_val.data);
-                if (old_arg != new_arg) {
-                    changed = true;
-                    return make_diff_node(DiffEntry::Type::Change, old_val, new_val);
-                }
-                return ImmerValue{}; // No change
-            }
-        },
-        old_val.data);
-}
-
-// ValueBox version for zero-copy when we already have boxes from container traversal
-// Note: With Container Boxing, this is primarily used for TableEntry which still uses ValueBox
-ImmerValue DiffValueCollector::diff_value_impl_box(const ValueBox& old_box, const ValueBox& new_box, bool& changed) {
-    const ImmerValue& old_val = *old_box;
-    const ImmerValue& new_val = *new_box;
-
-    const auto old_index = old_val.data.index();
-    const auto new_index = new_val.data.index();
-
-    // Different types - whole value changed, use the boxes directly
-    if (old_index != new_index) [[unlikely]] {
-        changed = true;
-        return make_diff_node(DiffEntry::Type::Change, old_box, new_box);
-    }
-
-    // Container Boxing: variant now holds BoxedValueMap, BoxedValueVector, etc.
-    return std::visit(
-        [&](const auto& old_arg) -> ImmerValue {
-            using T = std::decay_t<decltype(old_arg)>;
-
-            if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                const auto& new_boxed = std::get<BoxedValueMap>(new_val.data);
-                const auto& old_map = old_arg.get();
-                const auto& new_map = new_boxed.get();
-                if (old_map.impl().root == new_map.impl().root && old_map.impl().size == new_map.impl().size)
-                    [[likely]] {
-                    return ImmerValue{};
-                }
-                if (!recursive_) {
-                    changed = true;
-                    return make_diff_node(DiffEntry::Type::Change, old_box, new_box);
-                }
-                return diff_map_impl(old_map, new_map, changed);
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                const auto& new_boxed = std::get<BoxedValueVector>(new_val.data);
-                const auto& old_vec = old_arg.get();
-                const auto& new_vec = new_boxed.get();
-                if (old_vec.impl().root == new_vec.impl().root && old_vec.impl().tail == new_vec.impl().tail &&
-                    old_vec.impl().size == new_vec.impl().size) [[likely]] {
-                    return ImmerValue{};
-                }
-                if (!recursive_) {
-                    changed = true;
-                    return make_diff_node(DiffEntry::Type::Change, old_box, new_box);
-                }
-                return diff_vector_impl(old_vec, new_vec, changed);
-            } else if constexpr (std::is_same_v<T, std::monostate>) {
-                return ImmerValue{};
-            } else {
-                const auto& new_arg = std::get<T>(new_val.data);
-                if (old_arg != new_arg) {
-                    changed = true;
-                    return make_diff_node(DiffEntry::Type::Change, old_box, new_box);
-                }
-                return ImmerValue{};
-            }
-        },
-        old_val.data);
-}
-
-ImmerValue DiffValueCollector::diff_map_impl(const ValueMap& old_map, const ValueMap& new_map, bool& changed) {
-    // Use transient for O(n) batch updates instead of O(n log n) with chained .set()
+/// Leaf diff node for Change (both _old and _new)
+ImmerValue make_diff_node(const ImmerValue& old_val, const ImmerValue& new_val) {
     auto transient = ValueMap{}.transient();
-    bool has_any_change = false;
-
-    // Container Boxing: ValueMap now stores ImmerValue directly, not ValueBox
-    auto map_differ = immer::make_differ(
-        // added - ImmerValue stored directly in map
-        [&](const std::pair<const std::string, ImmerValue>& added_kv) {
-            has_any_change = true;
-            ImmerValue subtree = collect_entries(added_kv.second, DiffEntry::Type::Add);
-            transient.set(added_kv.first, std::move(subtree));
-        },
-        // removed - ImmerValue stored directly in map
-        [&](const std::pair<const std::string, ImmerValue>& removed_kv) {
-            has_any_change = true;
-            ImmerValue subtree = collect_entries(removed_kv.second, DiffEntry::Type::Remove);
-            transient.set(removed_kv.first, std::move(subtree));
-        },
-        // changed (retained key)
-        [&](const std::pair<const std::string, ImmerValue>& old_kv,
-            const std::pair<const std::string, ImmerValue>& new_kv) {
-            // Compare value data addresses for identity check
-            if (&old_kv.second.data == &new_kv.second.data) [[likely]] {
-                return;
-            }
-            bool subtree_changed = false;
-            ImmerValue subtree = diff_value_impl(old_kv.second, new_kv.second, subtree_changed);
-            if (subtree_changed) {
-                has_any_change = true;
-                transient.set(old_kv.first, std::move(subtree));
-            }
-        });
-
-    immer::diff(old_map, new_map, map_differ);
+    transient.set(diff_keys::TYPE, get_type_box(DiffEntry::Type::Change));
+    transient.set(diff_keys::OLD, old_val);
+    transient.set(diff_keys::NEW, new_val);
+    return ImmerValue{transient.persistent()};
+}
 
-    if (has_any_change) {
-        changed = true;
-        return ImmerValue{BoxedValueMap{transient.persistent()}};
+/// Builds the diff tree while the walk runs: one map transient per open
+/// container, folded into its parent on leave() if anything changed below it.
+/// Vector and array indices and table ids become string keys. Subtrees added
+/// or removed as a whole are one leaf node, so apply_diff() restores them
+/// with their type (a table or array opened into keys would come back a map).
+class ValueTreeSink final : public DiffSink {
+public:
+    void on_add(PathView path, const ImmerValue& value) override {
+        place(path, make_diff_node(DiffEntry::Type::Add, value));
+    }
+    void on_remove(PathView path, const ImmerValue& value) override {
+        place(path, make_diff_node(DiffEntry::Type::Remove, value));
+    }
+    void on_change(PathView path, const ImmerValue& old_value, const ImmerValue& new_value) override {
+        place(path, make_diff_node(old_value, new_value));
     }
-    return ImmerValue{};
-}
 
-ImmerValue DiffValueCollector::diff_vector_impl(const ValueVector& old_vec, const ValueVector& new_vec, bool& changed) {
-    const size_t old_size = old_vec.size();
-    const size_t new_size = new_vec.size();
-    const size_t common_size = std::min(old_size, new_size);
+    void enter(PathView /*path*/) override { frames_.push_back(ValueMap{}.transient()); }
 
-    // Use transient for O(n) batch updates instead of O(n log n) with chained .set()
-    // Note: Vector diffs are stored as a map with string keys for indices
-    auto transient = ValueMap{}.transient();
-    bool has_any_change = false;
+    void leave(PathView path) override {
+        auto frame = std::move(frames_.back());
+        frames_.pop_back();
+        if (!frame.empty()) {
+            place(path, ImmerValue{BoxedValueMap{frame.persistent()}});
+        }
+    }
 
-    // Container Boxing: ValueVector now stores ImmerValue directly
-    // Compare common elements
-    for (size_t i = 0; i < common_size; ++i) {
-        const ImmerValue& old_val = old_vec[i];
-        const ImmerValue& new_val = new_vec[i];
+    [[nodiscard]] bool has_changes() const { return has_changes_; }
+    [[nodiscard]] ImmerValue take() { return std::move(result_); }
 
-        // Compare value data addresses for identity check
-        if (&old_val.data == &new_val.data) [[likely]] {
-            continue;
+private:
+    void place(PathView path, ImmerValue node) {
+        has_changes_ = true;
+        if (frames_.empty()) {
+            result_ = std::move(node); // Root
+            return;
         }
-
-        bool subtree_changed = false;
-        ImmerValue subtree = diff_value_impl(old_val, new_val, subtree_changed);
-        if (subtree_changed) {
-            has_any_change = true;
-            transient.set(get_index_string(i), std::move(subtree));
+        const PathElement& key = path.back();
+        if (auto* name = std::get_if<std::string_view>(&key)) {
+            frames_.back().set(std::string{*name}, std::move(node));
+        } else {
+            frames_.back().set(get_index_string(std::get<std::size_t>(key)), std::move(node));
         }
     }
 
-    // Removed tail elements
-    for (size_t i = common_size; i < old_size; ++i) {
-        has_any_change = true;
-        ImmerValue subtree = collect_entries(old_vec[i], DiffEntry::Type::Remove);
-        transient.set(get_index_string(i), std::move(subtree));
-    }
+    std::vector<decltype(ValueMap{}.transient())> frames_;
+    ImmerValue result_;
+    bool has_changes_ = false;
+};
+} // namespace
 
-    // Added tail elements
-    for (size_t i = common_size; i < new_size; ++i) {
-        has_any_change = true;
-        ImmerValue subtree = collect_entries(new_vec[i], DiffEntry::Type::Add);
-        transient.set(get_index_string(i), std::move(subtree));
-    }
+void DiffValueCollector::diff(const ImmerValue& old_val, const ImmerValue& new_val, bool recursive) {
+    clear();
+    recursive_ = recursive;
 
-    if (has_any_change) {
-        changed = true;
-        return ImmerValue{BoxedValueMap{transient.persistent()}};
-    }
-    return ImmerValue{};
+    ValueTreeSink sink;
+    diff_values(old_val, new_val, sink, DiffOptions{.recursive = recursive, .expand_subtrees = false});
+    has_changes_ = sink.has_changes();
+    result_ = sink.take();
 }
 
-ImmerValue DiffValueCollector::collect_entries(const ImmerValue& val, DiffEntry::Type type) {
-    // In shallow mode, just create a diff node for the entire value
-    // Use single-value make_diff_node which stores val in the appropriate field
-    if (!recursive_) {
-        return make_diff_node(type, val);
-    }
-
-    // Recursive mode: descend into containers
-    // Container Boxing: variant now holds BoxedValueMap, BoxedValueVector, etc.
-    return std::visit(
-        [&](const auto& arg) -> ImmerValue {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, BoxedValueMap>) {
-                // Use transient for O(n) batch updates
-                auto transient = ValueMap{}.transient();
-                // Container Boxing: map stores ImmerValue directly
-                for (const auto& [k, v] : arg.get()) {
-                    ImmerValue subtree = collect_entries(v, type);
-                    transient.set(k, std::move(subtree));
-                }
-                return ImmerValue{BoxedValueMap{transient.persistent()}};
-            } else if constexpr (std::is_same_v<T, BoxedValueVector>) {
-                // Use transient for O(n) batch updates
-                // Note: Vector diffs are stored as a map with string keys for indices
-                auto transient = ValueMap{}.transient();
-                // Container Boxing: vector stores ImmerValue directly
-                const auto& vec = arg.get();
-                for (size_t i = 0; i < vec.size(); ++i) {
-                    ImmerValue subtree = collect_entries(vec[i], type);
-                    transient.set(get_index_string(i), std::move(subtree));
-                }
-                return ImmerValue{BoxedValueMap{transient.persistent()}};
-            } else if constexpr (!std::is_same_v<T, std::monostate>) {
-                // Leaf value: create diff node - use single-value version
-                return make_diff_node(type, val);
-            } else {
-                return ImmerValue{}; // monostate - nothing to collect
-            }
-        },
-        val.data);
+void DiffValueCollector::clear() {
+    result_ = ImmerValue{};
+    has_changes_ = false;
 }
 
 bool DiffValueCollector::is_diff_node(const ImmerValue& val) {
@@ -828,12 +1011,56 @@ ImmerValue diff_as_value(const ImmerValue& old_val, const ImmerValue& new_val, b
 // ============================================================
 
 namespace {
+ImmerValue apply_diff_recursive(const ImmerValue& root, const ImmerValue& diff_tree, const Path& path = {});
+
+/// Apply indexed changes (numeric string keys) to a vector or array.
+/// Indices past the end are appended; removed elements at the end are dropped,
+/// removed elements in the middle are set to null to preserve the other indices.
+template <typename Seq>
+Seq apply_sequence_diff(Seq seq, const ValueMap& diff_map, const Path& path) {
+    std::vector<std::pair<size_t, const ImmerValue*>> indexed_diffs;
+    indexed_diffs.reserve(diff_map.size());
+    for (const auto& [index_str, diff_child] : diff_map) {
+        indexed_diffs.emplace_back(std::stoul(index_str), &diff_child);
+    }
+    std::sort(indexed_diffs.begin(), indexed_diffs.end());
+
+    std::vector<size_t> removed;
+    for (const auto& [index, diff_child] : indexed_diffs) {
+        Path child_path = path;
+        child_path.push_back(index);
+
+        ImmerValue current_val = index < seq.size() ? seq[index] : ImmerValue{};
+        ImmerValue new_child = apply_diff_recursive(current_val, *diff_child, child_path);
+
+        if (new_child.is_null()) {
+            if (index < seq.size()) {
+                removed.push_back(index);
+            }
+        } else if (index < seq.size()) {
+            seq = std::move(seq).set(index, std::move(new_child));
+        } else {
+            while (seq.size() < index) {
+                seq = std::move(seq).push_back(ImmerValue{});
+            }
+            seq = std::move(seq).push_back(std::move(new_child));
+        }
+    }
+
+    // Highest index first, so a run of removals at the end shrinks the sequence.
+    // (Copying take: immer::array's in-place take destroys the wrong elements.)
+    for (auto it = removed.rbegin(); it != removed.rend(); ++it) {
+        seq = (*it + 1 == seq.size()) ? seq.take(*it) : std::move(seq).set(*it, ImmerValue{});
+    }
+    return seq;
+}
+
 /// Recursively apply diff tree to a value, creating new ImmerValue with changes applied
 /// @param root Current value being modified
 /// @param diff_tree Current diff subtree to apply
 /// @param path Current path (for error reporting)
 /// @return New ImmerValue with diff applied
-ImmerValue apply_diff_recursive(const ImmerValue& root, const ImmerValue& diff_tree, const Path& path = {}) {
+ImmerValue apply_diff_recursive(const ImmerValue& root, const ImmerValue& diff_tree, const Path& path) {
     // Check if this is a diff leaf node (contains _diff_type)
     if (DiffValueCollector::is_diff_node(diff_tree)) {
         // This is a leaf diff node - extract the operation and value
@@ -903,6 +1130,27 @@ ImmerValue apply_diff_recursive(const ImmerValue& root, const ImmerValue& diff_t
             }
 
             return ImmerValue{BoxedValueMap{transient.persistent()}};
+        } else if (auto* root_boxed_table = root.get_if<BoxedValueTable>()) {
+            // Root is a table - the diff is keyed by entry id
+            ValueTable table = root_boxed_table->get();
+            for (const auto& [id, diff_child] : diff_map) {
+                Path child_path = path;
+                child_path.push_back(id);
+
+                ImmerValue current_val;
+                if (auto* entry = table.find(id)) {
+                    current_val = *entry->value;
+                }
+
+                ImmerValue new_child = apply_diff_recursive(current_val, diff_child, child_path);
+                if (new_child.is_null()) {
+                    table = std::move(table).erase(id);
+                } else {
+                    table = std::move(table).insert(TableEntry{id, ValueBox{std::move(new_child)}});
+                }
+            }
+
+            return ImmerValue{BoxedValueTable{std::move(table)}};
         } else if (root.is_null()) {
             // Root is null but we have changes to apply - create a new map using transient
             auto transient = ValueMap{}.transient();
@@ -936,42 +1184,9 @@ ImmerValue apply_diff_recursive(const ImmerValue& root, const ImmerValue& diff_t
             if (all_numeric) {
                 // This is a vector diff represented as a map with numeric string keys
                 if (auto* root_boxed_vec = root.get_if<BoxedValueVector>()) {
-                    const auto& root_vec = root_boxed_vec->get();
-                    // Root is a vector - apply indexed changes using transient
-                    auto transient = root_vec.transient();
-                    size_t current_size = root_vec.size();
-
-                    // Container Boxing: ValueVector now stores ImmerValue directly
-                    for (const auto& [index_str, diff_child] : diff_map) {
-                        size_t index = std::stoul(index_str);
-                        Path child_path = path;
-                        child_path.push_back(index);
-
-                        // Get the current value at this index (or null if out of bounds)
-                        ImmerValue current_val;
-                        if (index < current_size) {
-                            current_val = root_vec[index];
-                        } else {
-                            current_val = ImmerValue{}; // null for out-of-bounds indices
-                        }
-
-                        // Recursively apply diff to this child
-                        ImmerValue new_child = apply_diff_recursive(current_val, diff_child, child_path);
-
-                        // Update the vector
-                        if (!new_child.is_null()) {
-                            // Extend vector if necessary
-                            while (transient.size() <= index) {
-                                transient.push_back(ImmerValue{});
-                            }
-                            transient.set(index, std::move(new_child));
-                        } else if (index < transient.size()) {
-                            // For removal, set it to null to preserve indices
-                            transient.set(index, ImmerValue{});
-                        }
-                    }
-
-                    return ImmerValue{BoxedValueVector{transient.persistent()}};
+                    return ImmerValue{BoxedValueVector{apply_sequence_diff(root_boxed_vec->get(), diff_map, path)}};
+                } else if (auto* root_boxed_arr = root.get_if<BoxedValueArray>()) {
+                    return ImmerValue{BoxedValueArray{apply_sequence_diff(root_boxed_arr->get(), diff_map, path)}};
                 } else if (root.is_null()) {
                     // Root is null but we have vector changes to apply
                     auto transient = ValueVector{}.transient();
@@ -1002,8 +1217,8 @@ ImmerValue apply_diff_recursive(const ImmerValue& root, const ImmerValue& diff_t
 
                     return ImmerValue{BoxedValueVector{transient.persistent()}};
                 } else {
-                    throw std::runtime_error("apply_diff: Type mismatch - diff expects vector but root "
-                                             "is not a vector at path: " +
+                    throw std::runtime_error("apply_diff: Type mismatch - diff expects vector or array but root "
+                                             "is neither at path: " +
                                              path.to_dot_notation());
                 }
             }
@@ -2,10 +2,15 @@
 // Module 8: Diff system related interfaces
 
 #include <catch2/catch_all.hpp>
+#include <lager_ext/path_utils.h>
+#include <lager_ext/serialization.h>
+#include <lager_ext/shared_state.h>
 #include <lager_ext/value_diff.h>
 #include <lager_ext/value.h>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 using namespace lager_ext;
 
@@ -427,6 +432,23 @@ TEST_CASE("has_any_difference function", "[diff]") {
         auto shared = ImmerValue::map({{"key", ImmerValue{1}}});
         REQUIRE_FALSE(has_any_difference(shared, shared));
     }
+
+    SECTION("equal tables and arrays in separate storage") {
+        auto make = [](int k, int a) {
+            return ImmerValue::map({{"table", ImmerValue::table({{"k", ImmerValue{k}}})},
+                                    {"array", ImmerValue::array({ImmerValue{a}})}});
+        };
+        REQUIRE_FALSE(has_any_difference(make(1, 1), make(1, 1)));
+        REQUIRE(has_any_difference(make(1, 1), make(1, 1), false));
+        REQUIRE(has_any_difference(make(1, 1), make(2, 1)));
+        REQUIRE(has_any_difference(make(1, 1), make(1, 2)));
+    }
+
+    SECTION("added subtree holding only nulls") {
+        auto old_state = ImmerValue::map({{"a", ImmerValue{1}}});
+        auto new_state = old_state.set("b", ImmerValue::map({{"n", ImmerValue{}}}));
+        REQUIRE(has_any_difference(old_state, new_state));
+    }
 }
 
 // ============================================================
@@ -616,3 +638,272 @@ TEST_CASE("Diff edge cases", "[diff][edge]") {
         REQUIRE(has_any_difference(empty, filled));
     }
 }
+
+// ============================================================
+// collect_diff (structural sharing)
+// ============================================================
+
+TEST_CASE("collect_diff on large shared containers", "[diff][collect]") {
+    SECTION("single edit in a large map") {
+        auto items = ValueMap{}.transient();
+        for (int i = 0; i < 5000; ++i) {
+            items.set("item_" + std::to_string(i), ImmerValue::map({{"value", ImmerValue{i}}}));
+        }
+        auto before = ImmerValue::map({{"items", ImmerValue{BoxedValueMap{items.persistent()}}}});
+
+        Path target;
+        target.push_back("items").push_back("item_1234").push_back("value");
+        auto after = set_at_path(before, target, ImmerValue{-1});
+
+        auto result = collect_diff(before, after);
+        REQUIRE(result.added.empty());
+        REQUIRE(result.removed.empty());
+        REQUIRE(result.modified.size() == 1);
+        REQUIRE(result.modified[0].path == target);
+        REQUIRE(result.modified[0].old_value == ImmerValue{1234});
+        REQUIRE(result.modified[0].new_value == ImmerValue{-1});
+    }
+
+    SECTION("map keys added and removed") {
+        auto before = ImmerValue::map({{"a", ImmerValue{1}}, {"b", ImmerValue{2}}});
+        auto after = ImmerValue::map({{"b", ImmerValue{2}}, {"c", ImmerValue{3}}});
+
+        auto result = collect_diff(before, after);
+        REQUIRE(result.added.size() == 1);
+        REQUIRE(result.removed.size() == 1);
+        REQUIRE(result.modified.empty());
+        REQUIRE(result.added[0].second == ImmerValue{3});
+        REQUIRE(result.removed[0].second == ImmerValue{1});
+    }
+
+    SECTION("edit and append in a large vector") {
+        auto vec = ValueVector{}.transient();
+        for (int i = 0; i < 3000; ++i) {
+            vec.push_back(ImmerValue{i});
+        }
+        auto old_vec = vec.persistent();
+        auto new_vec = old_vec.set(2500, ImmerValue{-1}).push_back(ImmerValue{3000});
+        auto before = ImmerValue{BoxedValueVector{old_vec}};
+        auto after = ImmerValue{BoxedValueVector{new_vec}};
+
+        auto result = collect_diff(before, after);
+        REQUIRE(result.modified.size() == 1);
+        Path index;
+        index.push_back(std::size_t{2500});
+        REQUIRE(result.modified[0].path == index);
+        REQUIRE(result.added.size() == 1);
+        REQUIRE(result.added[0].second == ImmerValue{3000});
+        REQUIRE(result.removed.empty());
+
+        auto shrunk = collect_diff(after, before);
+        REQUIRE(shrunk.removed.size() == 1);
+        REQUIRE(shrunk.modified.size() == 1);
+    }
+
+    SECTION("identical roots") {
+        auto value = ImmerValue::map({{"x", ImmerValue{1}}});
+        auto result = collect_diff(value, value);
+        REQUIRE(result.empty());
+    }
+}
+
+// ============================================================
+// diff_values / DiffSink
+// ============================================================
+
+namespace {
+
+/// Records every callback as "<op> <path>"
+class RecordingSink : public DiffSink {
+public:
+    void on_add(PathView path, const ImmerValue&) override { events.push_back("add " + path.to_dot_notation()); }
+    void on_remove(PathView path, const ImmerValue&) override { events.push_back("remove " + path.to_dot_notation()); }
+    void on_change(PathView path, const ImmerValue&, const ImmerValue&) override {
+        events.push_back("change " + path.to_dot_notation());
+    }
+    void enter(PathView) override {
+        ++depth;
+        ++entered;
+    }
+    void leave(PathView) override { --depth; }
+
+    std::vector<std::string> events;
+    int depth = 0;
+    int entered = 0;
+};
+
+} // namespace
+
+TEST_CASE("diff_values covers tables and arrays", "[diff][sink]") {
+    auto before = ImmerValue::map({{"entities", ImmerValue::table({{"e1", ImmerValue{1}}, {"e2", ImmerValue{2}}})},
+                                   {"weights", ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}})}});
+    auto after = ImmerValue::map({{"entities", ImmerValue::table({{"e1", ImmerValue{10}}, {"e3", ImmerValue{3}}})},
+                                  {"weights", ImmerValue::array({ImmerValue{0.5}, ImmerValue{2.0}})}});
+
+    RecordingSink sink;
+    diff_values(before, after, sink);
+    std::sort(sink.events.begin(), sink.events.end());
+
+    REQUIRE(sink.depth == 0);
+    REQUIRE(sink.events == std::vector<std::string>{"add .entities.e3", "change .entities.e1",
+                                                    "change .weights[1]", "remove .entities.e2"});
+}
+
+TEST_CASE("apply_diff round-trips tables and arrays", "[diff][apply]") {
+    auto round_trip = [](const ImmerValue& before, const ImmerValue& after) {
+        return apply_diff(before, diff_as_value(before, after));
+    };
+    auto state = [](ImmerValue entities, ImmerValue weights) {
+        return ImmerValue::map({{"entities", std::move(entities)}, {"weights", std::move(weights)}});
+    };
+    auto entities = ImmerValue::table({{"e1", ImmerValue{1}}, {"e2", ImmerValue::map({{"hp", ImmerValue{5}}})}});
+    auto weights = ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}});
+    auto before = state(entities, weights);
+
+    SECTION("table entries") {
+        auto changed = state(entities.set("e1", ImmerValue{10}), weights);
+        auto nested = state(entities.set("e2", ImmerValue::map({{"hp", ImmerValue{4}}})), weights);
+        auto added = state(entities.set("e3", ImmerValue::table({{"t", ImmerValue{1}}})), weights);
+        auto removed = state(ImmerValue::table({{"e1", ImmerValue{1}}}), weights);
+
+        REQUIRE(round_trip(before, changed) == changed);
+        REQUIRE(round_trip(before, nested) == nested);
+        REQUIRE(round_trip(before, added) == added);
+        REQUIRE(round_trip(before, removed) == removed);
+        REQUIRE(round_trip(removed, before) == before);
+    }
+
+    SECTION("array elements") {
+        auto changed = state(entities, ImmerValue::array({ImmerValue{0.5}, ImmerValue{2.0}}));
+        auto grown = state(entities, ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}, ImmerValue{1.5},
+                                                        ImmerValue::array({ImmerValue{1}})}));
+        auto shrunk = state(entities, ImmerValue::array({ImmerValue{0.5}}));
+        auto emptied = state(entities, ImmerValue::array({}));
+
+        REQUIRE(round_trip(before, changed) == changed);
+        REQUIRE(round_trip(before, grown) == grown);
+        REQUIRE(round_trip(grown, before) == before);
+        REQUIRE(round_trip(before, shrunk) == shrunk);
+        REQUIRE(round_trip(before, emptied) == emptied);
+    }
+
+    SECTION("vector elements") {
+        auto items = ImmerValue::vector({ImmerValue{1}, ImmerValue{2}, ImmerValue{3}});
+        auto shorter = ImmerValue::vector({ImmerValue{1}});
+        REQUIRE(round_trip(items, shorter) == shorter);
+        REQUIRE(round_trip(shorter, items) == items);
+    }
+}
+
+TEST_CASE("diff_values options", "[diff][sink]") {
+    auto before = ImmerValue::map({{"a", ImmerValue{1}}});
+    auto after = ImmerValue::map({{"a", ImmerValue{1}}, {"b", ImmerValue::map({{"x", ImmerValue{1}}, {"y", ImmerValue{2}}})}});
+
+    SECTION("expanded subtrees report leaves") {
+        RecordingSink sink;
+        diff_values(before, after, sink);
+        REQUIRE(sink.events.size() == 2);
+    }
+
+    SECTION("unexpanded subtrees are one entry") {
+        RecordingSink sink;
+        diff_values(before, after, sink, DiffOptions{.recursive = true, .expand_subtrees = false});
+        REQUIRE(sink.events == std::vector<std::string>{"add .b"});
+    }
+
+    SECTION("shallow mode reports the root") {
+        RecordingSink sink;
+        diff_values(before, after, sink, DiffOptions{.recursive = false});
+        REQUIRE(sink.events == std::vector<std::string>{"change (root)"});
+    }
+
+    SECTION("empty containers are reported as themselves") {
+        auto with_empty = before.set("b", ImmerValue{ValueMap{}});
+        DiffEntryCollector collector;
+        collector.diff(before, with_empty);
+        REQUIRE(collector.get_diffs().size() == 1);
+        REQUIRE(collector.get_diffs()[0].type == DiffEntry::Type::Add);
+        REQUIRE(apply_diff(before, diff_as_value(before, with_empty)) == with_empty);
+    }
+}
+
+TEST_CASE("encode_diff straight from values", "[diff][encode]") {
+    auto before = ImmerValue::map({{"name", ImmerValue{"a"}}, {"gone", ImmerValue{1}}});
+    auto after = ImmerValue::map({{"name", ImmerValue{"b"}}, {"new", ImmerValue{2}}});
+
+    REQUIRE(encode_diff(before, after) == encode_diff(collect_diff(before, after)));
+    REQUIRE(encode_diff(before, before).empty());
+
+    auto decoded = decode_diff(encode_diff(before, after));
+    REQUIRE(apply_diff(before, decoded) == after);
+}
+
+TEST_CASE("parallel diff matches serial order", "[diff][parallel]") {
+    const int count = static_cast<int>(PARALLEL_DIFF_MIN_ELEMENTS) * 2;
+    auto items = ValueMap{}.transient();
+    auto order = ValueVector{}.transient();
+    for (int i = 0; i < count; ++i) {
+        items.set("item_" + std::to_string(i), ImmerValue::map({{"value", ImmerValue{i}}}));
+        order.push_back(ImmerValue{i});
+    }
+    auto old_items = items.persistent();
+    auto old_order = order.persistent();
+
+    auto new_items = old_items.erase("item_7").set("extra", ImmerValue{1});
+    auto new_order = old_order.take(count - 10);
+    for (int i = 0; i < count; i += 97) {
+        new_items = new_items.set("item_" + std::to_string(i), ImmerValue::map({{"value", ImmerValue{-i}}}));
+        new_order = new_order.set(i, ImmerValue{-i});
+    }
+
+    auto before = ImmerValue::map({{"items", ImmerValue{BoxedValueMap{old_items}}},
+                                   {"order", ImmerValue{BoxedValueVector{old_order}}}});
+    auto after = ImmerValue::map({{"items", ImmerValue{BoxedValueMap{new_items}}},
+                                  {"order", ImmerValue{BoxedValueVector{new_order}}},
+                                  {"copy", ImmerValue{BoxedValueMap{new_items}}}});
+
+    SECTION("diff_values") {
+        RecordingSink serial;
+        diff_values(before, after, serial);
+
+        RecordingSink parallel;
+        diff_values(before, after, parallel, DiffOptions{.num_threads = 4});
+
+        REQUIRE(parallel.depth == 0);
+        REQUIRE(parallel.events == serial.events);
+    }
+
+    SECTION("DiffEntryCollector and collect_diff") {
+        DiffEntryCollector serial;
+        serial.diff(before, after);
+        DiffEntryCollector parallel;
+        parallel.diff(before, after, true, 4);
+
+        REQUIRE(parallel.get_diffs().size() == serial.get_diffs().size());
+        for (std::size_t i = 0; i < serial.get_diffs().size(); ++i) {
+            REQUIRE(parallel.get_diffs()[i].path == serial.get_diffs()[i].path);
+        }
+
+        auto serial_result = collect_diff(before, after);
+        auto parallel_result = collect_diff(before, after, 4);
+        REQUIRE(encode_diff(parallel_result) == encode_diff(serial_result));
+    }
+}
+
+TEST_CASE("diff_values prune_by_hash", "[diff][hash]") {
+    auto original = ImmerValue::map({{"scene", ImmerValue::map({{"a", ImmerValue{1}}, {"b", ImmerValue{2}}})},
+                                     {"meta", ImmerValue::map({{"version", ImmerValue{1}}})}});
+    // Same content, no shared storage, one change
+    auto received = deserialize(serialize(original.set("meta", ImmerValue::map({{"version", ImmerValue{2}}}))));
+
+    RecordingSink full;
+    diff_values(original, received, full);
+
+    RecordingSink pruned;
+    diff_values(original, received, pruned, DiffOptions{.prune_by_hash = true});
+
+    REQUIRE(pruned.events == full.events);
+    REQUIRE(pruned.events == std::vector<std::string>{"change .meta.version"});
+    REQUIRE(full.entered == 3);   // root, scene, meta
+    REQUIRE(pruned.entered == 2); // scene skipped: equal hashes
+}
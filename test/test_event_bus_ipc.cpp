@@ -3,13 +3,19 @@
 
 #include <catch2/catch_all.hpp>
 #include <lager_ext/event_bus.h>
+#include <lager_ext/event_bus_ipc.h>
+#include <lager_ext/serialization.h>
 #include <lager_ext/ipc/ipc_event_bus.h>
 #include <lager_ext/value.h>
 
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <cstring>
+#include <future>
+#include <optional>
 #include <string>
+#include <vector>
 
 using namespace lager_ext;
 using namespace std::chrono_literals;
@@ -481,3 +487,455 @@ TEST_CASE("IPCEventBus state synchronization", "[eventbus][ipc][state]") {
         REQUIRE(reply_received.at("status").as<std::string>() == "ok");
     }
 }
+
+// ============================================================
+// RemoteBus Tests
+// ============================================================
+
+static std::string unique_remote_name(const std::string& prefix) {
+    return prefix + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+TEST_CASE("RemoteBus peers connect before creating", "[eventbus][ipc][remote][lifetime]") {
+    const std::string name = unique_remote_name("remote_peer_");
+    EventBus bus_a;
+    EventBus bus_b;
+
+    // Nothing to connect to yet: the first peer creates the channel pair
+    auto first = std::make_unique<RemoteBus>(name, bus_a);
+    REQUIRE(first->connected());
+
+    SECTION("second peer attaches to the first") {
+        RemoteBus second{name, bus_b};
+        REQUIRE(second.connected());
+
+        std::vector<int> at_first;
+        std::vector<int> at_second;
+        auto c1 = first->subscribe_remote("ping", [&](const ImmerValue& v) { at_first.push_back(v.as<int>()); });
+        auto c2 = second.subscribe_remote("ping", [&](const ImmerValue& v) { at_second.push_back(v.as<int>()); });
+
+        REQUIRE(second.post_remote("ping", ImmerValue{1}));
+        REQUIRE(first->post_remote("ping", ImmerValue{2}));
+        REQUIRE(first->poll() == 1);
+        REQUIRE(second.poll() == 1);
+        REQUIRE(at_first == std::vector<int>{1});
+        REQUIRE(at_second == std::vector<int>{2});
+    }
+
+    SECTION("connected peer teardown keeps the pair") {
+        {
+            RemoteBus second{name, bus_b};
+            REQUIRE(second.connected());
+        }
+        RemoteBus third{name, bus_b};
+        REQUIRE(third.connected());
+
+        int received = 0;
+        auto conn = first->subscribe_remote("ping", [&](const ImmerValue& v) { received = v.as<int>(); });
+        REQUIRE(third.post_remote("ping", ImmerValue{3}));
+        REQUIRE(first->poll() == 1);
+        REQUIRE(received == 3);
+    }
+
+    SECTION("creating peer teardown removes the pair") {
+        first.reset();
+        REQUIRE_FALSE(ipc::ChannelPair::connect(name));
+
+        // The next peer finds nothing and creates a fresh pair
+        RemoteBus next{name, bus_b};
+        REQUIRE(next.connected());
+    }
+}
+
+// ============================================================
+// RemoteBus Wire Format Tests
+// ============================================================
+
+// RemoteBus message header as it appears on the wire (mirrors EventHeader in event_bus_ipc.cpp)
+struct WireHeader {
+    uint32_t nameHash;
+    uint32_t requestId;
+    uint64_t timestamp;
+    uint8_t domain;
+    uint8_t flags;
+    uint8_t version;
+    uint8_t reserved[5];
+};
+static_assert(sizeof(WireHeader) == 24);
+
+static bool post_wire(ipc::ChannelPair& pair, uint32_t msg_id, const WireHeader& header,
+                      const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> bytes(sizeof(WireHeader) + payload.size());
+    std::memcpy(bytes.data(), &header, sizeof(WireHeader));
+    std::copy(payload.begin(), payload.end(), bytes.begin() + sizeof(WireHeader));
+    return pair.postRaw(msg_id, bytes.data(), bytes.size());
+}
+
+static WireHeader event_header(std::string_view name, MessageDomain domain = MessageDomain::Global) {
+    WireHeader header{};
+    header.nameHash = ipc::detail::fnv1a_hash32(name);
+    header.domain = static_cast<uint8_t>(domain);
+    header.version = 1;
+    return header;
+}
+
+LAGER_EXT_IPC_EVENT_DOMAIN(Document, RemoteDocSaved,
+    std::string path;
+,
+    return ImmerValue{evt.path};
+,
+    return RemoteDocSaved{.path = v.as<std::string>()};
+);
+
+TEST_CASE("RemoteBus event header round-trip", "[eventbus][ipc][remote][wire]") {
+    const std::string name = unique_remote_name("remote_wire_");
+    EventBus bus;
+    RemoteBus remote{name, bus};
+    auto raw = ipc::ChannelPair::connect(name);
+    REQUIRE(raw);
+
+    SECTION("header written by RemoteBus") {
+        const auto before = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        REQUIRE(remote.post_remote("doc.saved", ImmerValue{42}, MessageDomain::Document));
+        const auto after = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+        uint32_t msg_id = 0;
+        std::vector<uint8_t> buffer(1024);
+        const int size = raw->tryReceiveRaw(msg_id, buffer.data(), buffer.size());
+        REQUIRE(size > static_cast<int>(sizeof(WireHeader)));
+        REQUIRE(msg_id == detail::IPC_EVT_EVENT);
+
+        WireHeader header{};
+        std::memcpy(&header, buffer.data(), sizeof(WireHeader));
+        REQUIRE(header.nameHash == ipc::detail::fnv1a_hash32("doc.saved"));
+        REQUIRE(header.requestId == 0);
+        REQUIRE(header.timestamp >= before);
+        REQUIRE(header.timestamp <= after);
+        REQUIRE(header.domain == static_cast<uint8_t>(MessageDomain::Document));
+        REQUIRE(header.flags == static_cast<uint8_t>(MessageFlags::None));
+        REQUIRE(header.version == 1);
+        REQUIRE(deserialize(buffer.data() + sizeof(WireHeader), size - sizeof(WireHeader)).as<int>() == 42);
+    }
+
+    SECTION("header read by RemoteBus") {
+        STATIC_REQUIRE(std::is_same_v<decltype(RemoteBus::DomainEnvelope::requestId), uint32_t>);
+
+        std::vector<RemoteBus::DomainEnvelope> envelopes;
+        std::vector<ImmerValue> payloads;
+        auto conn = remote.subscribe_domain(MessageDomain::Asset,
+                                            [&](const RemoteBus::DomainEnvelope& env, const ImmerValue& data) {
+                                                envelopes.push_back(env);
+                                                payloads.push_back(data);
+                                            });
+
+        WireHeader header = event_header("asset.loaded", MessageDomain::Asset);
+        header.requestId = 0x12345678; // Needs all 32 bits
+        header.timestamp = 0x0102030405060708;
+        header.flags = static_cast<uint8_t>(MessageFlags::IsRequest);
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_REQUEST, header, serialize(ImmerValue{"mesh"}, BinaryFormat::Compact)));
+        REQUIRE(remote.poll() == 1);
+
+        REQUIRE(envelopes.size() == 1);
+        REQUIRE(envelopes[0].msgId == ipc::detail::fnv1a_hash32("asset.loaded"));
+        REQUIRE(envelopes[0].requestId == 0x12345678);
+        REQUIRE(envelopes[0].timestamp == 0x0102030405060708);
+        REQUIRE(envelopes[0].domain == MessageDomain::Asset);
+        REQUIRE(envelopes[0].flags == MessageFlags::IsRequest);
+        REQUIRE(payloads[0].as<std::string>() == "mesh");
+    }
+
+    SECTION("messages with another version or a short header are dropped") {
+        int received = 0;
+        auto conn = remote.subscribe_remote("doc.saved", [&](const ImmerValue&) { ++received; });
+
+        WireHeader header = event_header("doc.saved");
+        header.version = 2;
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_EVENT, header, serialize(ImmerValue{1}, BinaryFormat::Compact)));
+        const uint8_t too_short[8] = {};
+        REQUIRE(raw->postRaw(detail::IPC_EVT_EVENT, too_short, sizeof(too_short)));
+        REQUIRE(remote.poll() == 2);
+        REQUIRE(received == 0);
+        REQUIRE(remote.stats().dropped == 2);
+    }
+}
+
+TEST_CASE("RemoteBus dispatches by name hash", "[eventbus][ipc][remote][wire]") {
+    const std::string name = unique_remote_name("remote_dispatch_");
+    EventBus bus_a;
+    EventBus bus_b;
+    RemoteBus sender{name, bus_a};
+    RemoteBus receiver{name, bus_b};
+    REQUIRE(receiver.connected());
+
+    std::vector<std::string> saved;
+    std::vector<int> other;
+    std::vector<MessageDomain> domains;
+    auto c1 = receiver.subscribe_remote("RemoteDocSaved", [&](const ImmerValue& v) { saved.push_back(v.as<std::string>()); });
+    auto c2 = receiver.subscribe_remote("other", [&](const ImmerValue& v) { other.push_back(v.as<int>()); });
+    auto c3 = receiver.subscribe_domain(MessageDomain::Document,
+                                        [&](const RemoteBus::DomainEnvelope& env, const ImmerValue&) {
+                                            domains.push_back(env.domain);
+                                        });
+
+    // The typed post uses its compile-time hash and domain; the dynamic subscription hashes the same name
+    REQUIRE(sender.post_remote(RemoteDocSaved{.path = "/a.doc"}));
+    REQUIRE(sender.post_remote("other", ImmerValue{7}));
+    REQUIRE(receiver.poll() == 2);
+
+    REQUIRE(saved == std::vector<std::string>{"/a.doc"});
+    REQUIRE(other == std::vector<int>{7});
+    REQUIRE(domains == std::vector<MessageDomain>{MessageDomain::Document});
+
+    SECTION("typed subscriptions see typed posts") {
+        std::vector<std::string> typed;
+        auto c4 = sender.subscribe_remote<RemoteDocSaved>([&](const RemoteDocSaved& evt) { typed.push_back(evt.path); });
+        REQUIRE(receiver.post_remote("RemoteDocSaved", ImmerValue{"/b.doc"}));
+        REQUIRE(sender.poll() == 1);
+        REQUIRE(typed == std::vector<std::string>{"/b.doc"});
+    }
+
+    SECTION("disconnected handlers stop receiving") {
+        c2.disconnect();
+        REQUIRE(sender.post_remote("other", ImmerValue{8}));
+        REQUIRE(receiver.poll() == 1);
+        REQUIRE(other == std::vector<int>{7});
+    }
+}
+
+TEST_CASE("RemoteBus skips payloads nobody subscribes to", "[eventbus][ipc][remote][wire]") {
+    const std::string name = unique_remote_name("remote_skip_");
+    EventBus bus;
+    RemoteBus remote{name, bus};
+    auto raw = ipc::ChannelPair::connect(name);
+    REQUIRE(raw);
+
+    std::vector<int> received;
+    auto conn = remote.subscribe_remote("watched", [&](const ImmerValue& v) { received.push_back(v.as<int>()); });
+
+    // Not a valid serialized value: deserializing it would fail
+    const std::vector<uint8_t> garbage{0xEE, 0xEE, 0xEE, 0xEE};
+
+    SECTION("unsubscribed payloads are never decoded") {
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_EVENT, event_header("unwatched"), garbage));
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_REQUEST, event_header("no.handler"), garbage));
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_EVENT, event_header("watched"), serialize(ImmerValue{5}, BinaryFormat::Compact)));
+        REQUIRE(remote.poll() == 3);
+        REQUIRE(received == std::vector<int>{5});
+
+        auto stats = remote.stats();
+        REQUIRE(stats.received == 3);
+        REQUIRE(stats.payloads_decoded == 1);
+        REQUIRE(stats.dropped == 0);
+    }
+
+    SECTION("a malformed subscribed payload is dropped") {
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_EVENT, event_header("watched"), garbage));
+        REQUIRE(post_wire(*raw, detail::IPC_EVT_EVENT, event_header("watched"), serialize(ImmerValue{6}, BinaryFormat::Compact)));
+        REQUIRE(remote.poll() == 2);
+        REQUIRE(received == std::vector<int>{6});
+
+        auto stats = remote.stats();
+        REQUIRE(stats.payloads_decoded == 1);
+        REQUIRE(stats.dropped == 1);
+    }
+}
+
+TEST_CASE("RemoteBus rejects event names whose hashes collide", "[eventbus][ipc][remote][wire]") {
+    // Two names with the same FNV-1a hash
+    STATIC_REQUIRE(ipc::detail::fnv1a_hash32("event_1439599") == ipc::detail::fnv1a_hash32("event_1622382"));
+
+    const std::string name = unique_remote_name("remote_collide_");
+    EventBus bus;
+    RemoteBus remote{name, bus};
+
+    int first = 0;
+    auto c1 = remote.subscribe_remote("event_1439599", [&](const ImmerValue&) { ++first; });
+    REQUIRE(c1.connected());
+    REQUIRE(remote.last_error().empty());
+
+    SECTION("subscribe_remote") {
+        auto c2 = remote.subscribe_remote("event_1622382", [](const ImmerValue&) {});
+        REQUIRE_FALSE(c2.connected());
+        REQUIRE(remote.last_error().find("hash collision") != std::string::npos);
+    }
+
+    SECTION("on_request") {
+        auto c2 = remote.on_request("event_1622382", [](const ImmerValue& v) { return v; });
+        REQUIRE_FALSE(c2.connected());
+        REQUIRE(remote.last_error().find("hash collision") != std::string::npos);
+    }
+
+    SECTION("the same name subscribes again") {
+        auto c2 = remote.subscribe_remote("event_1439599", [](const ImmerValue&) {});
+        REQUIRE(c2.connected());
+        REQUIRE(remote.last_error().empty());
+    }
+}
+
+// ============================================================
+// RemoteBus Request Tests
+// ============================================================
+
+// Take the next request off a raw peer: its header and payload
+static std::optional<std::pair<WireHeader, ImmerValue>> receive_request(ipc::ChannelPair& pair) {
+    uint32_t msg_id = 0;
+    std::vector<uint8_t> buffer(1024);
+    const int size = pair.tryReceiveRaw(msg_id, buffer.data(), buffer.size());
+    if (size < static_cast<int>(sizeof(WireHeader)) || msg_id != detail::IPC_EVT_REQUEST) {
+        return std::nullopt;
+    }
+    WireHeader header{};
+    std::memcpy(&header, buffer.data(), sizeof(WireHeader));
+    return std::pair{header, deserialize(buffer.data() + sizeof(WireHeader), size - sizeof(WireHeader))};
+}
+
+static bool post_response(ipc::ChannelPair& pair, const WireHeader& request, const ImmerValue& payload) {
+    WireHeader header = request;
+    header.flags = static_cast<uint8_t>(MessageFlags::IsResponse);
+    return post_wire(pair, detail::IPC_EVT_RESPONSE, header, serialize(payload, BinaryFormat::Compact));
+}
+
+TEST_CASE("RemoteBus correlates responses by request id", "[eventbus][ipc][remote][request]") {
+    const std::string name = unique_remote_name("remote_reply_");
+    EventBus bus;
+    RemoteBus remote{name, bus};
+    auto raw = ipc::ChannelPair::connect(name);
+    REQUIRE(raw);
+
+    std::vector<std::pair<int, int>> completed; // (request, response)
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(remote.send_async("square", ImmerValue{i}, [&completed, i](std::optional<ImmerValue> reply) {
+            REQUIRE(reply);
+            completed.emplace_back(i, reply->as<int>());
+        }));
+    }
+    REQUIRE(remote.pending_requests() == 3);
+
+    std::vector<std::pair<WireHeader, ImmerValue>> requests;
+    while (auto request = receive_request(*raw)) {
+        REQUIRE(request->first.requestId != 0);
+        REQUIRE(request->first.flags == static_cast<uint8_t>(MessageFlags::IsRequest));
+        requests.push_back(*request);
+    }
+    REQUIRE(requests.size() == 3);
+
+    // An unknown id is ignored; the others are answered in reverse order
+    WireHeader unknown = requests[0].first;
+    unknown.requestId = requests[0].first.requestId + 100;
+    REQUIRE(post_response(*raw, unknown, ImmerValue{-1}));
+    for (auto it = requests.rbegin(); it != requests.rend(); ++it) {
+        const int value = it->second.as<int>();
+        REQUIRE(post_response(*raw, it->first, ImmerValue{value * value}));
+    }
+    REQUIRE(remote.poll() == 4);
+
+    REQUIRE(completed == std::vector<std::pair<int, int>>{{2, 4}, {1, 1}, {0, 0}});
+    REQUIRE(remote.pending_requests() == 0);
+
+    SECTION("a duplicate response is dropped") {
+        REQUIRE(post_response(*raw, requests[0].first, ImmerValue{99}));
+        REQUIRE(remote.poll() == 1);
+        REQUIRE(completed.size() == 3);
+    }
+
+    SECTION("send() between peers") {
+        EventBus other_bus;
+        RemoteBus responder{unique_remote_name("remote_send_"), other_bus};
+        RemoteBus requester{responder.channel_name(), bus};
+        auto conn = responder.on_request("double", [](const ImmerValue& v) { return ImmerValue{v.as<int>() * 2}; });
+
+        auto future = requester.send_async("double", ImmerValue{21});
+        REQUIRE(responder.poll() == 1);
+        while (future.wait_for(0ms) != std::future_status::ready) {
+            requester.wait_and_poll(100ms);
+        }
+        auto reply = future.get();
+        REQUIRE(reply);
+        REQUIRE(reply->as<int>() == 42);
+    }
+}
+
+TEST_CASE("RemoteBus times out unanswered requests", "[eventbus][ipc][remote][request]") {
+    const std::string name = unique_remote_name("remote_timeout_");
+    EventBus bus;
+    RemoteBus remote{name, bus};
+    auto raw = ipc::ChannelPair::connect(name);
+    REQUIRE(raw);
+
+    SECTION("expired requests complete with nullopt") {
+        std::vector<std::optional<ImmerValue>> replies;
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE(remote.send_async("slow", ImmerValue{1}, [&](std::optional<ImmerValue> r) { replies.push_back(r); }, 20ms));
+        REQUIRE(remote.send_async("slow", ImmerValue{2}, [&](std::optional<ImmerValue> r) { replies.push_back(r); }, 2000ms));
+
+        while (replies.empty()) {
+            remote.wait_and_poll(1000ms);
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start >= 20ms);
+        REQUIRE(replies.size() == 1);
+        REQUIRE_FALSE(replies[0]);
+        REQUIRE(remote.pending_requests() == 1);
+
+        // A late response to the expired request is dropped; the other one still completes
+        auto first = receive_request(*raw);
+        auto second = receive_request(*raw);
+        REQUIRE((first && second));
+        REQUIRE(post_response(*raw, first->first, ImmerValue{10}));
+        REQUIRE(post_response(*raw, second->first, ImmerValue{20}));
+        REQUIRE(remote.poll() == 2);
+        REQUIRE(replies.size() == 2);
+        REQUIRE(replies[1]->as<int>() == 20);
+        REQUIRE(remote.pending_requests() == 0);
+    }
+
+    SECTION("send() returns nullopt after the timeout") {
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE_FALSE(remote.send("slow", ImmerValue{1}, 30ms));
+        REQUIRE(std::chrono::steady_clock::now() - start >= 30ms);
+        REQUIRE(remote.pending_requests() == 0);
+    }
+
+    SECTION("milliseconds::max() never expires") {
+        std::optional<ImmerValue> reply;
+        bool done = false;
+        REQUIRE(remote.send_async("slow", ImmerValue{1}, [&](std::optional<ImmerValue> r) {
+            reply = std::move(r);
+            done = true;
+        }, std::chrono::milliseconds::max()));
+
+        REQUIRE(remote.poll(20ms) == 0);
+        REQUIRE_FALSE(done);
+        REQUIRE(remote.pending_requests() == 1);
+
+        auto request = receive_request(*raw);
+        REQUIRE(request);
+        REQUIRE(post_response(*raw, request->first, ImmerValue{7}));
+        REQUIRE(remote.poll() == 1);
+        REQUIRE(done);
+        REQUIRE(reply->as<int>() == 7);
+    }
+}
+
+TEST_CASE("RemoteBus cancels the timeout of answered requests", "[eventbus][ipc][remote][request]") {
+    const std::string name = unique_remote_name("remote_cancel_");
+    EventBus bus;
+    RemoteBus remote{name, bus};
+    auto raw = ipc::ChannelPair::connect(name);
+    REQUIRE(raw);
+
+    int timeouts = 0;
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(remote.send_async("fast", ImmerValue{i}, [&](std::optional<ImmerValue> r) { timeouts += !r; }, 30ms));
+    }
+    while (auto request = receive_request(*raw)) {
+        REQUIRE(post_response(*raw, request->first, request->second));
+    }
+    REQUIRE(remote.poll() == 100);
+    REQUIRE(remote.pending_requests() == 0);
+
+    // No timer is left to cut an idle wait short
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(remote.wait_and_poll(150ms) == 0);
+    REQUIRE(std::chrono::steady_clock::now() - start >= 150ms);
+    REQUIRE(timeouts == 0);
+}
@@ -2,8 +2,16 @@
 // Module 1: Core ImmerValue functionality
 
 #include <catch2/catch_all.hpp>
+#include <lager_ext/indexed_snapshot.h>
+#include <lager_ext/serialization.h>
+#include <lager_ext/snapshot_file.h>
 #include <lager_ext/value.h>
 
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
 using namespace lager_ext;
 
 // ============================================================
@@ -477,6 +485,56 @@ TEST_CASE("ImmerValue equality", "[value][comparison]") {
     }
 }
 
+TEST_CASE("ImmerValue content hash", "[value][comparison]") {
+    auto original = ImmerValue::map({{"name", ImmerValue{"cube"}},
+                                     {"position", ImmerValue::vec3(1.0f, 2.0f, 3.0f)},
+                                     {"tags", ImmerValue::vector({ImmerValue{"a"}, ImmerValue{"b"}})}});
+
+    SECTION("equal values hash equal, whatever their storage") {
+        auto copy = deserialize(serialize(original));
+        REQUIRE(copy == original);
+        REQUIRE(content_hash(copy) == content_hash(original));
+
+        auto reordered = ImmerValue{ValueMap{}}
+                             .set("tags", original.at("tags"))
+                             .set("position", original.at("position"))
+                             .set("name", ImmerValue{"cube"});
+        REQUIRE(content_hash(reordered) == content_hash(original));
+        REQUIRE(content_hash(ImmerValue{0.0}) == content_hash(ImmerValue{-0.0}));
+    }
+
+    SECTION("differences change the hash") {
+        REQUIRE(content_hash(original.set("name", ImmerValue{"sphere"})) != content_hash(original));
+        REQUIRE(content_hash(ImmerValue{int32_t{1}}) != content_hash(ImmerValue{int64_t{1}}));
+        auto swapped = ImmerValue::vector({ImmerValue{"b"}, ImmerValue{"a"}});
+        REQUIRE(content_hash(swapped) != content_hash(original.at("tags")));
+    }
+
+    SECTION("hashes are cached in the containers") {
+        auto copy = deserialize(serialize(original));
+        REQUIRE(cached_content_hash(copy) == 0);
+        const std::size_t hash = content_hash(copy);
+        REQUIRE(cached_content_hash(copy) == hash);
+        REQUIRE(cached_content_hash(copy.at("tags")) != 0);
+        REQUIRE(cached_content_hash(ImmerValue{42}) == 0);
+
+        // Cached hashes that differ decide inequality; equal ones still compare
+        auto changed = deserialize(serialize(original.set("name", ImmerValue{"sphere"})));
+        (void)content_hash(changed);
+        REQUIRE(copy != changed);
+        (void)content_hash(original);
+        REQUIRE(copy == original);
+    }
+
+    SECTION("std::hash deduplicates by content") {
+        std::unordered_set<ImmerValue> unique;
+        unique.insert(original);
+        unique.insert(deserialize(serialize(original)));
+        unique.insert(original.set("name", ImmerValue{"sphere"}));
+        REQUIRE(unique.size() == 2);
+    }
+}
+
 // ============================================================
 // Serialization Tests
 // ============================================================
@@ -508,6 +566,118 @@ TEST_CASE("ImmerValue JSON serialization", "[value][serialization]") {
         REQUIRE(parsed.at("name").as_string() == "test");
         REQUIRE(parsed.at("value").as<int>() == 123);
     }
+
+    SECTION("string escaping") {
+        ImmerValue v{std::string("a\"b\\c\n\t\x01 long enough to cross a 16-byte block")};
+        REQUIRE(to_json(v, true) == "\"a\\\"b\\\\c\\n\\t\\u0001 long enough to cross a 16-byte block\"");
+    }
+
+    SECTION("floating point formatting") {
+        REQUIRE(to_json(ImmerValue{1.5f}, true) == "1.5");
+        REQUIRE(to_json(ImmerValue{0.1}, true) == "0.1");
+        REQUIRE(to_json(ImmerValue{1e20}, true) == "1e+20");
+        REQUIRE(to_json(ImmerValue::vec3(1.0f, 2.5f, -3.0f), true) == "[1,2.5,-3]");
+    }
+
+    SECTION("pretty format") {
+        auto original = ImmerValue::map({{"inner", ImmerValue::map({{"x", ImmerValue{1}}})}});
+        REQUIRE(to_json(original, false) == "{\n  \"inner\": {\n    \"x\": 1\n  }\n}");
+        REQUIRE(to_json(ImmerValue::map({}), false) == "{}");
+    }
+
+    SECTION("append to existing string") {
+        std::string out = "prefix:";
+        to_json(ImmerValue{42}, out, true);
+        REQUIRE(out == "prefix:42");
+    }
+
+    SECTION("stream to FILE") {
+        auto original = ImmerValue::map({{"name", ImmerValue{"test"}}});
+        std::FILE* file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        REQUIRE(to_json_file(original, file, false));
+
+        std::string expected = to_json(original, false);
+        std::string written(expected.size(), '\0');
+        std::rewind(file);
+        REQUIRE(std::fread(written.data(), 1, written.size(), file) == expected.size());
+        std::fclose(file);
+        REQUIRE(written == expected);
+    }
+}
+
+TEST_CASE("ImmerValue parse_json", "[value][serialization]") {
+    SECTION("matches from_json") {
+        std::string json = R"({
+            "name": "test",
+            "count": 123,
+            "big": 9007199254740993,
+            "ratio": -1.25e-2,
+            "flags": [true, false, null],
+            "nested": {"items": [1, [2, {"three": 3}]], "empty": {}, "none": []}
+        })";
+        auto result = parse_json(json);
+        REQUIRE(result.ok());
+        REQUIRE(result.value == from_json(json));
+        REQUIRE(result.value.at("count").as<int>() == 123);
+        REQUIRE(result.value.at("big").as<int64_t>() == 9007199254740993LL);
+    }
+
+    SECTION("strings crossing scan blocks") {
+        // Escaped quotes and backslash runs straddling 64-byte block boundaries
+        std::string expected;
+        std::string json = "\"";
+        for (int i = 0; i < 300; ++i) {
+            if (i % 61 == 0) {
+                json += "\\\"";
+                expected += '"';
+            } else if (i % 37 == 0) {
+                json += "\\\\\\\\";
+                expected += "\\\\";
+            } else {
+                json += static_cast<char>('a' + i % 26);
+                expected += static_cast<char>('a' + i % 26);
+            }
+        }
+        json += "\"";
+        auto result = parse_json(json);
+        REQUIRE(result.ok());
+        REQUIRE(result.value.as_string() == expected);
+    }
+
+    SECTION("unicode escapes") {
+        auto result = parse_json(R"("\u00e9\ud83d\ude00")");
+        REQUIRE(result.ok());
+        REQUIRE(result.value.as_string() == "\xC3\xA9\xF0\x9F\x98\x80");
+    }
+
+    SECTION("round trip with to_json") {
+        auto original = ImmerValue::map({{"a", ImmerValue{1}}, {"b", ImmerValue{"x\ny"}}, {"c", ImmerValue{2.5}}});
+        REQUIRE(parse_json(to_json(original, false)).value == original);
+    }
+
+    SECTION("errors are reported with offsets") {
+        auto check = [](std::string_view json, JsonError error, std::size_t offset) {
+            auto result = parse_json(json);
+            REQUIRE(result.error == error);
+            REQUIRE(result.offset == offset);
+            REQUIRE_FALSE(result);
+            REQUIRE(result.value.is_null());
+        };
+        check("", JsonError::EmptyInput, 0);
+        check("{\"a\":1", JsonError::UnexpectedEnd, 6);
+        check("\"abc", JsonError::UnterminatedString, 4);
+        check("[1 2]", JsonError::UnexpectedCharacter, 3);
+        check("[1,]", JsonError::UnexpectedCharacter, 3);
+        check("1 2", JsonError::TrailingCharacters, 2);
+        check("truex", JsonError::InvalidLiteral, 0);
+        check("01", JsonError::InvalidNumber, 0);
+        check("1e999", JsonError::InvalidNumber, 0);
+        check("\"a\\qb\"", JsonError::InvalidEscape, 2);
+        check("\"a\x01\"", JsonError::InvalidString, 2);
+        check(std::string(600, '['), JsonError::DepthLimitExceeded, 512);
+        REQUIRE(std::string(json_error_message(JsonError::InvalidNumber)) == "Invalid number");
+    }
 }
 
 TEST_CASE("ImmerValue binary serialization", "[value][serialization]") {
@@ -554,3 +724,282 @@ TEST_CASE("ImmerValue binary serialization", "[value][serialization]") {
         REQUIRE(vec[2] == Catch::Approx(3.0f));
     }
 }
+
+TEST_CASE("ImmerValue compact binary format", "[value][serialization]") {
+    auto original = ImmerValue::map({
+        {"id", ImmerValue{42}},
+        {"name", ImmerValue{"cube"}},
+        {"big", ImmerValue{int64_t{-9000000000LL}}},
+        {"mask", ImmerValue{uint32_t{0xFFFFFFFFu}}},
+        {"small", ImmerValue{int16_t{-3}}},
+        {"pos", ImmerValue::vec3(1.0f, 2.0f, 3.0f)}
+    });
+
+    SECTION("round-trip and auto-detection") {
+        auto buffer = serialize(original, BinaryFormat::Compact);
+        REQUIRE(buffer[0] == COMPACT_FORMAT_MARKER);
+        REQUIRE(deserialize(buffer) == original);
+    }
+
+    SECTION("smaller than the standard format") {
+        REQUIRE(serialized_size(original, BinaryFormat::Compact) < serialized_size(original));
+    }
+
+    SECTION("serialized_size and serialize_to agree") {
+        std::size_t size = serialized_size(original, BinaryFormat::Compact);
+        ByteBuffer buffer(size);
+        REQUIRE(serialize_to(original, buffer.data(), buffer.size(), BinaryFormat::Compact) == size);
+        REQUIRE(buffer == serialize(original, BinaryFormat::Compact));
+        REQUIRE_THROWS(serialize_to(original, buffer.data(), size - 1, BinaryFormat::Compact));
+    }
+
+    SECTION("integer limits") {
+        for (int64_t v : {int64_t{0}, int64_t{-1}, int64_t{63}, int64_t{-64}, INT64_MIN, INT64_MAX}) {
+            REQUIRE(deserialize(serialize(ImmerValue{v}, BinaryFormat::Compact)).as<int64_t>() == v);
+        }
+        REQUIRE(deserialize(serialize(ImmerValue{UINT64_MAX}, BinaryFormat::Compact)).as<uint64_t>() == UINT64_MAX);
+    }
+
+    SECTION("out-of-range varint is rejected") {
+        // int16 tag with a varint payload of 2^20
+        const uint8_t bad[] = {COMPACT_FORMAT_MARKER, 0x0C, 0x80, 0x80, 0x40};
+        REQUIRE_THROWS(deserialize(bad, sizeof(bad)));
+    }
+
+    SECTION("streaming decode") {
+        auto buffer = serialize(original, BinaryFormat::Compact);
+        StreamingDeserializer decoder;
+        for (uint8_t byte : buffer) {
+            decoder.feed(&byte, 1);
+        }
+        REQUIRE(decoder.status() == StreamingDeserializer::Status::Complete);
+        REQUIRE(decoder.take_result() == original);
+    }
+}
+
+TEST_CASE("ImmerValue dictionary binary format", "[value][serialization]") {
+    // Many maps sharing the same keys: each key should be stored once
+    auto scene = ImmerValue::map({});
+    for (int i = 0; i < 32; ++i) {
+        scene = scene.set("entity_" + std::to_string(i), ImmerValue::map({
+            {"name", ImmerValue{"entity"}},
+            {"position", ImmerValue::vec3(1.0f, 2.0f, float(i))},
+            {"visible", ImmerValue{true}},
+            {"layer", ImmerValue{i % 4}}
+        }));
+    }
+
+    SECTION("round-trip and auto-detection") {
+        auto buffer = serialize(scene, BinaryFormat::Dictionary);
+        REQUIRE(buffer[0] == DICTIONARY_FORMAT_MARKER);
+        REQUIRE(deserialize(buffer) == scene);
+    }
+
+    SECTION("smaller than the compact format") {
+        REQUIRE(serialized_size(scene, BinaryFormat::Dictionary) < serialized_size(scene, BinaryFormat::Compact));
+    }
+
+    SECTION("serialized_size and serialize_to agree") {
+        std::size_t size = serialized_size(scene, BinaryFormat::Dictionary);
+        ByteBuffer buffer(size);
+        REQUIRE(serialize_to(scene, buffer.data(), buffer.size(), BinaryFormat::Dictionary) == size);
+        REQUIRE(buffer == serialize(scene, BinaryFormat::Dictionary));
+        REQUIRE_THROWS(serialize_to(scene, buffer.data(), size - 1, BinaryFormat::Dictionary));
+    }
+
+    SECTION("scalars and empty containers") {
+        for (const ImmerValue& v : {ImmerValue{}, ImmerValue{"text"}, ImmerValue::map({})}) {
+            REQUIRE(deserialize(serialize(v, BinaryFormat::Dictionary)) == v);
+        }
+    }
+
+    SECTION("out-of-range key index is rejected") {
+        // Dictionary {"k"}, then a one-entry map referencing key #5
+        const uint8_t bad[] = {DICTIONARY_FORMAT_MARKER, 0x01, 0x01, 'k', 0x06, 0x01, 0x05, 0x00};
+        REQUIRE_THROWS(deserialize(bad, sizeof(bad)));
+
+        StreamingDeserializer decoder;
+        REQUIRE(decoder.feed(bad, sizeof(bad)) == StreamingDeserializer::Status::Error);
+    }
+
+    SECTION("streaming decode") {
+        auto buffer = serialize(scene, BinaryFormat::Dictionary);
+        StreamingDeserializer decoder;
+        for (uint8_t byte : buffer) {
+            decoder.feed(&byte, 1);
+        }
+        REQUIRE(decoder.status() == StreamingDeserializer::Status::Complete);
+        REQUIRE(decoder.take_result() == scene);
+    }
+}
+
+TEST_CASE("LazyValueView over an indexed snapshot", "[value][serialization]") {
+    auto scene = ImmerValue::map({
+        {"name", ImmerValue{"level_1"}},
+        {"entities", ImmerValue::map({
+            {"e1", ImmerValue::map({{"position", ImmerValue::vec3(1.0f, 2.0f, 3.0f)}, {"visible", ImmerValue{true}}})},
+            {"e2", ImmerValue::map({{"position", ImmerValue::vec3(4.0f, 5.0f, 6.0f)}, {"visible", ImmerValue{false}}})}
+        })},
+        {"layers", ImmerValue::vector({ImmerValue{"default"}, ImmerValue{"ui"}})}
+    });
+    auto buffer = serialize_indexed(scene);
+    LazyValueView root(buffer);
+
+    SECTION("full materialization and auto-detection") {
+        REQUIRE(buffer[0] == INDEXED_FORMAT_MARKER);
+        REQUIRE(root.materialize() == scene);
+        REQUIRE(deserialize(buffer) == scene);
+    }
+
+    SECTION("path lookups decode only the target") {
+        REQUIRE(root.get_at_path({"entities", "e2", "position"}) == ImmerValue::vec3(4.0f, 5.0f, 6.0f));
+        REQUIRE(root.get_at_path({"layers", std::size_t{1}}) == ImmerValue{"ui"});
+        REQUIRE(root.at("name").as_string_view() == "level_1");
+    }
+
+    SECTION("structure queries") {
+        REQUIRE(root.is_map());
+        REQUIRE(root.size() == 3);
+        REQUIRE(root.at("entities").size() == 2);
+        REQUIRE(root.at("entities").key_at(0) == "e1");
+        REQUIRE(root.at("layers").is_vector());
+    }
+
+    SECTION("missing paths yield an empty view") {
+        REQUIRE_FALSE(root.at("missing"));
+        REQUIRE_FALSE(root.at_path({"entities", "e3", "position"}));
+        REQUIRE_FALSE(root.at_path({"layers", std::size_t{5}}));
+        REQUIRE(root.get_at_path({"name", "nested"}).is_null());
+    }
+
+    SECTION("rejects other formats and corrupt offsets") {
+        auto standard = serialize(scene);
+        REQUIRE_THROWS(LazyValueView{standard});
+
+        // Map with one entry whose value offset points back into its own header
+        const uint8_t bad[] = {INDEXED_FORMAT_MARKER, 0x06, 1, 0, 0, 0, 17, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 'k', 0x00};
+        REQUIRE_THROWS(LazyValueView(bad, sizeof(bad)).materialize());
+    }
+}
+
+TEST_CASE("Memory-mapped snapshot files", "[value][serialization]") {
+    auto scene = ImmerValue::map({
+        {"name", ImmerValue{"level_1"}},
+        {"entities", ImmerValue::map({
+            {"e1", ImmerValue::map({{"position", ImmerValue::vec3(1.0f, 2.0f, 3.0f)}})},
+            {"e2", ImmerValue::map({{"position", ImmerValue::vec3(4.0f, 5.0f, 6.0f)}})}
+        })}
+    });
+    const std::string path = (std::filesystem::temp_directory_path() / "lager_ext_test.snap").string();
+
+    SECTION("round-trip in every format") {
+        for (auto format : {SnapshotFormat::Standard, SnapshotFormat::Compact, SnapshotFormat::Dictionary,
+                            SnapshotFormat::Indexed}) {
+            REQUIRE(save_snapshot(path, scene, format));
+            REQUIRE(load_snapshot(path) == scene);
+        }
+    }
+
+    SECTION("view mode reads through the mapping") {
+        REQUIRE(save_snapshot(path, scene));
+        MappedSnapshot snapshot;
+        REQUIRE(snapshot.open(path, SnapshotOpenMode::View));
+        REQUIRE(snapshot.format() == SnapshotFormat::Indexed);
+        REQUIRE(snapshot.view().get_at_path({"entities", "e2", "position"}) == ImmerValue::vec3(4.0f, 5.0f, 6.0f));
+        REQUIRE(snapshot.verify());
+    }
+
+    SECTION("checksum mismatch is detected") {
+        REQUIRE(save_snapshot(path, scene));
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(40);
+            file.put('\x7F');
+        }
+        MappedSnapshot snapshot;
+        REQUIRE_FALSE(snapshot.open(path));
+        REQUIRE_FALSE(snapshot.last_error().empty());
+
+        // View mode skips the checksum; verify() still catches it
+        REQUIRE(snapshot.open(path, SnapshotOpenMode::View));
+        REQUIRE_FALSE(snapshot.verify());
+    }
+
+    SECTION("missing file") {
+        std::string error;
+        REQUIRE(load_snapshot(path + ".missing", &error).is_null());
+        REQUIRE_FALSE(error.empty());
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("StreamingDeserializer", "[value][serialization]") {
+    auto original = ImmerValue::map({
+        {"users", ImmerValue::vector({
+            ImmerValue::map({{"name", ImmerValue{"Alice"}}}),
+            ImmerValue::map({{"name", ImmerValue{std::string(300, 'b')}}})
+        })},
+        {"count", ImmerValue{int64_t{2}}},
+        {"transform", ImmerValue::vec3(1.0f, 2.0f, 3.0f)}
+    });
+    auto buffer = serialize(original);
+
+    SECTION("one byte at a time") {
+        StreamingDeserializer decoder;
+        for (std::size_t i = 0; i < buffer.size(); ++i) {
+            REQUIRE(decoder.status() == StreamingDeserializer::Status::NeedMoreData);
+            decoder.feed(buffer.data() + i, 1);
+        }
+        REQUIRE(decoder.status() == StreamingDeserializer::Status::Complete);
+        REQUIRE(decoder.take_result() == original);
+    }
+
+    SECTION("every two-chunk split") {
+        for (std::size_t split = 0; split <= buffer.size(); ++split) {
+            StreamingDeserializer decoder;
+            decoder.feed(buffer.data(), split);
+            decoder.feed(buffer.data() + split, buffer.size() - split);
+            REQUIRE(decoder.status() == StreamingDeserializer::Status::Complete);
+            REQUIRE(decoder.take_result() == original);
+        }
+    }
+
+    SECTION("stops at the end of the value") {
+        ByteBuffer two = buffer;
+        two.insert(two.end(), buffer.begin(), buffer.end());
+
+        StreamingDeserializer decoder;
+        REQUIRE(decoder.feed(two) == StreamingDeserializer::Status::Complete);
+        REQUIRE(decoder.bytes_consumed() == buffer.size());
+
+        decoder.reset();
+        decoder.feed(two.data() + buffer.size(), buffer.size());
+        REQUIRE(decoder.take_result() == original);
+    }
+
+    SECTION("subtree callbacks") {
+        std::vector<std::string> seen;
+        StreamingDeserializer decoder;
+        decoder.on_subtree(1, [&](PathView path, const ImmerValue&) {
+            REQUIRE(path.size() == 1);
+            seen.emplace_back(std::get<std::string_view>(path[0]));
+            return seen.back() != "users"; // Drop the large subtree
+        });
+        decoder.feed(buffer);
+        REQUIRE(decoder.status() == StreamingDeserializer::Status::Complete);
+        REQUIRE(seen.size() == 3);
+
+        auto result = decoder.take_result();
+        REQUIRE(result.size() == 2);
+        REQUIRE(result.at("count").as<int64_t>() == 2);
+        REQUIRE_FALSE(result.contains("users"));
+    }
+
+    SECTION("unknown tag is an error") {
+        const uint8_t bad[] = {0x7F};
+        StreamingDeserializer decoder;
+        REQUIRE(decoder.feed(bad, sizeof(bad)) == StreamingDeserializer::Status::Error);
+        REQUIRE_FALSE(decoder.error().empty());
+    }
+}
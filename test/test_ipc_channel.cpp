@@ -0,0 +1,700 @@
+// test_ipc_channel.cpp - Tests for the shared-memory IPC channels
+// Module 10: Channel / ChannelPair / ChannelMPMC
+
+#include <catch2/catch_all.hpp>
+#include <lager_ext/ipc.h>
+#include <lager_ext/serialization.h>
+#include <lager_ext/shared_memory_pool.h>
+#include <lager_ext/value.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lager_ext;
+using namespace lager_ext::ipc;
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+static std::string unique_channel_name(const std::string& prefix) {
+    return prefix + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+// ============================================================
+// Ownership Tests
+// ============================================================
+
+TEST_CASE("Channel creator owns the shared memory", "[ipc][channel][lifetime]") {
+    const std::string name = unique_channel_name("chan_owner_");
+    auto producer = Channel::create(name, 16, 64 * 1024);
+    REQUIRE(producer);
+
+    SECTION("consumer teardown leaves the channel in place") {
+        auto consumer = Channel::open(name);
+        REQUIRE(consumer);
+        REQUIRE(producer->post(1, ImmerValue{"first"}));
+        consumer.reset();
+
+        REQUIRE(producer->post(2, ImmerValue{"second"}));
+        auto reopened = Channel::open(name);
+        REQUIRE(reopened);
+        REQUIRE(reopened->tryReceive()->msgId == 1);
+        REQUIRE(reopened->tryReceive()->msgId == 2);
+    }
+
+    SECTION("creator teardown removes the channel and its pool") {
+        auto consumer = Channel::open(name);
+        REQUIRE(consumer);
+        const std::string large(1000, 'x');
+        REQUIRE(producer->post(1, ImmerValue{large}));
+        producer.reset();
+
+        REQUIRE_FALSE(Channel::open(name));
+        REQUIRE_FALSE(SharedMemoryPool::open(name + "_pool"));
+
+        // An attached consumer keeps its mappings and drains what was queued
+        auto msg = consumer->tryReceive();
+        REQUIRE(msg);
+        REQUIRE(msg->data.as<std::string>() == large);
+    }
+}
+
+TEST_CASE("ChannelPair creator owns both channels", "[ipc][channelpair][lifetime]") {
+    const std::string name = unique_channel_name("pair_owner_");
+    auto creator = ChannelPair::create(name, 16);
+    REQUIRE(creator);
+
+    auto connector = ChannelPair::connect(name);
+    REQUIRE(connector);
+
+    // The connector produces on the reverse channel, the creator consumes it
+    REQUIRE(connector->post(1, ImmerValue{"to creator"}));
+    auto request = creator->tryReceive();
+    REQUIRE(request);
+    REQUIRE(request->data.as<std::string>() == "to creator");
+    REQUIRE(creator->post(2, ImmerValue{"to connector"}));
+    auto reply = connector->tryReceive();
+    REQUIRE(reply);
+    REQUIRE(reply->data.as<std::string>() == "to connector");
+
+    SECTION("connector teardown leaves both channels to the creator") {
+        connector.reset();
+        REQUIRE(creator->post(3, ImmerValue{"queued"}));
+
+        auto reconnected = ChannelPair::connect(name);
+        REQUIRE(reconnected);
+        REQUIRE(reconnected->tryReceive()->msgId == 3);
+        REQUIRE(reconnected->post(4, ImmerValue{"again"}));
+        REQUIRE(creator->tryReceive()->msgId == 4);
+    }
+
+    SECTION("creator teardown removes both channels") {
+        creator.reset();
+        REQUIRE_FALSE(Channel::open(name + "_AtoB"));
+        REQUIRE_FALSE(Channel::open(name + "_BtoA"));
+        REQUIRE_FALSE(ChannelPair::connect(name));
+    }
+}
+
+// ============================================================
+// Large Payload Tests
+// ============================================================
+
+TEST_CASE("Channel drops messages with an invalid pool block", "[ipc][channel][pool]") {
+    const std::string name = unique_channel_name("chan_badblock_");
+    constexpr size_t pool_size = 64 * 1024;
+    auto producer = Channel::create(name, 16, pool_size);
+    REQUIRE(producer);
+    auto consumer = Channel::open(name);
+    REQUIRE(consumer);
+
+    const std::string large(1000, 'x');
+    const std::string small = "still here";
+
+    // The first block of a fresh pool has a fixed offset: find it with a scratch pool,
+    // then free it behind the producer's back to break the queued message
+    auto scratch = SharedMemoryPool::create(unique_channel_name("chan_scratch_"), pool_size);
+    REQUIRE(scratch);
+    const uint64_t offset = scratch->allocate(large.size()).offset();
+    auto pool = SharedMemoryPool::open(name + "_pool");
+    REQUIRE(pool);
+
+    REQUIRE(producer->postRaw(1, large.data(), large.size()));
+    REQUIRE(producer->post(2, ImmerValue{small}));
+    REQUIRE(pool->allocated_count() == 1);
+    pool->deallocate(offset);
+    REQUIRE(pool->allocated_count() == 0);
+
+    SECTION("tryReceive") {
+        auto msg = consumer->tryReceive();
+        REQUIRE(msg);
+        REQUIRE(msg->msgId == 2);
+        REQUIRE(msg->data.as<std::string>() == small);
+        REQUIRE(consumer->lastError() == "Invalid payload pool block");
+        REQUIRE_FALSE(consumer->tryReceive());
+    }
+
+    SECTION("receiveBatch") {
+        std::vector<Channel::ReceivedMessage> batch;
+        REQUIRE(consumer->receiveBatch(batch) == 1);
+        REQUIRE(batch[0].msgId == 2);
+        REQUIRE(batch[0].data.as<std::string>() == small);
+        REQUIRE(consumer->pendingCount() == 0);
+    }
+
+    SECTION("drainRaw") {
+        std::vector<uint32_t> handled;
+        REQUIRE(consumer->drainRaw([&](uint32_t msgId, std::span<const uint8_t>) { handled.push_back(msgId); }) == 1);
+        REQUIRE(handled == std::vector<uint32_t>{2});
+    }
+
+    SECTION("tryReceiveRaw") {
+        // The buffer is too small for the broken message, but it is dropped before the size check
+        uint32_t msgId = 0;
+        uint8_t buffer[64] = {};
+        const int size = consumer->tryReceiveRaw(msgId, buffer, sizeof(buffer));
+        REQUIRE(size > 0);
+        REQUIRE(msgId == 2);
+        REQUIRE(deserialize(buffer, static_cast<size_t>(size)).as<std::string>() == small);
+    }
+}
+
+// ============================================================
+// ByteRing Tests
+// ============================================================
+
+// Payload of the given size whose bytes depend on seed, so misplaced records show up
+static std::vector<uint8_t> pattern_payload(size_t size, uint32_t seed) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>((seed * 31 + i * 7) & 0xFF);
+    }
+    return bytes;
+}
+
+static std::vector<uint8_t> receive_raw(Channel& channel, uint32_t& msgId) {
+    std::vector<uint8_t> buffer(64 * 1024);
+    const int size = channel.tryReceiveRaw(msgId, buffer.data(), buffer.size());
+    REQUIRE(size >= 0);
+    buffer.resize(static_cast<size_t>(size));
+    return buffer;
+}
+
+TEST_CASE("ByteRing wraps with a padding record", "[ipc][channel][bytering]") {
+    // capacity 1: a 256-byte ring, payloads up to 64 bytes stay inline
+    const std::string name = unique_channel_name("ring_wrap_");
+    auto producer = Channel::create(name, 1, 0, ChannelMode::ByteRing);
+    REQUIRE(producer);
+    auto consumer = Channel::open(name);
+    REQUIRE(consumer);
+    REQUIRE(consumer->mode() == ChannelMode::ByteRing);
+
+    SECTION("records fill the ring exactly") {
+        // 32-byte header + 32-byte payload = 64-byte records, four to a ring
+        for (uint32_t i = 0; i < 4; ++i) {
+            auto payload = pattern_payload(32, i);
+            REQUIRE(producer->postRaw(i, payload.data(), payload.size()));
+        }
+        REQUIRE_FALSE(producer->canPost());
+        REQUIRE_FALSE(producer->postRaw(4, nullptr, 0));
+        REQUIRE(producer->lastError() == "Queue full");
+
+        // Freeing the first record makes room at offset 0, with no padding needed
+        uint32_t msgId = 0;
+        REQUIRE(receive_raw(*consumer, msgId) == pattern_payload(32, 0));
+        auto payload = pattern_payload(32, 4);
+        REQUIRE(producer->postRaw(4, payload.data(), payload.size()));
+
+        for (uint32_t i = 1; i <= 4; ++i) {
+            REQUIRE(receive_raw(*consumer, msgId) == pattern_payload(32, i));
+            REQUIRE(msgId == i);
+        }
+        REQUIRE(consumer->pendingCount() == 0);
+    }
+
+    SECTION("a record that does not fit the tail starts at offset 0") {
+        // 32 + 56 = 88-byte records: two fill 176 bytes and leave an 80-byte tail
+        auto a = pattern_payload(56, 1);
+        auto b = pattern_payload(56, 2);
+        auto c = pattern_payload(56, 3);
+        REQUIRE(producer->postRaw(1, a.data(), a.size()));
+        REQUIRE(producer->postRaw(2, b.data(), b.size()));
+
+        // The tail is skipped too, so C needs 80 + 88 bytes
+        REQUIRE_FALSE(producer->postRaw(3, c.data(), c.size()));
+
+        uint32_t msgId = 0;
+        REQUIRE(receive_raw(*consumer, msgId) == a);
+        REQUIRE(producer->postRaw(3, c.data(), c.size()));
+        REQUIRE(consumer->pendingCount() == 2);
+
+        // The padding record is skipped transparently
+        REQUIRE(receive_raw(*consumer, msgId) == b);
+        REQUIRE(msgId == 2);
+        REQUIRE(receive_raw(*consumer, msgId) == c);
+        REQUIRE(msgId == 3);
+        REQUIRE(consumer->pendingCount() == 0);
+        REQUIRE_FALSE(consumer->tryReceive());
+    }
+
+    SECTION("variable-size records round-trip across many revolutions") {
+        std::deque<std::pair<uint32_t, std::vector<uint8_t>>> expected;
+        uint32_t received = 0;
+        for (uint32_t i = 0; i < 2000; ++i) {
+            auto payload = pattern_payload((i * 13) % 65, i);
+            while (!producer->postRaw(i, payload.data(), payload.size())) {
+                REQUIRE_FALSE(expected.empty());
+                uint32_t msgId = 0;
+                REQUIRE(receive_raw(*consumer, msgId) == expected.front().second);
+                REQUIRE(msgId == expected.front().first);
+                expected.pop_front();
+                ++received;
+            }
+            expected.emplace_back(i, std::move(payload));
+        }
+        while (!expected.empty()) {
+            uint32_t msgId = 0;
+            REQUIRE(receive_raw(*consumer, msgId) == expected.front().second);
+            REQUIRE(msgId == expected.front().first);
+            expected.pop_front();
+            ++received;
+        }
+        REQUIRE(received == 2000);
+        REQUIRE(consumer->pendingCount() == 0);
+    }
+}
+
+TEST_CASE("Channel inline payload threshold", "[ipc][channel][pool]") {
+    const std::string name = unique_channel_name("chan_threshold_");
+    const bool byteRing = GENERATE(false, true);
+    const ChannelMode mode = byteRing ? ChannelMode::ByteRing : ChannelMode::FixedSlots;
+
+    // FixedSlots keeps Message::INLINE_SIZE bytes inline, ByteRing a quarter of the ring
+    constexpr size_t capacity = 16;
+    const size_t inlineLimit = byteRing ? capacity * sizeof(Message) / 4 : Message::INLINE_SIZE;
+
+    auto producer = Channel::create(name, capacity, 64 * 1024, mode);
+    REQUIRE(producer);
+    auto consumer = Channel::open(name);
+    REQUIRE(consumer);
+    auto pool = SharedMemoryPool::open(name + "_pool");
+    REQUIRE(pool);
+
+    auto atLimit = pattern_payload(inlineLimit, 1);
+    REQUIRE(producer->postRaw(1, atLimit.data(), atLimit.size()));
+    REQUIRE(pool->allocated_count() == 0);
+
+    auto overLimit = pattern_payload(inlineLimit + 1, 2);
+    REQUIRE(producer->postRaw(2, overLimit.data(), overLimit.size()));
+    REQUIRE(pool->allocated_count() == 1);
+
+    uint32_t msgId = 0;
+    REQUIRE(receive_raw(*consumer, msgId) == atLimit);
+    REQUIRE(msgId == 1);
+    REQUIRE(receive_raw(*consumer, msgId) == overLimit);
+    REQUIRE(msgId == 2);
+}
+
+// ============================================================
+// Batch Tests
+// ============================================================
+
+// Post same-sized messages until the queue is full; returns how many fit
+static uint32_t fill_queue(Channel& producer) {
+    uint32_t count = 0;
+    while (producer.post(count, ImmerValue{static_cast<int>(count)})) {
+        ++count;
+    }
+    return count;
+}
+
+TEST_CASE("Channel batches", "[ipc][channel][batch]") {
+    const bool byteRing = GENERATE(false, true);
+    const ChannelMode mode = byteRing ? ChannelMode::ByteRing : ChannelMode::FixedSlots;
+    const std::string name = unique_channel_name("chan_batch_");
+    auto producer = Channel::create(name, 8, 64 * 1024, mode);
+    REQUIRE(producer);
+    auto consumer = Channel::open(name);
+    REQUIRE(consumer);
+
+    auto batch_of = [](uint32_t first, uint32_t count) {
+        std::vector<Channel::OutgoingMessage> batch;
+        for (uint32_t id = first; id < first + count; ++id) {
+            batch.push_back({id, ImmerValue{static_cast<int>(id)}});
+        }
+        return batch;
+    };
+
+    SECTION("a batch into a nearly full queue posts a prefix") {
+        // Equal-sized messages, so each one received makes room for exactly one more
+        // (in ByteRing mode the first also pays for the skipped tail it had left)
+        const uint32_t full = fill_queue(*producer);
+        REQUIRE(full > 3);
+        for (uint32_t id = 0; id < 3; ++id) {
+            REQUIRE(consumer->tryReceive()->msgId == id);
+        }
+
+        auto batch = batch_of(full, 5);
+        REQUIRE(producer->postBatch(batch) == 3);
+        REQUIRE(producer->lastError() == "Queue full");
+        REQUIRE_FALSE(producer->canPost());
+        REQUIRE(producer->postBatch(batch_of(full + 3, 2)) == 0);
+
+        std::vector<Channel::ReceivedMessage> received;
+        REQUIRE(consumer->receiveBatch(received) == full);
+        for (uint32_t i = 0; i < full; ++i) {
+            REQUIRE(received[i].msgId == i + 3);
+            REQUIRE(received[i].data.as<int>() == static_cast<int>(i + 3));
+        }
+        REQUIRE(producer->postBatch(batch_of(100, 2)) == 2);
+    }
+
+    SECTION("batches keep FIFO order with single posts") {
+        REQUIRE(producer->postBatch({}) == 0);
+        REQUIRE(producer->post(1, ImmerValue{1}));
+        REQUIRE(producer->postBatch(batch_of(2, 3)) == 3);
+        REQUIRE(producer->post(5, ImmerValue{5}));
+        REQUIRE(consumer->pendingCount() == 5);
+
+        std::vector<Channel::ReceivedMessage> received;
+        REQUIRE(consumer->receiveBatch(received) == 5);
+        for (uint32_t i = 0; i < 5; ++i) {
+            REQUIRE(received[i].msgId == i + 1);
+            REQUIRE(received[i].data.as<int>() == static_cast<int>(i + 1));
+        }
+    }
+
+    SECTION("maxCount limits receiveBatch and drainRaw") {
+        REQUIRE(producer->postBatch(batch_of(1, 6)) == 6);
+
+        std::vector<Channel::ReceivedMessage> received(1);
+        REQUIRE(consumer->receiveBatch(received, 2) == 2);
+        REQUIRE(received.size() == 3); // Appended behind the existing entry
+        REQUIRE(received[1].msgId == 1);
+        REQUIRE(received[2].msgId == 2);
+        REQUIRE(consumer->pendingCount() == 4);
+
+        std::vector<uint32_t> handled;
+        auto record = [&](uint32_t msgId, std::span<const uint8_t>) { handled.push_back(msgId); };
+        REQUIRE(consumer->drainRaw(record, 3) == 3);
+        REQUIRE(handled == std::vector<uint32_t>{3, 4, 5});
+        REQUIRE(consumer->pendingCount() == 1);
+
+        REQUIRE(consumer->drainRaw(record, 0) == 0);
+        REQUIRE(consumer->drainRaw(record) == 1);
+        REQUIRE(handled.back() == 6);
+        REQUIRE(consumer->drainRaw(record) == 0);
+        REQUIRE(consumer->receiveBatch(received) == 0);
+        REQUIRE(received.size() == 3);
+    }
+
+    SECTION("drainRaw hands over each payload as posted") {
+        // Empty, inline, and pooled (over the inline limit in either mode) payloads
+        const std::vector<size_t> sizes = {0, 1, 64, Message::INLINE_SIZE, 1500};
+        for (uint32_t i = 0; i < sizes.size(); ++i) {
+            auto payload = pattern_payload(sizes[i], i);
+            REQUIRE(producer->postRaw(i, payload.data(), payload.size()));
+        }
+
+        std::vector<std::pair<uint32_t, std::vector<uint8_t>>> handled;
+        REQUIRE(consumer->drainRaw([&](uint32_t msgId, std::span<const uint8_t> payload) {
+            handled.emplace_back(msgId, std::vector<uint8_t>(payload.begin(), payload.end()));
+        }) == sizes.size());
+
+        REQUIRE(handled.size() == sizes.size());
+        for (uint32_t i = 0; i < sizes.size(); ++i) {
+            REQUIRE(handled[i].first == i);
+            REQUIRE(handled[i].second == pattern_payload(sizes[i], i));
+        }
+        REQUIRE(consumer->pendingCount() == 0);
+    }
+}
+
+// ============================================================
+// Wait Tests
+// ============================================================
+
+namespace {
+using WaitClock = std::chrono::steady_clock;
+
+/// Post msgId from a second thread after delay
+std::thread post_later(Channel& producer, uint32_t msgId, std::chrono::milliseconds delay) {
+    return std::thread([&producer, msgId, delay] {
+        std::this_thread::sleep_for(delay);
+        producer.post(msgId, ImmerValue{static_cast<int>(msgId)});
+    });
+}
+} // namespace
+
+TEST_CASE("Channel wait wakes on a post from another thread", "[ipc][channel][wait]") {
+    const bool byteRing = GENERATE(false, true);
+    const std::string name = unique_channel_name("chan_wake_");
+    auto producer = Channel::create(name, 16, 0, byteRing ? ChannelMode::ByteRing : ChannelMode::FixedSlots);
+    REQUIRE(producer);
+    auto consumer = Channel::open(name);
+    REQUIRE(consumer);
+
+    SECTION("a sleeping consumer is woken well before its timeout") {
+        auto poster = post_later(*producer, 1, std::chrono::milliseconds(50));
+        const auto start = WaitClock::now();
+        const bool woken = consumer->waitForMessage(std::chrono::seconds(10));
+        const auto waited = WaitClock::now() - start;
+        poster.join();
+        REQUIRE(woken);
+        REQUIRE(waited < std::chrono::seconds(5));
+        REQUIRE(consumer->tryReceive()->msgId == 1);
+    }
+
+    SECTION("no wakeup is lost across many hand-offs") {
+        // The producer posts as the consumer goes to sleep, at every point of the
+        // spin / announce / futex_wait sequence; a lost wakeup hangs until the timeout
+        std::atomic<uint32_t> consumed{0};
+        constexpr uint32_t ROUNDS = 500;
+        std::thread poster([&] {
+            for (uint32_t i = 0; i < ROUNDS; ++i) {
+                while (consumed.load(std::memory_order_acquire) < i) {
+                    std::this_thread::yield();
+                }
+                if (i % 3 == 1) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(i % 200));
+                }
+                producer->post(i, ImmerValue{static_cast<int>(i)});
+            }
+        });
+
+        // A lost wakeup still finds the message once the wait times out: time each round
+        uint32_t received = 0;
+        for (uint32_t i = 0; i < ROUNDS; ++i) {
+            const auto start = WaitClock::now();
+            auto msg = consumer->receive(std::chrono::seconds(2));
+            if (!msg || msg->msgId != i || WaitClock::now() - start > std::chrono::seconds(1)) {
+                break;
+            }
+            ++received;
+            consumed.store(i + 1, std::memory_order_release);
+        }
+        consumed.store(ROUNDS, std::memory_order_release);
+        poster.join();
+        REQUIRE(received == ROUNDS);
+    }
+
+    SECTION("an empty queue times out on time") {
+        const auto start = WaitClock::now();
+        REQUIRE_FALSE(consumer->waitForMessage(std::chrono::milliseconds(50)));
+        const auto waited = WaitClock::now() - start;
+        REQUIRE(waited >= std::chrono::milliseconds(50));
+        REQUIRE(waited < std::chrono::seconds(2));
+
+        REQUIRE_FALSE(consumer->receive(std::chrono::milliseconds(20)));
+        REQUIRE_FALSE(consumer->waitForMessage(std::chrono::milliseconds(0)));
+    }
+
+    SECTION("milliseconds::max() waits instead of overflowing the deadline") {
+        // An overflowed deadline lies in the past: the wait would return false at once
+        auto poster = post_later(*producer, 2, std::chrono::milliseconds(100));
+        const auto start = WaitClock::now();
+        const bool woken = consumer->waitForMessage(std::chrono::milliseconds::max());
+        const auto waited = WaitClock::now() - start;
+        poster.join();
+        REQUIRE(woken);
+        REQUIRE(waited >= std::chrono::milliseconds(90));
+
+        poster = post_later(*producer, 3, std::chrono::milliseconds(20));
+        auto msgs = std::vector<uint32_t>{consumer->receive()->msgId, consumer->receive()->msgId};
+        poster.join();
+        REQUIRE(msgs == std::vector<uint32_t>{2, 3});
+    }
+
+    SECTION("only the consumer waits") {
+        REQUIRE_FALSE(producer->waitForMessage(std::chrono::milliseconds(0)));
+        REQUIRE(producer->lastError() == "Not a consumer");
+    }
+}
+
+TEST_CASE("ChannelPair waits on its incoming channel", "[ipc][channelpair][wait]") {
+    const std::string name = unique_channel_name("pair_wait_");
+    auto creator = ChannelPair::create(name, 16);
+    REQUIRE(creator);
+    auto connector = ChannelPair::connect(name);
+    REQUIRE(connector);
+
+    // A message the pair posted itself is on its outgoing channel: nothing to wait for
+    REQUIRE(creator->post(1, ImmerValue{1}));
+    REQUIRE_FALSE(creator->waitForMessage(std::chrono::milliseconds(20)));
+    REQUIRE(connector->waitForMessage(std::chrono::milliseconds(0)));
+    REQUIRE(connector->tryReceive()->msgId == 1);
+
+    // Each side is woken by the other side posting from another thread
+    std::thread reply([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        connector->post(2, ImmerValue{2});
+    });
+    const auto start = WaitClock::now();
+    const bool woken = creator->waitForMessage(std::chrono::seconds(10));
+    const auto waited = WaitClock::now() - start;
+    reply.join();
+    REQUIRE(woken);
+    REQUIRE(waited < std::chrono::seconds(5));
+    REQUIRE(creator->tryReceive()->msgId == 2);
+
+    std::thread request([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        creator->post(3, ImmerValue{3});
+    });
+    const auto requestStart = WaitClock::now();
+    auto msg = connector->receive(std::chrono::seconds(10));
+    const auto requestWaited = WaitClock::now() - requestStart;
+    request.join();
+    REQUIRE(msg);
+    REQUIRE(requestWaited < std::chrono::seconds(5));
+    REQUIRE(msg->msgId == 3);
+}
+
+// ============================================================
+// ChannelMPMC Tests
+// ============================================================
+
+// Every consumer thread records (producer, sequence) in the order it received them
+struct MPMCReceived {
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+static std::vector<std::vector<MPMCReceived>> run_mpmc(const std::string& name, size_t producers, size_t consumers,
+                                                       uint32_t perProducer) {
+    std::atomic<size_t> producersDone{0};
+    std::vector<std::vector<MPMCReceived>> received(consumers);
+    std::vector<std::thread> threads;
+
+    // Each thread attaches with its own handle, like a separate process would
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            auto queue = ChannelMPMC::open(name);
+            for (uint32_t seq = 0; queue && seq < perProducer;) {
+                if (queue->postRaw(static_cast<uint32_t>(p), &seq, sizeof(seq))) {
+                    ++seq;
+                } else {
+                    std::this_thread::yield(); // Full
+                }
+            }
+            producersDone.fetch_add(1);
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            auto queue = ChannelMPMC::open(name);
+            while (queue) {
+                uint32_t producer = 0;
+                uint32_t seq = 0;
+                const int size = queue->tryReceiveRaw(producer, &seq, sizeof(seq));
+                if (size == sizeof(seq)) {
+                    received[c].push_back({producer, seq});
+                } else if (producersDone.load() == producers && queue->pendingCount() == 0) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return received;
+}
+
+TEST_CASE("ChannelMPMC delivers every message exactly once", "[ipc][mpmc]") {
+    const std::string name = unique_channel_name("mpmc_many_");
+    auto queue = ChannelMPMC::create(name, 64); // Small, so producers often find it full
+    REQUIRE(queue);
+    REQUIRE(queue->isCreator());
+
+    const size_t producers = GENERATE(1, 4);
+    const size_t consumers = GENERATE(1, 4);
+    constexpr uint32_t perProducer = 20000;
+    auto received = run_mpmc(name, producers, consumers, perProducer);
+
+    std::vector<std::vector<uint32_t>> seen(producers, std::vector<uint32_t>(perProducer, 0));
+    size_t total = 0;
+    for (const auto& consumer : received) {
+        // Each consumer sees every producer's messages in the order they were posted
+        std::vector<int64_t> last(producers, -1);
+        for (const auto& msg : consumer) {
+            REQUIRE(msg.producer < producers);
+            REQUIRE(msg.sequence < perProducer);
+            REQUIRE(static_cast<int64_t>(msg.sequence) > last[msg.producer]);
+            last[msg.producer] = msg.sequence;
+            ++seen[msg.producer][msg.sequence];
+        }
+        total += consumer.size();
+    }
+
+    // Nothing lost, nothing duplicated
+    REQUIRE(total == producers * perProducer);
+    for (const auto& counts : seen) {
+        REQUIRE(std::all_of(counts.begin(), counts.end(), [](uint32_t n) { return n == 1; }));
+    }
+    REQUIRE(queue->pendingCount() == 0);
+}
+
+TEST_CASE("ChannelMPMC limits", "[ipc][mpmc]") {
+    const std::string name = unique_channel_name("mpmc_limits_");
+    auto queue = ChannelMPMC::create(name, 6);
+    REQUIRE(queue);
+    REQUIRE(queue->capacity() == 8);
+    auto other = ChannelMPMC::open(name);
+    REQUIRE(other);
+    REQUIRE_FALSE(other->isCreator());
+
+    SECTION("tryReceiveRaw drops a message that does not fit the buffer") {
+        auto large = pattern_payload(100, 1);
+        auto small = pattern_payload(8, 2);
+        REQUIRE(queue->postRaw(1, large.data(), large.size()));
+        REQUIRE(queue->postRaw(2, small.data(), small.size()));
+
+        uint32_t msgId = 0;
+        uint8_t buffer[16] = {};
+        REQUIRE(other->tryReceiveRaw(msgId, buffer, sizeof(buffer)) == -1);
+        REQUIRE(msgId == 1);
+        REQUIRE(other->pendingCount() == 1);
+
+        // The next receive gets the following message, not the dropped one again
+        REQUIRE(queue->tryReceiveRaw(msgId, buffer, sizeof(buffer)) == static_cast<int>(small.size()));
+        REQUIRE(msgId == 2);
+        REQUIRE(std::memcmp(buffer, small.data(), small.size()) == 0);
+        REQUIRE(queue->tryReceiveRaw(msgId, buffer, sizeof(buffer)) == 0);
+    }
+
+    SECTION("payloads must fit inline") {
+        auto tooLarge = pattern_payload(Message::INLINE_SIZE + 1, 3);
+        REQUIRE_FALSE(queue->postRaw(1, tooLarge.data(), tooLarge.size()));
+        REQUIRE_FALSE(queue->post(2, ImmerValue{std::string(Message::INLINE_SIZE, 'x')}));
+        REQUIRE(queue->pendingCount() == 0);
+    }
+
+    SECTION("a full queue rejects posts until a message is received") {
+        for (uint32_t i = 0; i < 8; ++i) {
+            REQUIRE(queue->post(i, ImmerValue{static_cast<int>(i)}));
+        }
+        REQUIRE_FALSE(queue->canPost());
+        REQUIRE_FALSE(other->post(8, ImmerValue{8}));
+
+        REQUIRE(other->tryReceive()->msgId == 0);
+        REQUIRE(other->post(8, ImmerValue{8}));
+
+        std::vector<Channel::ReceivedMessage> batch;
+        REQUIRE(queue->receiveBatch(batch) == 8);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            REQUIRE(batch[i].msgId == i + 1);
+            REQUIRE(batch[i].data.as<int>() == static_cast<int>(i + 1));
+        }
+    }
+}
@@ -3,8 +3,11 @@
 
 #include <catch2/catch_all.hpp>
 #include <lager_ext/path.h>
+#include <lager_ext/path_utils.h>
+#include <lager_ext/path_watcher.h>
 #include <lager_ext/value.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -408,3 +411,111 @@ TEST_CASE("Path assign from iterators", "[path]") {
     REQUIRE(std::get<std::string_view>(target[1]) == "b");
     REQUIRE(std::get<std::string_view>(target[2]) == "c");
 }
+
+// ============================================================
+// PathWatcher Tests
+// ============================================================
+
+namespace {
+
+ImmerValue make_scene(int objects) {
+    ImmerValue scene = ImmerValue::map({});
+    for (int i = 0; i < objects; ++i) {
+        scene = scene.set("obj_" + std::to_string(i),
+                          ImmerValue::map({{"transform", ImmerValue::map({{"position", ImmerValue{i}},
+                                                                           {"scale", ImmerValue{1}}})},
+                                           {"visible", ImmerValue{true}}}));
+    }
+    return ImmerValue::map({{"objects", scene}});
+}
+
+} // namespace
+
+TEST_CASE("PathWatcher exact paths", "[path][watcher]") {
+    auto before = make_scene(3);
+    auto after = set_at_path(before, Path{"/objects/obj_1/transform/position"}, ImmerValue{42});
+
+    PathWatcher watcher;
+    std::vector<int> seen;
+    watcher.watch("/objects/obj_1/transform/position",
+                  [&seen](const ImmerValue& old_v, const ImmerValue& new_v) {
+                      seen.push_back(old_v.as<int>());
+                      seen.push_back(new_v.as<int>());
+                  });
+    watcher.watch("/objects/obj_2/transform/position",
+                  [&seen](const ImmerValue&, const ImmerValue&) { seen.push_back(-1); });
+
+    REQUIRE(watcher.check(before, after) == 1);
+    REQUIRE(seen == std::vector<int>{1, 42});
+
+    SECTION("equal content in separate storage does not fire") {
+        REQUIRE(watcher.check(make_scene(3), make_scene(3)) == 0);
+    }
+
+    SECTION("unwatch") {
+        watcher.unwatch("/objects/obj_1/transform/position");
+        REQUIRE(watcher.size() == 1);
+        REQUIRE(watcher.check(before, after) == 0);
+    }
+}
+
+TEST_CASE("PathWatcher wildcard segment", "[path][watcher]") {
+    auto before = make_scene(1000);
+    auto after = set_at_path(before, Path{"/objects/obj_10/transform/position"}, ImmerValue{-1});
+    after = set_at_path(after, Path{"/objects/obj_500/transform/scale"}, ImmerValue{2});
+    after = set_at_path(after, Path{"/objects/obj_700/transform/position"}, ImmerValue{-2});
+
+    PathWatcher watcher;
+    std::vector<std::string> paths;
+    watcher.watch("/objects/*/transform/position", [&paths](PathView path, const ImmerValue&, const ImmerValue&) {
+        paths.push_back(path.to_string_path());
+    });
+
+    REQUIRE(watcher.check(before, after) == 2);
+    std::sort(paths.begin(), paths.end());
+    REQUIRE(paths == std::vector<std::string>{"/objects/obj_10/transform/position",
+                                              "/objects/obj_700/transform/position"});
+    // Only the three changed objects are visited, not all 1000
+    REQUIRE(watcher.stats().nodes_visited < 20);
+
+    SECTION("added and removed children") {
+        auto grown = before.set("objects", before.at("objects").set("obj_new", ImmerValue::map({{"transform",
+                                ImmerValue::map({{"position", ImmerValue{7}}})}})));
+        paths.clear();
+        REQUIRE(watcher.check(before, grown) == 1);
+        REQUIRE(paths == std::vector<std::string>{"/objects/obj_new/transform/position"});
+        REQUIRE(watcher.check(grown, before) == 1);
+    }
+
+    SECTION("exact and wildcard watches on the same level") {
+        int exact = 0;
+        watcher.watch("/objects/obj_10/transform/position", [&exact](const ImmerValue&, const ImmerValue&) { ++exact; });
+        REQUIRE(watcher.check(before, after) == 3);
+        REQUIRE(exact == 1);
+    }
+
+    SECTION("unwatch pattern") {
+        watcher.unwatch("/objects/*/transform/position");
+        REQUIRE(watcher.empty());
+        REQUIRE(watcher.check(before, after) == 0);
+    }
+}
+
+TEST_CASE("PathWatcher any-depth segment", "[path][watcher]") {
+    auto before = ImmerValue::map({{"visible", ImmerValue{true}},
+                                   {"children", ImmerValue::vector({ImmerValue::map({{"visible", ImmerValue{true}}}),
+                                                                    ImmerValue::map({{"visible", ImmerValue{true}}})})}});
+    auto after = set_at_path(before, Path{"/visible"}, ImmerValue{false});
+    after = set_at_path(after, Path{"/children/1/visible"}, ImmerValue{false});
+
+    PathWatcher watcher;
+    std::vector<std::string> paths;
+    watcher.watch("/**/visible", [&paths](PathView path, const ImmerValue&, const ImmerValue&) {
+        paths.push_back(path.to_string_path());
+    });
+
+    // "**" matches zero segments (/visible) as well as several (/children/1/visible)
+    REQUIRE(watcher.check(before, after) == 2);
+    std::sort(paths.begin(), paths.end());
+    REQUIRE(paths == std::vector<std::string>{"/children/1/visible", "/visible"});
+}
@@ -0,0 +1,427 @@
+// test_shared_memory_pool.cpp - Tests for the shared memory payload pool
+// Module 11: SharedMemoryPool (TLSF allocator, deferred frees)
+
+#include <catch2/catch_all.hpp>
+#include <lager_ext/shared_memory_pool.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace lager_ext::ipc;
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+static std::string unique_pool_name(const std::string& prefix) {
+    return prefix + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+// Every block carries a 32-byte header and is rounded up to whole 64-byte granules
+constexpr size_t BLOCK_HEADER = 32;
+constexpr size_t POOL_SIZE = 64 * 1024;
+
+static constexpr size_t block_bytes(size_t size) {
+    return (BLOCK_HEADER + size + MIN_BLOCK_SIZE - 1) / MIN_BLOCK_SIZE * MIN_BLOCK_SIZE;
+}
+
+// ============================================================
+// Allocation Tests
+// ============================================================
+
+TEST_CASE("SharedMemoryPool splits free blocks and reuses exact fits", "[ipc][pool][alloc]") {
+    auto pool = SharedMemoryPool::create(unique_pool_name("pool_split_"), POOL_SIZE);
+    REQUIRE(pool);
+    REQUIRE(pool->pool_size() == POOL_SIZE);
+    REQUIRE(pool->free_space() == POOL_SIZE);
+
+    SECTION("allocations are carved off the front of the free block") {
+        auto a = pool->allocate(100);
+        auto b = pool->allocate(100);
+        REQUIRE((a && b));
+        REQUIRE(a.offset() == 0);
+        REQUIRE(b.offset() == block_bytes(100));
+        REQUIRE(a.size() == 100);
+        REQUIRE(pool->cache_misses() == 2);
+        REQUIRE(pool->allocated_count() == 2);
+        REQUIRE(pool->free_space() == POOL_SIZE - 2 * block_bytes(100));
+
+        // Data round-trips through the offset
+        std::memset(a.data(), 0xAB, a.size());
+        auto view = pool->get(a.offset(), a.size());
+        REQUIRE(view.data() == a.data());
+        REQUIRE(view.size() == 100);
+        REQUIRE(view[99] == 0xAB);
+    }
+
+    SECTION("a freed block of the same size class is reused whole") {
+        auto a = pool->allocate(100);
+        auto b = pool->allocate(100);
+        pool->deallocate(a.offset());
+
+        auto c = pool->allocate(97); // Same granule count as 100
+        REQUIRE(c);
+        REQUIRE(c.offset() == a.offset());
+        REQUIRE(pool->cache_hits() == 1);
+        REQUIRE(pool->cache_misses() == 2);
+    }
+
+    SECTION("a request for the whole pool fits exactly") {
+        auto all = pool->allocate(POOL_SIZE - BLOCK_HEADER);
+        REQUIRE(all);
+        REQUIRE(all.offset() == 0);
+        REQUIRE(pool->cache_hits() == 1);
+        REQUIRE(pool->free_space() == 0);
+
+        REQUIRE_FALSE(pool->allocate(1));
+        REQUIRE(SharedMemoryPool::last_error().find("Pool exhausted") != std::string::npos);
+        REQUIRE_FALSE(pool->allocate(POOL_SIZE));
+    }
+
+    SECTION("granule boundaries") {
+        // 32 bytes of data fill one granule, 33 need two
+        auto one = pool->allocate(MIN_BLOCK_SIZE - BLOCK_HEADER);
+        auto two = pool->allocate(MIN_BLOCK_SIZE - BLOCK_HEADER + 1);
+        auto next = pool->allocate(1);
+        REQUIRE(two.offset() == one.offset() + MIN_BLOCK_SIZE);
+        REQUIRE(next.offset() == two.offset() + 2 * MIN_BLOCK_SIZE);
+    }
+}
+
+TEST_CASE("SharedMemoryPool coalesces freed blocks with free neighbours", "[ipc][pool][coalesce]") {
+    auto pool = SharedMemoryPool::create(unique_pool_name("pool_merge_"), POOL_SIZE);
+    REQUIRE(pool);
+
+    auto a = pool->allocate(100);
+    auto b = pool->allocate(100);
+    auto c = pool->allocate(100);
+    auto d = pool->allocate(100); // Keeps c apart from the free tail
+    REQUIRE((a && b && c && d));
+
+    SECTION("both neighbours free") {
+        pool->deallocate(a.offset());
+        pool->deallocate(c.offset());
+        auto big = pool->allocate(1000); // Drains a and c; served from the tail
+        REQUIRE(big.offset() == 4 * block_bytes(100));
+        REQUIRE(pool->fragmentation_stats().free_blocks == 3);
+
+        // b merges with a before it and c after it into one block
+        pool->deallocate(b.offset());
+        auto merged = pool->allocate(3 * block_bytes(100) - BLOCK_HEADER);
+        REQUIRE(merged);
+        REQUIRE(merged.offset() == a.offset());
+        REQUIRE(pool->cache_hits() == 1);
+        REQUIRE(pool->fragmentation_stats().free_blocks == 1);
+    }
+
+    SECTION("predecessor free") {
+        pool->deallocate(a.offset());
+        REQUIRE(pool->allocate(1000)); // Drains a on its own
+        pool->deallocate(b.offset());
+        auto merged = pool->allocate(2 * block_bytes(100) - BLOCK_HEADER);
+        REQUIRE(merged.offset() == a.offset());
+        REQUIRE(pool->cache_hits() == 1);
+    }
+
+    SECTION("successor free") {
+        pool->deallocate(c.offset());
+        REQUIRE(pool->allocate(1000)); // Drains c on its own
+        pool->deallocate(b.offset());
+        auto merged = pool->allocate(2 * block_bytes(100) - BLOCK_HEADER);
+        REQUIRE(merged.offset() == b.offset());
+        REQUIRE(pool->cache_hits() == 1);
+    }
+
+    SECTION("everything freed merges back into one block") {
+        for (auto* block : {&b, &d, &a, &c}) {
+            pool->deallocate(block->offset());
+        }
+        auto all = pool->allocate(POOL_SIZE - BLOCK_HEADER);
+        REQUIRE(all);
+        REQUIRE(all.offset() == 0);
+    }
+}
+
+// ============================================================
+// Deferred Free Tests
+// ============================================================
+
+TEST_CASE("SharedMemoryPool defers frees until the next allocate", "[ipc][pool][deferred]") {
+    const std::string name = unique_pool_name("pool_deferred_");
+    auto producer = SharedMemoryPool::create(name, POOL_SIZE);
+    REQUIRE(producer);
+    auto consumer = SharedMemoryPool::open(name);
+    REQUIRE(consumer);
+    REQUIRE_FALSE(consumer->is_creator());
+
+    auto a = producer->allocate(100);
+    auto b = producer->allocate(100);
+    const auto before = producer->fragmentation_stats();
+
+    // Any side may free: the block goes onto the shared deferred stack, not into the bins
+    consumer->deallocate(a.offset());
+    producer->deallocate(b.offset());
+    REQUIRE(producer->allocated_count() == 0);
+    REQUIRE(consumer->get(a.offset(), 100).empty());
+
+    auto deferred = producer->fragmentation_stats();
+    REQUIRE(deferred.deferred_bytes == 2 * block_bytes(100));
+    REQUIRE(deferred.free_bytes == before.free_bytes);
+    REQUIRE(deferred.free_blocks == before.free_blocks);
+    REQUIRE(producer->free_space() == POOL_SIZE);
+
+    // The next allocate merges both back (into the tail) before allocating
+    auto c = producer->allocate(10);
+    REQUIRE(c.offset() == 0);
+    auto drained = consumer->fragmentation_stats();
+    REQUIRE(drained.deferred_bytes == 0);
+    REQUIRE(drained.free_blocks == 1);
+    REQUIRE(drained.free_bytes == POOL_SIZE - block_bytes(10));
+    REQUIRE(consumer->allocated_count() == 1);
+}
+
+// ============================================================
+// Fragmentation Tests
+// ============================================================
+
+TEST_CASE("SharedMemoryPool fragmentation stats", "[ipc][pool][stats]") {
+    auto pool = SharedMemoryPool::create(unique_pool_name("pool_frag_"), POOL_SIZE);
+    REQUIRE(pool);
+
+    auto fresh = pool->fragmentation_stats();
+    REQUIRE(fresh.free_bytes == POOL_SIZE);
+    REQUIRE(fresh.free_blocks == 1);
+    REQUIRE(fresh.largest_free_block == POOL_SIZE - BLOCK_HEADER);
+    REQUIRE(fresh.deferred_bytes == 0);
+    REQUIRE(fresh.fragmentation == 0.0);
+
+    // Fill the pool with one-granule blocks, then free every other one
+    std::vector<uint64_t> offsets;
+    while (auto block = pool->allocate(MIN_BLOCK_SIZE - BLOCK_HEADER)) {
+        offsets.push_back(block.offset());
+    }
+    REQUIRE(offsets.size() == POOL_SIZE / MIN_BLOCK_SIZE);
+    REQUIRE(pool->fragmentation_stats().free_blocks == 0);
+
+    for (size_t i = 0; i < offsets.size(); i += 2) {
+        pool->deallocate(offsets[i]);
+    }
+    // Half the pool is free, but only in single granules
+    REQUIRE_FALSE(pool->allocate(MIN_BLOCK_SIZE));
+
+    auto checkerboard = pool->fragmentation_stats();
+    REQUIRE(checkerboard.free_bytes == POOL_SIZE / 2);
+    REQUIRE(checkerboard.free_blocks == offsets.size() / 2);
+    REQUIRE(checkerboard.largest_free_block == MIN_BLOCK_SIZE - BLOCK_HEADER);
+    REQUIRE(checkerboard.deferred_bytes == 0);
+    REQUIRE(checkerboard.fragmentation ==
+            Catch::Approx(1.0 - double(MIN_BLOCK_SIZE - BLOCK_HEADER) / double(POOL_SIZE / 2 - BLOCK_HEADER)));
+
+    // Freeing the rest merges everything back
+    for (size_t i = 1; i < offsets.size(); i += 2) {
+        pool->deallocate(offsets[i]);
+    }
+    REQUIRE(pool->allocate(1));
+    auto healed = pool->fragmentation_stats();
+    REQUIRE(healed.free_blocks == 1);
+    REQUIRE(healed.free_bytes == POOL_SIZE - MIN_BLOCK_SIZE);
+    REQUIRE(healed.fragmentation == 0.0);
+}
+
+// ============================================================
+// Invalid Offset Tests
+// ============================================================
+
+TEST_CASE("SharedMemoryPool ignores double frees and stale offsets", "[ipc][pool][invalid]") {
+    auto pool = SharedMemoryPool::create(unique_pool_name("pool_stale_"), POOL_SIZE);
+    REQUIRE(pool);
+
+    auto a = pool->allocate(100);
+    auto b = pool->allocate(100);
+    auto c = pool->allocate(100);
+    REQUIRE(pool->allocated_count() == 3);
+
+    SECTION("double free") {
+        pool->deallocate(b.offset());
+        pool->deallocate(b.offset());
+        REQUIRE(pool->allocated_count() == 2);
+        REQUIRE(pool->fragmentation_stats().deferred_bytes == block_bytes(100));
+
+        // Also once drained into the bins
+        REQUIRE(pool->allocate(5000));
+        pool->deallocate(b.offset());
+        REQUIRE(pool->allocated_count() == 3);
+        REQUIRE(pool->fragmentation_stats().deferred_bytes == 0);
+    }
+
+    SECTION("offsets that are not block starts") {
+        pool->deallocate(b.offset() + 1);                   // Misaligned
+        pool->deallocate(b.offset() + MIN_BLOCK_SIZE);      // Inside the block
+        pool->deallocate(POOL_SIZE);                        // Past the segment
+        pool->deallocate(uint64_t{1} << 34);                // Segment that does not exist
+        pool->deallocate(UINT64_MAX - MIN_BLOCK_SIZE + 1);  // Beyond 32-bit granule refs
+        REQUIRE(pool->allocated_count() == 3);
+        REQUIRE(pool->fragmentation_stats().deferred_bytes == 0);
+        REQUIRE(pool->get(b.offset() + 1, 1).empty());
+        REQUIRE(pool->get(POOL_SIZE, 1).empty());
+    }
+
+    SECTION("offset of a block merged into its neighbour") {
+        pool->deallocate(a.offset());
+        pool->deallocate(b.offset());
+        REQUIRE(pool->allocate(5000)); // b merges into a
+
+        REQUIRE(pool->get(b.offset(), 100).empty());
+        pool->deallocate(b.offset());
+        REQUIRE(pool->allocated_count() == 2);
+        REQUIRE(pool->fragmentation_stats().deferred_bytes == 0);
+        REQUIRE(pool->get(c.offset(), 100).size() == 100);
+    }
+}
+
+// ============================================================
+// Segment Chaining Tests
+// ============================================================
+
+// Offset of the first block in chained segment k (granule refs keep the segment in their top 4 bits)
+static constexpr uint64_t segment_offset(uint64_t k) {
+    return (k << 28) * MIN_BLOCK_SIZE;
+}
+
+TEST_CASE("SharedMemoryPool grows into chained segments", "[ipc][pool][segments]") {
+    const std::string name = unique_pool_name("pool_grow_");
+    auto producer = SharedMemoryPool::create(name, POOL_SIZE, 4 * POOL_SIZE);
+    REQUIRE(producer);
+    auto early = SharedMemoryPool::open(name); // Attached before the pool grows
+    REQUIRE(early);
+
+    auto first = producer->allocate(POOL_SIZE - 4096);
+    REQUIRE(first);
+    REQUIRE(producer->segment_count() == 1);
+
+    // Nothing left in segment 0 fits: a second segment of the same size is chained
+    auto second = producer->allocate(8192);
+    REQUIRE(second);
+    REQUIRE(second.offset() == segment_offset(1));
+    REQUIRE(producer->segment_count() == 2);
+    REQUIRE(producer->pool_size() == 2 * POOL_SIZE);
+    std::memset(first.data(), 0x11, first.size());
+    std::memset(second.data(), 0x22, second.size());
+
+    // Small requests still fill the rest of segment 0 first
+    auto small = producer->allocate(100);
+    REQUIRE(small.offset() < segment_offset(1));
+
+    SECTION("refs resolve in pools opened after the growth") {
+        auto late = SharedMemoryPool::open(name);
+        REQUIRE(late);
+        REQUIRE(late->segment_count() == 2);
+        REQUIRE(late->pool_size() == 2 * POOL_SIZE);
+
+        auto view = late->get(second.offset(), second.size());
+        REQUIRE(view.size() == second.size());
+        REQUIRE(view.front() == 0x22);
+        REQUIRE(view.back() == 0x22);
+        REQUIRE(late->get(first.offset(), first.size()).back() == 0x11);
+
+        // A free from the late side is merged back by the producer
+        late->deallocate(second.offset());
+        REQUIRE(producer->allocated_count() == 2);
+        auto again = producer->allocate(8192);
+        REQUIRE(again.offset() == second.offset());
+        REQUIRE(producer->segment_count() == 2);
+    }
+
+    SECTION("pools opened before the growth map the segment on first access") {
+        auto view = early->get(second.offset(), second.size());
+        REQUIRE(view.size() == second.size());
+        REQUIRE(view.front() == 0x22);
+    }
+
+    SECTION("a request larger than a segment gets a segment of its own size") {
+        auto big = producer->allocate(POOL_SIZE + 1000);
+        REQUIRE(big);
+        REQUIRE(big.offset() == segment_offset(2));
+        REQUIRE(producer->segment_count() == 3);
+        REQUIRE(producer->pool_size() == 2 * POOL_SIZE + block_bytes(POOL_SIZE + 1000));
+    }
+
+    SECTION("growth stops at max_pool_size") {
+        auto third = producer->allocate(POOL_SIZE - BLOCK_HEADER);
+        REQUIRE(third);
+        REQUIRE(producer->segment_count() == 3);
+
+        // 64 KB of growth budget left, but not in one piece that fits
+        REQUIRE_FALSE(producer->allocate(POOL_SIZE + 1000));
+        REQUIRE(SharedMemoryPool::last_error().find("Pool exhausted") != std::string::npos);
+        REQUIRE(producer->segment_count() == 3);
+    }
+}
+
+TEST_CASE("SharedMemoryPool chains at most MAX_POOL_SEGMENTS segments", "[ipc][pool][segments]") {
+    const std::string name = unique_pool_name("pool_limit_");
+    constexpr size_t segment_size = 4096;
+    auto producer = SharedMemoryPool::create(name, segment_size, 1024 * segment_size);
+    REQUIRE(producer);
+
+    // Each block fills a whole segment
+    std::vector<SharedMemoryPool::Block> blocks;
+    for (size_t k = 0; k < MAX_POOL_SEGMENTS; ++k) {
+        auto block = producer->allocate(segment_size - BLOCK_HEADER);
+        REQUIRE(block);
+        REQUIRE(block.offset() == segment_offset(k));
+        std::memset(block.data(), static_cast<int>(k + 1), block.size());
+        blocks.push_back(block);
+    }
+    REQUIRE(producer->segment_count() == MAX_POOL_SEGMENTS);
+    REQUIRE(producer->pool_size() == MAX_POOL_SEGMENTS * segment_size);
+
+    // The 4-bit segment field is used up, however much growth budget is left
+    REQUIRE_FALSE(producer->allocate(1));
+    REQUIRE(SharedMemoryPool::last_error().find("Pool exhausted") != std::string::npos);
+    REQUIRE(producer->segment_count() == MAX_POOL_SEGMENTS);
+
+    // Every segment, the last included, resolves in a pool opened afterwards
+    auto late = SharedMemoryPool::open(name);
+    REQUIRE(late);
+    for (size_t k = 0; k < blocks.size(); ++k) {
+        auto view = late->get(blocks[k].offset(), blocks[k].size());
+        REQUIRE(view.size() == segment_size - BLOCK_HEADER);
+        REQUIRE(view.front() == k + 1);
+        REQUIRE(view.back() == k + 1);
+    }
+    REQUIRE(late->get(segment_offset(MAX_POOL_SEGMENTS - 1) + segment_size, 1).empty());
+
+#ifndef _WIN32
+    // Same from another process: the child reports how many blocks it could read back
+    pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        int readable = 0;
+        if (auto attached = SharedMemoryPool::open(name)) {
+            for (size_t k = 0; k < blocks.size(); ++k) {
+                auto view = attached->get(blocks[k].offset(), blocks[k].size());
+                readable += view.size() == blocks[k].size() && view.front() == k + 1 && view.back() == k + 1;
+            }
+        }
+        _exit(readable);
+    }
+    int status = 0;
+    REQUIRE(waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == static_cast<int>(MAX_POOL_SEGMENTS));
+#endif
+
+    // Freed space in the last segment is reused without growing
+    late->deallocate(blocks.back().offset());
+    auto reused = producer->allocate(100);
+    REQUIRE(reused.offset() == segment_offset(MAX_POOL_SEGMENTS - 1));
+    REQUIRE(producer->segment_count() == MAX_POOL_SEGMENTS);
+}
@@ -0,0 +1,206 @@
+// test_shared_state.cpp - Tests for cross-process state sharing
+// Module 9: StatePublisher / StateSubscriber versioned ring
+
+#include <catch2/catch_all.hpp>
+#include <lager_ext/shared_state.h>
+#include <lager_ext/value.h>
+
+#include <chrono>
+#include <string>
+
+using namespace lager_ext;
+
+// ============================================================
+// Helper Functions
+// ============================================================
+
+static SharedMemoryConfig ring_config(const std::string& prefix, std::size_t ring_slots) {
+    SharedMemoryConfig config;
+    config.name = prefix + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    config.size = 64 * 1024;
+    config.ring_slots = ring_slots;
+    return config;
+}
+
+static ImmerValue counter_state(int counter) {
+    return ImmerValue::map({
+        {"title", ImmerValue{"document"}},
+        {"body", ImmerValue{std::string(256, 'x')}},
+        {"counter", ImmerValue{counter}}
+    });
+}
+
+// ============================================================
+// Ring Replay Tests
+// ============================================================
+
+TEST_CASE("StateSubscriber replays diffs still in the ring", "[shared_state][ring]") {
+    auto config = ring_config("ring_replay_", 8);
+    StatePublisher publisher{config};
+    REQUIRE(publisher.is_valid());
+
+    publisher.publish(counter_state(0));
+    StateSubscriber subscriber{config};
+    REQUIRE(subscriber.version() == 1);
+
+    ImmerValue state = counter_state(0);
+    for (int i = 1; i <= 3; ++i) {
+        ImmerValue next = counter_state(i);
+        REQUIRE(publisher.publish_diff(state, next));
+        state = next;
+    }
+
+    REQUIRE(subscriber.poll());
+    REQUIRE(subscriber.version() == publisher.version());
+    REQUIRE(subscriber.current() == state);
+
+    auto stats = subscriber.stats();
+    REQUIRE(stats.diff_updates == 3);
+    REQUIRE(stats.snapshot_fallbacks == 0);
+    REQUIRE(stats.missed_updates == 0);
+}
+
+TEST_CASE("Lapped StateSubscriber catches up from the snapshot", "[shared_state][ring]") {
+    auto config = ring_config("ring_catchup_", 4);
+    StatePublisher publisher{config};
+    REQUIRE(publisher.is_valid());
+
+    publisher.publish(counter_state(0));
+    StateSubscriber subscriber{config};
+    REQUIRE(subscriber.version() == 1);
+
+    // Publish several ring revolutions without the subscriber polling
+    ImmerValue state = counter_state(0);
+    for (int i = 1; i <= 19; ++i) {
+        ImmerValue next = counter_state(i);
+        REQUIRE(publisher.publish_diff(state, next));
+        state = next;
+    }
+    REQUIRE(publisher.stats().snapshot_writes > 1);
+
+    REQUIRE(subscriber.poll());
+    REQUIRE(subscriber.version() == publisher.version());
+    REQUIRE(subscriber.current() == state);
+
+    auto stats = subscriber.stats();
+    REQUIRE(stats.snapshot_fallbacks >= 1);
+    REQUIRE(stats.missed_updates > 0);
+
+    // Back in step: the next diff is replayed from its slot
+    ImmerValue next = counter_state(100);
+    REQUIRE(publisher.publish_diff(state, next));
+    REQUIRE(subscriber.poll());
+    REQUIRE(subscriber.current() == next);
+    REQUIRE(subscriber.stats().diff_updates == stats.diff_updates + 1);
+}
+
+TEST_CASE("StatePublisher rejects diffs whose snapshot refresh does not fit", "[shared_state][ring]") {
+    auto config = ring_config("ring_overflow_", 2);
+    config.size = 4 * 1024;
+    config.slot_size = 256;
+    config.snapshot_interval = 1;
+    StatePublisher publisher{config};
+    REQUIRE(publisher.is_valid());
+
+    ImmerValue state = ImmerValue::map({});
+    publisher.publish(state);
+    StateSubscriber subscriber{config};
+
+    // Grow the state by small diffs until it outgrows the snapshot area
+    uint64_t published_version = publisher.version();
+    bool rejected = false;
+    for (int i = 0; i < 1000 && !rejected; ++i) {
+        ImmerValue next = state.set("key_" + std::to_string(i), ImmerValue{std::string(32, 'x')});
+        if (!publisher.publish_diff(state, next) && publisher.stats().rejected_publishes > 0) {
+            rejected = true;
+            break;
+        }
+        state = next;
+        published_version = publisher.version();
+    }
+
+    REQUIRE(rejected);
+    REQUIRE(publisher.version() == published_version);
+
+    // Every published version stays reachable for a subscriber
+    subscriber.poll();
+    REQUIRE(subscriber.version() == published_version);
+    REQUIRE(subscriber.current() == state);
+}
+
+// ============================================================
+// Diff Encoding Round-Trip Tests
+// ============================================================
+
+TEST_CASE("Encoded diffs round-trip tables and arrays", "[shared_state][diff]") {
+    auto round_trip = [](const ImmerValue& before, const ImmerValue& after) {
+        auto decoded = decode_diff(encode_diff(before, after));
+        REQUIRE(encode_diff(before, after) == encode_diff(collect_diff(before, after)));
+        return apply_diff(before, decoded);
+    };
+    auto state = [](ImmerValue entities, ImmerValue weights) {
+        return ImmerValue::map({{"entities", std::move(entities)}, {"weights", std::move(weights)}});
+    };
+    auto entities = ImmerValue::table({{"e1", ImmerValue{1}}, {"e2", ImmerValue::map({{"hp", ImmerValue{5}}})}});
+    auto weights = ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}});
+    auto before = state(entities, weights);
+
+    SECTION("table entries") {
+        auto changed = state(entities.set("e1", ImmerValue{10}), weights);
+        auto nested = state(entities.set("e2", ImmerValue::map({{"hp", ImmerValue{4}}})), weights);
+        auto added = state(entities.set("e3", ImmerValue::table({{"t", ImmerValue{1}}})), weights);
+        auto removed = state(ImmerValue::table({{"e1", ImmerValue{1}}}), weights);
+
+        REQUIRE(round_trip(before, changed) == changed);
+        REQUIRE(round_trip(before, nested) == nested);
+        REQUIRE(round_trip(before, added) == added);
+        REQUIRE(round_trip(before, removed) == removed);
+        REQUIRE(round_trip(removed, before) == before);
+    }
+
+    SECTION("array elements") {
+        auto changed = state(entities, ImmerValue::array({ImmerValue{0.5}, ImmerValue{2.0}}));
+        auto grown = state(entities, ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}, ImmerValue{1.5},
+                                                        ImmerValue::array({ImmerValue{1}})}));
+        auto shrunk = state(entities, ImmerValue::array({ImmerValue{0.5}}));
+        auto emptied = state(entities, ImmerValue::array({}));
+
+        REQUIRE(round_trip(before, changed) == changed);
+        REQUIRE(round_trip(before, grown) == grown);
+        REQUIRE(round_trip(grown, before) == before);
+        REQUIRE(round_trip(before, shrunk) == shrunk);
+        REQUIRE(round_trip(before, emptied) == emptied);
+    }
+
+    SECTION("vector elements") {
+        auto items = ImmerValue::map({{"items", ImmerValue::vector({ImmerValue{1}, ImmerValue{2}, ImmerValue{3}})}});
+        auto shorter = ImmerValue::map({{"items", ImmerValue::vector({ImmerValue{1}})}});
+        REQUIRE(round_trip(items, shorter) == shorter);
+        REQUIRE(round_trip(shorter, items) == items);
+    }
+}
+
+TEST_CASE("StateSubscriber applies table and array diffs", "[shared_state][diff]") {
+    auto config = ring_config("table_diff_", 8);
+    StatePublisher publisher{config};
+    REQUIRE(publisher.is_valid());
+
+    // The body keeps every diff smaller than the full state, so diffs are published
+    auto state = ImmerValue::map({{"body", ImmerValue{std::string(256, 'x')}},
+                                  {"entities", ImmerValue::table({{"e1", ImmerValue{1}}, {"e2", ImmerValue{2}}})},
+                                  {"weights", ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}})}});
+    publisher.publish(state);
+    StateSubscriber subscriber{config};
+    REQUIRE(subscriber.current() == state);
+
+    auto next = state.set("entities", ImmerValue::table({{"e1", ImmerValue{10}}, {"e3", ImmerValue{3}}}))
+                    .set("weights", ImmerValue::array({ImmerValue{0.5}, ImmerValue{1.0}, ImmerValue{1.5}}));
+    REQUIRE(publisher.publish_diff(state, next));
+    subscriber.poll();
+    REQUIRE(subscriber.current() == next);
+
+    auto last = next.set("weights", ImmerValue::array({ImmerValue{0.5}}));
+    REQUIRE(publisher.publish_diff(next, last));
+    subscriber.poll();
+    REQUIRE(subscriber.current() == last);
+}
@@ -2,9 +2,11 @@
 // Module 4: SharedValue related interfaces
 
 #include <catch2/catch_all.hpp>
+#include <lager_ext/fast_shared_value.h>
 #include <lager_ext/shared_value.h>
 #include <lager_ext/value.h>
 
+#include <atomic>
 #include <string>
 
 using namespace lager_ext;
@@ -436,6 +438,31 @@ TEST_CASE("SharedMemoryRegion construction", "[shared][region]") {
         SharedMemoryRegion region2 = std::move(region1);
         REQUIRE_FALSE(region2.is_valid());
     }
+
+    SECTION("sub-arena of an unmapped region") {
+        SharedMemoryRegion region;
+        std::atomic<size_t> heap_cursor{0};
+        SharedMemoryRegion arena = region.make_sub_arena(heap_cursor, 4096);
+        REQUIRE(arena.is_sub_arena());
+        REQUIRE_FALSE(region.is_sub_arena());
+        REQUIRE_FALSE(arena.is_valid());
+        REQUIRE(arena.allocate(64) == nullptr);
+        REQUIRE(heap_cursor.load() == 0);
+    }
+}
+
+// ============================================================
+// Parallel FastSharedValue construction (without actual shared memory)
+// ============================================================
+
+TEST_CASE("fast_deep_copy_to_shared_parallel requires a region", "[shared][fast][parallel]") {
+    SharedMemoryRegion* original = get_current_shared_region();
+    set_current_shared_region(nullptr);
+
+    ImmerValue scene = ImmerValue::map({{"name", "scene"}, {"count", 3}});
+    REQUIRE_THROWS_AS(fast_deep_copy_to_shared_parallel(scene, 4), shared_memory_error);
+
+    set_current_shared_region(original);
 }
 
 // ============================================================